@@ -19,6 +19,7 @@
 #include <azure/core/az_result.h>
 #include <azure/core/az_span.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <azure/core/_az_cfg_prefix.h>
@@ -119,6 +120,157 @@ AZ_NODISCARD az_result az_base64_url_decode(
  */
 AZ_NODISCARD int32_t az_base64_url_get_max_decoded_size(int32_t source_base64_url_text_size);
 
+/**
+ * @brief Encodes binary data that arrives in pieces into base 64 text.
+ *
+ * @details Initialize with #az_base64_encoder_init(), pass each piece to
+ * #az_base64_encoder_update() and finish with #az_base64_encoder_final(). The concatenated output
+ * is the same as the output of #az_base64_encode() for the concatenated input.
+ */
+typedef struct
+{
+  struct
+  {
+    uint8_t pending[2];
+    int32_t pending_size;
+  } _internal;
+} az_base64_encoder;
+
+/**
+ * @brief Initializes an #az_base64_encoder.
+ *
+ * @param[out] out_encoder A pointer to the #az_base64_encoder to initialize.
+ */
+void az_base64_encoder_init(az_base64_encoder* out_encoder);
+
+/**
+ * @brief Encodes the next piece of binary data.
+ *
+ * @details Every complete group of three bytes is written out; up to two bytes are kept until the
+ * next call.
+ *
+ * @param[in,out] ref_encoder A pointer to the #az_base64_encoder.
+ * @param destination_base64_text The output #az_span where the encoded base 64 text should be
+ * copied to. It needs room for `((pending + size of source_bytes) / 3) * 4` characters, which is
+ * at most `az_base64_get_max_encoded_size(size of source_bytes)`.
+ * @param[in] source_bytes The next piece of binary data. It can be empty.
+ * @param[out] out_written A pointer to an `int32_t` that receives the number of bytes written into
+ * the destination #az_span.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p destination_base64_text is not large enough. Nothing is
+ * consumed and the call can be repeated with a larger destination.
+ */
+AZ_NODISCARD az_result az_base64_encoder_update(
+    az_base64_encoder* ref_encoder,
+    az_span destination_base64_text,
+    az_span source_bytes,
+    int32_t* out_written);
+
+/**
+ * @brief Writes the last, padded group of base 64 text and resets the encoder.
+ *
+ * @param[in,out] ref_encoder A pointer to the #az_base64_encoder.
+ * @param destination_base64_text The output #az_span, with room for up to 4 characters.
+ * @param[out] out_written A pointer to an `int32_t` that receives the number of bytes written into
+ * the destination #az_span, either 0 or 4.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p destination_base64_text is not large enough.
+ */
+AZ_NODISCARD az_result az_base64_encoder_final(
+    az_base64_encoder* ref_encoder,
+    az_span destination_base64_text,
+    int32_t* out_written);
+
+/**
+ * @brief Decodes base 64 or base 64 url text that arrives in pieces into binary data.
+ *
+ * @details Initialize with #az_base64_decoder_init() or #az_base64_url_decoder_init(), pass each
+ * piece to #az_base64_decoder_update() and finish with #az_base64_decoder_final(). The concatenated
+ * output is the same as the output of #az_base64_decode() or #az_base64_url_decode() for the
+ * concatenated input.
+ *
+ * @remarks After an error other than #AZ_ERROR_NOT_ENOUGH_SPACE the decoder must be initialized
+ * again before it is reused.
+ */
+typedef struct
+{
+  struct
+  {
+    uint8_t pending[3];
+    int32_t pending_size;
+    bool url;
+    bool finished;
+    bool has_input;
+  } _internal;
+} az_base64_decoder;
+
+/**
+ * @brief Initializes an #az_base64_decoder for base 64 text.
+ *
+ * @param[out] out_decoder A pointer to the #az_base64_decoder to initialize.
+ */
+void az_base64_decoder_init(az_base64_decoder* out_decoder);
+
+/**
+ * @brief Initializes an #az_base64_decoder for base 64 url text, where the padding is optional.
+ *
+ * @param[out] out_decoder A pointer to the #az_base64_decoder to initialize.
+ */
+void az_base64_url_decoder_init(az_base64_decoder* out_decoder);
+
+/**
+ * @brief Decodes the next piece of base 64 text.
+ *
+ * @details Every complete group of four characters is decoded; up to three characters are kept
+ * until the next call.
+ *
+ * @param[in,out] ref_decoder A pointer to the #az_base64_decoder.
+ * @param destination_bytes The output #az_span where the decoded binary data should be copied to.
+ * Room for `az_base64_get_max_decoded_size(size of source_base64_text) + 3` bytes is always
+ * enough.
+ * @param[in] source_base64_text The next piece of base 64 text. It can be empty.
+ * @param[out] out_written A pointer to an `int32_t` that receives the number of bytes written into
+ * the destination #az_span.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p destination_bytes is not large enough. Nothing is
+ * consumed and the call can be repeated with a larger destination.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR The text contains characters outside of the expected base 64
+ * range, invalid padding, or characters after the padding.
+ */
+AZ_NODISCARD az_result az_base64_decoder_update(
+    az_base64_decoder* ref_decoder,
+    az_span destination_bytes,
+    az_span source_base64_text,
+    int32_t* out_written);
+
+/**
+ * @brief Decodes the characters that are left at the end of base 64 url text without padding and
+ * checks that the text is complete.
+ *
+ * @param[in,out] ref_decoder A pointer to the #az_base64_decoder.
+ * @param destination_bytes The output #az_span, with room for up to 2 bytes.
+ * @param[out] out_written A pointer to an `int32_t` that receives the number of bytes written into
+ * the destination #az_span.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p destination_bytes is not large enough.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR The characters that are left are outside of the expected base
+ * 64 range.
+ * @retval #AZ_ERROR_UNEXPECTED_END The text was empty or is incomplete (for base 64 text, not of a
+ * size which is a multiple of 4; for base 64 url text, length % 4 == 1).
+ */
+AZ_NODISCARD az_result az_base64_decoder_final(
+    az_base64_decoder* ref_decoder,
+    az_span destination_bytes,
+    int32_t* out_written);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_BASE64_H
@@ -556,6 +556,34 @@ AZ_NODISCARD az_result az_json_writer_append_double(
     double value,
     int32_t fractional_digits);
 
+/**
+ * @brief Appends a `double` number with as few digits as possible while still parsing back to
+ * exactly the same value.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance containing the buffer to
+ * append the number to.
+ * @param[in] value The value to be written as a JSON number.
+ *
+ * @note If you receive an #AZ_ERROR_NOT_ENOUGH_SPACE result while appending data for which there is
+ * sufficient space, note that the JSON writer requires at least 64 bytes of slack within the
+ * output buffer, above the theoretical minimal space needed. The JSON writer pessimistically
+ * requires this extra space because it tries to write formatted text in chunks rather than one
+ * character at a time, whenever the input data is dynamic in size.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The number was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ *
+ * @remark Only finite double values are supported. Values such as `NAN` and `INFINITY` are not
+ * allowed and would lead to invalid JSON being written.
+ *
+ * @remark The number is formatted by az_span_dtoa_shortest(): `0.1` instead of `0.100000000000000`
+ * or `0.1000000000000000055511151231257827`, and `1e-7` for small and `1.5e300` for large
+ * magnitudes. Unlike az_json_writer_append_double(), there is no limit on the integer part.
+ */
+AZ_NODISCARD az_result
+az_json_writer_append_double_shortest(az_json_writer* ref_json_writer, double value);
+
 /**
  * @brief Appends the JSON literal `null`.
  *
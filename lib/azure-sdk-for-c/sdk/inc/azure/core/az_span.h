@@ -265,6 +265,9 @@ void az_span_to_str(char* destination, int32_t destination_max_size, az_span sou
  * @retval -1 \p target is not found in `source` OR \p source is empty (if its size is zero) and \p
  * target is non-empty.
  * @retval >=0 The position of \p target in \p source.
+ *
+ * @remarks The search takes time linear in the sizes of \p source and \p target and uses no
+ * additional memory.
  */
 AZ_NODISCARD int32_t az_span_find(az_span source, az_span target);
 
@@ -381,6 +384,14 @@ AZ_NODISCARD az_result az_span_atoi32(az_span source, int32_t* out_number);
  *
  * @remark The #az_span being parsed must contain a number that is finite. Values such as `NaN`,
  * `INFINITY`, and those that would overflow a `double` to `+/-inf` are not allowed.
+ *
+ * @remark The result is correctly rounded (round half to even) and does not depend on the C
+ * library or the current locale. The accepted format is an optional sign, decimal digits with an
+ * optional fraction and an optional exponent; hexadecimal numbers are not allowed.
+ *
+ * @remark Most numbers are converted with a few integer multiplications. Numbers within rounding
+ * distance of a halfway point between two doubles, and subnormal numbers, take an exact decimal
+ * fallback that keeps up to 768 significant digits and needs about 800 bytes of stack.
  */
 AZ_NODISCARD az_result az_span_atod(az_span source, double* out_number);
 
@@ -483,6 +494,31 @@ AZ_NODISCARD az_result az_span_u64toa(az_span destination, uint64_t source, az_s
 AZ_NODISCARD az_result
 az_span_dtoa(az_span destination, double source, int32_t fractional_digits, az_span* out_span);
 
+/**
+ * @brief Converts a `double` into the shortest text that parses back to exactly the same value, and
+ * copies it to the \p destination #az_span starting at its 0-th index.
+ *
+ * @param destination The #az_span where the bytes should be copied to.
+ * @param[in] source The `double` whose number is copied to the \p destination #az_span.
+ * @param[out] out_span A pointer to an #az_span that receives the remainder of the \p destination
+ * #az_span after the `double` has been copied.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p destination is not big enough to contain the copied
+ * bytes.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The \p source is not a finite decimal number.
+ *
+ * @remark The text has as few significant digits as possible (at most 17), and az_span_atod()
+ * returns exactly \p source for it. Numbers from 1e-6 up to, but not including, 1e21 are written
+ * in decimal notation (`0.1`, `23.5`, `1500`), all others with an exponent (`1e-7`, `1.5e300`).
+ * Negative zero is written as `-0`. At most 25 bytes are written.
+ *
+ * @remark Only finite `double` values are supported. Values such as `NaN` and `INFINITY` are not
+ * allowed.
+ */
+AZ_NODISCARD az_result az_span_dtoa_shortest(az_span destination, double source, az_span* out_span);
+
 /******************************  NON-CONTIGUOUS SPAN  */
 
 /**
@@ -3,6 +3,22 @@
 
 #include <azure/core/az_base64.h>
 #include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Host builds that target SSSE3 or AVX2 (for example with -march=native) convert 12 or 24 bytes per
+// step with vector instructions. Define AZ_NO_BASE64_SIMD to use only the table-driven loops.
+#if !defined(AZ_NO_BASE64_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define _az_BASE64_SIMD_AVX2
+#define _az_BASE64_SIMD_SSSE3
+#elif !defined(AZ_NO_BASE64_SIMD) && defined(__SSSE3__)
+#include <tmmintrin.h>
+#define _az_BASE64_SIMD_SSSE3
+#endif
 
 #include <azure/core/_az_cfg.h>
 
@@ -12,6 +28,10 @@
 
 #define _az_ENCODING_PAD '='
 
+// Table value of characters outside of the alphabet. Any of them sets this bit when OR-ed together.
+#define _az_BASE64_INVALID 0xFF
+#define _az_BASE64_INVALID_BIT 0x80
+
 typedef enum
 {
   _az_base64_mode_standard,
@@ -21,45 +41,259 @@ typedef enum
 static char const _az_base64_encode_array[65]
     = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-static AZ_NODISCARD int32_t _az_base64_encode(uint8_t* three_bytes)
+// Map each character to its 6-bit value, or to _az_BASE64_INVALID if it is not part of the
+// alphabet.
+// clang-format off
+static uint8_t const _az_base64_decode_standard[256] = {
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  62, 255, 255, 255,  63,
+   52,  53,  54,  55,  56,  57,  58,  59,  60,  61, 255, 255, 255, 255, 255, 255,
+  255,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,
+   15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25, 255, 255, 255, 255, 255,
+  255,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,
+   41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+// The same for the url alphabet, where '-' and '_' replace '+' and '/'.
+static uint8_t const _az_base64_decode_url[256] = {
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  62, 255, 255,
+   52,  53,  54,  55,  56,  57,  58,  59,  60,  61, 255, 255, 255, 255, 255, 255,
+  255,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,
+   15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25, 255, 255, 255, 255,  63,
+  255,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,
+   41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+};
+// clang-format on
+
+AZ_INLINE void _az_base64_encode_group(uint8_t* destination, uint8_t const* three_bytes)
 {
-  int32_t i = (*three_bytes << 16) | (*(three_bytes + 1) << 8) | *(three_bytes + 2);
+  uint32_t const value
+      = ((uint32_t)three_bytes[0] << 16) | ((uint32_t)three_bytes[1] << 8) | three_bytes[2];
+
+  destination[0] = (uint8_t)_az_base64_encode_array[value >> 18];
+  destination[1] = (uint8_t)_az_base64_encode_array[(value >> 12) & 0x3F];
+  destination[2] = (uint8_t)_az_base64_encode_array[(value >> 6) & 0x3F];
+  destination[3] = (uint8_t)_az_base64_encode_array[value & 0x3F];
+}
 
-  int32_t i0 = _az_base64_encode_array[i >> 18];
-  int32_t i1 = _az_base64_encode_array[(i >> 12) & 0x3F];
-  int32_t i2 = _az_base64_encode_array[(i >> 6) & 0x3F];
-  int32_t i3 = _az_base64_encode_array[i & 0x3F];
+// Encodes the last one or two bytes and pads the group with '='.
+static void _az_base64_encode_and_pad(uint8_t* destination, uint8_t const* source, int32_t size)
+{
+  uint32_t const value = ((uint32_t)source[0] << 16) | (size > 1 ? (uint32_t)source[1] << 8 : 0);
 
-  return i0 | (i1 << 8) | (i2 << 16) | (i3 << 24);
+  destination[0] = (uint8_t)_az_base64_encode_array[value >> 18];
+  destination[1] = (uint8_t)_az_base64_encode_array[(value >> 12) & 0x3F];
+  destination[2]
+      = size > 1 ? (uint8_t)_az_base64_encode_array[(value >> 6) & 0x3F] : _az_ENCODING_PAD;
+  destination[3] = _az_ENCODING_PAD;
+}
+
+#if defined(_az_BASE64_SIMD_SSSE3)
+// Puts the three bytes of each group into a 32-bit lane, in the order the 6-bit indices are cut.
+AZ_INLINE __m128i _az_base64_encode_shuffle(void)
+{
+  return _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+}
+
+// What to add to a 6-bit index to get its character, by the range the index falls in.
+AZ_INLINE __m128i _az_base64_encode_offsets(void)
+{
+  return _mm_setr_epi8(
+      'a' - 26,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '+' - 62,
+      '/' - 63,
+      'A',
+      0,
+      0);
+}
+
+// Takes the first, second and third byte of each 32-bit lane of decoded values.
+AZ_INLINE __m128i _az_base64_decode_shuffle(void)
+{
+  return _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
 }
 
-static AZ_NODISCARD int32_t _az_base64_encode_and_pad_one(uint8_t* two_bytes)
+// Spreads 12 bytes, one group of three per 32-bit lane, into 16 indices of 6 bits and maps them to
+// the alphabet (Mula and Lemire, "Faster Base64 Encoding and Decoding using AVX2 Instructions").
+AZ_INLINE __m128i _az_base64_encode_lanes_128(__m128i input)
 {
-  int32_t i = (*two_bytes << 16) | (*(two_bytes + 1) << 8);
+  input = _mm_shuffle_epi8(input, _az_base64_encode_shuffle());
+  __m128i const t0 = _mm_and_si128(input, _mm_set1_epi32(0x0FC0FC00));
+  __m128i const t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  __m128i const t2 = _mm_and_si128(input, _mm_set1_epi32(0x003F03F0));
+  __m128i const t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  __m128i const indices = _mm_or_si128(t1, t3);
+
+  // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12: the offset to add.
+  __m128i offset_index = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  __m128i const below_26 = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  offset_index = _mm_or_si128(offset_index, _mm_and_si128(below_26, _mm_set1_epi8(13)));
+  return _mm_add_epi8(indices, _mm_shuffle_epi8(_az_base64_encode_offsets(), offset_index));
+}
 
-  int32_t i0 = _az_base64_encode_array[i >> 18];
-  int32_t i1 = _az_base64_encode_array[(i >> 12) & 0x3F];
-  int32_t i2 = _az_base64_encode_array[(i >> 6) & 0x3F];
+// Maps 16 characters to their 6-bit values. Returns the mask of the valid characters.
+AZ_INLINE int _az_base64_decode_values_128(__m128i* ref_input, _az_base64_mode mode)
+{
+  __m128i const input = *ref_input;
+  __m128i const upper = _mm_and_si128(
+      _mm_cmpgt_epi8(input, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(input, _mm_set1_epi8('Z' + 1)));
+  __m128i const lower = _mm_and_si128(
+      _mm_cmpgt_epi8(input, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(input, _mm_set1_epi8('z' + 1)));
+  __m128i const digit = _mm_and_si128(
+      _mm_cmpgt_epi8(input, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(input, _mm_set1_epi8('9' + 1)));
+  char const char_62 = mode == _az_base64_mode_url ? '-' : '+';
+  char const char_63 = mode == _az_base64_mode_url ? '_' : '/';
+  __m128i const is_62 = _mm_cmpeq_epi8(input, _mm_set1_epi8(char_62));
+  __m128i const is_63 = _mm_cmpeq_epi8(input, _mm_set1_epi8(char_63));
+
+  __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+  shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+  shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+  shift = _mm_or_si128(shift, _mm_and_si128(is_62, _mm_set1_epi8((char)(62 - char_62))));
+  shift = _mm_or_si128(shift, _mm_and_si128(is_63, _mm_set1_epi8((char)(63 - char_63))));
+  *ref_input = _mm_add_epi8(input, shift);
+
+  __m128i const valid = _mm_or_si128(
+      _mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(is_62, is_63)));
+  return _mm_movemask_epi8(valid);
+}
 
-  return i0 | (i1 << 8) | (i2 << 16) | (_az_ENCODING_PAD << 24);
+// Stores the low 12 bytes, so that nothing past the decoded data is touched.
+AZ_INLINE void _az_base64_store_12_bytes(uint8_t* destination, __m128i bytes)
+{
+  _mm_storel_epi64((__m128i*)destination, bytes);
+  uint32_t const last = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(bytes, 8));
+  memcpy(destination + 8, &last, sizeof(last));
 }
 
-static AZ_NODISCARD int32_t _az_base64_encode_and_pad_two(uint8_t* one_byte)
+// Packs four 6-bit values per 32-bit lane into three bytes and stores the 12 bytes.
+AZ_INLINE void _az_base64_store_lanes_128(uint8_t* destination, __m128i values)
 {
-  int32_t i = (*one_byte << 8);
+  __m128i const pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+  __m128i const lanes = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+  _az_base64_store_12_bytes(destination, _mm_shuffle_epi8(lanes, _az_base64_decode_shuffle()));
+}
+#endif
 
-  int32_t i0 = _az_base64_encode_array[i >> 10];
-  int32_t i1 = _az_base64_encode_array[(i >> 4) & 0x3F];
+#if defined(_az_BASE64_SIMD_AVX2)
+AZ_INLINE __m256i _az_base64_encode_lanes_256(__m256i input)
+{
+  input = _mm256_shuffle_epi8(input, _mm256_broadcastsi128_si256(_az_base64_encode_shuffle()));
+  __m256i const t0 = _mm256_and_si256(input, _mm256_set1_epi32(0x0FC0FC00));
+  __m256i const t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+  __m256i const t2 = _mm256_and_si256(input, _mm256_set1_epi32(0x003F03F0));
+  __m256i const t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+  __m256i const indices = _mm256_or_si256(t1, t3);
+
+  __m256i offset_index = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+  __m256i const below_26 = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+  offset_index = _mm256_or_si256(offset_index, _mm256_and_si256(below_26, _mm256_set1_epi8(13)));
+  __m256i const offsets = _mm256_broadcastsi128_si256(_az_base64_encode_offsets());
+  return _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, offset_index));
+}
 
-  return i0 | (i1 << 8) | (_az_ENCODING_PAD << 16) | (_az_ENCODING_PAD << 24);
+AZ_INLINE int _az_base64_decode_values_256(__m256i* ref_input, _az_base64_mode mode)
+{
+  __m256i const input = *ref_input;
+  __m256i const upper = _mm256_andnot_si256(
+      _mm256_cmpgt_epi8(input, _mm256_set1_epi8('Z')),
+      _mm256_cmpgt_epi8(input, _mm256_set1_epi8('A' - 1)));
+  __m256i const lower = _mm256_andnot_si256(
+      _mm256_cmpgt_epi8(input, _mm256_set1_epi8('z')),
+      _mm256_cmpgt_epi8(input, _mm256_set1_epi8('a' - 1)));
+  __m256i const digit = _mm256_andnot_si256(
+      _mm256_cmpgt_epi8(input, _mm256_set1_epi8('9')),
+      _mm256_cmpgt_epi8(input, _mm256_set1_epi8('0' - 1)));
+  char const char_62 = mode == _az_base64_mode_url ? '-' : '+';
+  char const char_63 = mode == _az_base64_mode_url ? '_' : '/';
+  __m256i const is_62 = _mm256_cmpeq_epi8(input, _mm256_set1_epi8(char_62));
+  __m256i const is_63 = _mm256_cmpeq_epi8(input, _mm256_set1_epi8(char_63));
+
+  __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+  shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+  shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+  shift = _mm256_or_si256(shift, _mm256_and_si256(is_62, _mm256_set1_epi8((char)(62 - char_62))));
+  shift = _mm256_or_si256(shift, _mm256_and_si256(is_63, _mm256_set1_epi8((char)(63 - char_63))));
+  *ref_input = _mm256_add_epi8(input, shift);
+
+  __m256i const valid = _mm256_or_si256(
+      _mm256_or_si256(upper, lower), _mm256_or_si256(digit, _mm256_or_si256(is_62, is_63)));
+  return _mm256_movemask_epi8(valid);
 }
+#endif
 
-static void _az_base64_write_int_as_four_bytes(uint8_t* destination, int32_t value)
+// Encodes group_count groups of three bytes into four characters each.
+static void
+_az_base64_encode_groups(uint8_t* destination, uint8_t const* source, int32_t group_count)
 {
-  *(destination + 3) = (uint8_t)((value >> 24) & 0xFF);
-  *(destination + 2) = (uint8_t)((value >> 16) & 0xFF);
-  *(destination + 1) = (uint8_t)((value >> 8) & 0xFF);
-  *(destination + 0) = (uint8_t)(value & 0xFF);
+  int32_t group = 0;
+
+#if defined(_az_BASE64_SIMD_AVX2)
+  // 24 bytes per step, loaded as two overlapping 16-byte halves: needs 28 readable bytes.
+  for (; (group_count - group) * 3 >= 28; group += 8)
+  {
+    uint8_t const* const from = source + group * 3;
+    __m256i const input = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((__m128i const*)from)),
+        _mm_loadu_si128((__m128i const*)(from + 12)),
+        1);
+    _mm256_storeu_si256(
+        (__m256i*)(destination + group * 4), _az_base64_encode_lanes_256(input));
+  }
+#endif
+
+#if defined(_az_BASE64_SIMD_SSSE3)
+  // 12 bytes per step from a 16-byte load.
+  for (; (group_count - group) * 3 >= 16; group += 4)
+  {
+    __m128i const input = _mm_loadu_si128((__m128i const*)(source + group * 3));
+    _mm_storeu_si128((__m128i*)(destination + group * 4), _az_base64_encode_lanes_128(input));
+  }
+#endif
+
+  for (; group_count - group >= 4; group += 4)
+  {
+    uint8_t const* const from = source + group * 3;
+    uint8_t* const to = destination + group * 4;
+    _az_base64_encode_group(to, from);
+    _az_base64_encode_group(to + 4, from + 3);
+    _az_base64_encode_group(to + 8, from + 6);
+    _az_base64_encode_group(to + 12, from + 9);
+  }
+
+  for (; group < group_count; group++)
+  {
+    _az_base64_encode_group(destination + group * 4, source + group * 3);
+  }
 }
 
 AZ_NODISCARD az_result
@@ -80,33 +314,18 @@ az_base64_encode(az_span destination_base64_text, az_span source_bytes, int32_t*
     return AZ_ERROR_NOT_ENOUGH_SPACE;
   }
 
-  int32_t source_index = 0;
-  int32_t result = 0;
-
-  while (source_index < source_length - 2)
-  {
-    result = _az_base64_encode(source_ptr + source_index);
-    _az_base64_write_int_as_four_bytes(destination_ptr, result);
-    destination_ptr += 4;
-    source_index += 3;
-  }
+  int32_t const group_count = source_length / 3;
+  _az_base64_encode_groups(destination_ptr, source_ptr, group_count);
 
-  if (source_index == source_length - 1)
-  {
-    result = _az_base64_encode_and_pad_two(source_ptr + source_index);
-    _az_base64_write_int_as_four_bytes(destination_ptr, result);
-    destination_ptr += 4;
-    source_index += 1;
-  }
-  else if (source_index == source_length - 2)
+  int32_t written = group_count * 4;
+  if (source_length % 3 != 0)
   {
-    result = _az_base64_encode_and_pad_one(source_ptr + source_index);
-    _az_base64_write_int_as_four_bytes(destination_ptr, result);
-    destination_ptr += 4;
-    source_index += 2;
+    _az_base64_encode_and_pad(
+        destination_ptr + written, source_ptr + group_count * 3, source_length % 3);
+    written += 4;
   }
 
-  *out_written = (int32_t)(destination_ptr - az_span_ptr(destination_base64_text));
+  *out_written = written;
   return AZ_OK;
 }
 
@@ -116,87 +335,168 @@ AZ_NODISCARD int32_t az_base64_get_max_encoded_size(int32_t source_bytes_size)
   return (((source_bytes_size + 2) / 3) * 4);
 }
 
-static int32_t _get_base64_decoded_char(int32_t c, _az_base64_mode mode)
+AZ_INLINE uint8_t const* _az_base64_decode_table(_az_base64_mode mode)
 {
-  if (mode == _az_base64_mode_url)
+  return mode == _az_base64_mode_url ? _az_base64_decode_url : _az_base64_decode_standard;
+}
+
+// Decodes four characters; any character outside of the alphabet sets _az_BASE64_INVALID_BIT in
+// ref_invalid.
+AZ_INLINE uint32_t
+_az_base64_decode_group(uint8_t const* four_chars, uint8_t const* table, uint32_t* ref_invalid)
+{
+  uint32_t const i0 = table[four_chars[0]];
+  uint32_t const i1 = table[four_chars[1]];
+  uint32_t const i2 = table[four_chars[2]];
+  uint32_t const i3 = table[four_chars[3]];
+
+  *ref_invalid |= i0 | i1 | i2 | i3;
+  return (i0 << 18) | (i1 << 12) | (i2 << 6) | i3;
+}
+
+AZ_INLINE void _az_base64_write_three_bytes(uint8_t* destination, uint32_t value)
+{
+  destination[0] = (uint8_t)(value >> 16);
+  destination[1] = (uint8_t)(value >> 8);
+  destination[2] = (uint8_t)value;
+}
+
+// Decodes group_count groups of four characters, without padding, into three bytes each.
+// Returns false if any character is not part of the alphabet.
+static AZ_NODISCARD bool _az_base64_decode_groups(
+    uint8_t* destination,
+    uint8_t const* source,
+    int32_t group_count,
+    _az_base64_mode mode)
+{
+  uint8_t const* const table = _az_base64_decode_table(mode);
+  int32_t group = 0;
+
+#if defined(_az_BASE64_SIMD_AVX2)
+  for (; group_count - group >= 8; group += 8)
   {
-    if (c == '+' || c == '/')
+    __m256i values = _mm256_loadu_si256((__m256i const*)(source + group * 4));
+    if (_az_base64_decode_values_256(&values, mode) != -1)
     {
-      return -1; // can't use + or / with URL encoding
+      return false;
     }
+    __m256i const pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    __m256i const lanes = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    __m256i const bytes
+        = _mm256_shuffle_epi8(lanes, _mm256_broadcastsi128_si256(_az_base64_decode_shuffle()));
+    uint8_t* const to = destination + group * 3;
+    _az_base64_store_12_bytes(to, _mm256_castsi256_si128(bytes));
+    _az_base64_store_12_bytes(to + 12, _mm256_extracti128_si256(bytes, 1));
+  }
+#endif
 
-    if (c == '-')
-    {
-      c = '+'; // - becomes a +
-    }
-    else if (c == '_')
+#if defined(_az_BASE64_SIMD_SSSE3)
+  for (; group_count - group >= 4; group += 4)
+  {
+    __m128i values = _mm_loadu_si128((__m128i const*)(source + group * 4));
+    if (_az_base64_decode_values_128(&values, mode) != 0xFFFF)
     {
-      c = '/'; // _ becomes a /
+      return false;
     }
+    _az_base64_store_lanes_128(destination + group * 3, values);
   }
+#endif
 
-  if (c >= 'A' && c <= 'Z')
+  for (; group_count - group >= 4; group += 4)
   {
-    return (c - 'A');
-  }
+    uint8_t const* const from = source + group * 4;
+    uint32_t invalid = 0;
+    uint32_t const v0 = _az_base64_decode_group(from, table, &invalid);
+    uint32_t const v1 = _az_base64_decode_group(from + 4, table, &invalid);
+    uint32_t const v2 = _az_base64_decode_group(from + 8, table, &invalid);
+    uint32_t const v3 = _az_base64_decode_group(from + 12, table, &invalid);
+    if ((invalid & _az_BASE64_INVALID_BIT) != 0)
+    {
+      return false;
+    }
 
-  if (c >= 'a' && c <= 'z')
-  {
-    return 26 + (c - 'a');
+    uint8_t* const to = destination + group * 3;
+    _az_base64_write_three_bytes(to, v0);
+    _az_base64_write_three_bytes(to + 3, v1);
+    _az_base64_write_three_bytes(to + 6, v2);
+    _az_base64_write_three_bytes(to + 9, v3);
   }
 
-  if (c >= '0' && c <= '9')
+  for (; group < group_count; group++)
   {
-    return 52 + (c - '0');
+    uint32_t invalid = 0;
+    uint32_t const value = _az_base64_decode_group(source + group * 4, table, &invalid);
+    if ((invalid & _az_BASE64_INVALID_BIT) != 0)
+    {
+      return false;
+    }
+    _az_base64_write_three_bytes(destination + group * 3, value);
   }
 
-  if (c == '+')
-  {
-    return 62;
-  }
+  return true;
+}
 
-  if (c == '/')
+// Checks that complete groups without padding only contain characters of the alphabet.
+static AZ_NODISCARD bool
+_az_base64_groups_valid(uint8_t const* source, int32_t group_count, _az_base64_mode mode)
+{
+  uint8_t const* const table = _az_base64_decode_table(mode);
+  uint32_t invalid = 0;
+  for (int32_t i = 0; i < group_count * 4; i++)
   {
-    return 63;
+    invalid |= table[source[i]];
   }
+  return (invalid & _az_BASE64_INVALID_BIT) == 0;
+}
 
-  return -1;
+// Number of bytes in the last group of four characters c0 c1 c2 c3, which may end with padding.
+AZ_INLINE int32_t _az_base64_last_group_size(uint8_t c2, uint8_t c3)
+{
+  return c3 != _az_ENCODING_PAD ? 3 : (c2 != _az_ENCODING_PAD ? 2 : 1);
 }
 
-static AZ_NODISCARD int32_t
-_az_base64_decode_four_bytes(uint8_t* encoded_bytes, _az_base64_mode mode)
+// Decodes the last group of two to four characters. It may end with one or two padding characters;
+// missing characters count as padding, as in base 64 url text.
+static AZ_NODISCARD az_result _az_base64_decode_last_group(
+    uint8_t* destination,
+    int32_t destination_size,
+    uint8_t const* source,
+    int32_t source_size,
+    _az_base64_mode mode,
+    int32_t* out_written)
 {
-  int32_t i0 = *encoded_bytes;
-  int32_t i1 = *(encoded_bytes + 1);
-  int32_t i2 = *(encoded_bytes + 2);
-  int32_t i3 = *(encoded_bytes + 3);
+  uint8_t const* const table = _az_base64_decode_table(mode);
+  uint8_t const c2 = source_size > 2 ? source[2] : (uint8_t)_az_ENCODING_PAD;
+  uint8_t const c3 = source_size > 3 ? source[3] : (uint8_t)_az_ENCODING_PAD;
+  int32_t const size = _az_base64_last_group_size(c2, c3);
 
-  i0 = _get_base64_decoded_char(i0, mode);
-  i1 = _get_base64_decoded_char(i1, mode);
-  i2 = _get_base64_decoded_char(i2, mode);
-  i3 = _get_base64_decoded_char(i3, mode);
+  uint32_t const i0 = table[source[0]];
+  uint32_t const i1 = table[source[1]];
+  uint32_t const i2 = size > 1 ? table[c2] : 0;
+  uint32_t const i3 = size > 2 ? table[c3] : 0;
 
-  if (i0 == -1 || i1 == -1 || i2 == -1 || i3 == -1)
+  if (((i0 | i1 | i2 | i3) & _az_BASE64_INVALID_BIT) != 0)
   {
-    return -1;
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+  if (destination_size < size)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
   }
 
-  i0 <<= 18;
-  i1 <<= 12;
-  i2 <<= 6;
-
-  i0 |= i3;
-  i1 |= i2;
-
-  i0 |= i1;
-  return i0;
-}
+  uint32_t const value = (i0 << 18) | (i1 << 12) | (i2 << 6) | i3;
+  destination[0] = (uint8_t)(value >> 16);
+  if (size > 1)
+  {
+    destination[1] = (uint8_t)(value >> 8);
+  }
+  if (size > 2)
+  {
+    destination[2] = (uint8_t)value;
+  }
 
-static void _az_base64_write_three_low_order_bytes(uint8_t* destination, int32_t value)
-{
-  *destination = (uint8_t)(value >> 16);
-  *(destination + 1) = (uint8_t)(value >> 8);
-  *(destination + 2) = (uint8_t)(value);
+  *out_written = size;
+  return AZ_OK;
 }
 
 static az_result _az_base64_decode(
@@ -216,97 +516,43 @@ static az_result _az_base64_decode(
     return AZ_ERROR_NOT_ENOUGH_SPACE;
   }
 
-  int32_t source_index = 0;
-  int32_t destination_index = 0;
-
-  while (source_index < source_length - 4)
-  {
-    int32_t result = _az_base64_decode_four_bytes(source_ptr + source_index, mode);
-    if (result < 0)
-    {
-      return AZ_ERROR_UNEXPECTED_CHAR;
-    }
-    _az_base64_write_three_low_order_bytes(destination_ptr, result);
-    destination_ptr += 3;
-    destination_index += 3;
-    source_index += 4;
-  }
-
-  // If using standard base64 decoding, there is a precondition guaranteeing size is divisible by 4.
-  // Otherwise with url encoding, we can assume padding characters.
-  // If length is divisible by four, do nothing. Else, we assume up to two padding characters.
-  int32_t source_length_mod_four = source_length % 4;
-  int32_t i0 = *(source_ptr + source_index);
-  int32_t i1 = *(source_ptr + source_index + 1);
-  int32_t i2 = source_length_mod_four == 2 ? _az_ENCODING_PAD : *(source_ptr + source_index + 2);
-  int32_t i3 = source_length_mod_four == 2 || source_length_mod_four == 3
-      ? _az_ENCODING_PAD
-      : *(source_ptr + source_index + 3);
-
-  i0 = _get_base64_decoded_char(i0, mode);
-  i1 = _get_base64_decoded_char(i1, mode);
-
-  i0 <<= 18;
-  i1 <<= 12;
-
-  i0 |= i1;
-
-  if (i3 != _az_ENCODING_PAD)
-  {
-    i2 = _get_base64_decoded_char(i2, mode);
-    i3 = _get_base64_decoded_char(i3, mode);
-
-    i2 <<= 6;
-
-    i0 |= i3;
-    i0 |= i2;
-
-    if (i0 < 0)
-    {
-      return AZ_ERROR_UNEXPECTED_CHAR;
-    }
-    if (destination_index > destination_length - 3)
-    {
-      return AZ_ERROR_NOT_ENOUGH_SPACE;
-    }
-    _az_base64_write_three_low_order_bytes(destination_ptr, i0);
-    destination_ptr += 3;
-  }
-  else if (i2 != _az_ENCODING_PAD)
+  // All groups but the last one are complete and have no padding. Base 64 url text without padding
+  // can have one more of them than the size check above accounts for.
+  int32_t const group_count = (source_length - 1) / 4;
+  if (destination_length < group_count * 3)
   {
-    i2 = _get_base64_decoded_char(i2, mode);
-
-    i2 <<= 6;
-
-    i0 |= i2;
-
-    if (i0 < 0)
+    // Invalid input is still reported as such, before the destination size. With no room left, the
+    // last group is only validated.
+    if (!_az_base64_groups_valid(source_ptr, group_count, mode))
     {
       return AZ_ERROR_UNEXPECTED_CHAR;
     }
-    if (destination_index > destination_length - 2)
-    {
-      return AZ_ERROR_NOT_ENOUGH_SPACE;
-    }
-    *(destination_ptr + 1) = (uint8_t)(i0 >> 8);
-    *destination_ptr = (uint8_t)(i0 >> 16);
-    destination_ptr += 2;
+    int32_t last_group_written = 0;
+    return _az_base64_decode_last_group(
+        destination_ptr,
+        0,
+        source_ptr + group_count * 4,
+        source_length - group_count * 4,
+        mode,
+        &last_group_written);
   }
-  else
+  if (!_az_base64_decode_groups(destination_ptr, source_ptr, group_count, mode))
   {
-    if (i0 < 0)
-    {
-      return AZ_ERROR_UNEXPECTED_CHAR;
-    }
-    if (destination_index > destination_length - 1)
-    {
-      return AZ_ERROR_NOT_ENOUGH_SPACE;
-    }
-    *destination_ptr = (uint8_t)(i0 >> 16);
-    destination_ptr += 1;
+    return AZ_ERROR_UNEXPECTED_CHAR;
   }
 
-  *out_written = (int32_t)(destination_ptr - az_span_ptr(destination_bytes));
+  // If using standard base64 decoding, there is a precondition guaranteeing size is divisible by 4.
+  // Otherwise with url encoding, we can assume padding characters.
+  int32_t last_group_written = 0;
+  _az_RETURN_IF_FAILED(_az_base64_decode_last_group(
+      destination_ptr + group_count * 3,
+      destination_length - group_count * 3,
+      source_ptr + group_count * 4,
+      source_length - group_count * 4,
+      mode,
+      &last_group_written));
+
+  *out_written = group_count * 3 + last_group_written;
   return AZ_OK;
 }
 
@@ -362,3 +608,243 @@ AZ_NODISCARD int32_t az_base64_url_get_max_decoded_size(int32_t source_base64_ur
   _az_PRECONDITION(source_base64_url_text_size >= 0);
   return (source_base64_url_text_size / 4) * 3;
 }
+
+void az_base64_encoder_init(az_base64_encoder* out_encoder)
+{
+  _az_PRECONDITION_NOT_NULL(out_encoder);
+  *out_encoder = (az_base64_encoder){ 0 };
+}
+
+AZ_NODISCARD az_result az_base64_encoder_update(
+    az_base64_encoder* ref_encoder,
+    az_span destination_base64_text,
+    az_span source_bytes,
+    int32_t* out_written)
+{
+  _az_PRECONDITION_NOT_NULL(ref_encoder);
+  _az_PRECONDITION_VALID_SPAN(destination_base64_text, 0, true);
+  _az_PRECONDITION_VALID_SPAN(source_bytes, 0, true);
+  _az_PRECONDITION_RANGE(0, az_span_size(source_bytes), _az_MAX_SAFE_ENCODED_LENGTH);
+  _az_PRECONDITION_NOT_NULL(out_written);
+
+  int32_t const source_length = az_span_size(source_bytes);
+  uint8_t const* const source_ptr = az_span_ptr(source_bytes);
+  uint8_t* const destination_ptr = az_span_ptr(destination_base64_text);
+  int32_t const pending_size = ref_encoder->_internal.pending_size;
+
+  int32_t group_count = (pending_size + source_length) / 3;
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(destination_base64_text, group_count * 4);
+
+  int32_t written = 0;
+  int32_t source_index = 0;
+  if (pending_size > 0 && group_count > 0)
+  {
+    uint8_t group[3];
+    memcpy(group, ref_encoder->_internal.pending, (size_t)pending_size);
+    source_index = 3 - pending_size;
+    memcpy(group + pending_size, source_ptr, (size_t)source_index);
+    _az_base64_encode_group(destination_ptr, group);
+    ref_encoder->_internal.pending_size = 0;
+    written = 4;
+    group_count--;
+  }
+
+  _az_base64_encode_groups(destination_ptr + written, source_ptr + source_index, group_count);
+  written += group_count * 4;
+  source_index += group_count * 3;
+
+  int32_t const remaining = source_length - source_index;
+  if (remaining > 0)
+  {
+    memcpy(
+        ref_encoder->_internal.pending + ref_encoder->_internal.pending_size,
+        source_ptr + source_index,
+        (size_t)remaining);
+    ref_encoder->_internal.pending_size += remaining;
+  }
+
+  *out_written = written;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_base64_encoder_final(
+    az_base64_encoder* ref_encoder,
+    az_span destination_base64_text,
+    int32_t* out_written)
+{
+  _az_PRECONDITION_NOT_NULL(ref_encoder);
+  _az_PRECONDITION_VALID_SPAN(destination_base64_text, 0, true);
+  _az_PRECONDITION_NOT_NULL(out_written);
+
+  int32_t const pending_size = ref_encoder->_internal.pending_size;
+  if (pending_size > 0)
+  {
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(destination_base64_text, 4);
+    _az_base64_encode_and_pad(
+        az_span_ptr(destination_base64_text), ref_encoder->_internal.pending, pending_size);
+  }
+
+  *out_written = pending_size > 0 ? 4 : 0;
+  *ref_encoder = (az_base64_encoder){ 0 };
+  return AZ_OK;
+}
+
+void az_base64_decoder_init(az_base64_decoder* out_decoder)
+{
+  _az_PRECONDITION_NOT_NULL(out_decoder);
+  *out_decoder = (az_base64_decoder){ 0 };
+}
+
+void az_base64_url_decoder_init(az_base64_decoder* out_decoder)
+{
+  _az_PRECONDITION_NOT_NULL(out_decoder);
+  *out_decoder = (az_base64_decoder){ ._internal = { .url = true } };
+}
+
+AZ_NODISCARD az_result az_base64_decoder_update(
+    az_base64_decoder* ref_decoder,
+    az_span destination_bytes,
+    az_span source_base64_text,
+    int32_t* out_written)
+{
+  _az_PRECONDITION_NOT_NULL(ref_decoder);
+  _az_PRECONDITION_VALID_SPAN(destination_bytes, 0, true);
+  _az_PRECONDITION_VALID_SPAN(source_base64_text, 0, true);
+  _az_PRECONDITION_NOT_NULL(out_written);
+
+  int32_t const source_length = az_span_size(source_base64_text);
+  uint8_t const* const source_ptr = az_span_ptr(source_base64_text);
+  int32_t const destination_length = az_span_size(destination_bytes);
+  uint8_t* const destination_ptr = az_span_ptr(destination_bytes);
+  int32_t const pending_size = ref_decoder->_internal.pending_size;
+  _az_base64_mode const mode
+      = ref_decoder->_internal.url ? _az_base64_mode_url : _az_base64_mode_standard;
+
+  if (source_length == 0)
+  {
+    *out_written = 0;
+    return AZ_OK;
+  }
+
+  // Padding ends the text.
+  if (ref_decoder->_internal.finished)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  int32_t const total_length = pending_size + source_length;
+  int32_t const group_count = total_length / 4;
+  if (group_count == 0)
+  {
+    memcpy(ref_decoder->_internal.pending + pending_size, source_ptr, (size_t)source_length);
+    ref_decoder->_internal.pending_size = total_length;
+    ref_decoder->_internal.has_input = true;
+    *out_written = 0;
+    return AZ_OK;
+  }
+
+  // The last complete group is the only one that can be padded; it decides the size needed.
+  uint8_t last_group[4];
+  for (int32_t i = 0; i < 4; i++)
+  {
+    int32_t const index = (group_count - 1) * 4 + i;
+    last_group[i] = index < pending_size ? ref_decoder->_internal.pending[index]
+                                         : source_ptr[index - pending_size];
+  }
+
+  int32_t const remaining = total_length % 4;
+  if (remaining > 0 && last_group[3] == _az_ENCODING_PAD)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+  if (destination_length
+      < (group_count - 1) * 3 + _az_base64_last_group_size(last_group[2], last_group[3]))
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  int32_t written = 0;
+  int32_t source_index = 0;
+  int32_t strict_group_count = group_count - 1;
+  if (pending_size > 0 && strict_group_count > 0)
+  {
+    uint8_t first_group[4];
+    memcpy(first_group, ref_decoder->_internal.pending, (size_t)pending_size);
+    source_index = 4 - pending_size;
+    memcpy(first_group + pending_size, source_ptr, (size_t)source_index);
+    if (!_az_base64_decode_groups(destination_ptr, first_group, 1, mode))
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+    written = 3;
+    strict_group_count--;
+  }
+
+  if (!_az_base64_decode_groups(
+          destination_ptr + written, source_ptr + source_index, strict_group_count, mode))
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+  written += strict_group_count * 3;
+
+  int32_t last_group_written = 0;
+  _az_RETURN_IF_FAILED(_az_base64_decode_last_group(
+      destination_ptr + written,
+      destination_length - written,
+      last_group,
+      4,
+      mode,
+      &last_group_written));
+  written += last_group_written;
+
+  // Every pending character went into the first group, so the characters left over are at the end
+  // of the source.
+  if (remaining > 0)
+  {
+    memcpy(
+        ref_decoder->_internal.pending,
+        source_ptr + source_length - remaining,
+        (size_t)remaining);
+  }
+  ref_decoder->_internal.pending_size = remaining;
+  ref_decoder->_internal.finished = last_group[3] == _az_ENCODING_PAD;
+  ref_decoder->_internal.has_input = true;
+
+  *out_written = written;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_base64_decoder_final(
+    az_base64_decoder* ref_decoder,
+    az_span destination_bytes,
+    int32_t* out_written)
+{
+  _az_PRECONDITION_NOT_NULL(ref_decoder);
+  _az_PRECONDITION_VALID_SPAN(destination_bytes, 0, true);
+  _az_PRECONDITION_NOT_NULL(out_written);
+
+  int32_t const pending_size = ref_decoder->_internal.pending_size;
+  if (!ref_decoder->_internal.has_input)
+  {
+    return AZ_ERROR_UNEXPECTED_END;
+  }
+  if (pending_size == 0)
+  {
+    *out_written = 0;
+    return AZ_OK;
+  }
+
+  // Only base 64 url text can leave out the padding, and at most two characters of it.
+  if (!ref_decoder->_internal.url || pending_size == 1)
+  {
+    return AZ_ERROR_UNEXPECTED_END;
+  }
+
+  return _az_base64_decode_last_group(
+      az_span_ptr(destination_bytes),
+      az_span_size(destination_bytes),
+      ref_decoder->_internal.pending,
+      pending_size,
+      _az_base64_mode_url,
+      out_written);
+}
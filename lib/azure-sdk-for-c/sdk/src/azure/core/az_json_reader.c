@@ -8,6 +8,18 @@
 #include <azure/core/internal/az_span_internal.h>
 
 #include <ctype.h>
+#include <stddef.h>
+#include <string.h>
+
+// Strings and whitespace are scanned a machine word at a time (SWAR). On targets with SSE2 or
+// AArch64 NEON, 16-byte vectors are used first. Define AZ_NO_JSON_SIMD to use only the word path.
+#if !defined(AZ_NO_JSON_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define _az_JSON_SIMD_SSE2
+#elif !defined(AZ_NO_JSON_SIMD) && defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define _az_JSON_SIMD_NEON
+#endif
 
 #include <azure/core/_az_cfg.h>
 
@@ -174,6 +186,181 @@ AZ_NODISCARD static az_result _az_json_reader_get_next_buffer(
   return AZ_OK;
 }
 
+// A machine word, used to test sizeof(size_t) bytes at once.
+typedef size_t _az_json_word;
+
+// 0x0101...01 and 0x8080...80 for the width of _az_json_word.
+#define _az_JSON_WORD_ONES ((_az_json_word)-1 / 0xFF)
+#define _az_JSON_WORD_HIGHS (_az_JSON_WORD_ONES * 0x80)
+
+AZ_NODISCARD AZ_INLINE _az_json_word _az_json_load_word(uint8_t const* ptr)
+{
+  _az_json_word word;
+  memcpy(&word, ptr, sizeof(word)); // Unaligned load, which compilers turn into a single move.
+  return word;
+}
+
+// Non-zero if any byte of the word is less than n (n <= 0x80). Bytes above the first match may be
+// reported too, so this only answers whether the whole word is free of such bytes.
+AZ_NODISCARD AZ_INLINE _az_json_word _az_json_word_has_less(_az_json_word word, uint8_t n)
+{
+  return (word - _az_JSON_WORD_ONES * n) & ~word & _az_JSON_WORD_HIGHS;
+}
+
+// The high bit of exactly those bytes of the word that equal c.
+AZ_NODISCARD AZ_INLINE _az_json_word _az_json_word_equal_bytes(_az_json_word word, uint8_t c)
+{
+  _az_json_word const low_bits = ~_az_JSON_WORD_HIGHS;
+  _az_json_word const x = word ^ (_az_JSON_WORD_ONES * c);
+  return ~(((x & low_bits) + low_bits) | x) & _az_JSON_WORD_HIGHS;
+}
+
+AZ_NODISCARD AZ_INLINE bool _az_json_is_plain_string_byte(uint8_t c)
+{
+  return c != '"' && c != '\\' && c >= _az_ASCII_SPACE_CHARACTER;
+}
+
+AZ_NODISCARD AZ_INLINE bool _az_json_is_whitespace(uint8_t c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+#if defined(_az_JSON_SIMD_SSE2) && defined(__GNUC__)
+#define _az_JSON_LOWEST_SET_BIT(mask) __builtin_ctz(mask)
+#endif
+
+// Returns the number of leading bytes that can be copied verbatim within a JSON string, that is
+// bytes that are neither '"', '\\' nor control characters.
+AZ_NODISCARD static int32_t _az_json_string_plain_prefix(uint8_t const* ptr, int32_t size)
+{
+  int32_t i = 0;
+
+#if defined(_az_JSON_SIMD_SSE2)
+  __m128i const quote = _mm_set1_epi8('"');
+  __m128i const backslash = _mm_set1_epi8('\\');
+  __m128i const last_control = _mm_set1_epi8(_az_ASCII_SPACE_CHARACTER - 1);
+  for (; i + 16 <= size; i += 16)
+  {
+    __m128i const bytes = _mm_loadu_si128((__m128i const*)(void const*)(ptr + i));
+    // min(b, 0x1F) == b exactly for the control characters.
+    __m128i const special = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, backslash)),
+        _mm_cmpeq_epi8(_mm_min_epu8(bytes, last_control), bytes));
+    int const mask = _mm_movemask_epi8(special);
+    if (mask != 0)
+    {
+#if defined(_az_JSON_LOWEST_SET_BIT)
+      return i + _az_JSON_LOWEST_SET_BIT((unsigned int)mask);
+#else
+      break;
+#endif
+    }
+  }
+#elif defined(_az_JSON_SIMD_NEON)
+  uint8x16_t const quote = vdupq_n_u8('"');
+  uint8x16_t const backslash = vdupq_n_u8('\\');
+  uint8x16_t const space = vdupq_n_u8(_az_ASCII_SPACE_CHARACTER);
+  for (; i + 16 <= size; i += 16)
+  {
+    uint8x16_t const bytes = vld1q_u8(ptr + i);
+    uint8x16_t const special = vorrq_u8(
+        vorrq_u8(vceqq_u8(bytes, quote), vceqq_u8(bytes, backslash)), vcltq_u8(bytes, space));
+    if (vmaxvq_u8(special) != 0)
+    {
+      break;
+    }
+  }
+#endif
+
+  for (; i + (int32_t)sizeof(_az_json_word) <= size; i += (int32_t)sizeof(_az_json_word))
+  {
+    _az_json_word const word = _az_json_load_word(ptr + i);
+    if ((_az_json_word_equal_bytes(word, '"') | _az_json_word_equal_bytes(word, '\\')
+         | _az_json_word_has_less(word, _az_ASCII_SPACE_CHARACTER))
+        != 0)
+    {
+      break;
+    }
+  }
+
+  while (i < size && _az_json_is_plain_string_byte(ptr[i]))
+  {
+    i++;
+  }
+  return i;
+}
+
+// Returns the number of leading JSON whitespace bytes (space, tab, line feed, carriage return).
+AZ_NODISCARD static int32_t _az_json_whitespace_prefix(uint8_t const* ptr, int32_t size)
+{
+  // Tokens are mostly separated by no or a single whitespace byte; handle that without any setup.
+  int32_t i = 0;
+  while (i < size && i < 2 && _az_json_is_whitespace(ptr[i]))
+  {
+    i++;
+  }
+  if (i < 2)
+  {
+    return i;
+  }
+
+#if defined(_az_JSON_SIMD_SSE2)
+  __m128i const space = _mm_set1_epi8(' ');
+  __m128i const tab = _mm_set1_epi8('\t');
+  __m128i const line_feed = _mm_set1_epi8('\n');
+  __m128i const carriage_return = _mm_set1_epi8('\r');
+  for (; i + 16 <= size; i += 16)
+  {
+    __m128i const bytes = _mm_loadu_si128((__m128i const*)(void const*)(ptr + i));
+    __m128i const whitespace = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(bytes, space), _mm_cmpeq_epi8(bytes, tab)),
+        _mm_or_si128(_mm_cmpeq_epi8(bytes, line_feed), _mm_cmpeq_epi8(bytes, carriage_return)));
+    int const mask = _mm_movemask_epi8(whitespace);
+    if (mask != 0xFFFF)
+    {
+#if defined(_az_JSON_LOWEST_SET_BIT)
+      return i + _az_JSON_LOWEST_SET_BIT(~(unsigned int)mask);
+#else
+      break;
+#endif
+    }
+  }
+#elif defined(_az_JSON_SIMD_NEON)
+  uint8x16_t const space = vdupq_n_u8(' ');
+  uint8x16_t const tab = vdupq_n_u8('\t');
+  uint8x16_t const line_feed = vdupq_n_u8('\n');
+  uint8x16_t const carriage_return = vdupq_n_u8('\r');
+  for (; i + 16 <= size; i += 16)
+  {
+    uint8x16_t const bytes = vld1q_u8(ptr + i);
+    uint8x16_t const whitespace = vorrq_u8(
+        vorrq_u8(vceqq_u8(bytes, space), vceqq_u8(bytes, tab)),
+        vorrq_u8(vceqq_u8(bytes, line_feed), vceqq_u8(bytes, carriage_return)));
+    if (vminvq_u8(whitespace) != 0xFF)
+    {
+      break;
+    }
+  }
+#endif
+
+  for (; i + (int32_t)sizeof(_az_json_word) <= size; i += (int32_t)sizeof(_az_json_word))
+  {
+    _az_json_word const word = _az_json_load_word(ptr + i);
+    if ((_az_json_word_equal_bytes(word, ' ') | _az_json_word_equal_bytes(word, '\t')
+         | _az_json_word_equal_bytes(word, '\n') | _az_json_word_equal_bytes(word, '\r'))
+        != _az_JSON_WORD_HIGHS)
+    {
+      break;
+    }
+  }
+
+  while (i < size && _az_json_is_whitespace(ptr[i]))
+  {
+    i++;
+  }
+  return i;
+}
+
 AZ_NODISCARD static az_span _az_json_reader_skip_whitespace(az_json_reader* ref_json_reader)
 {
   az_span json;
@@ -181,7 +368,8 @@ AZ_NODISCARD static az_span _az_json_reader_skip_whitespace(az_json_reader* ref_
 
   while (true)
   {
-    json = _az_span_trim_whitespace_from_start(remaining);
+    json = az_span_slice_to_end(
+        remaining, _az_json_whitespace_prefix(az_span_ptr(remaining), az_span_size(remaining)));
 
     // Find out how many whitespace characters were trimmed.
     int32_t consumed = _az_span_diff(json, remaining);
@@ -325,6 +513,13 @@ AZ_NODISCARD static az_result _az_json_reader_process_string(az_json_reader* ref
       {
         return AZ_ERROR_UNEXPECTED_CHAR;
       }
+
+      // Skip the run of ordinary bytes that follows within this segment in one step. The code
+      // below then moves past the last of them as if they had been read one at a time.
+      int32_t const plain_bytes = _az_json_string_plain_prefix(
+          token_ptr + current_index + 1, remaining_size - current_index - 1);
+      current_index += plain_bytes;
+      string_length += plain_bytes;
     }
 
     current_index++;
@@ -929,6 +929,45 @@ AZ_NODISCARD az_result az_json_writer_append_double(
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result
+az_json_writer_append_double_shortest(az_json_writer* ref_json_writer, double value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION(_az_is_appending_value_valid(ref_json_writer));
+  // Non-finite numbers are not supported because they lead to invalid JSON.
+  // Unquoted strings such as nan and -inf are invalid as JSON numbers.
+  _az_PRECONDITION(_az_isfinite(value));
+
+  // Need enough space to write any double number.
+  int32_t required_size = _az_MAX_SIZE_FOR_WRITING_SHORTEST_DOUBLE;
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    required_size++; // For the leading comma separator.
+  }
+
+  az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    remaining_json = az_span_copy_u8(remaining_json, ',');
+  }
+
+  // Since we asked for the maximum needed space above, this is guaranteed not to fail due to
+  // AZ_ERROR_NOT_ENOUGH_SPACE. Still checking the returned az_result, for other potential failure
+  // cases.
+  az_span leftover;
+  _az_RETURN_IF_FAILED(az_span_dtoa_shortest(remaining_json, value, &leftover));
+
+  // We already accounted for the maximum size needed in required_size, so subtract that to get the
+  // actual bytes written.
+  int32_t written = required_size + _az_span_diff(leftover, remaining_json)
+      - _az_MAX_SIZE_FOR_WRITING_SHORTEST_DOUBLE;
+  _az_update_json_writer_state(ref_json_writer, written, written, true, AZ_JSON_TOKEN_NUMBER);
+  return AZ_OK;
+}
+
 static AZ_NODISCARD az_result _az_json_writer_append_container_start(
     az_json_writer* ref_json_writer,
     uint8_t byte,
@@ -10,10 +10,11 @@
 #include <azure/core/internal/az_span_internal.h>
 
 #include <ctype.h>
+#include <float.h>
 #include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
+#include <string.h>
 
 #include <azure/core/_az_cfg.h>
 
@@ -354,13 +355,16 @@ static bool _is_valid_start_of_double(uint8_t first_byte)
   return result;
 }
 
-// Disable the following warning just for this particular use case.
-// C4996: 'sscanf': This function or variable may be unsafe. Consider using sscanf_s instead.
-// C4710: 'sscanf': function not inlined
-#ifdef _MSC_VER
-#pragma warning(push)
-#pragma warning(disable : 4996)
-#pragma warning(disable : 4710)
+// FLT_EVAL_METHOD 0, or 16 where only _Float16 is widened, evaluates doubles in double precision.
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0 || FLT_EVAL_METHOD == 16
+#define _az_DOUBLE_EVAL_IS_EXACT
+#endif
+
+#ifdef _az_DOUBLE_EVAL_IS_EXACT
+// Powers of ten that are exact as doubles, for the fast path of az_span_atod().
+static double const _az_exact_powers_of_ten[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                  1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                                  1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
 #endif
 
 AZ_NODISCARD az_result az_span_atod(az_span source, double* out_number)
@@ -372,56 +376,291 @@ AZ_NODISCARD az_result az_span_atod(az_span source, double* out_number)
 
   _az_PRECONDITION_RANGE(1, size, _az_MAX_SIZE_FOR_PARSING_DOUBLE);
 
-  // This check is necessary to prevent sscanf from reading bytes past the end of the span, when the
-  // span might contain whitespace or other invalid bytes at the start.
   uint8_t* source_ptr = az_span_ptr(source);
   if (size < 1 || !_is_valid_start_of_double(source_ptr[0]))
   {
     return AZ_ERROR_UNEXPECTED_CHAR;
   }
 
-  // Stack based string to allow thread-safe mutation.
-  // The length is 8 to allow space for the null-terminating character.
-  // NOLINTNEXTLINE(readability-magic-numbers,  cppcoreguidelines-avoid-magic-numbers)
-  char format[8] = "%00lf%n";
+  // Accepts [+-]digits[.digits][(e|E)[+-]digits], where either the integer or the fractional
+  // digits may be missing, but not both. The first 19 significant digits are collected into
+  // mantissa, so that the value is mantissa * 10^exponent, plus something smaller than one unit of
+  // the mantissa if truncated is set.
+  int32_t i = 0;
+  bool const negative = source_ptr[0] == '-';
+  if (source_ptr[0] == '+' || source_ptr[0] == '-')
+  {
+    i++;
+  }
 
-  // Starting at 1 to skip the '%' character
-  format[1] = (char)((size / _az_NUMBER_OF_DECIMAL_VALUES) + '0');
-  format[2] = (char)((size % _az_NUMBER_OF_DECIMAL_VALUES) + '0');
+  uint64_t mantissa = 0;
+  int32_t mantissa_digits = 0;
+  int32_t exponent = 0;
+  bool truncated = false;
+  bool has_digits = false;
+  bool in_fraction = false;
 
-  int32_t chars_consumed = 0;
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
-  int32_t n = sscanf((char*)source_ptr, format, out_number, &chars_consumed);
+  for (; i < size; i++)
+  {
+    uint8_t const next_byte = source_ptr[i];
+    if (next_byte == '.' && !in_fraction)
+    {
+      in_fraction = true;
+      continue;
+    }
+    if (!isdigit(next_byte))
+    {
+      break;
+    }
 
-  // Success if the entire source was consumed by sscanf and it set the out_number argument.
-  return (size == chars_consumed && n == 1 && _az_isfinite(*out_number)) ? AZ_OK
-                                                                         : AZ_ERROR_UNEXPECTED_CHAR;
-}
+    has_digits = true;
+    if (mantissa_digits < _az_MAX_SIZE_FOR_UINT64 - 1)
+    {
+      // Leading zeros don't count towards the significant digits.
+      mantissa = mantissa * _az_NUMBER_OF_DECIMAL_VALUES + (uint64_t)(next_byte - '0');
+      mantissa_digits += mantissa == 0 ? 0 : 1;
+      exponent -= in_fraction ? 1 : 0;
+    }
+    else
+    {
+      truncated = truncated || next_byte != '0';
+      exponent += in_fraction ? 0 : 1;
+    }
+  }
 
-#ifdef _MSC_VER
-#pragma warning(pop)
+  if (!has_digits)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  if (i < size && (source_ptr[i] == 'e' || source_ptr[i] == 'E'))
+  {
+    i++;
+    bool const negative_exponent = i < size && source_ptr[i] == '-';
+    if (i < size && (source_ptr[i] == '+' || source_ptr[i] == '-'))
+    {
+      i++;
+    }
+    if (i >= size)
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+
+    int32_t exponent_value = 0;
+    for (; i < size && isdigit(source_ptr[i]); i++)
+    {
+      // Anything beyond this is out of range either way; stop before it can overflow.
+      if (exponent_value < 100000)
+      {
+        exponent_value = exponent_value * _az_NUMBER_OF_DECIMAL_VALUES + (source_ptr[i] - '0');
+      }
+    }
+    exponent += negative_exponent ? -exponent_value : exponent_value;
+  }
+
+  if (i != size)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  uint64_t bits = 0;
+  double value = 0;
+
+  if (mantissa == 0 || exponent < _az_POWER_OF_TEN_MIN_EXPONENT)
+  {
+    value = 0;
+  }
+  else if (exponent > DBL_MAX_10_EXP)
+  {
+    // Any non-zero mantissa times 10^309 or more overflows.
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+#ifdef _az_DOUBLE_EVAL_IS_EXACT
+  // Both the mantissa and the power of ten are exact doubles, so a single correctly rounded
+  // multiplication or division gives the correctly rounded result.
+  else if (
+      !truncated && mantissa <= _az_MAX_SAFE_INTEGER + 1 && exponent >= -22 && exponent <= 22)
+  {
+    value = (double)mantissa;
+    value = exponent < 0 ? value / _az_exact_powers_of_ten[-exponent]
+                         : value * _az_exact_powers_of_ten[exponent];
+  }
 #endif
+  else
+  {
+    // With truncated digits, the result is only known if both bounds round to the same double.
+    uint64_t upper_bits = 0;
+    if (_az_eisel_lemire(mantissa, exponent, &bits)
+        && (!truncated
+            || (_az_eisel_lemire(mantissa + 1, exponent, &upper_bits) && upper_bits == bits)))
+    {
+      memcpy(&value, &bits, sizeof(value));
+    }
+    else if (_az_span_atod_exact(source, &bits))
+    {
+      memcpy(&value, &bits, sizeof(value));
+    }
+    else
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+  }
+
+  *out_number = negative ? -value : value;
+  return AZ_OK;
+}
+
+// Candidates found with memchr() are compared byte by byte until this many more comparisons than
+// source positions have been made; the rest of the source is then searched with the two-way
+// algorithm, which is linear in the worst case.
+#define _az_SPAN_FIND_ANCHORED_BUDGET 64
+
+// Returns the start of the maximal suffix of needle[0, size) for the byte order (or its reverse)
+// and the period of that suffix.
+static int32_t _az_span_find_maximal_suffix(
+    uint8_t const* needle,
+    int32_t size,
+    bool reverse_order,
+    int32_t* out_period)
+{
+  int32_t suffix = -1;
+  int32_t candidate = 0;
+  int32_t offset = 1;
+  int32_t period = 1;
+
+  while (candidate + offset < size)
+  {
+    uint8_t const a = needle[candidate + offset];
+    uint8_t const b = needle[suffix + offset];
+    if (reverse_order ? a > b : a < b)
+    {
+      // The candidate suffix is smaller; everything up to here belongs to the period.
+      candidate += offset;
+      offset = 1;
+      period = candidate - suffix;
+    }
+    else if (a == b)
+    {
+      if (offset != period)
+      {
+        offset++;
+      }
+      else
+      {
+        candidate += period;
+        offset = 1;
+      }
+    }
+    else
+    {
+      // The candidate suffix is larger and becomes the maximal suffix.
+      suffix = candidate;
+      candidate = suffix + 1;
+      offset = 1;
+      period = 1;
+    }
+  }
+
+  *out_period = period;
+  return suffix;
+}
+
+// Crochemore-Perrin two-way string matching: at most 2 * haystack_size comparisons and constant
+// space. Returns the position of the first occurrence of needle in haystack, or -1.
+static int32_t _az_span_find_two_way(
+    uint8_t const* haystack,
+    int32_t haystack_size,
+    uint8_t const* needle,
+    int32_t needle_size)
+{
+  // Critical factorization: needle = needle[0, split] + needle(split, needle_size).
+  int32_t period = 0;
+  int32_t reverse_period = 0;
+  int32_t split = _az_span_find_maximal_suffix(needle, needle_size, false, &period);
+  int32_t const reverse_split
+      = _az_span_find_maximal_suffix(needle, needle_size, true, &reverse_period);
+  if (reverse_split > split)
+  {
+    split = reverse_split;
+    period = reverse_period;
+  }
+
+  int32_t const last_start = haystack_size - needle_size;
+  if (memcmp(needle, needle + period, (size_t)(split + 1)) == 0)
+  {
+    // The needle is periodic: after a full match attempt, the part of the period that matched is
+    // remembered and not compared again.
+    int32_t memory = -1;
+    for (int32_t position = 0; position <= last_start;)
+    {
+      int32_t i = (split > memory ? split : memory) + 1;
+      while (i < needle_size && needle[i] == haystack[position + i])
+      {
+        i++;
+      }
+      if (i < needle_size)
+      {
+        position += i - split;
+        memory = -1;
+        continue;
+      }
+
+      i = split;
+      while (i > memory && needle[i] == haystack[position + i])
+      {
+        i--;
+      }
+      if (i <= memory)
+      {
+        return position;
+      }
+      position += period;
+      memory = needle_size - period - 1;
+    }
+  }
+  else
+  {
+    // A mismatch on the left side allows a shift larger than either side.
+    int32_t const left_size = split + 1;
+    int32_t const right_size = needle_size - split - 1;
+    int32_t const shift = (left_size > right_size ? left_size : right_size) + 1;
+    for (int32_t position = 0; position <= last_start;)
+    {
+      int32_t i = split + 1;
+      while (i < needle_size && needle[i] == haystack[position + i])
+      {
+        i++;
+      }
+      if (i < needle_size)
+      {
+        position += i - split;
+        continue;
+      }
+
+      i = split;
+      while (i >= 0 && needle[i] == haystack[position + i])
+      {
+        i--;
+      }
+      if (i < 0)
+      {
+        return position;
+      }
+      position += shift;
+    }
+  }
+
+  return -1;
+}
 
 AZ_NODISCARD int32_t az_span_find(az_span source, az_span target)
 {
-  /* This function implements the Naive string-search algorithm.
-   * The rationale to use this algorithm instead of other potentially more
-   * performing ones (Rabin-Karp, e.g.) is due to no additional space needed.
-   * The logic:
-   * 1. The function will look into each position of `source` if it contains the same value as the
-   * first position of `target`.
-   * 2. If it does, it could be that the next bytes in `source` are a perfect match of the remaining
-   * bytes of `target`.
-   * 3. Being so, it loops through the remaining bytes of `target` and see if they match exactly the
-   * next bytes of `source`.
-   * 4. If the loop gets to the end (all bytes of `target` are evaluated), it means `target` indeed
-   * occurs in that position of `source`.
-   * 5. If the loop gets interrupted before cruising through the entire `target`, the function must
-   * go back to step 1. from  the next position in `source`.
-   *   The loop in 5. gets interrupted if
-   *     - a byte in `target` is different than `source`, in the expected corresponding position;
-   *     - the loop has reached the end of `source` (and there are still remaining bytes of `target`
-   *         to be checked).
+  /* Positions where `source` holds the first byte of `target` are found with memchr() and the
+   * remaining bytes compared one by one. That is the fastest approach for the short targets and
+   * topic strings this is used for, but is O(source_size * target_size) on inputs such as
+   * "aaaa...a" searched for "aa...ab". Once the comparisons exceed the distance covered by more
+   * than a fixed budget, the rest of `source` is searched with the two-way algorithm instead, which
+   * needs no additional space either.
    */
 
   int32_t source_size = az_span_size(source);
@@ -438,42 +677,40 @@ AZ_NODISCARD int32_t az_span_find(az_span source, az_span target)
     return target_not_found;
   }
 
-  uint8_t* source_ptr = az_span_ptr(source);
-  uint8_t* target_ptr = az_span_ptr(target);
+  uint8_t const* source_ptr = az_span_ptr(source);
+  uint8_t const* target_ptr = az_span_ptr(target);
+  int32_t const last_start = source_size - target_size;
+  int32_t comparisons = 0;
 
-  // This loop traverses `source` position by position (step 1.)
-  for (int32_t i = 0; i < (source_size - target_size + 1); i++)
+  for (int32_t i = 0; i <= last_start; i++)
   {
-    // This is the check done in step 1. above.
-    if (source_ptr[i] == target_ptr[0])
+    uint8_t const* const candidate
+        = (uint8_t const*)memchr(source_ptr + i, target_ptr[0], (size_t)(last_start - i + 1));
+    if (candidate == NULL)
     {
-      // The condition in step 2. has been satisfied.
-      int32_t j = 1;
-      // This is the loop defined in step 3.
-      // The loop must be broken if it reaches the ends of `target` (step 3.) OR `source`
-      // (step 5.).
-      for (; j < target_size && (i + j) < source_size; j++)
-      {
-        // Condition defined in step 5.
-        if (source_ptr[i + j] != target_ptr[j])
-        {
-          break;
-        }
-      }
+      return target_not_found;
+    }
+    i = (int32_t)(candidate - source_ptr);
 
-      if (j == target_size)
-      {
-        // All bytes in `target` have been checked and matched the corresponding bytes in `source`
-        // (from the start point `i`), so this is indeed an instance of `target` in that position
-        // of `source` (step 4.).
+    int32_t j = 1;
+    while (j < target_size && source_ptr[i + j] == target_ptr[j])
+    {
+      j++;
+    }
+    if (j == target_size)
+    {
+      return i;
+    }
 
-        return i;
-      }
+    comparisons += j;
+    if (comparisons > i + _az_SPAN_FIND_ANCHORED_BUDGET)
+    {
+      int32_t const index
+          = _az_span_find_two_way(source_ptr + i + 1, source_size - i - 1, target_ptr, target_size);
+      return index < 0 ? target_not_found : i + 1 + index;
     }
   }
 
-  // If the function hasn't returned before, all positions
-  // of `source` have been evaluated but `target` could not be found.
   return target_not_found;
 }
 
@@ -787,6 +1024,112 @@ az_span_dtoa(az_span destination, double source, int32_t fractional_digits, az_s
   return _az_span_builder_append_uint64(out_span, fractional_part);
 }
 
+AZ_NODISCARD az_result az_span_dtoa_shortest(az_span destination, double source, az_span* out_span)
+{
+  _az_PRECONDITION_VALID_SPAN(destination, 0, false);
+  // Inputs that are either positive or negative infinity, or not a number, are not supported.
+  _az_PRECONDITION(_az_isfinite(source));
+  _az_PRECONDITION_NOT_NULL(out_span);
+
+  *out_span = destination;
+
+  // The input is either positive or negative infinity, or not a number.
+  if (!_az_isfinite(source))
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  uint64_t bits = 0;
+  memcpy(&bits, &source, sizeof(bits));
+  bool const negative = (bits >> 63) != 0;
+  bits &= ~(1ULL << 63);
+
+  uint64_t significand = 0;
+  int32_t exponent = 0;
+  if (bits != 0)
+  {
+    significand = _az_double_to_shortest_decimal(bits, &exponent);
+    while (significand % _az_NUMBER_OF_DECIMAL_VALUES == 0)
+    {
+      significand /= _az_NUMBER_OF_DECIMAL_VALUES;
+      exponent++;
+    }
+  }
+
+  // The significant digits, right aligned.
+  uint8_t digits[_az_MAX_SIZE_FOR_UINT64];
+  int32_t first = _az_MAX_SIZE_FOR_UINT64;
+  do
+  {
+    digits[--first] = _az_decimal_to_ascii((uint8_t)(significand % _az_NUMBER_OF_DECIMAL_VALUES));
+    significand /= _az_NUMBER_OF_DECIMAL_VALUES;
+  } while (significand != 0);
+  int32_t const digit_count = _az_MAX_SIZE_FOR_UINT64 - first;
+
+  // Position of the decimal point relative to the first digit.
+  int32_t const point = digit_count + exponent;
+
+  uint8_t text[_az_MAX_SIZE_FOR_WRITING_SHORTEST_DOUBLE];
+  az_span remaining = AZ_SPAN_FROM_BUFFER(text);
+  if (negative)
+  {
+    remaining = az_span_copy_u8(remaining, '-');
+  }
+
+  if (point >= digit_count && point <= 21)
+  {
+    // 1500
+    remaining = az_span_copy(remaining, az_span_create(digits + first, digit_count));
+    for (int32_t i = digit_count; i < point; i++)
+    {
+      remaining = az_span_copy_u8(remaining, '0');
+    }
+  }
+  else if (point > 0 && point <= 21)
+  {
+    // 23.5
+    remaining = az_span_copy(remaining, az_span_create(digits + first, point));
+    remaining = az_span_copy_u8(remaining, '.');
+    remaining
+        = az_span_copy(remaining, az_span_create(digits + first + point, digit_count - point));
+  }
+  else if (point > -6 && point <= 0)
+  {
+    // 0.0025
+    remaining = az_span_copy(remaining, AZ_SPAN_FROM_STR("0."));
+    for (int32_t i = point; i < 0; i++)
+    {
+      remaining = az_span_copy_u8(remaining, '0');
+    }
+    remaining = az_span_copy(remaining, az_span_create(digits + first, digit_count));
+  }
+  else
+  {
+    // 1.5e-7
+    remaining = az_span_copy_u8(remaining, digits[first]);
+    if (digit_count > 1)
+    {
+      remaining = az_span_copy_u8(remaining, '.');
+      remaining = az_span_copy(remaining, az_span_create(digits + first + 1, digit_count - 1));
+    }
+    remaining = az_span_copy_u8(remaining, 'e');
+    int32_t const decimal_exponent = point - 1;
+    if (decimal_exponent < 0)
+    {
+      remaining = az_span_copy_u8(remaining, '-');
+    }
+    _az_RETURN_IF_FAILED(_az_span_builder_append_u32toa(
+        remaining,
+        (uint32_t)(decimal_exponent < 0 ? -decimal_exponent : decimal_exponent),
+        &remaining));
+  }
+
+  int32_t const written = _az_span_diff(remaining, AZ_SPAN_FROM_BUFFER(text));
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(destination, written);
+  *out_span = az_span_copy(destination, az_span_create(text, written));
+  return AZ_OK;
+}
+
 // TODO: pass az_span by value
 AZ_NODISCARD az_result _az_is_expected_span(az_span* ref_span, az_span expected)
 {
@@ -44,9 +44,18 @@ enum
   // 19 + sign (i.e. -9,223,372,036,854,775,808)
   _az_MAX_SIZE_FOR_INT64 = 20,
 
-  // Two digit length to create the "format" passed to sscanf.
+  // Longest text written by az_span_dtoa_shortest(), i.e. -0.00000 followed by 17 digits.
+  _az_MAX_SIZE_FOR_WRITING_SHORTEST_DOUBLE = 25,
+
+  // Longest text accepted by az_span_atod() and az_json_token_get_double().
   _az_MAX_SIZE_FOR_PARSING_DOUBLE = 99,
 
+  // Range of the 128-bit power of ten table. Below 1e-342 any 19-digit mantissa rounds to zero;
+  // formatting the smallest subnormal needs 1e324.
+  _az_POWER_OF_TEN_MIN_EXPONENT = -342,
+  _az_POWER_OF_TEN_MAX_EXPONENT = 324,
+  _az_POWER_OF_TEN_COUNT = _az_POWER_OF_TEN_MAX_EXPONENT - _az_POWER_OF_TEN_MIN_EXPONENT + 1,
+
   // The number value of the ASCII space character ' '.
   _az_ASCII_SPACE_CHARACTER = 0x20,
 
@@ -86,6 +95,48 @@ AZ_NODISCARD AZ_INLINE bool _az_isfinite(double value)
 
 AZ_NODISCARD az_result _az_is_expected_span(az_span* ref_span, az_span expected);
 
+/**
+ * @brief 128-bit approximations of 10^e for e in [#_az_POWER_OF_TEN_MIN_EXPONENT,
+ * #_az_POWER_OF_TEN_MAX_EXPONENT], rounded down and normalized. Each entry holds the high and the
+ * low 64 bits.
+ */
+extern uint64_t const _az_power_of_ten_128[_az_POWER_OF_TEN_COUNT][2];
+
+/**
+ * @brief Converts \p mantissa * 10^\p exponent to the nearest double with the Eisel-Lemire
+ * algorithm.
+ *
+ * @param[in] mantissa A non-zero decimal mantissa.
+ * @param[in] exponent The power of ten, within the range of #_az_power_of_ten_128.
+ * @param[out] out_bits The IEEE 754 representation of the positive result.
+ *
+ * @return `false` if the result cannot be decided this way (close to halfway between two doubles,
+ * subnormal, or overflowing). The caller must then use #_az_span_atod_exact.
+ */
+AZ_NODISCARD bool _az_eisel_lemire(uint64_t mantissa, int32_t exponent, uint64_t* out_bits);
+
+/**
+ * @brief Converts a number already validated by az_span_atod() to the nearest double using
+ * arbitrary precision decimal arithmetic. This is slow and keeps up to 768 digits on the stack.
+ *
+ * @param[in] source The number text: sign, digits with an optional '.', and an optional exponent.
+ * @param[out] out_bits The IEEE 754 representation of the absolute value of the result.
+ *
+ * @return `false` if the number overflows a double.
+ */
+AZ_NODISCARD bool _az_span_atod_exact(az_span source, uint64_t* out_bits);
+
+/**
+ * @brief Finds the shortest decimal that converts back to the given double (Schubfach algorithm).
+ * Among several candidates of the same length, the one closest to the double is chosen.
+ *
+ * @param[in] bits The IEEE 754 representation of a positive, finite, non-zero double.
+ * @param[out] out_exponent The power of ten to scale the returned digits by.
+ *
+ * @return The significant digits, at most 17. They may have trailing zeros.
+ */
+AZ_NODISCARD uint64_t _az_double_to_shortest_decimal(uint64_t bits, int32_t* out_exponent);
+
 /**
  * @brief Removes all leading and trailing whitespace characters from the \p span. Function will
  * create a new #az_span pointing to the first non-whitespace (` `, \\n, \\r, \\t) character found
@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief Measures the throughput of base 64 encoding and decoding.
+ *
+ * @details Each buffer is encoded and decoded repeatedly for a fixed amount of processor time and
+ * the result is printed in MB/s of binary data, next to a group-at-a-time reference that decodes
+ * each character with comparisons, as the SDK used to. Large buffers are also decoded in chunks
+ * with #az_base64_decoder. Every output is checked against the reference before measuring.
+ */
+
+#include <azure/core/az_base64.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <azure/core/_az_cfg.h>
+
+#define MEASUREMENT_SECONDS 1.0
+#define MAX_SIZE 65536
+#define CHUNK_SIZE 1024
+
+static uint8_t bytes[MAX_SIZE];
+static uint8_t text[MAX_SIZE / 3 * 4 + 4];
+static uint8_t decoded[MAX_SIZE];
+static uint8_t reference_output[MAX_SIZE / 3 * 4 + 4];
+
+static char const alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static int32_t reference_decoded_char(uint8_t c)
+{
+  if (c >= 'A' && c <= 'Z')
+  {
+    return c - 'A';
+  }
+  if (c >= 'a' && c <= 'z')
+  {
+    return 26 + (c - 'a');
+  }
+  if (c >= '0' && c <= '9')
+  {
+    return 52 + (c - '0');
+  }
+  if (c == '+')
+  {
+    return 62;
+  }
+  if (c == '/')
+  {
+    return 63;
+  }
+  return -1;
+}
+
+static int32_t reference_encode(uint8_t* destination, uint8_t const* source, int32_t size)
+{
+  int32_t written = 0;
+  for (int32_t i = 0; i < size; i += 3)
+  {
+    int32_t const remaining = size - i;
+    uint32_t const value = ((uint32_t)source[i] << 16)
+        | (remaining > 1 ? (uint32_t)source[i + 1] << 8 : 0)
+        | (remaining > 2 ? source[i + 2] : 0);
+    destination[written++] = (uint8_t)alphabet[value >> 18];
+    destination[written++] = (uint8_t)alphabet[(value >> 12) & 0x3F];
+    destination[written++] = remaining > 1 ? (uint8_t)alphabet[(value >> 6) & 0x3F] : '=';
+    destination[written++] = remaining > 2 ? (uint8_t)alphabet[value & 0x3F] : '=';
+  }
+  return written;
+}
+
+static int32_t reference_decode(uint8_t* destination, uint8_t const* source, int32_t size)
+{
+  int32_t written = 0;
+  for (int32_t i = 0; i < size; i += 4)
+  {
+    int32_t const i0 = reference_decoded_char(source[i]);
+    int32_t const i1 = reference_decoded_char(source[i + 1]);
+    int32_t const i2 = source[i + 2] == '=' ? 0 : reference_decoded_char(source[i + 2]);
+    int32_t const i3 = source[i + 3] == '=' ? 0 : reference_decoded_char(source[i + 3]);
+    if (i0 < 0 || i1 < 0 || i2 < 0 || i3 < 0)
+    {
+      return -1;
+    }
+    uint32_t const value
+        = ((uint32_t)i0 << 18) | ((uint32_t)i1 << 12) | ((uint32_t)i2 << 6) | (uint32_t)i3;
+    destination[written++] = (uint8_t)(value >> 16);
+    if (source[i + 2] != '=')
+    {
+      destination[written++] = (uint8_t)(value >> 8);
+    }
+    if (source[i + 3] != '=')
+    {
+      destination[written++] = (uint8_t)value;
+    }
+  }
+  return written;
+}
+
+typedef int32_t (*convert_function)(int32_t size);
+
+static int32_t encode(int32_t size)
+{
+  int32_t written = 0;
+  return az_result_succeeded(
+             az_base64_encode(AZ_SPAN_FROM_BUFFER(text), az_span_create(bytes, size), &written))
+      ? written
+      : -1;
+}
+
+static int32_t decode(int32_t size)
+{
+  int32_t written = 0;
+  return az_result_succeeded(az_base64_decode(
+             AZ_SPAN_FROM_BUFFER(decoded),
+             az_span_create(text, az_base64_get_max_encoded_size(size)),
+             &written))
+      ? written
+      : -1;
+}
+
+static int32_t decode_chunked(int32_t size)
+{
+  int32_t const text_size = az_base64_get_max_encoded_size(size);
+  az_base64_decoder decoder;
+  az_base64_decoder_init(&decoder);
+
+  int32_t total = 0;
+  for (int32_t i = 0; i < text_size; i += CHUNK_SIZE)
+  {
+    int32_t written = 0;
+    int32_t const chunk = text_size - i < CHUNK_SIZE ? text_size - i : CHUNK_SIZE;
+    if (az_result_failed(az_base64_decoder_update(
+            &decoder,
+            az_span_create(decoded + total, MAX_SIZE - total),
+            az_span_create(text + i, chunk),
+            &written)))
+    {
+      return -1;
+    }
+    total += written;
+  }
+  int32_t written = 0;
+  if (az_result_failed(az_base64_decoder_final(
+          &decoder, az_span_create(decoded + total, MAX_SIZE - total), &written)))
+  {
+    return -1;
+  }
+  return total + written;
+}
+
+static int32_t encode_reference(int32_t size)
+{
+  return reference_encode(reference_output, bytes, size);
+}
+
+static int32_t decode_reference(int32_t size)
+{
+  return reference_decode(reference_output, text, az_base64_get_max_encoded_size(size));
+}
+
+static double measure(convert_function convert, int32_t size)
+{
+  long iterations = 0;
+  volatile int32_t sink = 0;
+  clock_t const start = clock();
+  clock_t elapsed = 0;
+  do
+  {
+    for (int i = 0; i < 16; i++)
+    {
+      sink += convert(size);
+    }
+    iterations += 16;
+    elapsed = clock() - start;
+  } while ((double)elapsed < MEASUREMENT_SECONDS * CLOCKS_PER_SEC);
+
+  (void)sink;
+  return (double)size * (double)iterations / ((double)elapsed / CLOCKS_PER_SEC) / 1e6;
+}
+
+static int run(char const* name, int32_t size)
+{
+  int32_t const text_size = az_base64_get_max_encoded_size(size);
+  if (encode(size) != text_size || reference_encode(reference_output, bytes, size) != text_size
+      || memcmp(text, reference_output, (size_t)text_size) != 0)
+  {
+    printf("%s: encoding differs from the reference\n", name);
+    return 1;
+  }
+  if (decode(size) != size || memcmp(decoded, bytes, (size_t)size) != 0)
+  {
+    printf("%s: decoding differs from the input\n", name);
+    return 1;
+  }
+  memset(decoded, 0, (size_t)size);
+  if (decode_chunked(size) != size || memcmp(decoded, bytes, (size_t)size) != 0)
+  {
+    printf("%s: chunked decoding differs from the input\n", name);
+    return 1;
+  }
+
+  printf(
+      "%-24s encode %8.1f MB/s (reference %7.1f)  decode %8.1f MB/s (reference %7.1f)",
+      name,
+      measure(encode, size),
+      measure(encode_reference, size),
+      measure(decode, size),
+      measure(decode_reference, size));
+  if (size > CHUNK_SIZE)
+  {
+    printf("  chunked decode %8.1f MB/s", measure(decode_chunked, size));
+  }
+  printf("\n");
+  return 0;
+}
+
+int main(void)
+{
+  uint32_t random = 2463534242u;
+  for (int32_t i = 0; i < MAX_SIZE; i++)
+  {
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    bytes[i] = (uint8_t)random;
+  }
+
+  int failures = 0;
+  failures += run("SHA-256 hash (32 B)", 32);
+  failures += run("SAS key (64 B)", 64);
+  failures += run("certificate (1 KiB)", 1024);
+  failures += run("blob (64 KiB)", MAX_SIZE);
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
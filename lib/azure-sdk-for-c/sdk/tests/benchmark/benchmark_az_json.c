@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief Measures the throughput of the JSON reader on typical IoT payloads.
+ *
+ * @details Each payload is tokenized repeatedly for a fixed amount of processor time, once as a
+ * single buffer and once split into 64-byte segments, and the result is printed in MB/s.
+ */
+
+#include <azure/core/az_json.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <azure/core/_az_cfg.h>
+
+#define MEASUREMENT_SECONDS 1.0
+#define SEGMENT_SIZE 64
+#define MAX_SEGMENTS 64
+
+// Device twin as returned by a twin GET request, pretty-printed.
+static char twin_payload[]
+    = "{\n"
+      "  \"desired\": {\n"
+      "    \"telemetryInterval\": 60,\n"
+      "    \"wateringThreshold\": 35.5,\n"
+      "    \"wateringDuration\": 12,\n"
+      "    \"displayName\": \"AquaBotanica \\\"Kitchen\\\" sunflower\",\n"
+      "    \"schedule\": {\n"
+      "      \"start\": \"2024-06-01T06:00:00Z\",\n"
+      "      \"days\": [\"Mon\", \"Tue\", \"Wed\", \"Thu\", \"Fri\", \"Sat\", \"Sun\"],\n"
+      "      \"enabled\": true\n"
+      "    },\n"
+      "    \"$metadata\": {\n"
+      "      \"$lastUpdated\": \"2024-06-01T05:58:21.4321876Z\",\n"
+      "      \"$lastUpdatedVersion\": 17,\n"
+      "      \"telemetryInterval\": {\n"
+      "        \"$lastUpdated\": \"2024-06-01T05:58:21.4321876Z\",\n"
+      "        \"$lastUpdatedVersion\": 17\n"
+      "      },\n"
+      "      \"wateringThreshold\": {\n"
+      "        \"$lastUpdated\": \"2024-05-30T18:12:03.1184422Z\",\n"
+      "        \"$lastUpdatedVersion\": 14\n"
+      "      }\n"
+      "    },\n"
+      "    \"$version\": 17\n"
+      "  },\n"
+      "  \"reported\": {\n"
+      "    \"firmwareVersion\": \"1.4.2+build.20240601\",\n"
+      "    \"serialNumber\": \"WIO-TERMINAL-0x2F8A91C4\",\n"
+      "    \"temperature\": 23.87,\n"
+      "    \"humidity\": 48.2,\n"
+      "    \"soilMoisture\": 41,\n"
+      "    \"lastWatering\": \"2024-06-01T05:42:10Z\",\n"
+      "    \"network\": {\n"
+      "      \"ssid\": \"greenhouse-iot\",\n"
+      "      \"rssi\": -61,\n"
+      "      \"ipAddress\": \"192.168.178.54\",\n"
+      "      \"availabilityPermille\": 998\n"
+      "    },\n"
+      "    \"$metadata\": {\n"
+      "      \"$lastUpdated\": \"2024-06-01T06:00:04.9916312Z\"\n"
+      "    },\n"
+      "    \"$version\": 3120\n"
+      "  }\n"
+      "}\n";
+
+// Device Update request with its embedded, escaped update manifest (from the ADU tests).
+static char adu_request_payload[]
+    = "{\"service\":{\"workflow\":{\"action\":3,\"id\":\"51552a54-765e-419f-892a-c822549b6f38\"},"
+      "\"updateManifest\":\"{\\\"manifestVersion\\\":\\\"5\\\",\\\"updateId\\\":{\\\"provider\\\":"
+      "\\\"Contoso\\\",\\\"name\\\":\\\"Foobar\\\",\\\"version\\\":\\\"1.1\\\"},"
+      "\\\"compatibility\\\":[{\\\"deviceManufacturer\\\":\\\"Contoso\\\",\\\"deviceModel\\\":"
+      "\\\"Foobar\\\"}],\\\"instructions\\\":{\\\"steps\\\":[{\\\"handler\\\":\\\"microsoft/"
+      "swupdate:1\\\",\\\"files\\\":[\\\"f2f4a804ca17afbae\\\"],\\\"handlerProperties\\\":{"
+      "\\\"installedCriteria\\\":\\\"1.0\\\"}}]},\\\"files\\\":{\\\"f2f4a804ca17afbae\\\":{"
+      "\\\"fileName\\\":\\\"iot-middleware-sample-adu-v1.1\\\",\\\"sizeInBytes\\\":844976,"
+      "\\\"hashes\\\":{\\\"sha256\\\":\\\"xsoCnYAMkZZ7m9RL9Vyg9jKfFehCNxyuPFaJVM/"
+      "WBi0=\\\"}}},\\\"createdDateTime\\\":\\\"2022-07-07T03:02:48.8449038Z\\\"}\","
+      "\"updateManifestSignature\":"
+      "\"eyJhbGciOiJSUzI1NiIsInNqd2siOiJleUpoYkdjaU9pSlNVekkxTmlJc0ltdHBaQ0k2SWtGRVZTNHlNREEzTURJdV"
+      "VpSjkuZXlKcmRIa2lPaUpTVTBFaUxDSnVJam9pYkV4bWMwdHZPRmwwWW1Oak1sRXpUalV3VlhSTVNXWlhVVXhXVTBGRl"
+      "ltTm9LMFl2WTJVM1V6Rlpja3BvV0U5VGNucFRaa051VEhCVmFYRlFWSGMwZWxndmRHbEJja0ZGZFhrM1JFRmxWVzVGU0"
+      "VWamVEZE9hM2QzZVRVdk9IcExaV3AyWTBWWWNFRktMMlV6UWt0SE5FVTBiMjVtU0ZGRmNFOXplSGRQUzBWbFJ6Qkhkam"
+      "wzVjB3emVsUmpUblprUzFoUFJGaEdNMVZRWlVveGIwZGlVRkZ0Y3pKNmJVTktlRUppZEZOSldVbDBiWFpwWTNneVpXdG"
+      "tWbnBYUm5jdmRrdFVUblZMYXpob2NVczNTRkptYWs5VlMzVkxXSGxqSzNsSVVVa3dZVVpDY2pKNmEyc3plR2d4ZEVWUF"
+      "N6azRWMHBtZUdKamFsQnpSRTgyWjNwWmVtdFlla05OZW1Fd1R6QkhhV0pDWjB4QlZGUTVUV1k0V1ZCd1dVY3lhblpQWV"
+      "VSVmIwTlJiakpWWTFWU1RtUnNPR2hLWW5scWJscHZNa3B5SzFVNE5IbDFjVTlyTjBZMFdubFRiMEoyTkdKWVNrZ3lXbE"
+      "pTV2tab0wzVlRiSE5XT1hkU2JWbG9XWEoyT1RGRVdtbHhhemhJVWpaRVUyeHVabTVsZFRJNFJsUm9SVzF0YjNOVlRUTn"
+      "JNbGxNYzBKak5FSnZkWEIwTTNsaFNEaFpia3BVTnpSMU16TjFlakU1TDAxNlZIVnFTMmMzVkdGcE1USXJXR0owYmxwRU"
+      "9XcFVSMkY1U25Sc2FFWmxWeXRJUXpVM1FYUkJSbHBvY1ZsM2VVZHJXQ3M0TTBGaFVGaGFOR0V4VHpoMU1qTk9WVWQxTW"
+      "tGd04yOU5NVTR3ZVVKS0swbHNUM29pTENKbElqb2lRVkZCUWlJc0ltRnNaeUk2SWxKVE1qVTJJaXdpYTJsa0lqb2lRVV"
+      "JWTGpJeE1EWXdPUzVTTGxNaWZRLlJLS2VBZE02dGFjdWZpSVU3eTV2S3dsNFpQLURMNnEteHlrTndEdkljZFpIaTBIa2"
+      "RIZ1V2WnoyZzZCTmpLS21WTU92dXp6TjhEczhybXo1dnMwT1RJN2tYUG1YeDZFLUYyUXVoUXNxT3J5LS1aN2J3TW5LYT"
+      "NkZk1sbkthWU9PdURtV252RWMyR0hWdVVTSzREbmw0TE9vTTQxOVlMNThWTDAtSEthU18xYmNOUDhXYjVZR08xZXh1Rm"
+      "piVGtIZkNIU0duVThJeUFjczlGTjhUT3JETHZpVEtwcWtvM3RiSUwxZE1TN3NhLWJkZExUVWp6TnVLTmFpNnpIWTdSan"
+      "ZGbjhjUDN6R2xjQnN1aVQ0XzVVaDZ0M05rZW1UdV9tZjdtZUFLLTBTMTAzMFpSNnNTR281azgtTE1sX0ZaUmh4djNFZF"
+      "NtR2RBUTNlMDVMRzNnVVAyNzhTQWVzWHhNQUlHWmcxUFE3aEpoZGZHdmVGanJNdkdTSVFEM09wRnEtZHREcEFXbUo2Zm"
+      "5sZFA1UWxYek5tQkJTMlZRQUtXZU9BYjh0Yjl5aVhsemhtT1dLRjF4SzlseHpYUG9GNmllOFRUWlJ4T0hxTjNiSkVISk"
+      "VoQmVLclh6YkViV2tFNm4zTEoxbkd5M1htUlVFcER0Umdpa0tBUzZybFhFT0VneXNjIn0."
+      "eyJzaGEyNTYiOiJiUlkrcis0MzdsYTV5d2hIeDdqVHhlVVRkeDdJdXQyQkNlcVpoQys5bmFNPSJ9."
+      "eYoBoq9EOiCebTJAMhRh9DARC69F3C4Qsia86no9YbMJzwKt-rH88Va4dL59uNTlPNBQid4u0RlXSUTuma_v-"
+      "Sf4hyw70tCskwru5Fp41k9Ve3YSkulUKzctEhaNUJ9tUSA11Tz9HwJHOAEA1-S_dXWR_yuxabk9G_"
+      "BiucsuKhoI0Bas4e1ydQE2jXZNdVVibrFSqxvuVZrxHKVhwm-"
+      "G9RYHjZcoSgmQ58vWyaC2l8K8ZqnlQWmuLur0CZFQlanUVxDocJUtu1MnB2ER6emMRD_"
+      "4Azup2K4apq9E1EfYBbXxOZ0N5jaSr-2xg8NVSow5NqNSaYYY43wy_NIUefRlbSYu5zOrSWtuIwRdsO-"
+      "43Eo8b9vuJj1Qty9ee6xz1gdUNHnUdnM6dHEplZK0GZznsxRviFXt7yv8bVLd32Z7QDtFh3s17xlKulBZxWP-"
+      "q96r92RoUTov2M3ynPZSDmc6Mz7-r8ioO5VHO5pAPCH-tF5zsqzipPJKmBMaf5gYk8wR\",\"fileUrls\":{"
+      "\"f2f4a804ca17afbae\":\"http://contoso-adu-instance--contoso-adu.b.nlu.dl.adu.microsoft.com/"
+      "westus2/contoso-adu-instance--contoso-adu/67c8d2ef5148403391bed74f51a28597/"
+      "iot-middleware-sample-adu-v1.1\"}}}";
+
+static az_result tokenize(az_span* buffers, int32_t number_of_buffers)
+{
+  az_json_reader reader;
+  az_result result = az_json_reader_chunked_init(&reader, buffers, number_of_buffers, NULL);
+  while (az_result_succeeded(result))
+  {
+    result = az_json_reader_next_token(&reader);
+  }
+  return result == AZ_ERROR_JSON_READER_DONE ? AZ_OK : result;
+}
+
+static int run(char const* name, az_span payload, int32_t segment_size)
+{
+  az_span buffers[MAX_SEGMENTS];
+  int32_t number_of_buffers = 0;
+  for (int32_t offset = 0; offset < az_span_size(payload); offset += segment_size)
+  {
+    if (number_of_buffers == MAX_SEGMENTS)
+    {
+      printf("%s: payload too large for %d segments\n", name, MAX_SEGMENTS);
+      return 1;
+    }
+    int32_t const end = offset + segment_size < az_span_size(payload) ? offset + segment_size
+                                                                        : az_span_size(payload);
+    buffers[number_of_buffers++] = az_span_slice(payload, offset, end);
+  }
+
+  if (az_result_failed(tokenize(buffers, number_of_buffers)))
+  {
+    printf("%s: payload is not valid JSON\n", name);
+    return 1;
+  }
+
+  long iterations = 0;
+  clock_t const start = clock();
+  clock_t elapsed = 0;
+  do
+  {
+    for (int i = 0; i < 256; i++)
+    {
+      (void)tokenize(buffers, number_of_buffers);
+    }
+    iterations += 256;
+    elapsed = clock() - start;
+  } while ((double)elapsed < MEASUREMENT_SECONDS * CLOCKS_PER_SEC);
+
+  double const seconds = (double)elapsed / CLOCKS_PER_SEC;
+  double const bytes = (double)az_span_size(payload) * (double)iterations;
+  printf(
+      "%-24s %6d bytes  %3d segment(s)  %8.1f MB/s\n",
+      name,
+      az_span_size(payload),
+      number_of_buffers,
+      bytes / seconds / 1e6);
+  return 0;
+}
+
+int main(void)
+{
+  az_span const twin = az_span_create_from_str(twin_payload);
+  az_span const adu = az_span_create_from_str(adu_request_payload);
+
+  int failures = 0;
+  failures += run("twin", twin, az_span_size(twin));
+  failures += run("twin (chunked)", twin, SEGMENT_SIZE);
+  failures += run("adu manifest", adu, az_span_size(adu));
+  failures += run("adu manifest (chunked)", adu, SEGMENT_SIZE);
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
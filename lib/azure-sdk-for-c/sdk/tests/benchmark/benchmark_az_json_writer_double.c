@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief Measures how fast and how large float-heavy telemetry documents are written with
+ * az_json_writer_append_double() and az_json_writer_append_double_shortest().
+ *
+ * @details The document is a batch of sensor samples, as sent by the firmware. The fixed-precision
+ * modes either lose information (2 digits) or pad the numbers (15 digits); only the shortest mode
+ * reads back every value exactly, which is checked before measuring.
+ */
+
+#include <azure/core/az_json.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_result_internal.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <azure/core/_az_cfg.h>
+
+#define MEASUREMENT_SECONDS 1.0
+#define SAMPLE_COUNT 32
+#define FIELD_COUNT 6
+#define SHORTEST -1
+
+static char* const field_names[FIELD_COUNT] = {
+  "temperature", "humidity", "moisture", "light", "pressure", "battery",
+};
+
+static double samples[SAMPLE_COUNT][FIELD_COUNT];
+
+static uint8_t document[16384];
+
+// Readings as the sensors deliver them: averaged ADC values scaled to physical units, so most of
+// them need all 17 digits to be reproduced exactly.
+static void create_samples(void)
+{
+  uint32_t random = 2463534242u;
+  for (int i = 0; i < SAMPLE_COUNT; i++)
+  {
+    for (int j = 0; j < FIELD_COUNT; j++)
+    {
+      random ^= random << 13;
+      random ^= random >> 17;
+      random ^= random << 5;
+      double const raw = (double)(random % 4096) / 4095.0;
+      samples[i][j] = j == 0 ? raw * 60.0 - 10.0 : (j == 4 ? 950.0 + raw * 100.0 : raw * 100.0);
+    }
+  }
+  // A few values that are already short.
+  samples[0][0] = 23.5;
+  samples[1][1] = 61.25;
+  samples[2][5] = 100;
+}
+
+static az_result write_document(int32_t fractional_digits, int32_t* out_size)
+{
+  az_json_writer writer;
+  _az_RETURN_IF_FAILED(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(document), NULL));
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(&writer));
+  for (int i = 0; i < SAMPLE_COUNT; i++)
+  {
+    _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(&writer));
+    for (int j = 0; j < FIELD_COUNT; j++)
+    {
+      _az_RETURN_IF_FAILED(az_json_writer_append_property_name(
+          &writer, az_span_create_from_str(field_names[j])));
+      _az_RETURN_IF_FAILED(
+          fractional_digits == SHORTEST
+              ? az_json_writer_append_double_shortest(&writer, samples[i][j])
+              : az_json_writer_append_double(&writer, samples[i][j], fractional_digits));
+    }
+    _az_RETURN_IF_FAILED(az_json_writer_append_end_object(&writer));
+  }
+  _az_RETURN_IF_FAILED(az_json_writer_append_end_array(&writer));
+  *out_size = az_span_size(az_json_writer_get_bytes_used_in_destination(&writer));
+  return AZ_OK;
+}
+
+// Counts the numbers in the document that do not read back as the original value.
+static int count_inexact(int32_t size)
+{
+  az_json_reader reader;
+  if (az_result_failed(az_json_reader_init(&reader, az_span_create(document, size), NULL)))
+  {
+    return -1;
+  }
+
+  int inexact = 0;
+  int index = 0;
+  while (az_result_succeeded(az_json_reader_next_token(&reader)))
+  {
+    if (reader.token.kind == AZ_JSON_TOKEN_NUMBER)
+    {
+      double value = 0;
+      if (az_result_failed(az_json_token_get_double(&reader.token, &value))
+          || memcmp(&value, &samples[index / FIELD_COUNT][index % FIELD_COUNT], sizeof(value)) != 0)
+      {
+        inexact++;
+      }
+      index++;
+    }
+  }
+  return inexact;
+}
+
+static int run(char const* name, int32_t fractional_digits)
+{
+  int32_t size = 0;
+  if (az_result_failed(write_document(fractional_digits, &size)))
+  {
+    printf("%s: writing failed\n", name);
+    return 1;
+  }
+  int const inexact = count_inexact(size);
+
+  long iterations = 0;
+  clock_t const start = clock();
+  clock_t elapsed = 0;
+  do
+  {
+    for (int i = 0; i < 64; i++)
+    {
+      (void)write_document(fractional_digits, &size);
+    }
+    iterations += 64;
+    elapsed = clock() - start;
+  } while ((double)elapsed < MEASUREMENT_SECONDS * CLOCKS_PER_SEC);
+
+  double const seconds = (double)elapsed / CLOCKS_PER_SEC;
+  printf(
+      "%-20s %6d bytes  %8.1f us/document  %8.1f ns/field  %3d of %d inexact\n",
+      name,
+      size,
+      seconds * 1e6 / (double)iterations,
+      seconds * 1e9 / ((double)iterations * SAMPLE_COUNT * FIELD_COUNT),
+      inexact,
+      SAMPLE_COUNT * FIELD_COUNT);
+  return 0;
+}
+
+int main(void)
+{
+  create_samples();
+
+  int failures = 0;
+  failures += run("2 digits", 2);
+  failures += run("15 digits", 15);
+  failures += run("shortest", SHORTEST);
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
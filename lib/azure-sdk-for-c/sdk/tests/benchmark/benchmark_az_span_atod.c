@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief Measures az_span_atod against the previous sscanf based implementation.
+ *
+ * @details Each set of numbers is parsed repeatedly for a fixed amount of processor time and the
+ * result is printed in nanoseconds per number. Every number is also checked to parse to the same
+ * value with both implementations.
+ */
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <azure/core/_az_cfg.h>
+
+#define MEASUREMENT_SECONDS 1.0
+
+// Values as they appear in telemetry and twin payloads: sensor readings with one or two decimals.
+static char* telemetry_numbers[] = {
+  "23.5",  "61.25", "0.5",   "1013.2", "35.5",  "12",    "-3.75", "100",
+  "48.05", "7.1",   "22.87", "998.6",  "0.125", "64.9",  "15.0",  "-0.4",
+};
+
+// Output of "%.17g", as written by serializers that round trip every double.
+static char* full_precision_numbers[] = {
+  "0.10000000000000001",    "23.449999999999999",     "1013.2000000000001",
+  "3.1415926535897931",     "2.7182818284590451",     "6.0221407599999999e+23",
+  "1.6021766340000001e-19", "299792458",              "0.30000000000000004",
+  "9.8066499999999994",     "1.4142135623730951",     "-273.14999999999998",
+};
+
+// Long mantissas and extreme exponents that need the slower paths.
+static char* hard_numbers[] = {
+  "9007199254740993",
+  "2.2250738585072011e-308",
+  "4.9406564584124654e-324",
+  "1.7976931348623157e308",
+  "0.500000000000000166533453693773481063544750213623046875",
+  "123456789012345678901234567890e-10",
+};
+
+static int reference_atod(az_span source, double* out_number)
+{
+  char buffer[100];
+  int32_t const size = az_span_size(source);
+  uint8_t const* const source_ptr = az_span_ptr(source);
+  if (size < 1 || (size_t)size >= sizeof(buffer)
+      || !(isdigit(source_ptr[0]) || source_ptr[0] == '+' || source_ptr[0] == '-'))
+  {
+    return 1;
+  }
+  memcpy(buffer, source_ptr, (size_t)size);
+  buffer[size] = '\0';
+
+  // Same format as the previous implementation: "%<size>lf%n".
+  char format[16];
+  (void)snprintf(format, sizeof(format), "%%%dlf%%n", (int)size);
+  int chars_consumed = 0;
+  int const n = sscanf(buffer, format, out_number, &chars_consumed);
+  return (n == 1 && chars_consumed == size && isfinite(*out_number)) ? 0 : 1;
+}
+
+typedef int (*parse_function)(az_span source, double* out_number);
+
+static int native_atod(az_span source, double* out_number)
+{
+  return az_result_succeeded(az_span_atod(source, out_number)) ? 0 : 1;
+}
+
+static double measure(parse_function parse, az_span const* numbers, int count)
+{
+  long iterations = 0;
+  volatile double sink = 0;
+  clock_t const start = clock();
+  clock_t elapsed = 0;
+  do
+  {
+    for (int i = 0; i < 256; i++)
+    {
+      for (int j = 0; j < count; j++)
+      {
+        double value = 0;
+        (void)parse(numbers[j], &value);
+        sink += value;
+      }
+    }
+    iterations += 256;
+    elapsed = clock() - start;
+  } while ((double)elapsed < MEASUREMENT_SECONDS * CLOCKS_PER_SEC);
+
+  (void)sink;
+  return (double)elapsed / CLOCKS_PER_SEC * 1e9 / ((double)iterations * count);
+}
+
+static int run(char const* name, char** texts, int count)
+{
+  az_span numbers[32];
+  for (int i = 0; i < count; i++)
+  {
+    numbers[i] = az_span_create_from_str(texts[i]);
+
+    double native = 0;
+    double reference = 0;
+    if (native_atod(numbers[i], &native) != 0 || reference_atod(numbers[i], &reference) != 0
+        || memcmp(&native, &reference, sizeof(native)) != 0)
+    {
+      printf("%s: %s parses differently\n", name, texts[i]);
+      return 1;
+    }
+  }
+
+  double const native_ns = measure(native_atod, numbers, count);
+  double const reference_ns = measure(reference_atod, numbers, count);
+  printf(
+      "%-16s az_span_atod %7.1f ns  sscanf %7.1f ns  %5.1fx\n",
+      name,
+      native_ns,
+      reference_ns,
+      reference_ns / native_ns);
+  return 0;
+}
+
+int main(void)
+{
+  int failures = 0;
+  failures += run(
+      "telemetry",
+      telemetry_numbers,
+      (int)(sizeof(telemetry_numbers) / sizeof(telemetry_numbers[0])));
+  failures += run(
+      "full precision",
+      full_precision_numbers,
+      (int)(sizeof(full_precision_numbers) / sizeof(full_precision_numbers[0])));
+  failures += run("hard", hard_numbers, (int)(sizeof(hard_numbers) / sizeof(hard_numbers[0])));
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
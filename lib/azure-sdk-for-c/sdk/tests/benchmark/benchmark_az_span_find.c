@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief Measures az_span_find against the previous byte-by-byte search.
+ *
+ * @details The topic searches are the ones the IoT clients make for each received message. The
+ * adversarial searches make a byte-by-byte search compare almost the whole target at every
+ * position. Each set is searched repeatedly for a fixed amount of processor time and the result is
+ * printed in nanoseconds per search, after checking both implementations find the same positions.
+ */
+
+#include <azure/core/az_span.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <azure/core/_az_cfg.h>
+
+#define MEASUREMENT_SECONDS 1.0
+#define ADVERSARIAL_SIZE 4096
+
+typedef struct
+{
+  char* source;
+  char* target;
+} search;
+
+// Received topics and the prefixes, suffixes and properties the hub and provisioning clients look
+// for in them.
+static search topic_searches[] = {
+  { "$iothub/twin/res/200/?$rid=1&$version=27", "$iothub/twin/" },
+  { "res/200/?$rid=1&$version=27", "res/" },
+  { "$iothub/twin/PATCH/properties/desired/?$version=28", "$iothub/twin/" },
+  { "PATCH/properties/desired/?$version=28", "res/" },
+  { "PATCH/properties/desired/?$version=28", "PATCH/properties/desired/" },
+  { "$iothub/methods/POST/setWateringSchedule/?$rid=5", "$iothub/methods/POST/" },
+  { "setWateringSchedule/?$rid=5", "/" },
+  { "/?$rid=5", "?$rid=" },
+  { "$dps/registrations/res/202/?$rid=1&retry-after=3&operationId=4.d0a671905ea5b2c8.e7173b7b",
+    "$dps/registrations/res/" },
+  { "202/?$rid=1&retry-after=3&operationId=4.d0a671905ea5b2c8.e7173b7b", "retry-after=" },
+  { "devices/aquabotanica-01/messages/devicebound/%24.to=%2Fdevices&iothub-ack=full",
+    "devices/aquabotanica-01/messages/devicebound/" },
+};
+
+static uint8_t adversarial_sources[3][ADVERSARIAL_SIZE];
+static uint8_t adversarial_targets[3][64];
+
+static int32_t reference_find(az_span source, az_span target)
+{
+  int32_t const source_size = az_span_size(source);
+  int32_t const target_size = az_span_size(target);
+  for (int32_t i = 0; i <= source_size - target_size; i++)
+  {
+    int32_t j = 0;
+    while (j < target_size && az_span_ptr(source)[i + j] == az_span_ptr(target)[j])
+    {
+      j++;
+    }
+    if (j == target_size)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+typedef int32_t (*find_function)(az_span source, az_span target);
+
+static double measure(find_function find, az_span const* sources, az_span const* targets, int count)
+{
+  long iterations = 0;
+  volatile int32_t sink = 0;
+  clock_t const start = clock();
+  clock_t elapsed = 0;
+  do
+  {
+    for (int i = 0; i < 16; i++)
+    {
+      for (int j = 0; j < count; j++)
+      {
+        sink += find(sources[j], targets[j]);
+      }
+    }
+    iterations += 16;
+    elapsed = clock() - start;
+  } while ((double)elapsed < MEASUREMENT_SECONDS * CLOCKS_PER_SEC);
+
+  (void)sink;
+  return (double)elapsed / CLOCKS_PER_SEC * 1e9 / ((double)iterations * count);
+}
+
+static int run(char const* name, az_span const* sources, az_span const* targets, int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    if (az_span_find(sources[i], targets[i]) != reference_find(sources[i], targets[i]))
+    {
+      printf("%s: search %d finds a different position\n", name, i);
+      return 1;
+    }
+  }
+
+  double const find_ns = measure(az_span_find, sources, targets, count);
+  double const reference_ns = measure(reference_find, sources, targets, count);
+  printf(
+      "%-16s az_span_find %9.1f ns  byte by byte %9.1f ns  %6.1fx\n",
+      name,
+      find_ns,
+      reference_ns,
+      reference_ns / find_ns);
+  return 0;
+}
+
+int main(void)
+{
+  int failures = 0;
+
+  int const topic_count = (int)(sizeof(topic_searches) / sizeof(topic_searches[0]));
+  az_span topic_sources[sizeof(topic_searches) / sizeof(topic_searches[0])];
+  az_span topic_targets[sizeof(topic_searches) / sizeof(topic_searches[0])];
+  for (int i = 0; i < topic_count; i++)
+  {
+    topic_sources[i] = az_span_create_from_str(topic_searches[i].source);
+    topic_targets[i] = az_span_create_from_str(topic_searches[i].target);
+  }
+  failures += run("topics", topic_sources, topic_targets, topic_count);
+
+  // "aaaa...a" for "aa...ab", "abab...ab" for "abab...aa" and "aaaa...a" for "a...aba...a".
+  az_span adversarial_source_spans[3];
+  az_span adversarial_target_spans[3];
+  memset(adversarial_sources[0], 'a', ADVERSARIAL_SIZE);
+  memset(adversarial_targets[0], 'a', 64);
+  adversarial_targets[0][63] = 'b';
+  for (int i = 0; i < ADVERSARIAL_SIZE; i++)
+  {
+    adversarial_sources[1][i] = (uint8_t)(i % 2 == 0 ? 'a' : 'b');
+  }
+  for (int i = 0; i < 64; i++)
+  {
+    adversarial_targets[1][i] = (uint8_t)(i % 2 == 0 ? 'a' : 'b');
+  }
+  adversarial_targets[1][63] = 'a';
+  memset(adversarial_sources[2], 'a', ADVERSARIAL_SIZE);
+  memset(adversarial_targets[2], 'a', 64);
+  adversarial_targets[2][32] = 'b';
+  for (int i = 0; i < 3; i++)
+  {
+    adversarial_source_spans[i] = AZ_SPAN_FROM_BUFFER(adversarial_sources[i]);
+    adversarial_target_spans[i] = AZ_SPAN_FROM_BUFFER(adversarial_targets[i]);
+  }
+  failures += run("adversarial", adversarial_source_spans, adversarial_target_spans, 3);
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
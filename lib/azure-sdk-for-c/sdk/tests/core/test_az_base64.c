@@ -3,9 +3,11 @@
 
 #include "az_test_definitions.h"
 #include <azure/core/az_base64.h>
+#include <azure/core/internal/az_result_internal.h>
 
 #include <setjmp.h>
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stddef.h>
 
 #include <cmocka.h>
@@ -446,6 +448,31 @@ static void az_base64_url_decode_destination_small_test(void** state)
       az_base64_url_decode(az_span_slice(destination, 0, 3), source, &bytes_written),
       AZ_ERROR_NOT_ENOUGH_SPACE);
   assert_int_equal(bytes_written, 10);
+
+  // Invalid characters take precedence over a destination that is too small.
+  source = AZ_SPAN_FROM_STR("AQIDBA");
+  assert_int_equal(
+      az_base64_url_decode(az_span_slice(destination, 0, 1), source, &bytes_written),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(bytes_written, 10);
+
+  source = AZ_SPAN_FROM_STR("AQ!DBA");
+  assert_int_equal(
+      az_base64_url_decode(az_span_slice(destination, 0, 1), source, &bytes_written),
+      AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(bytes_written, 10);
+
+  source = AZ_SPAN_FROM_STR("AQIDB!");
+  assert_int_equal(
+      az_base64_url_decode(az_span_slice(destination, 0, 1), source, &bytes_written),
+      AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(bytes_written, 10);
+
+  source = AZ_SPAN_FROM_STR("AQIDBA!");
+  assert_int_equal(
+      az_base64_url_decode(az_span_slice(destination, 0, 2), source, &bytes_written),
+      AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(bytes_written, 10);
 }
 
 static void az_base64_url_decode_source_small_test(void** state)
@@ -548,6 +575,312 @@ static void az_base64_url_decode_invalid_test(void** state)
   assert_int_equal(bytes_written, 0);
 }
 
+// Lengths up to a few hundred bytes go through every vectorized and unrolled loop and their tails.
+static void az_base64_long_round_trip_test(void** state)
+{
+  (void)state;
+
+  uint8_t bytes[200];
+  uint32_t random = 2463534242u;
+  for (int32_t i = 0; i < (int32_t)sizeof(bytes); i++)
+  {
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    bytes[i] = (uint8_t)random;
+  }
+
+  char const alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  for (int32_t length = 1; length <= (int32_t)sizeof(bytes); length++)
+  {
+    uint8_t text_buffer[268];
+    int32_t text_length = 0;
+    assert_int_equal(
+        az_base64_encode(
+            AZ_SPAN_FROM_BUFFER(text_buffer), az_span_create(bytes, length), &text_length),
+        AZ_OK);
+    assert_int_equal(text_length, az_base64_get_max_encoded_size(length));
+
+    for (int32_t i = 0; i < length / 3; i++)
+    {
+      uint32_t const group = ((uint32_t)bytes[i * 3] << 16) | ((uint32_t)bytes[i * 3 + 1] << 8)
+          | bytes[i * 3 + 2];
+      assert_int_equal(text_buffer[i * 4], alphabet[group >> 18]);
+      assert_int_equal(text_buffer[i * 4 + 1], alphabet[(group >> 12) & 0x3F]);
+      assert_int_equal(text_buffer[i * 4 + 2], alphabet[(group >> 6) & 0x3F]);
+      assert_int_equal(text_buffer[i * 4 + 3], alphabet[group & 0x3F]);
+    }
+
+    uint8_t decoded[200];
+    int32_t decoded_length = 0;
+    assert_int_equal(
+        az_base64_decode(
+            AZ_SPAN_FROM_BUFFER(decoded),
+            az_span_create(text_buffer, text_length),
+            &decoded_length),
+        AZ_OK);
+    assert_int_equal(decoded_length, length);
+    assert_memory_equal(decoded, bytes, (size_t)length);
+
+    // A single character outside of the alphabet is found wherever it is.
+    for (int32_t i = 0; i < text_length; i += 5)
+    {
+      uint8_t const original = text_buffer[i];
+      if (original == '=')
+      {
+        continue;
+      }
+      text_buffer[i] = (uint8_t)(i % 2 == 0 ? '-' : 0xC3);
+      assert_int_equal(
+          az_base64_decode(
+              AZ_SPAN_FROM_BUFFER(decoded),
+              az_span_create(text_buffer, text_length),
+              &decoded_length),
+          AZ_ERROR_UNEXPECTED_CHAR);
+      text_buffer[i] = original;
+    }
+  }
+}
+
+static void az_base64_encoder_test(void** state)
+{
+  (void)state;
+
+  uint8_t input_buffer[10] = { 23, 51, 61, 250, 131, 184, 127, 228, 250, 66 };
+
+  // Every way of splitting the input into three pieces gives the one-shot result.
+  for (int32_t first = 0; first <= 10; first++)
+  {
+    for (int32_t second = first; second <= 10; second++)
+    {
+      uint8_t destination_buffer[16];
+      az_span destination = AZ_SPAN_FROM_BUFFER(destination_buffer);
+      int32_t pieces[4] = { 0, first, second, 10 };
+
+      az_base64_encoder encoder;
+      az_base64_encoder_init(&encoder);
+      int32_t total = 0;
+      for (int32_t i = 0; i < 3; i++)
+      {
+        int32_t bytes_written = -1;
+        assert_int_equal(
+            az_base64_encoder_update(
+                &encoder,
+                az_span_slice_to_end(destination, total),
+                az_span_create(input_buffer + pieces[i], pieces[i + 1] - pieces[i]),
+                &bytes_written),
+            AZ_OK);
+        total += bytes_written;
+      }
+      int32_t bytes_written = -1;
+      assert_int_equal(
+          az_base64_encoder_final(
+              &encoder, az_span_slice_to_end(destination, total), &bytes_written),
+          AZ_OK);
+      total += bytes_written;
+
+      char actual[17];
+      az_span_to_str(actual, 17, az_span_slice(destination, 0, total));
+      assert_string_equal(actual, "FzM9+oO4f+T6Qg==");
+    }
+  }
+}
+
+static void az_base64_encoder_destination_small_test(void** state)
+{
+  (void)state;
+
+  uint8_t input_buffer[7] = { 1, 2, 3, 4, 5, 6, 7 };
+  uint8_t destination_buffer[12];
+  az_span destination = AZ_SPAN_FROM_BUFFER(destination_buffer);
+
+  az_base64_encoder encoder;
+  az_base64_encoder_init(&encoder);
+
+  int32_t bytes_written = 0;
+  assert_int_equal(
+      az_base64_encoder_update(
+          &encoder, destination, az_span_create(input_buffer, 2), &bytes_written),
+      AZ_OK);
+  assert_int_equal(bytes_written, 0);
+
+  // Nothing is consumed when the destination is too small.
+  assert_int_equal(
+      az_base64_encoder_update(
+          &encoder,
+          az_span_slice(destination, 0, 7),
+          az_span_create(input_buffer + 2, 5),
+          &bytes_written),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(bytes_written, 0);
+
+  assert_int_equal(
+      az_base64_encoder_update(
+          &encoder, destination, az_span_create(input_buffer + 2, 5), &bytes_written),
+      AZ_OK);
+  assert_int_equal(bytes_written, 8);
+
+  assert_int_equal(
+      az_base64_encoder_final(&encoder, az_span_slice(destination, 8, 11), &bytes_written),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(bytes_written, 8);
+
+  assert_int_equal(
+      az_base64_encoder_final(&encoder, az_span_slice_to_end(destination, 8), &bytes_written),
+      AZ_OK);
+  assert_int_equal(bytes_written, 4);
+
+  char actual[13];
+  az_span_to_str(actual, 13, destination);
+  assert_string_equal(actual, "AQIDBAUGBw==");
+
+  // The encoder starts over after the final call.
+  assert_int_equal(az_base64_encoder_final(&encoder, destination, &bytes_written), AZ_OK);
+  assert_int_equal(bytes_written, 0);
+}
+
+static az_result _az_base64_decoder_test_helper(
+    bool url,
+    az_span source,
+    int32_t first,
+    int32_t second,
+    az_span destination,
+    int32_t* out_written)
+{
+  az_base64_decoder decoder;
+  if (url)
+  {
+    az_base64_url_decoder_init(&decoder);
+  }
+  else
+  {
+    az_base64_decoder_init(&decoder);
+  }
+
+  int32_t pieces[4] = { 0, first, second, az_span_size(source) };
+  int32_t total = 0;
+  for (int32_t i = 0; i < 3; i++)
+  {
+    int32_t bytes_written = 0;
+    _az_RETURN_IF_FAILED(az_base64_decoder_update(
+        &decoder,
+        az_span_slice_to_end(destination, total),
+        az_span_slice(source, pieces[i], pieces[i + 1]),
+        &bytes_written));
+    total += bytes_written;
+  }
+
+  int32_t bytes_written = 0;
+  _az_RETURN_IF_FAILED(
+      az_base64_decoder_final(&decoder, az_span_slice_to_end(destination, total), &bytes_written));
+  *out_written = total + bytes_written;
+  return AZ_OK;
+}
+
+// Every way of splitting the text into three pieces gives the one-shot result.
+static void _az_base64_decoder_test_all_splits(bool url, az_span source, az_result expected_result)
+{
+  uint8_t expected_buffer[16];
+  int32_t expected_written = 0;
+  assert_int_equal(
+      url ? az_base64_url_decode(AZ_SPAN_FROM_BUFFER(expected_buffer), source, &expected_written)
+          : az_base64_decode(AZ_SPAN_FROM_BUFFER(expected_buffer), source, &expected_written),
+      expected_result);
+
+  int32_t const size = az_span_size(source);
+  for (int32_t first = 0; first <= size; first++)
+  {
+    for (int32_t second = first; second <= size; second++)
+    {
+      uint8_t destination_buffer[16];
+      int32_t bytes_written = -1;
+      az_result const result = _az_base64_decoder_test_helper(
+          url, source, first, second, AZ_SPAN_FROM_BUFFER(destination_buffer), &bytes_written);
+      assert_int_equal(result, expected_result);
+      if (az_result_succeeded(result))
+      {
+        assert_int_equal(bytes_written, expected_written);
+        assert_memory_equal(destination_buffer, expected_buffer, (size_t)expected_written);
+      }
+    }
+  }
+}
+
+static void az_base64_decoder_test(void** state)
+{
+  (void)state;
+
+  _az_base64_decoder_test_all_splits(false, AZ_SPAN_FROM_STR("AQ=="), AZ_OK);
+  _az_base64_decoder_test_all_splits(false, AZ_SPAN_FROM_STR("AQI="), AZ_OK);
+  _az_base64_decoder_test_all_splits(false, AZ_SPAN_FROM_STR("AQID"), AZ_OK);
+  _az_base64_decoder_test_all_splits(false, AZ_SPAN_FROM_STR("AQIDBAUGBw=="), AZ_OK);
+  _az_base64_decoder_test_all_splits(false, AZ_SPAN_FROM_STR("FzM9+oO4f+T6Qg=="), AZ_OK);
+
+  _az_base64_decoder_test_all_splits(
+      false, AZ_SPAN_FROM_STR("FzM9+oO4f-T6Qg=="), AZ_ERROR_UNEXPECTED_CHAR);
+  _az_base64_decoder_test_all_splits(false, AZ_SPAN_FROM_STR("AQ=A"), AZ_ERROR_UNEXPECTED_CHAR);
+  _az_base64_decoder_test_all_splits(
+      false, AZ_SPAN_FROM_STR("AQ==AQID"), AZ_ERROR_UNEXPECTED_CHAR);
+  _az_base64_decoder_test_all_splits(false, AZ_SPAN_FROM_STR("AQIDBA"), AZ_ERROR_UNEXPECTED_END);
+}
+
+static void az_base64_url_decoder_test(void** state)
+{
+  (void)state;
+
+  _az_base64_decoder_test_all_splits(true, AZ_SPAN_FROM_STR("AQ"), AZ_OK);
+  _az_base64_decoder_test_all_splits(true, AZ_SPAN_FROM_STR("AQI"), AZ_OK);
+  _az_base64_decoder_test_all_splits(true, AZ_SPAN_FROM_STR("AQI="), AZ_OK);
+  _az_base64_decoder_test_all_splits(true, AZ_SPAN_FROM_STR("AQIDBAUGBw"), AZ_OK);
+  _az_base64_decoder_test_all_splits(true, AZ_SPAN_FROM_STR("-AEC_AME"), AZ_OK);
+  _az_base64_decoder_test_all_splits(true, AZ_SPAN_FROM_STR("FzM9-oO4f-T6Qg"), AZ_OK);
+
+  _az_base64_decoder_test_all_splits(
+      true, AZ_SPAN_FROM_STR("FzM9+oO4f-T6Qg"), AZ_ERROR_UNEXPECTED_CHAR);
+  _az_base64_decoder_test_all_splits(true, AZ_SPAN_FROM_STR("-AEC_A/E"), AZ_ERROR_UNEXPECTED_CHAR);
+  _az_base64_decoder_test_all_splits(true, AZ_SPAN_FROM_STR("AQIDB"), AZ_ERROR_UNEXPECTED_END);
+}
+
+static void az_base64_decoder_destination_small_test(void** state)
+{
+  (void)state;
+
+  uint8_t destination_buffer[7];
+  az_span destination = AZ_SPAN_FROM_BUFFER(destination_buffer);
+
+  az_base64_decoder decoder;
+  az_base64_decoder_init(&decoder);
+
+  int32_t bytes_written = 0;
+  assert_int_equal(
+      az_base64_decoder_final(&decoder, destination, &bytes_written), AZ_ERROR_UNEXPECTED_END);
+
+  assert_int_equal(
+      az_base64_decoder_update(&decoder, destination, AZ_SPAN_FROM_STR("AQ"), &bytes_written),
+      AZ_OK);
+  assert_int_equal(bytes_written, 0);
+
+  // Nothing is consumed when the destination is too small: "AQIDBAUGBw==" decodes to 7 bytes.
+  assert_int_equal(
+      az_base64_decoder_update(
+          &decoder,
+          az_span_slice(destination, 0, 6),
+          AZ_SPAN_FROM_STR("IDBAUGBw=="),
+          &bytes_written),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(bytes_written, 0);
+
+  assert_int_equal(
+      az_base64_decoder_update(
+          &decoder, destination, AZ_SPAN_FROM_STR("IDBAUGBw=="), &bytes_written),
+      AZ_OK);
+  assert_int_equal(bytes_written, 7);
+  assert_memory_equal(destination_buffer, ((uint8_t[]){ 1, 2, 3, 4, 5, 6, 7 }), 7);
+
+  assert_int_equal(az_base64_decoder_final(&decoder, destination, &bytes_written), AZ_OK);
+  assert_int_equal(bytes_written, 0);
+}
+
 int test_az_base64()
 {
   const struct CMUnitTest tests[] = {
@@ -563,6 +896,12 @@ int test_az_base64()
     cmocka_unit_test(az_base64_url_decode_destination_small_test),
     cmocka_unit_test(az_base64_url_decode_source_small_test),
     cmocka_unit_test(az_base64_url_decode_invalid_test),
+    cmocka_unit_test(az_base64_long_round_trip_test),
+    cmocka_unit_test(az_base64_encoder_test),
+    cmocka_unit_test(az_base64_encoder_destination_small_test),
+    cmocka_unit_test(az_base64_decoder_test),
+    cmocka_unit_test(az_base64_url_decoder_test),
+    cmocka_unit_test(az_base64_decoder_destination_small_test),
   };
   return cmocka_run_group_tests_name("az_core_base64", tests, NULL, NULL);
 }
@@ -262,6 +262,35 @@ static void test_json_writer(void** state)
       assert_string_equal(array, "0");
     }
   }
+  {
+    uint8_t array[200] = { 0 };
+    az_json_writer writer = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 23.5));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 0.1));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, -0.0));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 1e-300));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 1e21));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 9007199254740993.0 * 4));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, -1.0 / 3.0));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+
+    az_span_to_str((char*)array, 200, az_json_writer_get_bytes_used_in_destination(&writer));
+    assert_string_equal(
+        array, "[23.5,0.1,-0,1e-300,1e21,36028797018963970,-0.3333333333333333]");
+  }
+  {
+    // The writer needs room for the longest possible number, plus the comma.
+    uint8_t array[26] = { 0 };
+    az_json_writer writer = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 1.5));
+    assert_int_equal(
+        az_json_writer_append_double_shortest(&writer, 2.5), AZ_ERROR_NOT_ENOUGH_SPACE);
+  }
   {
     // json with AZ_JSON_TOKEN_STRING
     uint8_t array[200] = { 0 };
@@ -2981,6 +3010,171 @@ static void test_az_json_reader_chunked(void** state)
   assert_true(az_span_is_content_equal(expected, az_span_create_from_str(m.name_string)));
 }
 
+// Byte-at-a-time reference for the string scanner: the number of bytes up to the closing '"' and
+// whether an escape was seen, -1 if a control character comes first or -2 if the input ends.
+static int32_t _az_json_reference_string_length(
+    uint8_t const* content,
+    int32_t size,
+    bool* out_escaped)
+{
+  *out_escaped = false;
+  for (int32_t i = 0; i < size; i++)
+  {
+    if (content[i] == '"')
+    {
+      return i;
+    }
+    if (content[i] == '\\')
+    {
+      *out_escaped = true;
+      i++;
+    }
+    else if (content[i] < ' ')
+    {
+      return -1;
+    }
+  }
+  return -2;
+}
+
+static void _az_json_check_string_token(
+    az_span* buffers,
+    int32_t number_of_buffers,
+    uint8_t const* content,
+    int32_t content_size)
+{
+  bool expected_escaped = false;
+  int32_t const expected_length
+      = _az_json_reference_string_length(content, content_size, &expected_escaped);
+
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, number_of_buffers, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_BEGIN_ARRAY);
+
+  az_result const result = az_json_reader_next_token(&reader);
+  if (expected_length < 0)
+  {
+    assert_int_equal(
+        result, expected_length == -1 ? AZ_ERROR_UNEXPECTED_CHAR : AZ_ERROR_UNEXPECTED_END);
+    return;
+  }
+  assert_int_equal(result, AZ_OK);
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_STRING);
+  assert_int_equal(reader.token.size, expected_length);
+  assert_true(reader.token._internal.string_has_escaped_chars == expected_escaped);
+  assert_true(az_json_token_is_text_equal(
+                  &reader.token, az_span_create((uint8_t*)(uintptr_t)content, expected_length))
+              || expected_escaped);
+}
+
+static void test_az_json_reader_string_scanning(void** state)
+{
+  (void)state;
+
+  // Bytes that end the fast path inside a string, plus the bytes right around the limits.
+  uint8_t const specials[]
+      = { '"', '\\', 0x00, 0x01, '\n', 0x1F, ' ', '!', '#', '[', ']', 0x7F, 0x80, 0xFF };
+  uint8_t json[64] = { 0 };
+  uint32_t random = 12345;
+
+  for (int32_t length = 0; length <= 40; length++)
+  {
+    for (int32_t position = 0; position <= length; position++)
+    {
+      for (size_t s = 0; s < sizeof(specials); s++)
+      {
+        // [ "<length ordinary bytes with one special byte>" ]
+        json[0] = '[';
+        json[1] = '"';
+        uint8_t* content = json + 2;
+        for (int32_t i = 0; i < length; i++)
+        {
+          random = random * 1103515245 + 12345;
+          uint8_t c = (uint8_t)(' ' + (random >> 16) % (256 - ' '));
+          content[i] = (c == '"' || c == '\\') ? 'a' : c;
+        }
+        content[length] = '"';
+        content[length + 1] = ']';
+        int32_t const json_size = length + 4;
+
+        if (position < length)
+        {
+          content[position] = specials[s];
+          if (specials[s] == '\\')
+          {
+            // Keep the escape valid; it may also escape the closing quote and run into ']'.
+            content[position + 1] = position + 1 < length ? 'n' : '"';
+          }
+        }
+        az_span whole = az_span_create(json, json_size);
+        _az_json_check_string_token(&whole, 1, content, json_size - 2);
+
+        // Every split into two segments, so runs end at segment boundaries too.
+        for (int32_t split = 1; split < json_size; split++)
+        {
+          az_span halves[2]
+              = { az_span_slice(whole, 0, split), az_span_slice_to_end(whole, split) };
+          _az_json_check_string_token(halves, 2, content, json_size - 2);
+        }
+      }
+    }
+  }
+}
+
+static void test_az_json_reader_whitespace_scanning(void** state)
+{
+  (void)state;
+
+  uint8_t const whitespace[] = { ' ', '\t', '\n', '\r' };
+  uint8_t const others[] = { 'x', 0x00, 0x0B, 0x0C, 0x1F, '!', 0xA0 };
+  uint8_t json[96] = { 0 };
+
+  for (int32_t length = 0; length <= 40; length++)
+  {
+    for (int32_t position = -1; position < length; position++)
+    {
+      for (size_t o = 0; o < sizeof(others); o++)
+      {
+        // <length whitespace bytes, one of them possibly replaced>true<length whitespace bytes>
+        for (int32_t i = 0; i < length; i++)
+        {
+          json[i] = whitespace[(size_t)(i * 7 + length) % sizeof(whitespace)];
+          json[length + 4 + i] = whitespace[(size_t)(i * 3 + length) % sizeof(whitespace)];
+        }
+        memcpy(json + length, "true", 4);
+        if (position >= 0)
+        {
+          json[position] = others[o];
+        }
+        int32_t const json_size = length * 2 + 4;
+        az_span whole = az_span_create(json, json_size);
+
+        for (int32_t split = 0; split < json_size; split++)
+        {
+          az_span halves[2]
+              = { az_span_slice(whole, 0, split), az_span_slice_to_end(whole, split) };
+          az_span* buffers = split == 0 ? &whole : halves;
+
+          az_json_reader reader = { 0 };
+          TEST_EXPECT_SUCCESS(
+              az_json_reader_chunked_init(&reader, buffers, split == 0 ? 1 : 2, NULL));
+          az_result const result = az_json_reader_next_token(&reader);
+          if (position >= 0)
+          {
+            assert_int_equal(result, AZ_ERROR_UNEXPECTED_CHAR);
+            continue;
+          }
+          assert_int_equal(result, AZ_OK);
+          assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_TRUE);
+          assert_int_equal(reader._internal.total_bytes_consumed, length + 4);
+          assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_DONE);
+        }
+      }
+    }
+  }
+}
+
 static void _az_span_free(az_span* p)
 {
   if (p == NULL)
@@ -3250,6 +3444,8 @@ int test_az_json()
           cmocka_unit_test(test_az_json_token_literal),
           cmocka_unit_test(test_az_json_token_copy),
           cmocka_unit_test(test_az_json_reader_chunked),
+          cmocka_unit_test(test_az_json_reader_string_scanning),
+          cmocka_unit_test(test_az_json_reader_whitespace_scanning),
           cmocka_unit_test(test_az_json_string_unescape),
           cmocka_unit_test(test_az_json_string_unescape_same_buffer) };
   return cmocka_run_group_tests_name("az_core_json", tests, NULL, NULL);
@@ -14,6 +14,9 @@
 #include <math.h>
 #include <setjmp.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <cmocka.h>
 
@@ -187,6 +190,9 @@ static void az_span_atox_return_errors(void** state)
   AZ_SPAN_ATOX_RETURN_ERRORS_HELPER(AZ_SPAN_FROM_STR("+ 1"));
   AZ_SPAN_ATOX_RETURN_ERRORS_HELPER(AZ_SPAN_FROM_STR("1.-e3"));
   AZ_SPAN_ATOX_RETURN_ERRORS_HELPER(AZ_SPAN_FROM_STR("1.-e/3"));
+  AZ_SPAN_ATOX_RETURN_ERRORS_HELPER(AZ_SPAN_FROM_STR("1e"));
+  AZ_SPAN_ATOX_RETURN_ERRORS_HELPER(AZ_SPAN_FROM_STR("1e-"));
+  AZ_SPAN_ATOX_RETURN_ERRORS_HELPER(AZ_SPAN_FROM_STR("0x1p3"));
   az_SPAN_ATOX_RETURN_ERRORS_HELPER_EXCLUDE_DOUBLE(AZ_SPAN_FROM_STR("1.23"));
   az_SPAN_ATOX_RETURN_ERRORS_HELPER_EXCLUDE_DOUBLE(AZ_SPAN_FROM_STR("-1.23"));
   az_SPAN_ATOX_RETURN_ERRORS_HELPER_EXCLUDE_DOUBLE(AZ_SPAN_FROM_STR("11e2"));
@@ -646,6 +652,157 @@ static void az_span_atod_test(void** state)
 #pragma clang diagnostic pop
 #endif // __clang__
 
+static uint64_t _az_span_test_double_bits(double value)
+{
+  uint64_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static void az_span_atod_correctly_rounded(void** state)
+{
+  (void)state;
+
+  // Halfway cases, long mantissas, subnormals and the edges of the double range, which need more
+  // than the fast path. The expected values are the IEEE 754 bit patterns.
+  struct
+  {
+    char* text;
+    uint64_t bits;
+  } const cases[] = {
+    { "9007199254740993", 0x4340000000000000ULL },
+    { "9007199254740995", 0x4340000000000002ULL },
+    { "9007199254740993.0000000001", 0x4340000000000001ULL },
+    { "2.2250738585072011e-308", 0x000FFFFFFFFFFFFFULL },
+    { "2.2250738585072012e-308", 0x0010000000000000ULL },
+    { "4.9406564584124654e-324", 0x0000000000000001ULL },
+    { "2.4703282292062327e-324", 0x0000000000000000ULL },
+    { "2.4703282292062328e-324", 0x0000000000000001ULL },
+    { "1.7976931348623157e308", 0x7FEFFFFFFFFFFFFFULL },
+    { "1.7976931348623158e308", 0x7FEFFFFFFFFFFFFFULL },
+    { "0.1", 0x3FB999999999999AULL },
+    { "1e23", 0x44B52D02C7E14AF6ULL },
+    { "8.98846567431158e307", 0x7FE0000000000000ULL },
+    { "0.500000000000000166533453693773481063544750213623046875", 0x3FE0000000000002ULL },
+    { "4.35569952e-316", 0x0000000005413854ULL },
+    { "3.0540316846723264e-319", 0x000000000000F176ULL },
+    { "123456789012345678901234567890e-10", 0x43E56A95319D63E1ULL },
+    { "7.3177701707893310e+15", 0x4339FF792393EDD3ULL },
+    { "2.225073858507201136057409796709131975934819546351645648e-308", 0x000FFFFFFFFFFFFFULL },
+    { "1.00000000000000011102230246251565404236316680908203125", 0x3FF0000000000000ULL },
+    { "1.00000000000000011102230246251565404236316680908203124", 0x3FF0000000000000ULL },
+    { "1.00000000000000011102230246251565404236316680908203126", 0x3FF0000000000001ULL },
+    { "-0", 0x8000000000000000ULL },
+    { "-.5", 0xBFE0000000000000ULL },
+    { "1e-99999", 0x0000000000000000ULL },
+    { "0e99999", 0x0000000000000000ULL },
+  };
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+  {
+    double value = 0;
+    assert_int_equal(az_span_atod(az_span_create_from_str(cases[i].text), &value), AZ_OK);
+    assert_true(_az_span_test_double_bits(value) == cases[i].bits);
+  }
+
+  double value = 0;
+  assert_int_equal(
+      az_span_atod(AZ_SPAN_FROM_STR("1.7976931348623159e308"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1e99999"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("0x10"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1e"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1e+"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1.5e-"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1.2.3"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("+.e1"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+}
+
+static void az_span_atod_round_trip(void** state)
+{
+  (void)state;
+
+  // Random bit patterns, covering subnormals and every exponent. 17 significant digits always
+  // identify a double; shorter forms must give the same result as the C library.
+  uint64_t random = 0x9E3779B97F4A7C15ULL;
+  char buffer[64] = { 0 };
+
+  for (int32_t i = 0; i < 200000; i++)
+  {
+    random ^= random << 13;
+    random ^= random >> 7;
+    random ^= random << 17;
+
+    double original = 0;
+    memcpy(&original, &random, sizeof(original));
+    if (!_az_isfinite(original))
+    {
+      continue;
+    }
+
+    for (int precision = 17; precision >= 1; precision -= 4)
+    {
+      int const length = snprintf(buffer, sizeof(buffer), "%.*g", precision, original);
+      double value = 0;
+      double const expected = strtod(buffer, NULL);
+      az_result const result
+          = az_span_atod(az_span_create((uint8_t*)buffer, (int32_t)length), &value);
+      if (!_az_isfinite(expected))
+      {
+        // Rounding to fewer digits can push the largest doubles out of range, e.g. "2e+308".
+        assert_int_equal(result, AZ_ERROR_UNEXPECTED_CHAR);
+        continue;
+      }
+      assert_int_equal(result, AZ_OK);
+      assert_true(_az_span_test_double_bits(value) == _az_span_test_double_bits(expected));
+      if (precision == 17)
+      {
+        assert_true(_az_span_test_double_bits(value) == random);
+      }
+    }
+  }
+
+  // Random decimal strings, including more digits than a double holds and exponents near the
+  // limits of the range.
+  for (int32_t i = 0; i < 200000; i++)
+  {
+    int32_t length = 0;
+    random ^= random << 13;
+    random ^= random >> 7;
+    random ^= random << 17;
+
+    uint64_t digits = random;
+    int32_t const digit_count = 1 + (int32_t)(random % 40);
+    int32_t const dot_position = (int32_t)((random >> 8) % (uint64_t)(digit_count + 1));
+    for (int32_t d = 0; d < digit_count; d++)
+    {
+      if (d == dot_position && d > 0)
+      {
+        buffer[length++] = '.';
+      }
+      buffer[length++] = (char)('0' + digits % 10);
+      digits = digits / 10 == 0 ? random * 31 + (uint64_t)d : digits / 10;
+    }
+    length += snprintf(
+        buffer + length,
+        sizeof(buffer) - (size_t)length,
+        "e%d",
+        (int)((random >> 16) % 660) - 340 - digit_count);
+
+    double value = 0;
+    double const expected = strtod(buffer, NULL);
+    az_result const result = az_span_atod(az_span_create((uint8_t*)buffer, length), &value);
+    if (_az_isfinite(expected))
+    {
+      assert_int_equal(result, AZ_OK);
+      assert_true(_az_span_test_double_bits(value) == _az_span_test_double_bits(expected));
+    }
+    else
+    {
+      assert_int_equal(result, AZ_ERROR_UNEXPECTED_CHAR);
+    }
+  }
+}
+
 static void az_span_atod_non_finite_not_allowed(void** state)
 {
   (void)state;
@@ -934,6 +1091,109 @@ static void az_span_find_overlapping_checks_success(void** state)
   assert_int_equal(az_span_find(source, az_span_slice(span, 2, 4)), 1);
 }
 
+// The byte-by-byte search az_span_find() used to implement, as the reference.
+static int32_t _az_span_find_naive(az_span source, az_span target)
+{
+  int32_t const source_size = az_span_size(source);
+  int32_t const target_size = az_span_size(target);
+  for (int32_t i = 0; i <= source_size - target_size; i++)
+  {
+    int32_t j = 0;
+    while (j < target_size && az_span_ptr(source)[i + j] == az_span_ptr(target)[j])
+    {
+      j++;
+    }
+    if (j == target_size)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void az_span_find_topics_success(void** state)
+{
+  (void)state;
+
+  az_span topic = AZ_SPAN_FROM_STR("$iothub/twin/res/200/?$rid=1&$version=27");
+  assert_int_equal(az_span_find(topic, AZ_SPAN_FROM_STR("$iothub/twin/")), 0);
+  assert_int_equal(az_span_find(topic, AZ_SPAN_FROM_STR("res/")), 13);
+  assert_int_equal(az_span_find(topic, AZ_SPAN_FROM_STR("PATCH/properties/desired/")), -1);
+  assert_int_equal(az_span_find(topic, AZ_SPAN_FROM_STR("$version=")), 29);
+
+  topic = AZ_SPAN_FROM_STR(
+      "$dps/registrations/res/202/?$rid=1&retry-after=3&operationId=4.d0a671905ea5b2c8.e7173b7b");
+  assert_int_equal(az_span_find(topic, AZ_SPAN_FROM_STR("$dps/registrations/res/")), 0);
+  assert_int_equal(az_span_find(topic, AZ_SPAN_FROM_STR("retry-after=")), 35);
+  assert_int_equal(az_span_find(topic, AZ_SPAN_FROM_STR("retry-after=x")), -1);
+}
+
+// Targets that make a byte-by-byte search slow go through the two-way search; the results must not
+// change.
+static void az_span_find_matches_naive_search_success(void** state)
+{
+  (void)state;
+
+  uint8_t source_buffer[1000];
+  uint8_t target_buffer[100];
+
+  // "aaaa...a" for "aa...ab" and "aa...ba", with and without a match at the end.
+  memset(source_buffer, 'a', sizeof(source_buffer));
+  memset(target_buffer, 'a', sizeof(target_buffer));
+  target_buffer[99] = 'b';
+  az_span const source = AZ_SPAN_FROM_BUFFER(source_buffer);
+  az_span const target = AZ_SPAN_FROM_BUFFER(target_buffer);
+  assert_int_equal(az_span_find(source, target), -1);
+  source_buffer[999] = 'b';
+  assert_int_equal(az_span_find(source, target), 900);
+  target_buffer[99] = 'a';
+  target_buffer[98] = 'b';
+  assert_int_equal(az_span_find(source, target), -1);
+  source_buffer[998] = 'b';
+  source_buffer[999] = 'a';
+  assert_int_equal(az_span_find(source, target), 900);
+
+  // Random text over small alphabets, with periodic and non-periodic targets.
+  uint32_t random = 2463534242u;
+  for (int32_t iteration = 0; iteration < 2000; iteration++)
+  {
+    int32_t const alphabet_size = 1 + iteration % 3;
+    int32_t const source_size = iteration % 10 == 0 ? 1000 : iteration % 100;
+    int32_t const target_size = iteration % 7 == 0 ? 1 + iteration % 100 : 1 + iteration % 12;
+    for (int32_t i = 0; i < source_size; i++)
+    {
+      random ^= random << 13;
+      random ^= random >> 17;
+      random ^= random << 5;
+      source_buffer[i] = (uint8_t)('a' + random % (uint32_t)alphabet_size);
+    }
+
+    if (iteration % 2 == 0 && target_size <= source_size)
+    {
+      // Take the target from the source and change its last byte half of the time.
+      memcpy(target_buffer, source_buffer + (source_size - target_size) / 2, (size_t)target_size);
+      if (iteration % 4 == 0)
+      {
+        target_buffer[target_size - 1] = 'b';
+      }
+    }
+    else
+    {
+      int32_t const period = 1 + iteration % 5;
+      for (int32_t i = 0; i < target_size; i++)
+      {
+        target_buffer[i] = (uint8_t)('a' + (i % period) % alphabet_size);
+      }
+    }
+
+    az_span const random_source = az_span_create(source_buffer, source_size);
+    az_span const random_target = az_span_create(target_buffer, target_size);
+    assert_int_equal(
+        az_span_find(random_source, random_target),
+        _az_span_find_naive(random_source, random_target));
+  }
+}
+
 static void az_span_i64toa_test(void** state)
 {
   (void)state;
@@ -1343,6 +1603,147 @@ static void az_span_dtoa_succeeds(void** state)
   AZ_SPAN_DTOA_SUCCEEDS_HELPER(1e-300, 2, AZ_SPAN_FROM_STR("0"));
 }
 
+#define AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(v, expected)                                  \
+  do                                                                                        \
+  {                                                                                         \
+    az_span buffer = AZ_SPAN_FROM_BUFFER(raw_buffer);                                       \
+    az_span out_span = AZ_SPAN_EMPTY;                                                       \
+    assert_int_equal(az_span_dtoa_shortest(buffer, v, &out_span), AZ_OK);                   \
+    az_span output = az_span_slice(buffer, 0, _az_span_diff(out_span, buffer));             \
+    assert_true(az_span_is_content_equal(output, AZ_SPAN_FROM_STR(expected)));              \
+    double round_trip = 0;                                                                  \
+    assert_int_equal(az_span_atod(output, &round_trip), AZ_OK);                             \
+    assert_true(_az_span_test_double_bits(round_trip) == _az_span_test_double_bits(v));     \
+  } while (0)
+
+static void az_span_dtoa_shortest_succeeds(void** state)
+{
+  (void)state;
+
+  uint8_t raw_buffer[_az_MAX_SIZE_FOR_WRITING_SHORTEST_DOUBLE] = { 0 };
+
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.0, "0");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-0.0, "-0");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1.0, "1");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-1.0, "-1");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1500.0, "1500");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.1, "0.1");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.1 + 0.2, "0.30000000000000004");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(23.5, "23.5");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-273.15, "-273.15");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1013.25, "1013.25");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1.0 / 3.0, "0.3333333333333333");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.0025, "0.0025");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.000001, "0.000001");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.0000001, "1e-7");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-1.5e-7, "-1.5e-7");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(9007199254740993.0, "9007199254740992");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(123456789012345680.0, "123456789012345680");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(999999999999999900000.0, "999999999999999900000");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1e21, "1e21");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1e23, "1e23");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1.5e300, "1.5e300");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1.7976931348623157e308, "1.7976931348623157e308");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-2.2250738585072014e-308, "-2.2250738585072014e-308");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(4.9406564584124654e-324, "5e-324");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-1.2345678901234568e-300, "-1.2345678901234568e-300");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-0.000012345678901234568, "-0.000012345678901234568");
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-0.0000012345678901234567, "-0.0000012345678901234567");
+}
+
+static void az_span_dtoa_shortest_round_trip(void** state)
+{
+  (void)state;
+
+  // Random bit patterns, covering subnormals and every exponent. The output must parse back to the
+  // same double and must not have more significant digits than the shortest "%.*g" that does.
+  uint64_t random = 0x2545F4914F6CDD1DULL;
+  uint8_t raw_buffer[_az_MAX_SIZE_FOR_WRITING_SHORTEST_DOUBLE] = { 0 };
+  char expected[32] = { 0 };
+
+  for (int32_t i = 0; i < 100000; i++)
+  {
+    random ^= random << 13;
+    random ^= random >> 7;
+    random ^= random << 17;
+
+    double value = 0;
+    memcpy(&value, &random, sizeof(value));
+    if (!_az_isfinite(value))
+    {
+      continue;
+    }
+
+    az_span const buffer = AZ_SPAN_FROM_BUFFER(raw_buffer);
+    az_span out_span = AZ_SPAN_EMPTY;
+    assert_int_equal(az_span_dtoa_shortest(buffer, value, &out_span), AZ_OK);
+    az_span const output = az_span_slice(buffer, 0, _az_span_diff(out_span, buffer));
+
+    double round_trip = 0;
+    assert_int_equal(az_span_atod(output, &round_trip), AZ_OK);
+    assert_true(_az_span_test_double_bits(round_trip) == random);
+
+    int precision = 1;
+    for (; precision < 17; precision++)
+    {
+      (void)snprintf(expected, sizeof(expected), "%.*g", precision, value);
+      if (_az_span_test_double_bits(strtod(expected, NULL)) == random)
+      {
+        break;
+      }
+    }
+
+    int digit_count = 0;
+    bool leading = true;
+    int trailing_zeros = 0;
+    for (int32_t j = 0; j < az_span_size(output); j++)
+    {
+      uint8_t const c = az_span_ptr(output)[j];
+      if (c == 'e')
+      {
+        break;
+      }
+      if (c >= '1' && c <= '9')
+      {
+        leading = false;
+      }
+      if (!leading && c >= '0' && c <= '9')
+      {
+        digit_count++;
+        trailing_zeros = c == '0' ? trailing_zeros + 1 : 0;
+      }
+    }
+    // Integers are padded with zeros up to the decimal point.
+    assert_true(digit_count - trailing_zeros <= precision);
+  }
+}
+
+static void az_span_dtoa_shortest_overflow_fails(void** state)
+{
+  (void)state;
+
+  uint8_t raw_buffer[_az_MAX_SIZE_FOR_WRITING_SHORTEST_DOUBLE];
+  az_span buff = AZ_SPAN_FROM_BUFFER(raw_buffer);
+  az_span o;
+
+  assert_int_equal(
+      az_span_dtoa_shortest(az_span_slice(buff, 0, 0), 0, &o), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_span_dtoa_shortest(az_span_slice(buff, 0, 1), -1, &o), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_span_dtoa_shortest(az_span_slice(buff, 0, 3), 0.25, &o), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_span_dtoa_shortest(az_span_slice(buff, 0, 20), 1e20, &o), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_span_dtoa_shortest(az_span_slice(buff, 0, 23), -2.2250738585072014e-308, &o),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_span_dtoa_shortest(az_span_slice(buff, 0, 24), -0.0000012345678901234567, &o),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_span_dtoa_shortest(az_span_slice(buff, 0, 25), -0.0000012345678901234567, &o), AZ_OK);
+}
+
 static void az_span_dtoa_overflow_fails(void** state)
 {
   (void)state;
@@ -1771,6 +2172,8 @@ int test_az_span()
     cmocka_unit_test(az_span_find_embedded_NULLs_success),
     cmocka_unit_test(az_span_find_capacity_checks_success),
     cmocka_unit_test(az_span_find_overlapping_checks_success),
+    cmocka_unit_test(az_span_find_topics_success),
+    cmocka_unit_test(az_span_find_matches_naive_search_success),
     cmocka_unit_test(az_span_atox_return_errors),
     cmocka_unit_test(az_span_atou32_test),
     cmocka_unit_test(az_span_atoi32_test),
@@ -1779,6 +2182,8 @@ int test_az_span()
     cmocka_unit_test(test_az_isfinite),
     cmocka_unit_test(az_span_atod_test),
     cmocka_unit_test(az_span_atod_non_finite_not_allowed),
+    cmocka_unit_test(az_span_atod_correctly_rounded),
+    cmocka_unit_test(az_span_atod_round_trip),
     cmocka_unit_test(az_span_ato_number_whitespace_or_invalid_not_allowed),
     cmocka_unit_test(az_span_ato_number_no_out_of_bounds_reads),
     cmocka_unit_test(az_span_i64toa_negative_number_test),
@@ -1797,6 +2202,9 @@ int test_az_span()
     cmocka_unit_test(az_span_u32toa_overflow_fails),
     cmocka_unit_test(az_span_dtoa_succeeds),
     cmocka_unit_test(az_span_dtoa_overflow_fails),
+    cmocka_unit_test(az_span_dtoa_shortest_succeeds),
+    cmocka_unit_test(az_span_dtoa_shortest_round_trip),
+    cmocka_unit_test(az_span_dtoa_shortest_overflow_fails),
     cmocka_unit_test(az_span_dtoa_too_large),
     cmocka_unit_test(az_span_copy_empty),
     cmocka_unit_test(test_az_span_is_valid),
@@ -0,0 +1,293 @@
+/**
+ * @file display_widgets.hpp
+ * @brief Widgets mit Merker des zuletzt gezeichneten Inhalts; gezeichnet werden nur geänderte Bereiche.
+*/
+
+#ifndef DISPLAY_WIDGETS_HPP__
+#define DISPLAY_WIDGETS_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief Textfeld in der eingebauten 6x8-Schrift (monospace) mit Hintergrundfarbe.
+ *
+ * Da alle Zeichen gleich breit sind, werden nur die Zeichen zwischen dem ersten und dem letzten
+ * geänderten Zeichen neu gezeichnet. Wird der Text kürzer, wird nur der überstehende Rest gelöscht.
+ *
+ * @tparam Display Displayklasse mit der Schnittstelle von TFT_eSPI.
+ */
+template <typename Display>
+class TextWidget
+{
+public:
+    static constexpr std::size_t MaxText = 24;
+
+private:
+    std::int16_t x;
+    std::int16_t y;
+    std::uint8_t textSize;
+    std::uint16_t background;
+    char text[MaxText] = {};
+    std::uint16_t color;
+    char shown[MaxText] = {};
+    std::uint16_t shownColor = 0;
+    bool valid = false;     // false: beim nächsten Frame vollständig zeichnen
+
+public:
+    TextWidget(std::int16_t x, std::int16_t y, std::uint16_t color, std::uint16_t background, std::uint8_t textSize = 2)
+        : x(x), y(y), textSize(textSize), background(background), color(color)
+    {
+    }
+
+    std::int16_t charWidth() const { return 6 * this->textSize; }
+    std::int16_t height() const { return 8 * this->textSize; }
+
+    /**
+     * @brief Setzt den anzuzeigenden Text; gezeichnet wird erst beim nächsten render().
+     */
+    void setText(const char *value)
+    {
+        // Längere Texte werden gekürzt
+        std::size_t length = 0;
+        while (length < MaxText - 1 && value[length] != '\0') {
+            length++;
+        }
+        std::memcpy(this->text, value, length);
+        this->text[length] = '\0';
+    }
+
+    void setText(const char *value, std::uint16_t color)
+    {
+        this->setText(value);
+        this->color = color;
+    }
+
+    const char *currentText() const { return this->text; }
+
+    /**
+     * @brief Erzwingt ein vollständiges Neuzeichnen, z.B. nachdem der Bildschirm gelöscht wurde.
+     * @param [in] cleared true, wenn der Bereich bereits in Hintergrundfarbe ist.
+     */
+    void invalidate(bool cleared = true)
+    {
+        this->valid = false;
+        if (cleared) {
+            this->shown[0] = '\0';
+        }
+    }
+
+    bool dirty() const { return !this->valid || this->color != this->shownColor || std::strcmp(this->text, this->shown) != 0; }
+
+    /**
+     * @brief Zeichnet die geänderten Zeichen.
+     * @return Anzahl der geschriebenen Pixel.
+     */
+    std::uint32_t render(Display &display)
+    {
+        if (!this->dirty()) {
+            return 0;
+        }
+        std::size_t newLength = std::strlen(this->text);
+        std::size_t oldLength = std::strlen(this->shown);
+        std::size_t first = 0;
+        std::size_t last = newLength;   // exklusiv
+        if (this->valid && this->color == this->shownColor) {
+            while (first < newLength && first < oldLength && this->text[first] == this->shown[first]) {
+                first++;
+            }
+            while (last > first && last <= oldLength && this->text[last - 1] == this->shown[last - 1]) {
+                last--;
+            }
+        }
+
+        std::uint32_t pixels = 0;
+        if (last > first) {
+            char run[MaxText];
+            std::memcpy(run, this->text + first, last - first);
+            run[last - first] = '\0';
+            display.setTextColor(this->color, this->background);
+            display.setTextSize(this->textSize);
+            display.setCursor(this->x + first * this->charWidth(), this->y);
+            display.print(run);
+            pixels += (last - first) * this->charWidth() * this->height();
+        }
+        if (oldLength > newLength) {
+            std::int16_t clearWidth = (oldLength - newLength) * this->charWidth();
+            display.fillRect(this->x + newLength * this->charWidth(), this->y, clearWidth, this->height(), this->background);
+            pixels += clearWidth * this->height();
+        }
+
+        std::memcpy(this->shown, this->text, MaxText);
+        this->shownColor = this->color;
+        this->valid = true;
+        return pixels;
+    }
+};
+
+/**
+ * @brief Feste Beschriftung.
+ */
+template <typename Display>
+class Label : public TextWidget<Display>
+{
+public:
+    Label(std::int16_t x, std::int16_t y, const char *text, std::uint16_t color, std::uint16_t background)
+        : TextWidget<Display>(x, y, color, background)
+    {
+        this->setText(text);
+    }
+};
+
+/**
+ * @brief Zahlenwert mit fester Anzahl Nachkommastellen (höchstens MaxDecimals) und Einheit.
+ */
+template <typename Display>
+class NumberField : public TextWidget<Display>
+{
+public:
+    static constexpr std::uint8_t MaxDecimals = 4;
+
+private:
+    std::uint8_t decimals;
+    const char *unit;
+
+public:
+    NumberField(std::int16_t x, std::int16_t y, std::uint8_t decimals, const char *unit, std::uint16_t color,
+                std::uint16_t background)
+        : TextWidget<Display>(x, y, color, background), decimals(decimals < MaxDecimals ? decimals : MaxDecimals),
+          unit(unit)
+    {
+    }
+
+    /**
+     * @brief Formatiert ohne printf-Gleitkommaunterstützung (newlib-nano).
+     */
+    void setValue(float value)
+    {
+        int width = this->decimals < MaxDecimals ? this->decimals : MaxDecimals;
+        long scale = 1;
+        for (int i = 0; i < width; i++) {
+            scale *= 10;
+        }
+        float scaled = value * scale;
+        long fixed = static_cast<long>(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+        unsigned long absValue = fixed < 0 ? -fixed : fixed;
+        // Vorzeichen, bis zu 20 Ziffern (64 Bit), Punkt, Nachkommastellen; setText() kürzt auf MaxText
+        char buffer[1 + 20 + 1 + MaxDecimals + TextWidget<Display>::MaxText];
+        if (width > 0) {
+            // Nachkommastellen von Hand mit führenden Nullen, statt %0*lu mit variabler Breite
+            char fraction[MaxDecimals + 1];
+            unsigned long rest = absValue % scale;
+            for (int i = width - 1; i >= 0; i--) {
+                fraction[i] = static_cast<char>('0' + rest % 10);
+                rest /= 10;
+            }
+            fraction[width] = '\0';
+            std::snprintf(buffer, sizeof(buffer), "%s%lu.%s%s", fixed < 0 ? "-" : "", absValue / scale, fraction,
+                          this->unit);
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "%ld%s", fixed, this->unit);
+        }
+        this->setText(buffer);
+    }
+};
+
+/**
+ * @brief Statuszeile mit wechselnder Textfarbe.
+ */
+template <typename Display>
+class StatusBanner : public TextWidget<Display>
+{
+public:
+    StatusBanner(std::int16_t x, std::int16_t y, std::uint16_t background) : TextWidget<Display>(x, y, 0, background) {}
+
+    void setStatus(const char *text, std::uint16_t color) { this->setText(text, color); }
+};
+
+/**
+ * @brief Uhrzeit im Format HH:MM:SS; pro Sekunde ändert sich meist nur ein Zeichen.
+ */
+template <typename Display>
+class ClockWidget : public TextWidget<Display>
+{
+public:
+    ClockWidget(std::int16_t x, std::int16_t y, std::uint16_t color, std::uint16_t background)
+        : TextWidget<Display>(x, y, color, background)
+    {
+    }
+
+    void setTime(int hour, int minute, int second)
+    {
+        char buffer[12];
+        std::snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d", hour, minute, second);
+        this->setText(buffer);
+    }
+};
+
+/**
+ * @brief Sammlung von Widgets eines Bildschirms mit Zählern für geschriebene Pixel.
+ */
+template <typename Display, std::size_t Capacity = 12>
+class WidgetScreen
+{
+private:
+    Display &display;
+    TextWidget<Display> *widgets[Capacity] = {};
+    std::size_t count = 0;
+
+    std::uint32_t frames = 0;
+    std::uint32_t lastPixels = 0;
+    std::uint32_t maxPixels = 0;
+    std::uint64_t totalPixels = 0;
+
+public:
+    explicit WidgetScreen(Display &display) : display(display) {}
+
+    bool add(TextWidget<Display> &widget)
+    {
+        if (this->count >= Capacity) {
+            return false;
+        }
+        this->widgets[this->count++] = &widget;
+        return true;
+    }
+
+    /**
+     * @brief Alle Widgets beim nächsten Frame vollständig zeichnen (nach fillScreen()).
+     */
+    void invalidate()
+    {
+        for (std::size_t i = 0; i < this->count; i++) {
+            this->widgets[i]->invalidate();
+        }
+    }
+
+    /**
+     * @brief Frame-Durchlauf: zeichnet nur geänderte Widgets bzw. Zeichen.
+     * @return Anzahl der in diesem Frame geschriebenen Pixel.
+     */
+    std::uint32_t render()
+    {
+        std::uint32_t pixels = 0;
+        for (std::size_t i = 0; i < this->count; i++) {
+            pixels += this->widgets[i]->render(this->display);
+        }
+        this->frames++;
+        this->lastPixels = pixels;
+        this->totalPixels += pixels;
+        if (pixels > this->maxPixels) {
+            this->maxPixels = pixels;
+        }
+        return pixels;
+    }
+
+    std::uint32_t frameCount() const { return this->frames; }
+    std::uint32_t lastFramePixels() const { return this->lastPixels; }
+    std::uint32_t maxFramePixels() const { return this->maxPixels; }
+    std::uint64_t pixelsPushed() const { return this->totalPixels; }
+};
+
+#endif //DISPLAY_WIDGETS_HPP__
@@ -0,0 +1,115 @@
+/**
+ * @file gfx_math.hpp
+ * @brief Ganzzahl-Trigonometrie (Q15) und ein Kreisbogen-Rasterizer mit horizontalen Linien.
+ *
+ * Die FPU des SAMD51 rechnet nur mit float; cos()/sin() mit double laufen in Software.
+ * Die Funktionen hier kommen ohne Gleitkomma aus.
+*/
+
+#ifndef GFX_MATH_HPP__
+#define GFX_MATH_HPP__
+
+#include <cstdint>
+
+namespace gfx {
+
+/**
+ * @brief sin(0°..90°) in Q15 (32767 = 1,0), gerundet.
+ */
+constexpr std::int16_t SineQ15[91] = {
+        0,   572,  1144,  1715,  2286,  2856,  3425,  3993,  4560,  5126,
+     5690,  6252,  6813,  7371,  7927,  8481,  9032,  9580, 10126, 10668,
+    11207, 11743, 12275, 12803, 13328, 13848, 14364, 14876, 15383, 15886,
+    16383, 16876, 17364, 17846, 18323, 18794, 19260, 19720, 20173, 20621,
+    21062, 21497, 21925, 22347, 22762, 23170, 23571, 23964, 24351, 24730,
+    25101, 25465, 25821, 26169, 26509, 26841, 27165, 27481, 27788, 28087,
+    28377, 28659, 28932, 29196, 29451, 29697, 29934, 30162, 30381, 30591,
+    30791, 30982, 31163, 31335, 31498, 31650, 31794, 31927, 32051, 32165,
+    32269, 32364, 32448, 32523, 32587, 32642, 32687, 32722, 32747, 32762,
+    32767,
+};
+
+/**
+ * @brief Sinus eines ganzzahligen Winkels in Grad (beliebiges Vorzeichen) in Q15.
+ */
+constexpr std::int16_t sinQ15(int degrees)
+{
+    return degrees < 0 ? static_cast<std::int16_t>(-sinQ15(-degrees))
+         : degrees >= 360 ? sinQ15(degrees % 360)
+         : degrees <= 90 ? SineQ15[degrees]
+         : degrees <= 180 ? SineQ15[180 - degrees]
+         : degrees <= 270 ? static_cast<std::int16_t>(-SineQ15[degrees - 180])
+         : static_cast<std::int16_t>(-SineQ15[360 - degrees]);
+}
+
+constexpr std::int16_t cosQ15(int degrees)
+{
+    return sinQ15(degrees < 0 ? 90 - degrees : degrees + 90);
+}
+
+/**
+ * @brief value * q (Q15), auf die nächste ganze Zahl gerundet (symmetrisch um 0).
+ */
+constexpr int mulQ15(std::int16_t q, int value)
+{
+    return q * value >= 0 ? (q * value + 16384) >> 15 : -((-(q * value) + 16384) >> 15);
+}
+
+/**
+ * @brief Zeichnet einen dicken Kreisbogen als horizontale Linien (drawFastHLine).
+ *
+ * Gerastert wird wie bisher in 1°-Schritten: jeder Bogenpunkt (x + r·cos, y - r·sin) wird
+ * horizontal auf [x0 - thickness/2, x0 + thickness/2 - 1] verbreitert (mindestens der Punkt
+ * selbst). Aufeinanderfolgende Stücke in derselben Zeile, die sich überlappen oder berühren,
+ * werden zu einer Linie zusammengefasst. Die gesetzten Pixel entsprechen damit exakt der
+ * pixelweisen Variante mit derselben Q15-Rechnung, aber mit wenigen SPI-Transaktionen.
+ *
+ * @tparam Gfx Ziel mit drawFastHLine(x, y, w, color), z.B. TFT_eSPI oder TFT_eSprite.
+ * @return Anzahl der ausgegebenen Linien.
+ */
+template <typename Gfx>
+int drawArcSpans(Gfx &gfx, int x, int y, int r, int startAngle, int endAngle, std::uint16_t color, int thickness)
+{
+    int left = -thickness / 2;
+    int right = thickness / 2 - 1;
+    if (right < 0) {
+        right = 0;
+    }
+    if (left > 0) {
+        left = 0;
+    }
+
+    int spans = 0;
+    bool open = false;
+    int spanY = 0;
+    int spanX0 = 0;
+    int spanX1 = 0;
+    for (int angle = startAngle; angle <= endAngle; angle++) {
+        int px = x + mulQ15(cosQ15(angle), r);
+        int py = y - mulQ15(sinQ15(angle), r);
+        int x0 = px + left;
+        int x1 = px + right;
+        if (open && py == spanY && x0 <= spanX1 + 1 && x1 >= spanX0 - 1) {
+            spanX0 = x0 < spanX0 ? x0 : spanX0;
+            spanX1 = x1 > spanX1 ? x1 : spanX1;
+            continue;
+        }
+        if (open) {
+            gfx.drawFastHLine(spanX0, spanY, spanX1 - spanX0 + 1, color);
+            spans++;
+        }
+        open = true;
+        spanY = py;
+        spanX0 = x0;
+        spanX1 = x1;
+    }
+    if (open) {
+        gfx.drawFastHLine(spanX0, spanY, spanX1 - spanX0 + 1, color);
+        spans++;
+    }
+    return spans;
+}
+
+} // namespace gfx
+
+#endif //GFX_MATH_HPP__
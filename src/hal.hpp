@@ -0,0 +1,173 @@
+/**
+ * @file hal.hpp
+ * @brief Hardware-Abstraktion: Typen und Funktionen, die auf dem Gerät die Bibliotheken des Wio Terminals
+ *        und im Simulator (env:native, AQUA_SIM) die Nachbildungen aus src/sim/ verwenden.
+ *
+ * Die Module sind bereits über ihre Hardware-Typen parametrisiert (SdLogger<FileT>, NtpClient<UdpT>, ...);
+ * hier wird nur festgelegt, welche Typen main.cpp einsetzt. Globale Objekte der Bibliotheken (Serial, SD,
+ * WiFi) behalten ihre Namen, im Simulator stellt sim_main.cpp sie bereit.
+*/
+
+#ifndef HAL_HPP__
+#define HAL_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef AQUA_SIM
+
+#include "sim/sim_arduino.hpp"
+#include "sim/sim_environment.hpp"
+#include "sim/sim_peripherals.hpp"
+#include "sim/sim_display.hpp"
+#include "sim/sim_storage.hpp"
+#include "sim/sim_network.hpp"
+#include "sim/sim_crypto.hpp"
+
+extern sim::Storage SD;
+extern sim::Network WiFi;
+
+namespace hal {
+
+typedef sim::Display Display;
+typedef sim::Sprite Sprite;
+typedef sim::ClimateSensor ClimateSensor;
+typedef sim::Rtc Rtc;
+typedef sim::RangeSensor RangeSensor;
+typedef sim::Storage Storage;
+typedef sim::File File;
+typedef sim::Udp Udp;
+typedef sim::Network Network;
+typedef sim::SecureClient SecureClient;
+typedef sim::MqttClient MqttClient;
+typedef sim::BackLight BackLight;
+typedef sim::Watchdog Watchdog;
+
+/** @brief Schläft bis wakeTime (millis); im Simulator springt die virtuelle Uhr vor. */
+inline void sleepUntil(unsigned long wakeTime)
+{
+    sim::clock.sleepUntil(wakeTime);
+}
+
+/** @brief Zykluszähler für den Profiler; im Simulator die virtuelle Zeit in µs. */
+constexpr std::uint32_t CyclesPerMicrosecond = 1;
+
+inline void enableCycleCounter() {}
+
+inline std::uint32_t cycleCount()
+{
+    return static_cast<std::uint32_t>(sim::clock.micros());
+}
+
+inline bool hmacSha256(const std::uint8_t *key, std::size_t keyLength, const std::uint8_t *data, std::size_t length,
+                       std::uint8_t digest[32])
+{
+    sim::hmacSha256(key, keyLength, data, length, digest);
+    return true;
+}
+
+inline bool base64Encode(std::uint8_t *out, std::size_t size, std::size_t *written, const std::uint8_t *in,
+                         std::size_t length)
+{
+    return sim::base64Encode(out, size, written, in, length);
+}
+
+inline bool base64Decode(std::uint8_t *out, std::size_t size, std::size_t *written, const std::uint8_t *in,
+                         std::size_t length)
+{
+    return sim::base64Decode(out, size, written, in, length);
+}
+
+} // namespace hal
+
+#else
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>   // Bibliothek für das Display des Wio Terminals
+#include "DHT.h"        // Bibliothek für Grove Temperature & Humidity Sensor
+#include <rpcWiFi.h>    // Bibliothek für WLAN-Verbindung
+#include <RTClib.h>
+#include <SD.h>
+#include <WiFiUdp.h>    // Bibliothek für UDP-Verbindung (NTP nutzt UDP)
+#include <Wire.h>       // I2C-Bibliothek für VL53L0X
+#include <Adafruit_VL53L0X.h>  // VL53L0X-Bibliothek für Entfernungsmessung
+#include <PubSubClient.h>       // MQTT-Client für den IoT Hub
+#include <mbedtls/base64.h>
+#include <mbedtls/md.h>         // HMAC-SHA256 für das SAS-Token
+#include "lcd_backlight.hpp"
+#include "watchdog.hpp"
+
+namespace hal {
+
+typedef TFT_eSPI Display;
+typedef TFT_eSprite Sprite;
+typedef DHT ClimateSensor;
+typedef RTC_DS3231 Rtc;
+typedef Adafruit_VL53L0X RangeSensor;
+typedef SDClass Storage;
+typedef ::File File;
+typedef WiFiUDP Udp;
+typedef WiFiClass Network;
+typedef WiFiClientSecure SecureClient;
+typedef PubSubClient MqttClient;
+typedef LCDBackLight BackLight;
+typedef ::Watchdog Watchdog;
+
+/**
+ * @brief CPU bis wakeTime (millis) schlafen legen; jeder Interrupt (SysTick, USB, ...) weckt kurz auf.
+ */
+inline void sleepUntil(unsigned long wakeTime)
+{
+    // IDLE: CPU-Takt aus, Peripherie und SysTick laufen weiter, millis() bleibt gültig
+    PM->SLEEPCFG.bit.SLEEPMODE = PM_SLEEPCFG_SLEEPMODE_IDLE_Val;
+    while (PM->SLEEPCFG.bit.SLEEPMODE != PM_SLEEPCFG_SLEEPMODE_IDLE_Val);
+    while ((long)(wakeTime - millis()) > 0) {
+        __WFI();
+    }
+}
+
+/** @brief Zykluszähler der CPU (DWT->CYCCNT) für den Profiler. */
+constexpr std::uint32_t CyclesPerMicrosecond = F_CPU / 1000000;
+
+inline void enableCycleCounter()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+inline std::uint32_t cycleCount()
+{
+    return DWT->CYCCNT;
+}
+
+inline bool hmacSha256(const std::uint8_t *key, std::size_t keyLength, const std::uint8_t *data, std::size_t length,
+                       std::uint8_t digest[32])
+{
+    mbedtls_md_context_t context;
+    mbedtls_md_init(&context);
+    bool ok = mbedtls_md_setup(&context, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 1) == 0
+              && mbedtls_md_hmac_starts(&context, key, keyLength) == 0
+              && mbedtls_md_hmac_update(&context, data, length) == 0
+              && mbedtls_md_hmac_finish(&context, digest) == 0;
+    mbedtls_md_free(&context);
+    return ok;
+}
+
+inline bool base64Encode(std::uint8_t *out, std::size_t size, std::size_t *written, const std::uint8_t *in,
+                         std::size_t length)
+{
+    return mbedtls_base64_encode(out, size, written, in, length) == 0;
+}
+
+inline bool base64Decode(std::uint8_t *out, std::size_t size, std::size_t *written, const std::uint8_t *in,
+                         std::size_t length)
+{
+    return mbedtls_base64_decode(out, size, written, in, length) == 0;
+}
+
+} // namespace hal
+
+#endif //AQUA_SIM
+
+#endif //HAL_HPP__
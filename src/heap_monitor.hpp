@@ -0,0 +1,82 @@
+/**
+ * @file heap_monitor.hpp
+ * @brief Zähler für die Heap-Belegung, um Fragmentierung im Dauerbetrieb zu erkennen.
+*/
+
+#ifndef HEAP_MONITOR_HPP__
+#define HEAP_MONITOR_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <malloc.h>
+#include <unistd.h>
+
+/**
+ * @brief Liest die Heap-Statistik von newlib (mallinfo) und merkt sich die Extremwerte.
+ *
+ * Wächst "frei im Heap" bei gleichbleibender Belegung über Tage, zerfällt der Heap in Lücken,
+ * die malloc nicht mehr nutzen kann.
+ *
+ * Auf dem Entwicklungsrechner (glibc) kommen die Werte aus mallinfo2(); Heap und Stack liegen dort
+ * nicht in einem gemeinsamen RAM-Bereich, freeAbove ist daher immer 0.
+ */
+class HeapMonitor
+{
+public:
+    struct Snapshot
+    {
+        std::size_t arena = 0;          // vom Heap belegter Speicher (bis sbrk)
+        std::size_t inUse = 0;          // durch malloc vergebene Bytes
+        std::size_t freeInHeap = 0;     // freigegebene Lücken innerhalb der Arena
+        std::size_t freeAbove = 0;      // Abstand zwischen Heap-Ende und Stack
+    };
+
+private:
+    Snapshot last;
+    std::size_t peakInUse = 0;
+    std::size_t peakFreeInHeap = 0;
+    std::size_t minFreeAbove = SIZE_MAX;
+    std::uint32_t samples = 0;
+
+public:
+    /**
+     * @brief Nimmt einen Messpunkt auf; kostet nur einen Durchlauf über die Freiliste.
+     */
+    const Snapshot &sample()
+    {
+#ifdef __GLIBC__
+        struct mallinfo2 info = mallinfo2();
+        this->last.freeAbove = 0;
+#else
+        struct mallinfo info = mallinfo();
+        char stackMarker;
+        char *heapEnd = static_cast<char *>(sbrk(0));
+        this->last.freeAbove = &stackMarker > heapEnd ? static_cast<std::size_t>(&stackMarker - heapEnd) : 0;
+#endif
+
+        this->last.arena = info.arena;
+        this->last.inUse = info.uordblks;
+        this->last.freeInHeap = info.fordblks;
+
+        if (this->last.inUse > this->peakInUse) {
+            this->peakInUse = this->last.inUse;
+        }
+        if (this->last.freeInHeap > this->peakFreeInHeap) {
+            this->peakFreeInHeap = this->last.freeInHeap;
+        }
+        if (this->last.freeAbove < this->minFreeAbove) {
+            this->minFreeAbove = this->last.freeAbove;
+        }
+        this->samples++;
+        return this->last;
+    }
+
+    const Snapshot &latest() const { return this->last; }
+    std::size_t maxInUse() const { return this->peakInUse; }
+    std::size_t maxFreeInHeap() const { return this->peakFreeInHeap; }
+    /** @brief Kleinster gemessener Abstand zwischen Heap und Stack. */
+    std::size_t minFree() const { return this->samples ? this->minFreeAbove : 0; }
+    std::uint32_t sampleCount() const { return this->samples; }
+};
+
+#endif //HEAP_MONITOR_HPP__
@@ -0,0 +1,209 @@
+/**
+ * @file irrigation_controller.hpp
+ * @brief Bewässerungssteuerung mit Hysterese, Laufzeitgrenzen, Sickerpause und Tagesbudget für die Pumpe.
+*/
+
+#ifndef IRRIGATION_CONTROLLER_HPP__
+#define IRRIGATION_CONTROLLER_HPP__
+
+#include <cstdint>
+
+/**
+ * @brief Zustandsautomat für das Pumpenrelais.
+ *
+ *   Idle     --(Feuchte <= startThreshold, Pause minOffTime vorbei, Budget übrig)--> Watering
+ *   Watering --(Feuchte >= stopThreshold nach minRunTime, maxRunTime oder Budget erreicht)--> Soaking
+ *   Soaking  --(nach soakTime: Feuchte >= stopThreshold)--> Idle
+ *            --(nach soakTime: zu trocken, Zyklen und Budget übrig)--> Watering
+ *            --(nach soakTime: zu trocken, keine Zyklen oder kein Budget mehr)--> Lockout
+ *   Lockout  --(neues Budgetfenster)--> Idle
+ *
+ * Das Relais wird nur bei einem Zustandswechsel geschrieben. Die Sickerpause gibt dem Wasser
+ * Zeit, den Sensor zu erreichen, bevor erneut gegossen wird. Lockout schützt vor Trockenlauf
+ * bzw. Überschwemmung, wenn die Feuchte trotz mehrerer Zyklen nicht steigt (Tank leer,
+ * Sensor defekt).
+ */
+class IrrigationController
+{
+public:
+    enum class State : std::uint8_t { Idle, Watering, Soaking, Lockout };
+    typedef void (*RelayFunction)(bool on);
+
+    /**
+     * @brief Parameter, alle Zeiten in ms.
+     */
+    struct Config
+    {
+        int startThreshold = 10;                    // gießen ab dieser Feuchte (oder trockener)
+        int stopThreshold = 100;                    // gießen bis zu dieser Feuchte (Hysterese)
+        unsigned long minRunTime = 5000;
+        unsigned long maxRunTime = 30000;           // je Zyklus
+        unsigned long soakTime = 300000;            // Sickerpause nach jedem Zyklus
+        unsigned long minOffTime = 600000;          // Pause zwischen zwei Gießvorgängen
+        std::uint8_t maxCycles = 4;                 // Zyklen je Gießvorgang
+        unsigned long dailyBudget = 180000;         // Pumpenlaufzeit je Budgetfenster
+        unsigned long budgetWindow = 86400000UL;    // 24 h
+    };
+
+private:
+    Config config;
+    RelayFunction relay;
+
+    State current = State::Idle;
+    unsigned long stateSince = 0;
+    unsigned long lastStop = 0;
+    bool stoppedOnce = false;
+    std::uint8_t cycle = 0;
+    int moisture = 0;
+    bool hasMoisture = false;
+
+    unsigned long windowStart = 0;
+    unsigned long usedToday = 0;    // Laufzeit im aktuellen Budgetfenster ohne laufenden Zyklus
+
+    std::uint32_t relayWriteCount = 0;
+    std::uint32_t pumpCycleCount = 0;
+    std::uint32_t lockoutCount = 0;
+    unsigned long totalRun = 0;
+
+    void writeRelay(bool on)
+    {
+        this->relay(on);
+        this->relayWriteCount++;
+    }
+
+    void enter(State state, unsigned long now)
+    {
+        this->current = state;
+        this->stateSince = now;
+    }
+
+    unsigned long runTime(unsigned long now) const
+    {
+        return this->current == State::Watering ? now - this->stateSince : 0;
+    }
+
+    bool budgetLeft(unsigned long now) const
+    {
+        return this->usedToday + this->runTime(now) < this->config.dailyBudget;
+    }
+
+    void startWatering(unsigned long now)
+    {
+        this->cycle++;
+        this->pumpCycleCount++;
+        this->writeRelay(true);
+        this->enter(State::Watering, now);
+    }
+
+    void stopWatering(unsigned long now)
+    {
+        unsigned long ran = this->runTime(now);
+        this->usedToday += ran;
+        this->totalRun += ran;
+        this->lastStop = now;
+        this->stoppedOnce = true;
+        this->writeRelay(false);
+        this->enter(State::Soaking, now);
+    }
+
+    void rollBudgetWindow(unsigned long now)
+    {
+        while (now - this->windowStart >= this->config.budgetWindow) {
+            this->windowStart += this->config.budgetWindow;
+            // Ein laufender Zyklus wird vollständig dem neuen Fenster angerechnet
+            this->usedToday = 0;
+            if (this->current == State::Lockout) {
+                this->cycle = 0;
+                this->enter(State::Idle, now);
+            }
+        }
+    }
+
+public:
+    /**
+     * @param [in] relay Funktion, die das Pumpenrelais schaltet; wird nur bei Zustandswechseln aufgerufen.
+     * @param [in] now aktuelle ms-Zeit, Beginn des ersten Budgetfensters.
+     */
+    IrrigationController(const Config &config, RelayFunction relay, unsigned long now = 0)
+        : config(config), relay(relay), windowStart(now)
+    {
+    }
+
+    /**
+     * @brief Schaltet das Relais einmalig aus (definierter Startzustand), z.B. in setup().
+     */
+    void begin(unsigned long now)
+    {
+        this->windowStart = now;
+        this->stateSince = now;
+        this->writeRelay(false);
+    }
+
+    /**
+     * @brief Übernimmt eine neue Feuchtemessung und schaltet den Automaten weiter.
+     */
+    State update(unsigned long now, int moistureValue)
+    {
+        this->moisture = moistureValue;
+        this->hasMoisture = true;
+        return this->poll(now);
+    }
+
+    /**
+     * @brief Prüft die Zeitbedingungen mit der letzten Messung; zwischen den Messungen aufrufen,
+     *        damit maxRunTime und Budget genau eingehalten werden.
+     */
+    State poll(unsigned long now)
+    {
+        this->rollBudgetWindow(now);
+        if (!this->hasMoisture) {
+            return this->current;
+        }
+
+        switch (this->current) {
+        case State::Idle:
+            if (this->moisture <= this->config.startThreshold && this->budgetLeft(now)
+                && (!this->stoppedOnce || now - this->lastStop >= this->config.minOffTime)) {
+                this->cycle = 0;
+                this->startWatering(now);
+            }
+            break;
+        case State::Watering: {
+            unsigned long ran = now - this->stateSince;
+            bool wet = this->moisture >= this->config.stopThreshold && ran >= this->config.minRunTime;
+            if (wet || ran >= this->config.maxRunTime || !this->budgetLeft(now)) {
+                this->stopWatering(now);
+            }
+            break;
+        }
+        case State::Soaking:
+            if (now - this->stateSince < this->config.soakTime) {
+                break;
+            }
+            if (this->moisture >= this->config.stopThreshold) {
+                this->enter(State::Idle, now);
+            } else if (this->cycle < this->config.maxCycles && this->budgetLeft(now)) {
+                this->startWatering(now);
+            } else {
+                this->lockoutCount++;
+                this->enter(State::Lockout, now);
+            }
+            break;
+        case State::Lockout:
+            break;
+        }
+        return this->current;
+    }
+
+    State state() const { return this->current; }
+    bool pumpOn() const { return this->current == State::Watering; }
+    /** @brief Pumpenlaufzeit im aktuellen Budgetfenster in ms. */
+    unsigned long usedBudget(unsigned long now) const { return this->usedToday + this->runTime(now); }
+    /** @brief Gesamte Pumpenlaufzeit abgeschlossener Zyklen in ms. */
+    unsigned long totalRunTime() const { return this->totalRun; }
+    std::uint32_t relayWrites() const { return this->relayWriteCount; }
+    std::uint32_t pumpCycles() const { return this->pumpCycleCount; }
+    std::uint32_t lockouts() const { return this->lockoutCount; }
+};
+
+#endif //IRRIGATION_CONTROLLER_HPP__
@@ -2,6 +2,7 @@
 // LICENSE: Boost Software License
 /**
  * @file lcd_backlight.hpp
+ * @brief Wio Terminal LCD back light control with timer driven fades and auto-dim.
 */
 
 #ifndef LCD_BACKLIGHT_HPP__
@@ -10,14 +11,104 @@
 //#include <samd51p19a.h>
 #include <cstdint>
 
+/**
+ * @brief Perceived brightness (0-100 %) to PWM duty (0-100 %), gamma 2.2.
+ */
+constexpr std::uint8_t BackLightGamma[101] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   3,
+      3,   3,   4,   4,   4,   5,   5,   6,   6,   7,   7,   8,   8,   9,   9,  10,  11,  11,  12,  13,
+     13,  14,  15,  16,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31,
+     33,  34,  35,  36,  37,  39,  40,  41,  43,  44,  46,  47,  49,  50,  52,  53,  55,  56,  58,  60,
+     61,  63,  65,  66,  68,  70,  72,  74,  75,  77,  79,  81,  83,  85,  87,  89,  91,  94,  96,  98,
+    100,
+};
+
 /**
  * @brief Controls Wio Terminal LCD back light brightness
+ *
+ * Fades and the auto-dim timeout run in the TC1 overflow interrupt (1 kHz). The interrupt has to
+ * be forwarded to handleTimerInterrupt() from TC1_Handler(). The timer only runs while a fade is
+ * in progress or the auto-dim timeout is counting.
  */
 class LCDBackLight
 {
+public:
+    static constexpr std::uint32_t TickRate = 1000;   // TC1 interrupts per second
 private:
-    std::uint8_t currentBrightness = 100;
+    volatile std::uint8_t currentBrightness = 100;
     std::uint8_t maxBrightness = 100;
+    bool enabled = true;
+    bool gammaCorrection = false;
+
+    volatile bool fading = false;
+    volatile std::int32_t fadeLevel = 0;    // brightness in 16.16 fixed point
+    volatile std::int32_t fadeStep = 0;     // per tick
+    volatile std::uint8_t fadeTarget = 0;
+    volatile std::uint32_t fadeTicks = 0;
+
+    std::uint32_t autoDimTicks = 0;         // 0 = auto-dim off
+    std::uint8_t autoDimLevel = 20;
+    std::uint16_t autoDimFade = 1000;
+    volatile std::uint32_t idleTicks = 0;
+    volatile bool timerRunning = false;
+
+    std::uint8_t dutyFor(std::uint8_t brightness) const
+    {
+        if( !this->gammaCorrection || this->maxBrightness == 0 ) {
+            return brightness;
+        }
+        std::uint8_t percent = brightness * 100u / this->maxBrightness;
+        return (BackLightGamma[percent] * this->maxBrightness + 50u) / 100u;
+    }
+
+    void writeDuty(std::uint8_t brightness)
+    {
+        this->currentBrightness = brightness;
+        if( !this->enabled ) {
+            return;
+        }
+        TC0->COUNT8.CC[0].reg = this->dutyFor(brightness);
+        while(TC0->COUNT8.SYNCBUSY.bit.CC0);
+    }
+
+    void startTimer()
+    {
+        if( this->timerRunning ) {
+            return;
+        }
+        this->timerRunning = true;
+        TC1->COUNT16.CTRLA.bit.ENABLE = 1;
+        while( TC1->COUNT16.SYNCBUSY.bit.ENABLE );
+    }
+
+    void stopTimer()
+    {
+        TC1->COUNT16.CTRLA.bit.ENABLE = 0;
+        while( TC1->COUNT16.SYNCBUSY.bit.ENABLE );
+        this->timerRunning = false;
+    }
+
+    void beginFade(std::uint8_t target, std::uint32_t durationMs)
+    {
+        std::uint32_t ticks = durationMs * TickRate / 1000u;
+        if( ticks == 0 || target == this->currentBrightness ) {
+            this->fading = false;
+            this->writeDuty(target);
+            return;
+        }
+        this->fadeLevel = static_cast<std::int32_t>(this->currentBrightness) << 16;
+        this->fadeStep = (static_cast<std::int32_t>(target) - this->currentBrightness) * 65536 / static_cast<std::int32_t>(ticks);
+        if( this->fadeStep == 0 ) {
+            this->fadeStep = target > this->currentBrightness ? 1 : -1;
+        }
+        this->fadeTarget = target;
+        this->fading = true;
+    }
+
+    std::uint8_t clip(std::uint8_t brightness) const
+    {
+        return brightness < this->maxBrightness ? brightness : this->maxBrightness;
+    }
 public:
     /**
      * @brief Gets current brightness
@@ -37,10 +128,138 @@ public:
      */
     void setBrightness(std::uint8_t brightness)
     {
-        this->currentBrightness = brightness < this->maxBrightness ? brightness : this->maxBrightness;
-        TC0->COUNT8.CC[0].reg = this->currentBrightness;
+        NVIC_DisableIRQ(TC1_IRQn);
+        this->fading = false;   // a direct value cancels a running fade
+        this->writeDuty(this->clip(brightness));
+        NVIC_EnableIRQ(TC1_IRQn);
+    }
+    /**
+     * @brief Fades to a brightness in the background.
+     * @param [in] brightness target brightness, clipped to the maximum brightness.
+     * @param [in] durationMs fade duration in milliseconds. 0 sets the brightness immediately.
+     * @remark Returns immediately; each step costs one short interrupt.
+     */
+    void fadeTo(std::uint8_t brightness, std::uint32_t durationMs)
+    {
+        NVIC_DisableIRQ(TC1_IRQn);
+        this->beginFade(this->clip(brightness), durationMs);
+        if( this->fading ) {
+            this->startTimer();
+        }
+        NVIC_EnableIRQ(TC1_IRQn);
+    }
+    /**
+     * @brief Gets whether a fade is in progress.
+     */
+    bool isFading() const { return this->fading; }
+    /**
+     * @brief Enables gamma correction so equal brightness steps look equally large.
+     */
+    void setGammaCorrection(bool enabled)
+    {
+        this->gammaCorrection = enabled;
+        this->writeDuty(this->currentBrightness);
+    }
+    /**
+     * @brief Fades to a standby brightness after a period without activity.
+     * @param [in] timeoutMs inactivity time in milliseconds, 0 disables auto-dim.
+     * @param [in] brightness standby brightness.
+     * @param [in] fadeMs duration of the dimming fade.
+     * @remark Activity is reported with touch().
+     */
+    void setAutoDim(std::uint32_t timeoutMs, std::uint8_t brightness, std::uint16_t fadeMs = 1000)
+    {
+        NVIC_DisableIRQ(TC1_IRQn);
+        this->autoDimTicks = timeoutMs * TickRate / 1000u;
+        this->autoDimLevel = brightness;
+        this->autoDimFade = fadeMs;
+        this->idleTicks = 0;
+        if( this->autoDimTicks ) {
+            this->startTimer();
+        }
+        NVIC_EnableIRQ(TC1_IRQn);
+    }
+    /**
+     * @brief Reports activity; restarts the auto-dim timeout.
+     */
+    void touch()
+    {
+        this->idleTicks = 0;
+        if( this->autoDimTicks && !this->timerRunning ) {
+            NVIC_DisableIRQ(TC1_IRQn);
+            this->startTimer();
+            NVIC_EnableIRQ(TC1_IRQn);
+        }
+    }
+    /**
+     * @brief Gets the number of interrupts spent on fades since start.
+     */
+    std::uint32_t getFadeTicks() const { return this->fadeTicks; }
+
+    /**
+     * @brief TC1 overflow handler, call from TC1_Handler().
+     */
+    void handleTimerInterrupt()
+    {
+        TC1->COUNT16.INTFLAG.reg = 0x01;   // Clear OVF
+
+        if( this->autoDimTicks && this->idleTicks < this->autoDimTicks ) {
+            if( ++this->idleTicks == this->autoDimTicks && this->currentBrightness > this->autoDimLevel ) {
+                this->beginFade(this->clip(this->autoDimLevel), this->autoDimFade);
+            }
+        }
+
+        if( this->fading ) {
+            this->fadeTicks++;
+            std::int32_t level = this->fadeLevel + this->fadeStep;
+            std::int32_t target = static_cast<std::int32_t>(this->fadeTarget) << 16;
+            if( (this->fadeStep > 0 && level >= target) || (this->fadeStep < 0 && level <= target) ) {
+                level = target;
+                this->fading = false;
+            }
+            this->fadeLevel = level;
+            std::uint8_t brightness = static_cast<std::uint8_t>((level + 0x8000) >> 16);
+            if( brightness != this->currentBrightness ) {
+                this->writeDuty(brightness);
+            }
+        }
+
+        if( !this->fading && (this->autoDimTicks == 0 || this->idleTicks >= this->autoDimTicks) ) {
+            this->stopTimer();
+        }
+    }
+    /**
+     * @brief Turns the back light off and stops the PWM timer to save power.
+     * @remark The brightness is kept and restored by enable().
+     */
+    void disable()
+    {
+        NVIC_DisableIRQ(TC1_IRQn);
+        this->fading = false;
+        NVIC_EnableIRQ(TC1_IRQn);
+        TC0->COUNT8.CC[0].reg = 0u;   // 0% duty keeps the output low while the timer stops
         while(TC0->COUNT8.SYNCBUSY.bit.CC0);
+        TC0->COUNT8.CTRLA.bit.ENABLE = 0;
+        while( TC0->COUNT8.SYNCBUSY.bit.ENABLE );
+        this->enabled = false;
     }
+    /**
+     * @brief Restarts the PWM timer with the current brightness.
+     */
+    void enable()
+    {
+        TC0->COUNT8.CC[0].reg = this->dutyFor(this->currentBrightness);
+        while(TC0->COUNT8.SYNCBUSY.bit.CC0);
+        TC0->COUNT8.CTRLA.bit.ENABLE = 1;
+        while( TC0->COUNT8.SYNCBUSY.bit.ENABLE );
+        this->enabled = true;
+    }
+    /**
+     * @brief Gets whether the back light is on.
+     * @return false after disable().
+     */
+    bool isEnabled() const { return this->enabled; }
+
     /**
      * @brief Sets maximum brightness.
      * @param [in] maxBrightness new value of maximum brightness. If the current brightness value exceeds maximum brightness, the current brightness will be clipped.
@@ -54,7 +273,7 @@ public:
         }
         TC0->COUNT8.PER.reg = this->maxBrightness;
         while(TC0->COUNT8.SYNCBUSY.bit.PER);
-        TC0->COUNT8.CC[0].reg = this->currentBrightness;
+        TC0->COUNT8.CC[0].reg = this->dutyFor(this->currentBrightness);
         while(TC0->COUNT8.SYNCBUSY.bit.CC0);
     }
 
@@ -73,6 +292,7 @@ public:
         while(!GCLK->PCHCTRL[33].bit.CHEN);
         /* Enable Peropheral APB Clocks */
         MCLK->APBAMASK.bit.TC0_ = 1;
+        MCLK->APBAMASK.bit.TC1_ = 1;
         MCLK->APBBMASK.bit.EVSYS_ = 1;
         MCLK->APBCMASK.bit.CCL_ = 1;
 
@@ -104,6 +324,21 @@ public:
         
         TC0->COUNT8.CTRLA.bit.ENABLE = 1;   // ENABLE
         while( TC0->COUNT8.SYNCBUSY.bit.ENABLE );
+
+        /* Configure TC1 as 1 kHz fade tick (120 MHz / 64 / 1875), started on demand */
+        TC1->COUNT16.CTRLA.reg = (1u<<0);   // SWRST;
+        while( TC1->COUNT16.SYNCBUSY.bit.SWRST );
+
+        TC1->COUNT16.CTRLA.reg = (0x00 << 2) | (0x01 << 4) | (0x06 << 8);   // MODE=COUNT16, PRESCALER=DIV64, PRESCSYNC=PRESC
+        TC1->COUNT16.WAVE.reg  = 0x01; // WAVEGEN=MFRQ, TOP=CC0
+        TC1->COUNT16.CC[0].reg = 120000000u / 64u / TickRate - 1u;
+        TC1->COUNT16.INTFLAG.reg = 0x33;    // Clear all flags
+        TC1->COUNT16.INTENSET.reg = 0x01;   // OVF
+        while( TC1->COUNT16.SYNCBUSY.reg );
+
+        NVIC_SetPriority(TC1_IRQn, 3);      // lowest priority, fades are not time critical
+        NVIC_ClearPendingIRQ(TC1_IRQn);
+        NVIC_EnableIRQ(TC1_IRQn);
     }
 };
 #endif //LCD_BACKLIGHT_HPP__
\ No newline at end of file
@@ -1,15 +1,24 @@
 //Libaries
 #include "config.h"
-#include <Arduino.h>
-#include <TFT_eSPI.h>   // Bibliothek für das Display des Wio Terminals
-#include "DHT.h"        // Bibliothek für Grove Temperature & Humidity Sensor
-#include <rpcWiFi.h>    // Bibliothek für WLAN-Verbindung
-#include <RTClib.h>
-#include <SD.h>
-#include <WiFiUdp.h>    // Bibliothek für UDP-Verbindung (NTP nutzt UDP)
-#include <Wire.h>       // I2C-Bibliothek für VL53L0X
-#include <Adafruit_VL53L0X.h>  // VL53L0X-Bibliothek für Entfernungsmessung
-#include "lcd_backlight.hpp"
+#include "hal.hpp"      // Bibliotheken des Wio Terminals bzw. Simulator (env:native)
+#include "sd_logger.hpp"
+#include "sensor_sampler.hpp"
+#include "scheduler.hpp"
+#include "ntp_client.hpp"
+#include "display_widgets.hpp"
+#include "plant_state.hpp"
+#include "sunflower.hpp"
+#include "heap_monitor.hpp"
+#include "moisture_filter.hpp"
+#include "irrigation_controller.hpp"
+#include "proximity_detector.hpp"
+#include "power_manager.hpp"
+#include "peripheral_health.hpp"
+#include "telemetry_uplink.hpp"
+#include "telemetry_queue.hpp"
+#include "sd_queue.hpp"
+#include "wifi_manager.hpp"
+#include "profiler.hpp"
 
 //Definitionen
 #define MOISTURE_PIN A2     // Pin A2 für den Feuchtigkeitssensor am rechten Grove-Anschluss
@@ -19,505 +28,1140 @@
 #define SDCARD_SS_PIN       // CS-Pin für die SD-Karte, prüfen Sie Ihren Anschluss!
 #define DIST_THRESHOLD 100  // Abstandsschwelle in mm für das Display (wenn unter diesem Wert wird das Display aktualisiert)
 #define TFT_DARKORANGE  0xFCC0
-#define TFT_DARKYELLOW  0xCD00
 
-File dataFile;              // Dateiobjekt für das Speichern der Daten
-DHT dht(DHT_PIN, DHT_TYPE); // DHT-Sensor-Objekt erstellen
-TFT_eSPI tft = TFT_eSPI();  // Display-Objekt erstellen
-RTC_DS3231 rtc;             // RTC-Objekt erstellen
-Adafruit_VL53L0X lox = Adafruit_VL53L0X(); // Instanz für Distanz Sensor 
-static LCDBackLight backLight;
+hal::File dataFile;              // Dateiobjekt für das Speichern der Daten
+SdLogger<hal::File> sampleLogger; // Gepufferter Binär-Logger, hält dataFile dauerhaft geöffnet
+hal::ClimateSensor dht(DHT_PIN, DHT_TYPE); // DHT-Sensor-Objekt erstellen
+hal::Display tft;           // Display-Objekt erstellen
+hal::Rtc rtc;               // RTC-Objekt erstellen
+hal::RangeSensor lox;       // Instanz für Distanz Sensor
+static hal::BackLight backLight;
 
 // Konfiguration für NTP
-const char* ntpServer = "pool.ntp.org"; // NTP-Server-Adresse
-const int ntpPort = 123;                // NTP-Port (Standard ist 123)
-WiFiUDP udp;                            // UDP-Instanz für NTP
+const char* ntpServers[] = {"pool.ntp.org", "time.google.com", "ptbtime1.ptb.de"}; // NTP-Server, der Reihe nach gefragt
+const unsigned long ntpPollInterval = 50;                   // Intervall für die Abfrage der NTP-Antwort
+const unsigned long ntpResyncInterval = 24UL * 3600 * 1000; // Erneute Synchronisation einmal täglich
+const long rtcDriftThresholdMs = 2000;                      // RTC nur stellen, wenn sie stärker abweicht
+hal::Udp udp;                           // UDP-Instanz für NTP
+NtpClient<hal::Udp> ntpClient(udp, ntpServers, sizeof(ntpServers) / sizeof(ntpServers[0]));
+// Letzte NTP-Zeit (UTC in ms) und die ms-Zeit dazu; ersetzt eine fehlende RTC, solange gültig
+bool ntpTimeValid = false;
+int64_t ntpUtcMs = 0;
+unsigned long ntpUtcAt = 0;
 
 // Offset für Zeitzone (in Sekunden)
 const long gmtOffsetSec = 3600;
 int daylightOffsetSec = 0; // Sommerzeit-Offset in Sekunden
 
-int lastMoistureValue = -1; // Speichern des vorherigen Feuchtigkeitswerts
-float lastTemperature = -1000; // Speichern des vorherigen Temperaturwerts
-float lastHumidity = -1000; // Speichern des vorherigen Feuchtigkeitswerts
+// Widgets des Hauptbildschirms, sie merken sich den zuletzt gezeichneten Inhalt
+WidgetScreen<hal::Display> mainView(tft);
+Label<hal::Display> timeLabel(10, 10, "Uhrzeit:", TFT_WHITE, TFT_BLACK);
+Label<hal::Display> moistureLabel(10, 50, "Pflanze F.:", TFT_WHITE, TFT_BLACK);
+Label<hal::Display> temperatureLabel(10, 90, "Temperatur:", TFT_WHITE, TFT_BLACK);
+Label<hal::Display> humidityLabel(10, 130, "Luft F.:", TFT_WHITE, TFT_BLACK);
+Label<hal::Display> statusLabel(10, 170, "Status:", TFT_WHITE, TFT_BLACK);
+ClockWidget<hal::Display> clockField(200, 10, TFT_WHITE, TFT_BLACK);
+NumberField<hal::Display> moistureField(200, 50, 0, "", TFT_WHITE, TFT_BLACK);
+NumberField<hal::Display> temperatureField(200, 90, 2, " C", TFT_WHITE, TFT_BLACK);
+NumberField<hal::Display> humidityField(200, 130, 2, " %", TFT_WHITE, TFT_BLACK);
+StatusBanner<hal::Display> statusBanner(20, 210, TFT_BLACK);
 
-unsigned long previousTimeUpdate = 0; // Letzte Aktualisierung der Uhrzeit
-unsigned long previousSensorUpdate = 0; // Letzte Aktualisierung der Sensorwerte
 const unsigned long timeInterval = 1000; // Intervall für Zeitaktualisierung (1 Sekunde)
 const unsigned long sensorInterval = 4000; // Intervall für Sensoraktualisierung (4 Sekunden)
 const unsigned long displayTimeout = 15000; // Timeout für die Anzeige von Sensorwerten (15 Sekunden)
+const uint8_t activeBrightness = 100;
+const uint8_t standbyBrightness = 48; // mit Gammakorrektur, entspricht dem bisherigen PWM-Wert 20
 bool isDisplayingSensorValues = false;
 unsigned long displayUpdateTime = 0;
-bool firstMainScreen = false;
-unsigned long previousFlowerUpdate = 0;
+bool bootComplete = false; // true, sobald WLAN/NTP-Meldungen durch den Hauptbildschirm ersetzt wurden
+const unsigned long proximityInterval = 50; // Intervall für die Abfrage, ob eine neue Abstandsmessung vorliegt
+const uint16_t rangingPeriod = 100; // Messperiode des VL53L0X im Continuous-Mode in ms
+ProximityDetector proximity(DIST_THRESHOLD, DIST_THRESHOLD + 50); // 50 mm Hysterese zum Verlassen
+int standbyTask = Scheduler::InvalidTask;
+
+// Energiesparen: im Standby nach lowPowerDelay Hintergrundbeleuchtung aus und Abstandssensor seltener messen
+const unsigned long lowPowerDelay = 60000;
+const uint16_t lowPowerRangingPeriod = 500; // Reaktionszeit auf Annäherung im Energiesparmodus
+const unsigned long maxRestTime = 1000;     // längste Schlafphase am Stück
+// Geschätzte Stromaufnahme je Zustand (Active, Idle, Sleep) in µA, mit einem Messgerät genauer bestimmen
+const uint32_t stateCurrents[PowerManager::StateCount] = {95000, 70000, 30000};
+int lowPowerTask = Scheduler::InvalidTask;
+
+PowerManager powerManager(millis, hal::sleepUntil);
+const unsigned long bootMessageTime = 2000; // Anzeigedauer der WLAN- und NTP-Meldungen
+
+Scheduler scheduler(millis); // Führt alle periodischen Aufgaben aus loop() aus
+int ntpPollTask = Scheduler::InvalidTask;
+int bootTask = Scheduler::InvalidTask;
+
+// WLAN im Hintergrund: Verbindungsaufbau ohne Warten, neuer Versuch nach 5 s bis 5 min (mit Jitter).
+// Die Verbindung besteht nur, solange NTP oder der Uplink sie angefordert haben.
+WiFiManager<hal::Network, WL_CONNECTED> wifiManager(WiFi, ssid, password);
+const unsigned long wifiBootWait = 10000;    // so lange wartet die Startanzeige höchstens auf das WLAN
+const unsigned long ntpWiFiTimeout = 60000;  // ohne WLAN wird die NTP-Synchronisation danach verschoben
+const unsigned long ntpRetryInterval = 3600000UL;
+bool ntpSyncPending = false;                 // Synchronisation angefordert, aber noch nicht abgeschlossen
+int ntpWaitTask = Scheduler::InvalidTask;
+
+void readSensors(Sample &sample);
+SensorSampler sensorSampler(readSensors, sensorInterval); // Liest alle Sensoren einmal pro Intervall
+MoistureFilter<9> moistureFilter(2); // Median über 9 Wandlungen, danach Tiefpass mit alpha 1/4
+HeapMonitor heapMonitor;    // Heap-Statistik, Ausgabe mit 'h' im Serial Monitor
+
+// Zustand der Peripherie; ausgefallene Teile werden im Hintergrund neu initialisiert, die Bewässerung läuft weiter
+PeripheralHealth health;
+int rtcHealth = PeripheralHealth::InvalidId;
+int tofHealth = PeripheralHealth::InvalidId;
+int sdHealth = PeripheralHealth::InvalidId;
+int dhtHealth = PeripheralHealth::InvalidId;
+int wifiHealth = PeripheralHealth::InvalidId;
+hal::Watchdog watchdog;
+const uint32_t watchdogTimeout = 16000; // Reset, wenn der Scheduler so lange keine Aufgabe ausführt
+
+// Laufzeitprofil einzelner Abschnitte (nur mit -DAQUA_PROFILE), Ausgabe mit 'r' im Serial Monitor
+#ifdef AQUA_PROFILE
+Profiler profiler(hal::cycleCount, hal::CyclesPerMicrosecond);
+const unsigned long profileTelemetryInterval = 3600000UL; // Maxima je Abschnitt an den IoT Hub, 0 = nicht senden
+#endif
+PROFILE_REGION(profiler, profileReadSensors, "readsensors");  // ADC-Serie und DHT
+PROFILE_REGION(profiler, profileSensorData, "sensordata");    // Widgets des Hauptbildschirms
+PROFILE_REGION(profiler, profileSunflower, "sunflower");      // Sonnenblume vollständig zeichnen
+PROFILE_REGION(profiler, profileMoodPush, "moodpush");        // Mundpartie aus dem Sprite übertragen
+PROFILE_REGION(profiler, profileLogSd, "logsd");              // Messwert in den Log-Puffer
+PROFILE_REGION(profiler, profileSdFlush, "sdflush");          // Log und Warteschlange auf die Karte schreiben
+PROFILE_REGION(profiler, profileTofRead, "tofread");          // Messergebnis des VL53L0X abholen
+PROFILE_REGION(profiler, profileNtpStart, "ntpstart");        // NTP-Anfrage senden
+
+// Zeit vom Start bis zur ersten Bewässerungsentscheidung bzw. zum ersten Einschalten der Pumpe
+unsigned long firstIrrigationCheckAt = 0;
+unsigned long firstWateringAt = 0;
+
+// Aktuelle RTC-Zeit oder 0 ohne RTC
+uint32_t currentUnixTime() {
+    return health.ok(rtcHealth) ? rtc.now().unixtime() : 0;
+}
 
-void connectToWiFi() {
-    int maxRetries = 2;  // Maximale Anzahl an Versuchen
-    int retryCount = 0;  // Zähler für Versuche
+bool initRtc() {
+    return rtc.begin();
+}
 
-    tft.setCursor(10, 10);
-    tft.setTextColor(TFT_WHITE);
-    tft.setTextSize(2);
-    tft.println("Verbinde mit WLAN...");
-    Serial.println("Verbinde mit WLAN...");
+bool initTof() {
+    if (!lox.begin()) {
+        return false;
+    }
+    // misst selbstständig, proximityTask holt nur das Ergebnis ab
+    lox.startRangeContinuous(powerManager.isLowPower() ? lowPowerRangingPeriod : rangingPeriod);
+    return true;
+}
+
+// Telemetrie an den Azure IoT Hub: 10 Messwerte pro Publish. Offline wird auf der SD-Karte gepuffert
+// (bis 128 Segmente zu 32 KB, rund 4 Wochen), ohne Karte bis zu 120 Einträge (8 min) im RAM.
+// Nach einem Ausfall wird der Rückstand mit 48 Einträgen alle 2 s nachgeliefert.
+// Erst mit eingetragenem Geräteschlüssel; ohne Root-CA würde der Server nicht geprüft
+const bool uplinkEnabled = strcmp(iotDeviceKey, "XX") != 0 && iotHubRootCA != nullptr;
+typedef SdQueue<hal::Storage, hal::File> TelemetryStore;
+TelemetryStore telemetryStore(SD, "/queue", O_READ | O_WRITE | O_CREAT, O_READ);
+telemetry::FallbackQueue<TelemetryStore, 120> telemetryQueue(telemetryStore);
+bool generateSasPassword(const az_iot_hub_client *client, uint64_t expiry, char *password, size_t size);
+hal::SecureClient tlsClient;
+hal::MqttClient mqttClient(tlsClient);
+TelemetryUplink<hal::MqttClient, decltype(telemetryQueue)> uplink(mqttClient, telemetryQueue, generateSasPassword);
+
+bool initSd() {
+    if (!SD.begin(SDCARD_SS_PIN)) {
+        return false;
+    }
+    // Log-Datei öffnen (bleibt geöffnet, ohne O_APPEND, da der letzte Block überschrieben wird)
+    dataFile = SD.open("sensors.bin", O_READ | O_WRITE | O_CREAT);
+    if (!dataFile || !sampleLogger.begin(dataFile, millis(), currentUnixTime())) {
+        return false;
+    }
+    // Telemetrie-Warteschlange wiederherstellen; ohne sie puffert der Uplink im RAM
+    if (uplinkEnabled && !telemetryStore.begin(millis())) {
+        Serial.println("Telemetrie-Warteschlange auf der SD-Karte nicht verfuegbar.");
+    }
+    return true;
+}
 
-    WiFi.begin(ssid, password);
+// Aktuelle Zeit in UTC (RTC läuft in Ortszeit); ohne RTC ab der ersten NTP-Antwort aus millis() fortgeschrieben,
+// davor 0
+uint32_t currentUtcTime() {
+    uint32_t local = currentUnixTime();
+    if (local) {
+        return local - gmtOffsetSec - daylightOffsetSec;
+    }
+    return ntpTimeValid ? (uint32_t)((ntpUtcMs + (int64_t)(millis() - ntpUtcAt)) / 1000) : 0;
+}
 
-    // Wiederhole Verbindung bis Maximum erreicht ist
-    while (WiFi.status() != WL_CONNECTED && retryCount < maxRetries) {
-        delay(500);
-        Serial.print(".");
-        tft.print(".");
-        retryCount++;
+// Ereignis für den IoT Hub einreihen (z.B. Pumpe an/aus)
+void queueEvent(const char *name, int32_t value) {
+    if (uplinkEnabled) {
+        telemetryQueue.push(telemetry::eventEntry(currentUtcTime(), name, value));
     }
+}
 
-    if (WiFi.status() == WL_CONNECTED) {
-        tft.fillScreen(TFT_BLACK);  // Bildschirm sofort nach Verbindung leeren
-        tft.setTextColor(TFT_GREEN);
-        tft.setTextSize(2);
-        tft.setCursor(10, 10);
-        tft.println("WLAN verbunden!");
-        Serial.println("\nWLAN verbunden!");
-    } else {
-        tft.fillScreen(TFT_BLACK);  // Bildschirm leeren
-        tft.setTextColor(TFT_RED);
-        tft.setTextSize(2);
-        tft.setCursor(10, 10);
-        tft.println("WLAN fehlgeschlagen!");
-        Serial.println("\nWLAN fehlgeschlagen!");
+// MQTT-Passwort (SAS-Token): Base64(HMAC-SHA256(Geräteschlüssel, Signatur)) im Format des IoT Hubs
+bool generateSasPassword(const az_iot_hub_client *client, uint64_t expiry, char *password, size_t size) {
+    uint8_t signatureBuffer[256];
+    az_span signature = AZ_SPAN_FROM_BUFFER(signatureBuffer);
+    if (az_result_failed(az_iot_hub_client_sas_get_signature(client, expiry, signature, &signature))) {
+        return false;
+    }
+
+    uint8_t key[64];
+    size_t keyLength = 0;
+    if (!hal::base64Decode(key, sizeof(key), &keyLength, (const uint8_t *)iotDeviceKey, strlen(iotDeviceKey))) {
+        return false;
+    }
+    uint8_t hmac[32];
+    if (!hal::hmacSha256(key, keyLength, az_span_ptr(signature), az_span_size(signature), hmac)) {
+        return false;
+    }
+
+    uint8_t hmacBase64[48];
+    size_t hmacBase64Length = 0;
+    if (!hal::base64Encode(hmacBase64, sizeof(hmacBase64), &hmacBase64Length, hmac, sizeof(hmac))) {
+        return false;
     }
+    return az_result_succeeded(az_iot_hub_client_sas_get_password(client, expiry,
+                                                                  az_span_create(hmacBase64, (int32_t)hmacBase64Length),
+                                                                  AZ_SPAN_EMPTY, password, size, NULL));
+}
 
-    delay(2000); 
+void getNtpTime();
+
+void wifiTask() {
+    wifiManager.poll(millis());
 }
 
-void getNtpTime() {
-    // Display Ausgabe
+// Meldung während des Starts; der Hauptbildschirm folgt nach bootMessageTime
+void showBootMessage(const char *text, uint16_t color) {
     tft.fillScreen(TFT_BLACK);
-    tft.setCursor(10, 10);
-    tft.setTextColor(TFT_WHITE);
+    tft.setTextColor(color);
     tft.setTextSize(2);
-    tft.println("NTP Zeit festlegen...");
-    Serial.println("NTP Zeit festlegen...");
-
-    // UDP starten
-    udp.begin(ntpPort);
-    Serial.println("NTP-Client gestartet...");
+    tft.setCursor(10, 10);
+    tft.println(text);
+    scheduler.reschedule(bootTask, bootMessageTime);
+}
 
-    // NTP-Anfrage vorbereiten
-    byte packetBuffer[48]; // NTP-Paket hat eine feste Größe von 48 Bytes
-    memset(packetBuffer, 0, 48);
-
-    // NTP-Paket Header konfigurieren
-    packetBuffer[0] = 0b11100011; // LI, Version, Mode
-    packetBuffer[1] = 0;          // Stratum
-    packetBuffer[2] = 6;          // Polling Interval
-    packetBuffer[3] = 0xEC;       // Precision
-
-    // NTP-Anfrage an den Server senden
-    udp.beginPacket(ntpServer, ntpPort);
-    udp.write(packetBuffer, 48);
-    udp.endPacket();
-
-    // Warten auf Antwort
-    delay(1000);
-
-    if (udp.parsePacket()) {
-        Serial.println("Antwort vom NTP-Server erhalten!");
-
-        // NTP-Antwort lesen
-        udp.read(packetBuffer, 48);
-
-        // Zeitstempel auslesen (Bytes 40–43 im Paket enthalten die Zeit in Sekunden seit 1900)
-        unsigned long highWord = word(packetBuffer[40], packetBuffer[41]);
-        unsigned long lowWord = word(packetBuffer[42], packetBuffer[43]);
-        unsigned long secsSince1900 = (highWord << 16) | lowWord;
-
-        // Epoch-Zeit berechnen (1970 ist der Startpunkt der Unix-Zeit)
-        const unsigned long seventyYears = 2208988800UL;
-        unsigned long epoch = secsSince1900 - seventyYears;
-
-        // Berechnung für Sommerzeit oder Winterzeit
-        DateTime now = rtc.now();  
-        int year = now.year();
-        DateTime lastSundayMarch(year, 3, 31);
-        while (lastSundayMarch.dayOfTheWeek() != 0) {
-            lastSundayMarch = lastSundayMarch - TimeSpan(1);
+// Verbindungsereignisse des WLANs: NTP startet erst mit bestehender Verbindung
+void onWiFiEvent(WiFiManager<hal::Network, WL_CONNECTED>::Event event, unsigned long now) {
+    switch (event) {
+    case WiFiManager<hal::Network, WL_CONNECTED>::Event::Connected:
+        health.report(wifiHealth, true, now);
+        Serial.println("WLAN verbunden!");
+        if (!bootComplete) {
+            showBootMessage("WLAN verbunden!", TFT_GREEN);
         }
-        DateTime lastSundayOctober(year, 10, 31);
-        while (lastSundayOctober.dayOfTheWeek() != 0) {
-            lastSundayOctober = lastSundayOctober - TimeSpan(1);
-        }
-        if (now >= lastSundayMarch && now <= lastSundayOctober) {
-            daylightOffsetSec = 3600;  // Sommerzeit-Offset
-            Serial.println("Sommerzeit aktiv.");
-        } else {
-            daylightOffsetSec = 0;  // Kein Sommerzeit-Offset
-            Serial.println("Winterzeit aktiv.");
+        if (ntpSyncPending && !ntpClient.busy()) {
+            getNtpTime();
         }
-        
-        // Zeitzonen-Offset anwenden
-        epoch += gmtOffsetSec;
-        if (daylightOffsetSec) {
-            epoch += daylightOffsetSec;
+        break;
+    case WiFiManager<hal::Network, WL_CONNECTED>::Event::Disconnected:
+        Serial.println("WLAN-Verbindung unterbrochen.");
+        break;
+    case WiFiManager<hal::Network, WL_CONNECTED>::Event::ConnectFailed:
+        health.report(wifiHealth, false, now);
+        Serial.println("WLAN fehlgeschlagen, neuer Versuch im Hintergrund.");
+        if (!bootComplete) {
+            showBootMessage("WLAN fehlgeschlagen!", TFT_RED);
         }
+        break;
+    }
+}
 
-        // RTC synchronisieren
-        rtc.adjust(DateTime(epoch));
-        Serial.println("RTC erfolgreich synchronisiert!");
+// Offset der Ortszeit (Zeitzone und Sommerzeit) zu einer UTC-Zeit in Sekunden
+long localOffsetSec(uint32_t utc) {
+    // Berechnung für Sommerzeit oder Winterzeit
+    DateTime now(utc + gmtOffsetSec);
+    int year = now.year();
+    DateTime lastSundayMarch(year, 3, 31);
+    while (lastSundayMarch.dayOfTheWeek() != 0) {
+        lastSundayMarch = lastSundayMarch - TimeSpan(1);
+    }
+    DateTime lastSundayOctober(year, 10, 31);
+    while (lastSundayOctober.dayOfTheWeek() != 0) {
+        lastSundayOctober = lastSundayOctober - TimeSpan(1);
+    }
+    if (now >= lastSundayMarch && now <= lastSundayOctober) {
+        daylightOffsetSec = 3600;  // Sommerzeit-Offset
     } else {
-        Serial.println("Keine Antwort vom NTP-Server erhalten!");
+        daylightOffsetSec = 0;  // Kein Sommerzeit-Offset
     }
+    return gmtOffsetSec + daylightOffsetSec;
+}
 
-    udp.stop(); // UDP beenden
+void pollNtpTime();
+void requestNtpSync();
+
+// NTP-Synchronisation abschließen, WLAN freigeben und die nächste einplanen
+void finishNtpSync(unsigned long next) {
+    ntpSyncPending = false;
+    wifiManager.release();
+    scheduler.addOneShot("ntpresync", requestNtpSync, next);
 }
 
-// Funktion zum Zeichnen eines Kreisbogens
-void drawArc(int x, int y, int r, int startAngle, int endAngle, uint16_t color, int thickness) {
-    for (int i = startAngle; i <= endAngle; i++) {
-    float angle = i * 3.14159 / 180.0;
-    int x0 = x + (int)(cos(angle) * r);
-    int y0 = y - (int)(sin(angle) * r);
-    tft.drawPixel(x0, y0, color);
+void ntpWaitTimeoutTask() {
+    ntpWaitTask = Scheduler::InvalidTask;
+    if (ntpSyncPending && !ntpClient.busy()) {
+        Serial.println("Kein WLAN, NTP-Synchronisation verschoben.");
+        finishNtpSync(ntpRetryInterval);
+    }
+}
 
-        for (int j = -thickness / 2; j < thickness / 2; j++) {
-            tft.drawPixel(x0 + j, y0, color);
+// NTP-Synchronisation anfordern; gestartet wird sie, sobald das WLAN verbunden ist
+void requestNtpSync() {
+    if (ntpSyncPending) {
+        return;
+    }
+    ntpSyncPending = true;
+    wifiManager.acquire();
+    if (wifiManager.isConnected()) {
+        getNtpTime();
+    } else {
+        ntpWaitTask = scheduler.addOneShot("ntpwait", ntpWaitTimeoutTask, ntpWiFiTimeout);
+    }
+}
+
+// NTP-Synchronisation starten, die Antwort wird von pollNtpTime ohne Warten abgeholt
+void getNtpTime() {
+    PROFILE_SCOPE(profiler, profileNtpStart);
+    scheduler.cancel(ntpWaitTask);
+    ntpWaitTask = Scheduler::InvalidTask;
+
+    // Zeitschätzung aus der RTC bzw. der letzten NTP-Antwort
+    int64_t utcEstimateMs = (int64_t)currentUtcTime() * 1000;
+    ntpClient.start(millis(), utcEstimateMs);
+    Serial.println("NTP-Client gestartet...");
+    if (!bootComplete) {
+        tft.setTextColor(TFT_WHITE);
+        tft.println("NTP Zeit festlegen...");
+    }
+    if (!scheduler.isActive(ntpPollTask)) {
+        ntpPollTask = scheduler.addPeriodic("ntp", pollNtpTime, ntpPollInterval);
+    }
+}
+
+void pollNtpTime() {
+    unsigned long now = millis();
+    if (ntpClient.poll(now) != NtpClient<hal::Udp>::State::Synced) {
+        if (!ntpClient.busy()) {
+            scheduler.cancel(ntpPollTask);
+            ntpPollTask = Scheduler::InvalidTask;
+            Serial.println("Keine Antwort vom NTP-Server erhalten!");
+            finishNtpSync(ntpRetryInterval);
         }
+        return;
     }
+    scheduler.cancel(ntpPollTask);
+    ntpPollTask = Scheduler::InvalidTask;
+
+    char line[96];
+    snprintf(line, sizeof(line), "Antwort von %s: Offset %ld ms, Laufzeit %ld ms, synchronisiert nach %lu ms",
+             ntpClient.server(), (long)ntpClient.offsetMs(), (long)ntpClient.delayMs(), ntpClient.timeToSync());
+    Serial.println(line);
+
+    // Zeitzonen-Offset anwenden
+    int64_t utcMs = ntpClient.unixMs(now);
+    ntpUtcMs = utcMs;
+    ntpUtcAt = now;
+    ntpTimeValid = true;
+    uint32_t utc = (uint32_t)(utcMs / 1000);
+    uint32_t local = utc + localOffsetSec(utc);
+    Serial.println(daylightOffsetSec ? "Sommerzeit aktiv." : "Winterzeit aktiv.");
+
+    // RTC nur bei nennenswerter Abweichung synchronisieren
+    if (!health.ok(rtcHealth)) {
+        Serial.println("Keine RTC, Zeit nicht gestellt.");
+        finishNtpSync(ntpResyncInterval);
+        return;
+    }
+    int64_t driftMs = (int64_t)local * 1000 + utcMs % 1000 - (int64_t)rtc.now().unixtime() * 1000;
+    if (driftMs > rtcDriftThresholdMs || driftMs < -rtcDriftThresholdMs) {
+        rtc.adjust(DateTime(local));
+        Serial.println("RTC erfolgreich synchronisiert!");
+    } else {
+        Serial.println("RTC-Abweichung innerhalb der Toleranz, nicht gestellt.");
+    }
+    finishNtpSync(ntpResyncInterval);
 }
 
 // Funktion zum Zeichnen der Sonnenblume
-void drawSunflower(String mood, uint16_t faceColor) {
+void drawSunflower(plant::Mood mood, uint16_t faceColor) {
+    PROFILE_SCOPE(profiler, profileSunflower);
     tft.fillScreen(TFT_BLACK); // Bildschirm löschen
 
-    int centerX = 160; // horizontal zentriert
-    int centerY = 90;  
-    int faceRadius = 50; // Radius des Gesichts
-
-    for (int angle = 0; angle < 360; angle += 30) {
-    float rad = angle * 3.14159 / 180.0;
-    int xOffset = (int)(cos(rad) * 60);
-    int yOffset = (int)(sin(rad) * 60);
+    sunflower::Colors colors = {TFT_YELLOW, faceColor, TFT_BLACK};
+    sunflower::drawHead(tft, 0, 0, mood, colors);
+    sunflower::drawStem(tft, TFT_GREEN);
+}
 
-    tft.fillCircle(centerX + xOffset,centerY + yOffset,20,TFT_YELLOW);
+// Beim Start vorgerenderte Mundpartie je Stimmung (4-Bit-Palette, ca. 1,2 KB je Sprite).
+// Nur dieser Bereich unterscheidet sich zwischen den Stimmungen.
+hal::Sprite sadSprite(&tft);
+hal::Sprite neutralSprite(&tft);
+hal::Sprite happySprite(&tft);
+hal::Sprite *const moodSprites[plant::MoodCount] = {&sadSprite, &neutralSprite, &happySprite}; // Reihenfolge wie plant::Mood
+bool moodSpritesReady = false;
+bool sunflowerShown = false; // false = Sonnenblume nicht auf dem Bildschirm
+plant::Mood shownMood = plant::Mood::Neutral;
+
+void renderMoodSprites() {
+    sunflower::Colors colors = {1, 2, 3}; // Palettenindizes
+    for (uint8_t i = 0; i < plant::MoodCount; i++) {
+        hal::Sprite &sprite = *moodSprites[i];
+        sprite.setColorDepth(4);
+        if (!sprite.createSprite(sunflower::MoodWidth, sunflower::MoodHeight)) {
+            Serial.println("Zu wenig RAM für Sonnenblumen-Sprites, zeichne direkt.");
+            return;
+        }
+        sprite.setPaletteColor(0, TFT_BLACK);
+        sprite.setPaletteColor(1, TFT_YELLOW);
+        sprite.setPaletteColor(2, TFT_DARKORANGE);
+        sprite.setPaletteColor(3, TFT_BLACK);
+        sprite.fillSprite(0);
+        sunflower::drawHead(sprite, sunflower::MoodX, sunflower::MoodY, static_cast<plant::Mood>(i), colors);
     }
+    moodSpritesReady = true;
+}
 
-    //Gesicht
-    tft.fillCircle(centerX, centerY, faceRadius, faceColor);
-
-    //Augen
-    tft.fillCircle(centerX - 25, centerY - 12, 6, TFT_BLACK); // Linkes Auge
-    tft.fillCircle(centerX + 25, centerY - 12, 6, TFT_BLACK); // Rechtes Auge
-
-    //Mund
-    int mouthY = centerY + 20;  
-    int mouthRadius = 25;      
+// Sonnenblume mit Stimmung anzeigen; ist sie bereits sichtbar, wird nur bei einem
+// Stimmungswechsel die Mundpartie aus dem Sprite übertragen
+void showSunflower(plant::Mood mood) {
+    if (!sunflowerShown || !moodSpritesReady) {
+        if (!sunflowerShown || mood != shownMood) {
+            drawSunflower(mood, TFT_DARKORANGE);
+        }
+    } else if (mood != shownMood) {
+        PROFILE_SCOPE(profiler, profileMoodPush);
+        moodSprites[plant::index(mood)]->pushSprite(sunflower::MoodX, sunflower::MoodY);
+    }
+    sunflowerShown = true;
+    shownMood = mood;
+}
 
-    if (mood == "happy") {
-    // Lachender Mund (oben gewölbt)
-    drawArc(centerX, mouthY, mouthRadius, 180, 360, TFT_BLACK, 4);
-    } 
-    else if (mood == "sad") {
-    // Trauriger Mund (unten gewölbt)
-    drawArc(centerX, mouthY + 10, mouthRadius, 0, 180, TFT_BLACK, 4);
-    } 
-    else {
-    // Neutraler Mund (gerade Linie)
-    tft.fillRect(centerX - 25, mouthY - 2, 50, 4, TFT_BLACK);
+void updateTimeDisplay() {
+    if (health.ok(rtcHealth)) {
+        DateTime now = rtc.now();
+        clockField.setTime(now.hour(), now.minute(), now.second());
+    } else {
+        clockField.setText("--:--:--");
     }
+    mainView.render();  // nur geänderte Ziffern zeichnen
+}
 
-    //Stiel
-    int stemWidth = 12; 
-    int stemX = centerX - stemWidth / 2;
-    int stemY = centerY + faceRadius; 
-    int stemHeight = 100; 
+// Pumpenrelais schalten; wird von der Bewässerungssteuerung nur bei Zustandswechseln aufgerufen
+void setPumpRelay(bool on) {
+    static bool pumpRunning = false;
+    digitalWrite(RELAY_PIN, on ? HIGH : LOW);
+    if (on != pumpRunning) {
+        queueEvent(on ? "pump_on" : "pump_off", sensorSampler.latest().moisture);  // nicht beim Ausschalten im Setup
+        pumpRunning = on;
+    }
+    if (on && firstWateringAt == 0) {
+        firstWateringAt = millis();
+    }
+}
 
-    tft.fillRect(stemX, stemY, stemWidth, stemHeight, TFT_GREEN);
+IrrigationController::Config irrigationConfig() {
+    IrrigationController::Config config;
+    config.startThreshold = plant::DryThreshold;  // wie bisher ab "Bitte giessen" einschalten
+    config.stopThreshold = 100;                    // Hysterese: erst deutlich feuchter wieder aus
+    return config;
+}
 
-    //Blätter
-    int leafCenterY = stemY + stemHeight / 2 + 10; 
-    int leafOffsetX = 40;   
-    int leafRadiusX = 30;   
-    int leafRadiusY = 15;   
+IrrigationController irrigation(irrigationConfig(), setPumpRelay);
 
-    // Linkes Blatt
-    tft.fillEllipse(centerX - leafOffsetX, leafCenterY, leafRadiusX, leafRadiusY, TFT_GREEN);
-    // Rechtes Blatt
-    tft.fillEllipse(centerX + leafOffsetX, leafCenterY, leafRadiusX, leafRadiusY, TFT_GREEN);
+void updateSensorData(int moistureValue, float temperature, float humidity) {
+    PROFILE_SCOPE(profiler, profileSensorData);
+    moistureField.setValue(moistureValue);
+    temperatureField.setValue(temperature);
+    humidityField.setValue(humidity);
+
+    // Text und Farbe aus der Tabelle, keine String-Objekte im Zeichenpfad
+    const plant::StatusStyle &style = plant::styleFor(plant::statusForMoisture(moistureValue));
+    statusBanner.setStatus(style.label, style.color);
+    mainView.render();  // nur geänderte Felder zeichnen
 }
 
-
-void updateTimeDisplay() {
-    DateTime now = rtc.now();
-    char timeBuffer[16];
-    snprintf(timeBuffer, sizeof(timeBuffer), "%02d:%02d:%02d", now.hour(), now.minute(), now.second());
-    tft.fillRect(200, 10, 100, 30, TFT_BLACK);
-    tft.setCursor(200, 10);
-    tft.setTextColor(TFT_WHITE);
-    tft.setTextSize(2);
-    tft.println(timeBuffer);
+// Messwert im Format der Log-Datei (auch für die Telemetrie)
+samplelog::Record toRecord(const Sample &sample) {
+    samplelog::Record record;
+    record.unixTime = sample.unixTime;                              // Datum und Uhrzeit
+    record.moisture = sample.moisture;                              // Feuchtigkeit
+    record.temperature = samplelog::toTenths(sample.temperature);   // Temperatur in 0,1 °C
+    record.humidity = samplelog::toTenths(sample.humidity);         // Luftfeuchtigkeit in 0,1 %
+    return record;
 }
 
-void controlRelayBasedOnMoisture(int moistureValue) {
-    if (moistureValue <= 10) { 
-        digitalWrite(RELAY_PIN, HIGH);  // Relais einschalten
-    } else if (moistureValue > 10 && moistureValue <= 300) {
-        digitalWrite(RELAY_PIN, LOW);  // Relais ausschalten
-    } else {
-        digitalWrite(RELAY_PIN, LOW);  // Relais ausschalten
+// Schreibfehler von Logger oder Warteschlange als Ausfall melden, damit initSd() im Hintergrund
+// die Karte neu initialisiert und beide Dateien wieder öffnet
+void checkSdWrites() {
+    static uint32_t queueErrors = 0;
+    uint32_t errors = telemetryStore.stats().writeErrors;
+    if (sampleLogger.isOpen() && errors == queueErrors) {
+        return;
     }
+    queueErrors = errors;
+    health.report(sdHealth, false, millis());
+    Serial.println("Schreibfehler auf der SD-Karte, neuer Versuch im Hintergrund.");
 }
 
-void updateSensorData(int moistureValue, float temperature, float humidity) {
-    if (moistureValue != lastMoistureValue || firstMainScreen) {
-        tft.fillRect(200, 50, 80, 30, TFT_BLACK);
-        tft.setCursor(200, 50);
-        tft.setTextColor(TFT_WHITE);
-        tft.setTextSize(2);
-        tft.print(moistureValue);
-        lastMoistureValue = moistureValue;
+void logDataToSD(const Sample &sample) {
+    PROFILE_SCOPE(profiler, profileLogSd);
+    if (!health.ok(sdHealth) || !sampleLogger.isOpen()) {
+        return;     // SD-Karte fehlt, wird im Hintergrund erneut initialisiert
     }
 
-    if (temperature != lastTemperature || firstMainScreen) {
-        tft.fillRect(200, 90, 100, 30, TFT_BLACK);
-        tft.setCursor(200, 90);
-        tft.setTextColor(TFT_WHITE);
-        tft.setTextSize(2);
-        tft.print(temperature);
-        tft.print(" C");
-        lastTemperature = temperature;
-    }
+    samplelog::Record record = toRecord(sample);
 
-    if (humidity != lastHumidity || firstMainScreen) {
-        tft.fillRect(200, 130, 100, 30, TFT_BLACK);
-        tft.setCursor(200, 130);
-        tft.setTextColor(TFT_WHITE);
-        tft.setTextSize(2);
-        tft.print(humidity);
-        tft.print(" %");
-        lastHumidity = humidity;
-    }
-
-    tft.fillRect(10, 210, 300, 30, TFT_BLACK);
-    String statusMessage;
-    if (moistureValue <= 10) {
-        statusMessage = "Bitte giessen";
-        tft.setTextColor(TFT_RED);
-    } else if (moistureValue > 10 && moistureValue <= 300) {
-        statusMessage = "Bald giessen";
-        tft.setTextColor(TFT_YELLOW);
-    } else {
-        statusMessage = "Alles gut";
-        tft.setTextColor(TFT_GREEN);
-    }
-    tft.setCursor(20, 210);
-    tft.setTextSize(2);
-    tft.println(statusMessage);
-    //Relai
-    controlRelayBasedOnMoisture(moistureValue);
-
-}
-
-void logDataToCSV(int moistureValue, float temperature, float humidity) {
-    dataFile = SD.open("sensors.csv", FILE_WRITE); // Datei im Anhängemodus öffnen
-    if (dataFile) {
-        DateTime now = rtc.now(); // Aktuelle Uhrzeit abrufen
-        char timeBuffer[16];
-        snprintf(timeBuffer, sizeof(timeBuffer), "%02d:%02d:%02d", now.hour(), now.minute(), now.second());
-
-        // Datenzeile in die CSV schreiben
-        dataFile.print(timeBuffer); // Zeit
-        dataFile.print(",");
-        dataFile.print(moistureValue); // Feuchtigkeit
-        dataFile.print(",");
-        dataFile.print(temperature); // Temperatur
-        dataFile.print(",");
-        dataFile.println(humidity); // Luftfeuchtigkeit
-
-        dataFile.close(); // Datei schließen
-        //Serial.println("Daten erfolgreich in CSV gespeichert!");
-    } else {
-        Serial.println("Fehler beim Öffnen der CSV-Datei!");
-    }
+    // Nur puffern, geschrieben wird blockweise bzw. beim nächsten flush()
+    sampleLogger.append(record);
+    checkSdWrites();
 }
 
 // Hauptbildschirm mit Sensorwerten
 void mainScreen() {
     //Update Screen
-    backLight.setBrightness(100);
+    backLight.fadeTo(activeBrightness, 300);
+    // Bildschirm nur beim Wechsel vom Standby löschen, danach zeichnen die Widgets alles neu
     tft.fillScreen(TFT_BLACK);
-    tft.setTextColor(TFT_WHITE);
-    tft.setTextSize(2);
-    tft.setCursor(10, 10);
-    tft.println("Uhrzeit:");
-    tft.setCursor(10, 50);
-    tft.println("Pflanze F.:");
-    tft.setCursor(10, 90);
-    tft.println("Temperatur:");
-    tft.setCursor(10, 130);
-    tft.println("Luft F.:");
-    tft.setCursor(10, 170);
-    tft.println("Status:");
-
-    //Update Sensordaten, Zeit, Relai
-    int moistureValue = analogRead(MOISTURE_PIN);
-    float temperature = dht.readTemperature();
-    float humidity = dht.readHumidity();
-    updateSensorData(moistureValue, temperature, humidity);
+    mainView.invalidate();
+    sunflowerShown = false;
+
+    //Update Sensordaten (letzte Messung, kein erneutes Auslesen), Zeit
+    const Sample &sample = sensorSampler.latest();
+    if (sensorSampler.hasSample() && sample.climateValid) {
+        updateSensorData(sample.moisture, sample.temperature, sample.humidity);
+    }
     updateTimeDisplay();
-    controlRelayBasedOnMoisture(moistureValue);
     isDisplayingSensorValues = true;
 }
 
 // Standby Screen
 void showStandbyScreen() {
-    tft.fillScreen(TFT_BLACK); 
-    backLight.setBrightness(20);
-    tft.setCursor(10, 10);
-    drawSunflower("neutral", TFT_DARKYELLOW);
+    backLight.fadeTo(standbyBrightness, 1000);
+    sunflowerShown = false;
+    showSunflower(sensorSampler.hasSample() ? plant::moodForMoisture(sensorSampler.latest().moisture) : plant::Mood::Neutral);
 }
 
-void setup() {
-    Serial.begin(115200);         // Serial Monitor starten
-    pinMode(MOISTURE_PIN, INPUT); // Feuchtigkeitssensor als Eingang konfigurieren
-    pinMode(RELAY_PIN, OUTPUT);   // Relais-Pin als Ausgang konfigurieren
-    digitalWrite(PIN_WIRE_SCL, LOW);  // Relais im Default als LOW setzen -> ausschalten
+void printHealth();
+void proximityTask();
+void clockTask();
+void standbyTimeoutTask();
 
-    // Display initialisieren
-    tft.begin();
-    tft.setRotation(3);           // Querformat
-    tft.fillScreen(TFT_BLACK);    // Hintergrundfarbe auf Schwarz setzen
-    Serial.println("Feuchtigkeitssensor- und DHT-Sensor-Test gestartet");
+// Boot abschließen: Hauptbildschirm anzeigen und Anzeige-Aufgaben starten
+void finishBootTask() {
+    bootTask = Scheduler::InvalidTask;
+    tft.fillScreen(TFT_BLACK);  // Bildschirm erneut leeren für Sensoranzeige
+    bootComplete = true;
+    displayUpdateTime = millis();
+    mainScreen();
+    // Niemand in der Nähe: nach Ablauf der Anzeigedauer in den Standby
+    standbyTask = scheduler.addOneShot("standby", standbyTimeoutTask, displayTimeout);
+    scheduler.addPeriodic("proximity", proximityTask, proximityInterval);
+    scheduler.addPeriodic("clock", clockTask, timeInterval);
+}
 
-    // DHT-Sensor initialisieren
-    dht.begin();
+// Alle Sensoren genau einmal auslesen
+void readSensors(Sample &sample) {
+    PROFILE_SCOPE(profiler, profileReadSensors);
+    sample.unixTime = currentUnixTime();
+    // Serie von ADC-Wandlungen, Median und Tiefpass gegen Flattern an den Schwellen
+    sample.moisture = moistureFilter.sample([]() { return analogRead(MOISTURE_PIN); });
+    sample.moistureRaw = moistureFilter.lastRaw();
+    sample.temperature = dht.readTemperature();
+    sample.humidity = dht.readHumidity();
+    sample.climateValid = !isnan(sample.temperature) && !isnan(sample.humidity);
+    if (!sample.climateValid) {
+        Serial.println("Fehler beim Lesen eines Sensors!");
+    }
+    health.report(dhtHealth, sample.climateValid, millis());
+}
 
-    // RTC initialisieren
-    if (!rtc.begin()) {
-        Serial.println("RTC nicht gefunden!");
-        while (1);
+// Abonnenten der Messwerte
+void onSampleRelay(const Sample &sample) {
+    if (firstIrrigationCheckAt == 0) {
+        firstIrrigationCheckAt = sample.timestamp;
     }
+    irrigation.update(sample.timestamp, sample.moisture);
+}
 
-    if (!lox.begin()) {
-        Serial.println("VL53L0X Sensor konnte nicht initialisiert werden.");
-        while (1);  // Falls der Sensor nicht gefunden wird, bleibe hier
-    } else {
-        Serial.println("VL53L0X Sensor initialisiert.");
+void onSampleDisplay(const Sample &sample) {
+    if (isDisplayingSensorValues && sample.climateValid) {
+        updateSensorData(sample.moisture, sample.temperature, sample.humidity);
     }
+}
 
-    // RTC Zeit Konfigurieren
-    //rtc.adjust(DateTime(F(__DATE__), F(__TIME__))); // Zeit einstellen
-    //rtc.adjust(DateTime(F(__DATE__), F(__TIME__)).unixtime() + 16); // 16 Sekunden hinzufügen (Falls nicht korrekt)
+void onSampleFlower(const Sample &sample) {
+    if (isDisplayingSensorValues || !bootComplete) {
+        return;
+    }
+    // Neu gezeichnet wird nur bei einem Stimmungswechsel
+    showSunflower(plant::moodForMoisture(sample.moisture));
+}
 
-    backLight.initialize();
+void onSampleLog(const Sample &sample) {
+    if (sample.climateValid) {
+        logDataToSD(sample);
+    }
+}
 
-    // SD-Karte initialisieren
-    if (!SD.begin(SDCARD_SS_PIN)) {
-        Serial.println("SD-Karte konnte nicht initialisiert werden!");
-        while (1);
-    }
-    Serial.println("SD-Karte erfolgreich initialisiert!");
-
-    // CSV-Datei erstellen/öffnen und Kopfzeilen schreiben
-    if (!SD.exists("sensors.csv")) {
-        // Datei existiert nicht, neu erstellen und Header schreiben
-        dataFile = SD.open("sensors.csv", FILE_WRITE);
-        if (dataFile) {
-            dataFile.println("Zeit,Feuchtigkeit_Pflanze,Temperatur,Luftfeuchtigkeit");
-            dataFile.close();
-            Serial.println("Kopfzeile in CSV-Datei geschrieben.");
-        } else {
-            Serial.println("Konnte CSV-Datei nicht erstellen!");
-            while (1);
-        }
+void onSampleUplink(const Sample &sample) {
+    if (!uplinkEnabled || !sample.climateValid) {
+        return;
+    }
+    samplelog::Record record = toRecord(sample);
+    if (record.unixTime != 0) {
+        record.unixTime -= gmtOffsetSec + daylightOffsetSec;   // RTC läuft in Ortszeit, der IoT Hub erhält UTC
     } else {
-        Serial.println("CSV-Datei existiert bereits, kein Header geschrieben.");
+        record.unixTime = currentUtcTime();                     // ohne RTC die NTP-Zeit, falls schon bekannt
     }
+    telemetryQueue.push(telemetry::sampleEntry(record));
+}
 
-    connectToWiFi();
-    getNtpTime();
+// Aufgaben des Schedulers
+void sensorTask() {
+    // Sensoren einmal auslesen; Relais, Anzeige, Sonnenblume und SD-Karte erhalten denselben Messwert
+    sensorSampler.sampleNow(millis());
+    heapMonitor.sample();   // Heap-Belegung mit jeder Messung mitschreiben
+}
 
-    delay(2000);  // Zeit für die Anzeige der Erfolgsnachricht
-    tft.fillScreen(TFT_BLACK);  // Bildschirm erneut leeren für Sensoranzeige
-    mainScreen();
+// Standby nach Ablauf der Anzeigedauer (einmalige Aufgabe, wird bei erneuter Annäherung gelöscht)
+void enterLowPowerTask();
+
+void standbyTimeoutTask() {
+    standbyTask = Scheduler::InvalidTask;
+    if (isDisplayingSensorValues) {
+        showStandbyScreen();
+        isDisplayingSensorValues = false;
+        lowPowerTask = scheduler.addOneShot("lowpower", enterLowPowerTask, lowPowerDelay);
+    }
 }
 
-void loop() {
-    unsigned long currentMillis = millis();
-    uint16_t distance = lox.readRange();
+// Timer-Interrupt für Überblendungen der Hintergrundbeleuchtung
+void TC1_Handler() {
+    backLight.handleTimerInterrupt();
+}
 
-    //Main-Screen und Standby-Screen Anzeige
+// Energiesparmodus: Hintergrundbeleuchtung aus, Abstandssensor mit längerer Messperiode
+void enterLowPowerTask() {
+    lowPowerTask = Scheduler::InvalidTask;
+    backLight.disable();
+    powerManager.setLowPower(true);
+    if (health.ok(tofHealth)) {
+        lox.stopRangeContinuous();
+        lox.startRangeContinuous(lowPowerRangingPeriod);
+    }
+}
 
-     if (distance <= DIST_THRESHOLD) {
-        if (!isDisplayingSensorValues) {
-            displayUpdateTime = currentMillis;  // Timer starten, wenn der Abstand unter der Schwelle liegt
-            isDisplayingSensorValues = true;
-            firstMainScreen = true;
-            mainScreen();
-        }
-    } else {
-        if (isDisplayingSensorValues && currentMillis - displayUpdateTime >= displayTimeout) {
-            showStandbyScreen(); 
-            isDisplayingSensorValues = false;
-            firstMainScreen = false;
-        }
+void exitLowPower() {
+    scheduler.cancel(lowPowerTask);
+    lowPowerTask = Scheduler::InvalidTask;
+    if (!powerManager.isLowPower()) {
+        return;
     }
+    powerManager.setLowPower(false);
+    if (health.ok(tofHealth)) {
+        lox.stopRangeContinuous();
+        lox.startRangeContinuous(rangingPeriod);
+    }
+    backLight.enable();
+}
 
-    if (!isDisplayingSensorValues && currentMillis - previousSensorUpdate >= sensorInterval) {
-        previousSensorUpdate = currentMillis;
-        int moistureValue = analogRead(MOISTURE_PIN);
-        controlRelayBasedOnMoisture(moistureValue);
+// Ereignis: jemand nähert sich dem Display
+void onApproach() {
+    scheduler.cancel(standbyTask);
+    standbyTask = Scheduler::InvalidTask;
+    exitLowPower();
+    if (!isDisplayingSensorValues) {
+        displayUpdateTime = millis();  // Anzeigedauer ab der Annäherung
+        isDisplayingSensorValues = true;
+        mainScreen();
+    }
+}
+
+// Ereignis: niemand mehr vor dem Display; Standby frühestens displayTimeout nach dem Aufwachen
+void onLeave() {
+    unsigned long shown = millis() - displayUpdateTime;
+    unsigned long remaining = shown < displayTimeout ? displayTimeout - shown : 0;
+    scheduler.cancel(standbyTask);
+    standbyTask = scheduler.addOneShot("standby", standbyTimeoutTask, remaining);
+}
+
+void proximityTask() {
+    if (!health.ok(tofHealth)) {
+        // Ohne Abstandssensor bleibt der Hauptbildschirm an
+        backLight.touch();
+        if (!isDisplayingSensorValues || standbyTask != Scheduler::InvalidTask) {
+            onApproach();
+        }
+        return;
+    }
+    // Continuous-Mode: nur prüfen, ob eine neue Messung vorliegt (ein Registerzugriff statt ~30 ms Blockieren)
+    if (!lox.isRangeComplete()) {
+        return;
     }
+    // Ungültige Messungen liefert readRangeResult als 0xFFFF, sie zählen als "kein Ziel"
+    uint16_t range;
+    {
+        PROFILE_SCOPE(profiler, profileTofRead);
+        range = lox.readRangeResult();
+    }
+    ProximityDetector::Event event = proximity.update(range);
+    if (proximity.isNear()) {
+        backLight.touch();  // Aktivität: automatisches Abdunkeln neu starten
+    }
+    switch (event) {
+    case ProximityDetector::Event::Approached:
+        onApproach();
+        break;
+    case ProximityDetector::Event::Left:
+        onLeave();
+        break;
+    default:
+        break;
+    }
+}
 
+void clockTask() {
     // Uhrzeit jede Sekunde aktualisieren
-    if (isDisplayingSensorValues && currentMillis - previousTimeUpdate >= timeInterval) {
-        previousTimeUpdate = currentMillis;
+    if (isDisplayingSensorValues) {
         updateTimeDisplay();
     }
+}
 
-    // Sensorwerte alle 4 Sekunden aktualisieren
-    if (isDisplayingSensorValues && currentMillis - previousSensorUpdate >= sensorInterval) {
-        previousSensorUpdate = currentMillis;
-        firstMainScreen = false;
-        int moistureValue = analogRead(MOISTURE_PIN);
-        float temperature = dht.readTemperature();
-        float humidity = dht.readHumidity();
+void logFlushTask() {
+    // Gepufferte Messwerte spätestens nach Ablauf des Flush-Intervalls schreiben
+    if (health.ok(sdHealth)) {
+        PROFILE_SCOPE(profiler, profileSdFlush);
+        sampleLogger.poll(millis());
+        telemetryStore.poll(millis());
+        checkSdWrites();
+    }
+}
 
-        if (!isnan(temperature) && !isnan(humidity)) {
-            updateSensorData(moistureValue, temperature, humidity);
-            controlRelayBasedOnMoisture(moistureValue);
-        } else {
-            Serial.println("Fehler beim Lesen eines Sensors!");
+// Log und Telemetrie-Warteschlange sofort schreiben, z.B. bevor das Gerät vom Strom getrennt wird
+void flushSdCommand() {
+    if (!health.ok(sdHealth)) {
+        Serial.println("Keine SD-Karte.");
+        return;
+    }
+    sampleLogger.flush();
+    telemetryStore.flush(millis());
+    checkSdWrites();
+    Serial.println("SD-Puffer geschrieben.");
+}
+
+void healthTask() {
+    unsigned long now = millis();
+    if (health.poll(now) > 0) {
+        Serial.println("Peripherie wiederhergestellt.");
+        printHealth();
+    }
+}
+
+void uplinkTask() {
+    uplink.poll(millis(), currentUtcTime(), wifiManager.isConnected());
+}
+
+void watchdogTask() {
+    // Wird nur gefüttert, solange der Scheduler Aufgaben ausführt
+    watchdog.feed();
+}
+
+void irrigationTask() {
+    // Laufzeit und Budget zwischen den Messungen prüfen, damit die Pumpe nicht bis zur nächsten Messung läuft
+    irrigation.poll(millis());
+}
+
+// Laufzeitstatistik aller Aufgaben ausgeben (Zeiten in ms)
+void printSchedulerStats() {
+    Serial.println("Aufgabe      Laeufe Verpasst Overruns  Jitter max/avg  Dauer max");
+    for (int i = 0; i < (int)scheduler.capacity(); i++) {
+        const char *name = scheduler.name(i);
+        if (!name) {
+            continue;
         }
+        const Scheduler::TaskStats &stats = scheduler.stats(i);
+        char line[96];
+        snprintf(line, sizeof(line), "%-10s %8lu %8lu %8lu %8lu/%-6lu %8lu", name,
+                 (unsigned long)stats.runs, (unsigned long)stats.missedDeadlines, (unsigned long)stats.overruns,
+                 stats.maxLateness, stats.runs ? stats.totalLateness / stats.runs : 0, stats.maxDuration);
+        Serial.println(line);
+    }
+}
+
+// Pixelstatistik des Hauptbildschirms ausgeben
+void printDisplayStats() {
+    char line[96];
+    snprintf(line, sizeof(line), "Frames %lu, Pixel letzter Frame %lu, max %lu, gesamt %lu",
+             (unsigned long)mainView.frameCount(), (unsigned long)mainView.lastFramePixels(),
+             (unsigned long)mainView.maxFramePixels(), (unsigned long)mainView.pixelsPushed());
+    Serial.println(line);
+}
+
+// Heap-Belegung ausgeben (Fragmentierung im Dauerbetrieb prüfen)
+void printHeapStats() {
+    const HeapMonitor::Snapshot &heap = heapMonitor.sample();
+    char line[128];
+    snprintf(line, sizeof(line), "Heap %u Byte, belegt %u (max %u), Luecken %u (max %u), frei bis Stack %u (min %u)",
+             (unsigned)heap.arena, (unsigned)heap.inUse, (unsigned)heapMonitor.maxInUse(),
+             (unsigned)heap.freeInHeap, (unsigned)heapMonitor.maxFreeInHeap(),
+             (unsigned)heap.freeAbove, (unsigned)heapMonitor.minFree());
+    Serial.println(line);
+}
+
+// Letzte Bodenfeuchte ungefiltert, als Median und gefiltert ausgeben
+void printMoistureStats() {
+    char line[64];
+    snprintf(line, sizeof(line), "Feuchte roh %d, Median %d, gefiltert %d",
+             moistureFilter.lastRaw(), moistureFilter.lastMedian(), moistureFilter.filtered());
+    Serial.println(line);
+}
+
+// Zustand und Zähler der Bewässerung ausgeben
+void printIrrigationStats() {
+    static const char *const states[] = {"Bereit", "Giessen", "Sickern", "Gesperrt"};
+    char line[128];
+    snprintf(line, sizeof(line), "Pumpe %s, Zyklen %lu, Relais-Schaltungen %lu, Sperren %lu, Budget %lu/%lu s",
+             states[static_cast<uint8_t>(irrigation.state())], (unsigned long)irrigation.pumpCycles(),
+             (unsigned long)irrigation.relayWrites(), (unsigned long)irrigation.lockouts(),
+             irrigation.usedBudget(millis()) / 1000, irrigationConfig().dailyBudget / 1000);
+    Serial.println(line);
+}
+
+// Laufzeit eines loop()-Durchlaufs in µs seit der letzten Ausgabe
+unsigned long loopIterations = 0;
+unsigned long loopMaxMicros = 0;
+uint64_t loopTotalMicros = 0;
+
+void recordLoopTime(unsigned long duration) {
+    loopIterations++;
+    loopTotalMicros += duration;
+    if (duration > loopMaxMicros) {
+        loopMaxMicros = duration;
+    }
+}
+
+// Loop-Laufzeit und Abstandssensor ausgeben, danach Loop-Zähler zurücksetzen
+void printLoopStats() {
+    char line[112];
+    snprintf(line, sizeof(line), "Loop %lu Durchlaeufe, mittel %lu us, max %lu us; Abstand %u mm, %lu Messungen",
+             loopIterations, loopIterations ? (unsigned long)(loopTotalMicros / loopIterations) : 0UL,
+             loopMaxMicros, (unsigned)proximity.distance(), (unsigned long)proximity.measurements());
+    Serial.println(line);
+    loopIterations = 0;
+    loopMaxMicros = 0;
+    loopTotalMicros = 0;
+}
+
+// Aufenthaltszeiten je Energiezustand und geschätzten mittleren Strom ausgeben
+void printPowerStats() {
+    uint64_t total = powerManager.totalTime();
+    if (total == 0) {
+        return;
+    }
+    char line[128];
+    snprintf(line, sizeof(line), "Aktiv %lu%%, Idle %lu%%, Sleep %lu%% von %lu s, %lu Schlafphasen, ca. %lu uA",
+             (unsigned long)(powerManager.residencyIn(PowerManager::State::Active) * 100 / total),
+             (unsigned long)(powerManager.residencyIn(PowerManager::State::Idle) * 100 / total),
+             (unsigned long)(powerManager.residencyIn(PowerManager::State::Sleep) * 100 / total),
+             (unsigned long)(total / 1000), (unsigned long)powerManager.rests(),
+             (unsigned long)powerManager.averageCurrent(stateCurrents));
+    Serial.println(line);
+}
+
+// Zustand der Peripherie und Startzeiten ausgeben
+void printHealth() {
+    static const char *const states[] = {"unbekannt", "ok", "ausgefallen"};
+    char line[96];
+    for (size_t i = 0; i < health.size(); i++) {
+        int id = static_cast<int>(i);
+        snprintf(line, sizeof(line), "%-8s %s, %u Versuche, %u Ausfaelle", health.name(id),
+                 states[static_cast<uint8_t>(health.status(id))], (unsigned)health.attempts(id),
+                 (unsigned)health.failures(id));
+        Serial.println(line);
     }
+    snprintf(line, sizeof(line), "Start bis erste Bewaesserungsentscheidung %lu ms, bis erstes Giessen %lu ms",
+             firstIrrigationCheckAt, firstWateringAt);
+    Serial.println(line);
+}
+
+// Statistik des Telemetrie-Uplinks ausgeben
+void printUplinkStats() {
+    static const char *const states[] = {"offline", "online", "wartet"};
+    const decltype(uplink)::Stats &stats = uplink.stats();
+    char line[160];
+    snprintf(line, sizeof(line), "Uplink %s, %lu Publishes (%lu/h, %lu fehlgeschlagen), %lu B/Messwert, "
+             "%lu wartend, %lu Verbindungen",
+             states[static_cast<uint8_t>(uplink.state())], (unsigned long)stats.publishes,
+             (unsigned long)uplink.publishesPerHour(millis()), (unsigned long)stats.failedPublishes,
+             (unsigned long)uplink.bytesPerSample(), (unsigned long)uplink.queued(),
+             (unsigned long)stats.connects);
+    Serial.println(line);
+    snprintf(line, sizeof(line), "Nachgeliefert: %lu Eintraege in %lu Publishes, %lu Eintraege/min; %lu Ereignisse gesendet",
+             (unsigned long)stats.replayEntries, (unsigned long)stats.replayPublishes,
+             (unsigned long)uplink.replayPerMinute(), (unsigned long)stats.eventsSent);
+    Serial.println(line);
+}
 
-    //Standby Screen
-    if (!isDisplayingSensorValues && currentMillis - previousFlowerUpdate >= sensorInterval) {
-        previousFlowerUpdate = currentMillis;
+// Zustand und Statistik der WLAN-Verbindung ausgeben
+void printWiFiStats() {
+    static const char *const states[] = {"aus", "verbindet", "verbunden", "wartet"};
+    const decltype(wifiManager)::Stats &stats = wifiManager.stats();
+    unsigned long now = millis();
+    char line[160];
+    snprintf(line, sizeof(line), "WLAN %s seit %lu s, Verfuegbarkeit %lu.%lu %%",
+             states[static_cast<uint8_t>(wifiManager.state())], wifiManager.connectedFor(now) / 1000,
+             (unsigned long)wifiManager.availability(now) / 10, (unsigned long)wifiManager.availability(now) % 10);
+    Serial.println(line);
+    snprintf(line, sizeof(line), "%lu Versuche, %lu Verbindungen, %lu fehlgeschlagen, %lu Abbrueche, letzter Aufbau %lu ms",
+             (unsigned long)stats.attempts, (unsigned long)stats.connects, (unsigned long)stats.failures,
+             (unsigned long)stats.drops, stats.lastConnectTime);
+    Serial.println(line);
+    snprintf(line, sizeof(line), "RSSI %d dBm (min %d, max %d, Mittel %d)", stats.rssi, stats.rssiMin,
+             stats.rssiMax, wifiManager.averageRssi());
+    Serial.println(line);
+}
 
-        int moistureValue = analogRead(MOISTURE_PIN);
-        uint16_t faceColor = TFT_DARKORANGE;
+// Zustand der Telemetrie-Warteschlange auf der SD-Karte ausgeben
+void printQueueStats() {
+    const TelemetryStore::Stats &stats = telemetryStore.stats();
+    const TelemetryStore::Position &write = telemetryStore.writePosition();
+    const TelemetryStore::Position &commit = telemetryStore.commitPosition();
+    char line[192];
+    snprintf(line, sizeof(line), "Warteschlange %s: %lu auf SD (%lu Segmente), %lu im RAM (%lu verworfen)",
+             telemetryStore.isOpen() ? "offen" : "nicht verfuegbar", (unsigned long)telemetryStore.pending(),
+             (unsigned long)telemetryStore.segments(), (unsigned long)telemetryQueue.pendingInRam(),
+             (unsigned long)telemetryQueue.droppedInRam());
+    Serial.println(line);
+    snprintf(line, sizeof(line), "Schreiben %lu:%lu, Commit %lu:%lu, %lu angehaengt, %lu gesendet",
+             (unsigned long)write.segment, (unsigned long)write.offset, (unsigned long)commit.segment,
+             (unsigned long)commit.offset, (unsigned long)stats.appended, (unsigned long)stats.consumed);
+    Serial.println(line);
+    snprintf(line, sizeof(line), "%lu verworfen, %lu B beim Start abgeschnitten, %lu Schreibfehler",
+             (unsigned long)stats.dropped, (unsigned long)stats.recoveredBytes, (unsigned long)stats.writeErrors);
+    Serial.println(line);
+}
 
-        if (moistureValue > 300) { // In Ordnung
-            drawSunflower("happy", faceColor);
-        } else if (moistureValue > 10) { // Bald gießen
-            drawSunflower("neutral", faceColor);
-        } else { // Sofort gießen
-            drawSunflower("sad", faceColor);
+#ifdef AQUA_PROFILE
+// Laufzeitprofil ausgeben: je Abschnitt Anzahl, Summe, Mittel, Maximum und die belegten Fächer des
+// Histogramms (Untergrenze in us: Anzahl)
+void printProfile() {
+    Serial.println("Abschnitt     Anzahl   Summe ms  Mittel us     Max us");
+    char line[160];
+    for (size_t i = 0; i < profiler.size(); i++) {
+        int id = static_cast<int>(i);
+        const Profiler::Region &region = profiler.region(id);
+        snprintf(line, sizeof(line), "%-11s %8lu %10lu %10lu %10lu", region.name, (unsigned long)region.count,
+                 (unsigned long)(profiler.toMicros(region.totalCycles) / 1000), (unsigned long)profiler.averageMicros(id),
+                 (unsigned long)profiler.toMicros(region.maxCycles));
+        Serial.println(line);
+        int length = snprintf(line, sizeof(line), "  ");
+        for (size_t bucket = 0; bucket < Profiler::Buckets && length < (int)sizeof(line); bucket++) {
+            if (region.histogram[bucket] != 0) {
+                length += snprintf(line + length, sizeof(line) - length, " %lu:%lu",
+                                   bucket ? 1UL << (bucket - 1) : 0UL, (unsigned long)region.histogram[bucket]);
+            }
         }
+        Serial.println(line);
+    }
+    // Anteil der Messungen an der Laufzeit in 0,01 %
+    uint64_t elapsed = (uint64_t)millis() * 1000;
+    unsigned long share = elapsed ? (unsigned long)((uint64_t)profiler.overheadMicros() * 10000 / elapsed) : 0;
+    snprintf(line, sizeof(line), "Profiler: %lu Zyklen je Messung, Anteil an der Laufzeit %lu.%02lu %%",
+             (unsigned long)profiler.costCycles(), share / 100, share % 100);
+    Serial.println(line);
+}
+
+// Maxima seit dem letzten Senden je Abschnitt als Ereignisse an den IoT Hub (Name des Abschnitts, Wert in us)
+void profileTelemetryTask() {
+    for (size_t i = 0; i < profiler.size(); i++) {
+        int id = static_cast<int>(i);
+        if (profiler.region(id).count != 0) {
+            queueEvent(profiler.region(id).name, (int32_t)profiler.takeWindowMax(id));
+        }
+    }
+}
+#endif
+
+// Befehle über den Serial Monitor: 's' = Scheduler-Statistik, 'd' = Display-Statistik, 'h' = Heap,
+// 'm' = Bodenfeuchte, 'p' = Pumpe, 'l' = Loop-Laufzeit, 'e' = Energie, 'b' = Peripherie und Start,
+// 'u' = Telemetrie, 'q' = Telemetrie-Warteschlange, 'w' = WLAN, 'f' = SD-Puffer schreiben,
+// 'r' = Laufzeitprofil (mit AQUA_PROFILE)
+void serialCommandTask() {
+    while (Serial.available() > 0) {
+        switch (Serial.read()) {
+        case 's':
+            printSchedulerStats();
+            break;
+        case 'd':
+            printDisplayStats();
+            break;
+        case 'h':
+            printHeapStats();
+            break;
+        case 'm':
+            printMoistureStats();
+            break;
+        case 'p':
+            printIrrigationStats();
+            break;
+        case 'l':
+            printLoopStats();
+            break;
+        case 'e':
+            printPowerStats();
+            break;
+        case 'b':
+            printHealth();
+            break;
+        case 'u':
+            printUplinkStats();
+            break;
+        case 'q':
+            printQueueStats();
+            break;
+        case 'w':
+            printWiFiStats();
+            break;
+        case 'f':
+            flushSdCommand();
+            break;
+#ifdef AQUA_PROFILE
+        case 'r':
+            printProfile();
+            break;
+#endif
+        }
+    }
+}
+
+void setup() {
+    Serial.begin(115200);         // Serial Monitor starten
+#ifdef AQUA_PROFILE
+    hal::enableCycleCounter();
+    profiler.begin();
+#endif
+    pinMode(MOISTURE_PIN, INPUT); // Feuchtigkeitssensor als Eingang konfigurieren
+    pinMode(RELAY_PIN, OUTPUT);   // Relais-Pin als Ausgang konfigurieren
+    irrigation.begin(millis());   // Relais im Default als LOW setzen -> ausschalten
+
+    // Display initialisieren
+    tft.begin();
+    tft.setRotation(3);           // Querformat
+    tft.fillScreen(TFT_BLACK);    // Hintergrundfarbe auf Schwarz setzen
+    renderMoodSprites();          // Sonnenblumen-Stimmungen einmalig vorrendern
+    Serial.println("Feuchtigkeitssensor- und DHT-Sensor-Test gestartet");
+
+    bool watchdogReset = hal::Watchdog::causedLastReset();
+    if (watchdogReset) {
+        Serial.println("Neustart durch Watchdog!");
+    }
+
+    // DHT-Sensor initialisieren (Zustand ergibt sich aus den Messungen)
+    dht.begin();
+    dhtHealth = health.add("DHT", nullptr);
+    wifiHealth = health.add("WLAN", nullptr);
+
+    // RTC initialisieren; ohne RTC laufen Bewässerung und Anzeige ohne Uhrzeit weiter
+    rtcHealth = health.add("RTC", initRtc);
+    if (!health.begin(rtcHealth, millis())) {
+        Serial.println("RTC nicht gefunden!");
     }
 
-    // Daten auf SD Karte schreiben alle 4 Sekunden
-    if (currentMillis - previousSensorUpdate >= sensorInterval) {
-        previousSensorUpdate = currentMillis;
+    tofHealth = health.add("VL53L0X", initTof);
+    if (!health.begin(tofHealth, millis())) {
+        Serial.println("VL53L0X Sensor konnte nicht initialisiert werden.");
+    } else {
+        Serial.println("VL53L0X Sensor initialisiert.");
+    }
 
-        int moistureValue = analogRead(MOISTURE_PIN);
-        float temperature = dht.readTemperature();
-        float humidity = dht.readHumidity();
+    // RTC Zeit Konfigurieren
+    //rtc.adjust(DateTime(F(__DATE__), F(__TIME__))); // Zeit einstellen
+    //rtc.adjust(DateTime(F(__DATE__), F(__TIME__)).unixtime() + 16); // 16 Sekunden hinzufügen (Falls nicht korrekt)
 
-        if (!isnan(temperature) && !isnan(humidity)) {
-            logDataToCSV(moistureValue, temperature, humidity);
+    backLight.initialize();
+    backLight.setGammaCorrection(true);
+    // Rückfallebene im Timer-Interrupt: ohne Aktivität nach der Anzeigedauer abdunkeln, auch wenn loop() hängt
+    backLight.setAutoDim(displayTimeout, standbyBrightness);
+
+    // SD-Karte initialisieren und Log-Datei öffnen; ohne Karte wird nicht geloggt
+    sdHealth = health.add("SD", initSd);
+    if (!health.begin(sdHealth, millis())) {
+        Serial.println("SD-Karte oder Log-Datei konnte nicht initialisiert werden!");
+    } else {
+        Serial.println("SD-Karte initialisiert, Log-Datei geöffnet.");
+    }
+    queueEvent("boot", watchdogReset ? 1 : 0);
+
+    // Widgets des Hauptbildschirms registrieren
+    mainView.add(timeLabel);
+    mainView.add(moistureLabel);
+    mainView.add(temperatureLabel);
+    mainView.add(humidityLabel);
+    mainView.add(statusLabel);
+    mainView.add(clockField);
+    mainView.add(moistureField);
+    mainView.add(temperatureField);
+    mainView.add(humidityField);
+    mainView.add(statusBanner);
+
+    // Verbraucher der Messwerte in Ausführungsreihenfolge registrieren
+    sensorSampler.subscribe(onSampleRelay);
+    sensorSampler.subscribe(onSampleDisplay);
+    sensorSampler.subscribe(onSampleFlower);
+    sensorSampler.subscribe(onSampleLog);
+    sensorSampler.subscribe(onSampleUplink);
+
+    // Bewässerung und Logging laufen sofort, Anzeige-Aufgaben starten nach der WLAN-Meldung (finishBootTask)
+    scheduler.addPeriodic("sensors", sensorTask, sensorInterval);
+    scheduler.addPeriodic("logflush", logFlushTask, 1000);
+    scheduler.addPeriodic("irrigation", irrigationTask, 500);
+    scheduler.addPeriodic("serial", serialCommandTask, 200);
+    scheduler.addPeriodic("health", healthTask, 1000);
+    scheduler.addPeriodic("watchdog", watchdogTask, 1000);
+
+    // Telemetrie-Uplink (nur mit eingetragenem Geräteschlüssel)
+    if (uplinkEnabled) {
+        tlsClient.setCACert(iotHubRootCA);
+        mqttClient.setServer(iotHubHost, 8883);
+        mqttClient.setBufferSize(2560);     // Topic + größter Batch beim Nachliefern passen hinein
+        if (uplink.begin(iotHubHost, iotDeviceId, millis())) {
+            wifiManager.acquire();          // Uplink hält das WLAN dauerhaft
+            scheduler.addPeriodic("uplink", uplinkTask, 1000);
+#ifdef AQUA_PROFILE
+            if (profileTelemetryInterval != 0) {
+                scheduler.addPeriodic("profile", profileTelemetryTask, profileTelemetryInterval);
+            }
+#endif
         } else {
-            Serial.println("Fehler beim Lesen eines Sensors!");
+            Serial.println("IoT-Hub-Client konnte nicht initialisiert werden!");
         }
     }
-}
\ No newline at end of file
+
+    // WLAN im Hintergrund aufbauen, der Start wartet höchstens wifiBootWait auf das Ergebnis
+    tft.setCursor(10, 10);
+    tft.setTextColor(TFT_WHITE);
+    tft.setTextSize(2);
+    tft.println("Verbinde mit WLAN...");
+    Serial.println("Verbinde mit WLAN...");
+    wifiManager.subscribe(onWiFiEvent);
+    wifiManager.begin(millis(), micros());
+    scheduler.addPeriodic("wifi", wifiTask, 500);
+    requestNtpSync();
+    bootTask = scheduler.addOneShot("boot", finishBootTask, wifiBootWait);
+
+    watchdog.begin(watchdogTimeout);
+}
+
+void loop() {
+    // Alle fälligen Aufgaben nach Deadline ausführen, keine Aufgabe setzt den Zeitstempel einer anderen zurück
+    unsigned long start = micros();
+    scheduler.runPending();
+    recordLoopTime(micros() - start);
+
+    // Bis zur nächsten Deadline schlafen statt die Schleife leer durchlaufen zu lassen
+    powerManager.rest(scheduler.timeUntilNext(maxRestTime));
+}
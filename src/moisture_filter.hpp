@@ -0,0 +1,100 @@
+/**
+ * @file moisture_filter.hpp
+ * @brief Filter für den Bodenfeuchtesensor: Median über eine kurze ADC-Serie und exponentielle Glättung.
+*/
+
+#ifndef MOISTURE_FILTER_HPP__
+#define MOISTURE_FILTER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Zweistufiger Ganzzahlfilter für verrauschte ADC-Werte.
+ *
+ * Pro Messung wird eine Serie von BurstSize Wandlungen aufgenommen. Der Median der Serie
+ * verwirft einzelne Ausreißer, ohne eine Periode Verzögerung hinzuzufügen. Danach glättet ein
+ * Tiefpass erster Ordnung (alpha = 1 / 2^smoothingShift) das verbleibende Rauschen zwischen den
+ * Messungen. Der Filterzustand wird mit 4 Nachkommabits geführt, damit kleine Änderungen nicht
+ * durch die Ganzzahldivision verloren gehen.
+ *
+ * @tparam BurstSize Anzahl der Wandlungen pro Messung.
+ */
+template <std::size_t BurstSize = 8>
+class MoistureFilter
+{
+    static_assert(BurstSize > 0 && BurstSize <= 32, "BurstSize muss zwischen 1 und 32 liegen");
+
+private:
+    static constexpr int FractionBits = 4;
+
+    std::uint8_t smoothingShift;
+    std::int32_t state = 0;         // gefilterter Wert << FractionBits
+    bool primed = false;
+    int raw = 0;
+    int median = 0;
+
+public:
+    /**
+     * @param [in] smoothingShift Glättung, 0 = aus, 2 = alpha 1/4 (Zeitkonstante ca. 4 Messungen).
+     */
+    explicit MoistureFilter(std::uint8_t smoothingShift = 2) : smoothingShift(smoothingShift) {}
+
+    /**
+     * @brief Nimmt eine Serie mit der übergebenen Lesefunktion auf und filtert sie.
+     * @param [in] read Funktion ohne Parameter, die einen ADC-Wert liefert (z.B. analogRead-Wrapper).
+     * @return gefilterter Wert.
+     */
+    template <typename ReadFunction>
+    int sample(ReadFunction read)
+    {
+        std::uint16_t values[BurstSize];
+        for (std::size_t i = 0; i < BurstSize; i++) {
+            values[i] = static_cast<std::uint16_t>(read());
+        }
+        return this->update(values);
+    }
+
+    /**
+     * @brief Filtert eine bereits aufgenommene Serie von BurstSize Werten (wird dabei sortiert).
+     * @return gefilterter Wert.
+     */
+    int update(std::uint16_t (&values)[BurstSize])
+    {
+        this->raw = values[0];
+
+        // Einfügesortierung, bei höchstens 32 Werten schneller als ein allgemeiner Sortieralgorithmus
+        for (std::size_t i = 1; i < BurstSize; i++) {
+            std::uint16_t value = values[i];
+            std::size_t j = i;
+            while (j > 0 && values[j - 1] > value) {
+                values[j] = values[j - 1];
+                j--;
+            }
+            values[j] = value;
+        }
+        this->median = BurstSize % 2 ? values[BurstSize / 2]
+                                     : (values[BurstSize / 2 - 1] + values[BurstSize / 2] + 1) / 2;
+
+        std::int32_t target = static_cast<std::int32_t>(this->median) << FractionBits;
+        if (!this->primed) {
+            this->state = target;   // erste Messung ohne Einschwingen übernehmen
+            this->primed = true;
+        } else {
+            this->state += (target - this->state) / (std::int32_t(1) << this->smoothingShift);
+        }
+        return this->filtered();
+    }
+
+    /** @brief Setzt den Tiefpass zurück, die nächste Messung wird direkt übernommen. */
+    void reset() { this->primed = false; }
+
+    /** @brief Gefilterter Wert, gerundet. */
+    int filtered() const { return (this->state + (1 << (FractionBits - 1))) >> FractionBits; }
+    /** @brief Erste Wandlung der letzten Serie (entspricht einem einzelnen analogRead). */
+    int lastRaw() const { return this->raw; }
+    /** @brief Median der letzten Serie vor dem Tiefpass. */
+    int lastMedian() const { return this->median; }
+};
+
+#endif //MOISTURE_FILTER_HPP__
@@ -0,0 +1,237 @@
+/**
+ * @file ntp_client.hpp
+ * @brief Nicht blockierender NTP-Client (SNTPv4) mit Wiederholung über mehrere Server.
+*/
+
+#ifndef NTP_CLIENT_HPP__
+#define NTP_CLIENT_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Zustandsautomat für eine NTP-Synchronisation, wird zyklisch mit poll() weitergeschaltet.
+ *
+ * Die lokale Zeit (T1, T4) wird beim Start aus der RTC-Zeit übernommen und danach mit der
+ * übergebenen ms-Zeit (millis) fortgeschrieben. Aus allen vier Zeitstempeln werden Offset und
+ * Umlaufzeit berechnet:
+ *   offset = ((T2 - T1) + (T3 - T4)) / 2,  delay = (T4 - T1) - (T3 - T2)
+ *
+ * Antwortet ein Server nicht innerhalb von replyTimeout, wird der nächste gefragt. Nach einer
+ * erfolglosen Runde über alle Server wird mit exponentiell wachsender Pause erneut versucht, bis
+ * maxRounds erreicht ist.
+ *
+ * @tparam UdpT UDP-Klasse mit der Schnittstelle von WiFiUDP.
+ */
+template <typename UdpT>
+class NtpClient
+{
+public:
+    enum class State : std::uint8_t { Idle, WaitingReply, Backoff, Synced, Failed };
+
+    static constexpr std::size_t PacketSize = 48;
+    static constexpr std::uint16_t Port = 123;
+
+private:
+    static constexpr std::uint32_t SeventyYears = 2208988800UL;  // Sekunden von 1900 bis 1970
+
+    UdpT &udp;
+    const char *const *servers;
+    std::size_t serverCount;
+    unsigned long replyTimeout;
+    unsigned long initialBackoff;
+    unsigned long maxBackoff;
+    std::uint8_t maxRounds;
+
+    State current = State::Idle;
+    std::size_t serverIndex = 0;
+    std::uint8_t round = 0;
+    unsigned long backoff = 0;
+    unsigned long stateSince = 0;       // ms-Zeit des letzten Zustandswechsels
+    unsigned long startedAt = 0;
+
+    std::int64_t anchorUnixMs = 0;      // lokale Zeit beim Start
+    unsigned long anchorMillis = 0;
+    std::uint8_t transmitStamp[8] = {}; // T1 im NTP-Format, muss als Originate zurückkommen
+    std::int64_t t1 = 0;
+
+    std::int64_t offset = 0;
+    std::int64_t roundTrip = 0;
+    unsigned long syncDuration = 0;
+    std::uint32_t requestCount = 0;
+
+    std::int64_t localUnixMs(unsigned long now) const
+    {
+        return this->anchorUnixMs + static_cast<std::int64_t>(now - this->anchorMillis);
+    }
+
+    static void toNtp(std::int64_t unixMs, std::uint8_t *p)
+    {
+        std::uint32_t seconds = static_cast<std::uint32_t>(unixMs / 1000) + SeventyYears;
+        std::uint32_t fraction = static_cast<std::uint32_t>(((unixMs % 1000) << 32) / 1000);
+        for (int i = 0; i < 4; i++) {
+            p[i] = static_cast<std::uint8_t>(seconds >> (24 - 8 * i));
+            p[4 + i] = static_cast<std::uint8_t>(fraction >> (24 - 8 * i));
+        }
+    }
+
+    static std::int64_t fromNtp(const std::uint8_t *p)
+    {
+        std::uint32_t seconds = (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16) | (std::uint32_t(p[2]) << 8) | p[3];
+        std::uint32_t fraction = (std::uint32_t(p[4]) << 24) | (std::uint32_t(p[5]) << 16) | (std::uint32_t(p[6]) << 8) | p[7];
+        // Ära 0 (bis 2036); Zeiten vor 1970 kommen von korrekten Servern nicht vor
+        std::int64_t unixSeconds = static_cast<std::int64_t>(seconds) - SeventyYears;
+        return unixSeconds * 1000 + ((static_cast<std::uint64_t>(fraction) * 1000) >> 32);
+    }
+
+    void enter(State state, unsigned long now)
+    {
+        this->current = state;
+        this->stateSince = now;
+    }
+
+    void sendRequest(unsigned long now)
+    {
+        std::uint8_t packet[PacketSize];
+        std::memset(packet, 0, PacketSize);
+        packet[0] = 0b11100011;     // LI = 3 (nicht synchronisiert), Version 4, Mode 3 (Client)
+        packet[2] = 6;              // Polling Interval
+        packet[3] = 0xEC;           // Precision
+
+        this->t1 = this->localUnixMs(now);
+        toNtp(this->t1, this->transmitStamp);
+        std::memcpy(packet + 40, this->transmitStamp, 8);
+
+        // Alte Antworten verwerfen, damit sie nicht dieser Anfrage zugeordnet werden
+        while (this->udp.parsePacket() > 0) {
+            this->udp.flush();
+        }
+        this->udp.beginPacket(this->servers[this->serverIndex], Port);
+        this->udp.write(packet, PacketSize);
+        this->udp.endPacket();
+        this->requestCount++;
+        this->enter(State::WaitingReply, now);
+    }
+
+    /**
+     * @brief Wertet eine Antwort aus.
+     * @return false, wenn die Antwort ungültig ist oder nicht zur Anfrage passt.
+     */
+    bool handleReply(const std::uint8_t *packet, unsigned long now)
+    {
+        std::uint8_t leap = packet[0] >> 6;
+        std::uint8_t mode = packet[0] & 0x07;
+        std::uint8_t stratum = packet[1];
+        if (mode != 4 || stratum == 0 || stratum > 15 || leap == 3) {
+            return false;   // kein Server-Paket, Kiss-o'-Death oder Server nicht synchronisiert
+        }
+        if (std::memcmp(packet + 24, this->transmitStamp, 8) != 0) {
+            return false;   // Antwort auf eine andere Anfrage
+        }
+        std::int64_t t2 = fromNtp(packet + 32);
+        std::int64_t t3 = fromNtp(packet + 40);
+        std::int64_t t4 = this->localUnixMs(now);
+
+        this->offset = ((t2 - this->t1) + (t3 - t4)) / 2;
+        this->roundTrip = (t4 - this->t1) - (t3 - t2);
+        return true;
+    }
+
+    void nextServer(unsigned long now)
+    {
+        this->serverIndex++;
+        if (this->serverIndex < this->serverCount) {
+            this->sendRequest(now);
+            return;
+        }
+        this->serverIndex = 0;
+        this->round++;
+        if (this->round >= this->maxRounds) {
+            this->udp.stop();
+            this->enter(State::Failed, now);
+            return;
+        }
+        this->enter(State::Backoff, now);
+    }
+
+public:
+    /**
+     * @param [in] udp UDP-Instanz, wird zwischen start() und Synced/Failed exklusiv genutzt.
+     * @param [in] servers Liste von Servernamen, muss dauerhaft gültig sein.
+     * @param [in] replyTimeout Wartezeit je Anfrage in ms.
+     * @param [in] maxRounds maximale Anzahl Runden über alle Server.
+     */
+    NtpClient(UdpT &udp, const char *const *servers, std::size_t serverCount, unsigned long replyTimeout = 1000,
+              std::uint8_t maxRounds = 5, unsigned long initialBackoff = 2000, unsigned long maxBackoff = 60000)
+        : udp(udp), servers(servers), serverCount(serverCount), replyTimeout(replyTimeout),
+          initialBackoff(initialBackoff), maxBackoff(maxBackoff), maxRounds(maxRounds)
+    {
+    }
+
+    /**
+     * @brief Startet eine Synchronisation.
+     * @param [in] now aktuelle ms-Zeit (millis).
+     * @param [in] localUnixMs aktuelle lokale Schätzung der UTC-Zeit in ms (z.B. aus der RTC).
+     */
+    void start(unsigned long now, std::int64_t localUnixMs)
+    {
+        this->anchorUnixMs = localUnixMs;
+        this->anchorMillis = now;
+        this->serverIndex = 0;
+        this->round = 0;
+        this->backoff = this->initialBackoff;
+        this->startedAt = now;
+        this->udp.begin(Port);
+        this->sendRequest(now);
+    }
+
+    /**
+     * @brief Schaltet den Automaten weiter, blockiert nie.
+     * @return aktueller Zustand nach dem Aufruf.
+     */
+    State poll(unsigned long now)
+    {
+        switch (this->current) {
+        case State::WaitingReply:
+            if (this->udp.parsePacket() >= static_cast<int>(PacketSize)) {
+                std::uint8_t packet[PacketSize];
+                this->udp.read(packet, PacketSize);
+                if (this->handleReply(packet, now)) {
+                    this->syncDuration = now - this->startedAt;
+                    this->udp.stop();
+                    this->enter(State::Synced, now);
+                }
+            } else if (now - this->stateSince >= this->replyTimeout) {
+                this->nextServer(now);
+            }
+            break;
+        case State::Backoff:
+            if (now - this->stateSince >= this->backoff) {
+                this->backoff = this->backoff * 2 < this->maxBackoff ? this->backoff * 2 : this->maxBackoff;
+                this->sendRequest(now);
+            }
+            break;
+        default:
+            break;
+        }
+        return this->current;
+    }
+
+    State state() const { return this->current; }
+    bool busy() const { return this->current == State::WaitingReply || this->current == State::Backoff; }
+    /** @brief Abweichung Server - lokal in ms, gültig im Zustand Synced. */
+    std::int64_t offsetMs() const { return this->offset; }
+    /** @brief Umlaufzeit ohne Serververarbeitungszeit in ms, gültig im Zustand Synced. */
+    std::int64_t delayMs() const { return this->roundTrip; }
+    /** @brief Korrigierte UTC-Zeit in ms zur ms-Zeit now, gültig im Zustand Synced. */
+    std::int64_t unixMs(unsigned long now) const { return this->localUnixMs(now) + this->offset; }
+    /** @brief Dauer vom start() bis zur gültigen Antwort in ms. */
+    unsigned long timeToSync() const { return this->syncDuration; }
+    /** @brief Gesendete Anfragen seit Start. */
+    std::uint32_t requestsSent() const { return this->requestCount; }
+    /** @brief Server der letzten Anfrage bzw. der erfolgreichen Antwort. */
+    const char *server() const { return this->servers[this->serverIndex]; }
+};
+
+#endif //NTP_CLIENT_HPP__
@@ -0,0 +1,158 @@
+/**
+ * @file peripheral_health.hpp
+ * @brief Register der Peripherie mit Initialisierungsstatus und Wiederholung im Hintergrund.
+*/
+
+#ifndef PERIPHERAL_HEALTH_HPP__
+#define PERIPHERAL_HEALTH_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Merkt sich je Peripherie, ob sie nutzbar ist, und initialisiert ausgefallene erneut.
+ *
+ * Statt beim Start in einer Endlosschleife zu hängen, wird eine fehlgeschlagene Peripherie als
+ * Failed markiert; poll() ruft ihre Init-Funktion mit exponentiell wachsender Pause erneut auf.
+ * Alle anderen Funktionen (vor allem die Bewässerung) laufen währenddessen weiter. Peripherie
+ * ohne Init-Funktion wird nur über report() aktualisiert (z.B. aus Messwerten).
+ */
+class PeripheralHealth
+{
+public:
+    enum class Status : std::uint8_t { Unknown, Ok, Failed };
+    typedef bool (*InitFunction)();
+    static constexpr std::size_t MaxPeripherals = 8;
+    static constexpr int InvalidId = -1;
+
+private:
+    struct Entry
+    {
+        const char *name = nullptr;
+        InitFunction init = nullptr;
+        Status status = Status::Unknown;
+        unsigned long nextRetry = 0;
+        unsigned long backoff = 0;
+        std::uint16_t attempts = 0;
+        std::uint16_t failures = 0;     // Wechsel nach Failed seit Start
+        unsigned long okSince = 0;
+    };
+
+    Entry entries[MaxPeripherals];
+    std::size_t count = 0;
+    unsigned long initialBackoff;
+    unsigned long maxBackoff;
+
+    bool valid(int id) const { return id >= 0 && static_cast<std::size_t>(id) < this->count; }
+
+    void setStatus(Entry &entry, bool ok, unsigned long now)
+    {
+        if (ok) {
+            if (entry.status != Status::Ok) {
+                entry.okSince = now;
+            }
+            entry.status = Status::Ok;
+            entry.backoff = this->initialBackoff;
+            return;
+        }
+        if (entry.status != Status::Failed) {
+            entry.failures++;
+            entry.backoff = this->initialBackoff;
+        } else {
+            entry.backoff = entry.backoff * 2 < this->maxBackoff ? entry.backoff * 2 : this->maxBackoff;
+        }
+        entry.status = Status::Failed;
+        entry.nextRetry = now + entry.backoff;
+    }
+
+    void attempt(Entry &entry, unsigned long now)
+    {
+        entry.attempts++;
+        this->setStatus(entry, entry.init(), now);
+    }
+
+public:
+    /**
+     * @param [in] initialBackoff Pause vor dem ersten Wiederholungsversuch in ms.
+     * @param [in] maxBackoff längste Pause zwischen zwei Versuchen in ms.
+     */
+    explicit PeripheralHealth(unsigned long initialBackoff = 5000, unsigned long maxBackoff = 300000)
+        : initialBackoff(initialBackoff), maxBackoff(maxBackoff)
+    {
+    }
+
+    /**
+     * @brief Registriert eine Peripherie, ohne sie zu initialisieren.
+     * @param [in] name Name für Ausgaben (muss dauerhaft gültig sein).
+     * @param [in] init Init-Funktion, true bei Erfolg; nullptr = Status nur über report().
+     * @return ID oder InvalidId, wenn kein Platz frei ist.
+     */
+    int add(const char *name, InitFunction init)
+    {
+        if (this->count >= MaxPeripherals) {
+            return InvalidId;
+        }
+        Entry &entry = this->entries[this->count];
+        entry.name = name;
+        entry.init = init;
+        entry.backoff = this->initialBackoff;
+        return static_cast<int>(this->count++);
+    }
+
+    /**
+     * @brief Erster Initialisierungsversuch.
+     * @return true, wenn die Peripherie nutzbar ist.
+     */
+    bool begin(int id, unsigned long now)
+    {
+        if (!this->valid(id) || this->entries[id].init == nullptr) {
+            return false;
+        }
+        this->attempt(this->entries[id], now);
+        return this->entries[id].status == Status::Ok;
+    }
+
+    /**
+     * @brief Meldet den Zustand von außen, z.B. nach einem Lesefehler im Betrieb.
+     */
+    void report(int id, bool ok, unsigned long now)
+    {
+        if (this->valid(id)) {
+            this->setStatus(this->entries[id], ok, now);
+        }
+    }
+
+    /**
+     * @brief Wiederholt fällige Initialisierungen; zyklisch aufrufen.
+     * @return Anzahl der in diesem Aufruf wiederhergestellten Peripherie.
+     */
+    unsigned int poll(unsigned long now)
+    {
+        unsigned int recovered = 0;
+        for (std::size_t i = 0; i < this->count; i++) {
+            Entry &entry = this->entries[i];
+            if (entry.status != Status::Failed || entry.init == nullptr
+                || static_cast<long>(now - entry.nextRetry) < 0) {
+                continue;
+            }
+            this->attempt(entry, now);
+            if (entry.status == Status::Ok) {
+                recovered++;
+            }
+        }
+        return recovered;
+    }
+
+    bool ok(int id) const { return this->valid(id) && this->entries[id].status == Status::Ok; }
+    Status status(int id) const { return this->valid(id) ? this->entries[id].status : Status::Unknown; }
+    std::size_t size() const { return this->count; }
+    const char *name(int id) const { return this->valid(id) ? this->entries[id].name : nullptr; }
+    /** @brief Anzahl der Init-Versuche seit Start. */
+    std::uint16_t attempts(int id) const { return this->valid(id) ? this->entries[id].attempts : 0; }
+    /** @brief Anzahl der Ausfälle seit Start. */
+    std::uint16_t failures(int id) const { return this->valid(id) ? this->entries[id].failures : 0; }
+    /** @brief ms-Zeit des nächsten Versuchs, nur im Zustand Failed gültig. */
+    unsigned long nextRetry(int id) const { return this->valid(id) ? this->entries[id].nextRetry : 0; }
+};
+
+#endif //PERIPHERAL_HEALTH_HPP__
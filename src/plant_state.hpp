@@ -0,0 +1,74 @@
+/**
+ * @file plant_state.hpp
+ * @brief Zustand der Pflanze (Gießstatus und Stimmung) als Aufzählung mit fester Darstellungstabelle.
+ *
+ * Texte und Farben liegen als Konstanten im Flash; im Zeichenpfad werden keine Strings
+ * angelegt oder verglichen.
+*/
+
+#ifndef PLANT_STATE_HPP__
+#define PLANT_STATE_HPP__
+
+#include <cstdint>
+
+namespace plant {
+
+/** @brief Bodenfeuchte (ADC-Wert), bis zu der sofort gegossen werden muss. */
+constexpr int DryThreshold = 10;
+/** @brief Bodenfeuchte (ADC-Wert), bis zu der bald gegossen werden muss. */
+constexpr int LowThreshold = 300;
+
+enum class Mood : std::uint8_t { Sad, Neutral, Happy };
+enum class WateringStatus : std::uint8_t { WaterNow, WaterSoon, Ok };
+
+constexpr std::uint8_t MoodCount = 3;
+
+/**
+ * @brief Darstellung eines Gießstatus.
+ */
+struct StatusStyle
+{
+    const char *label;      // Text der Statuszeile
+    std::uint16_t color;    // RGB565
+    Mood mood;              // Stimmung der Sonnenblume
+};
+
+// Farben wie TFT_RED, TFT_YELLOW und TFT_GREEN, damit der Header ohne TFT_eSPI auskommt
+constexpr StatusStyle StatusStyles[] = {
+    {"Bitte giessen", 0xF800, Mood::Sad},       // WaterNow
+    {"Bald giessen", 0xFFE0, Mood::Neutral},    // WaterSoon
+    {"Alles gut", 0x07E0, Mood::Happy},         // Ok
+};
+
+/**
+ * @brief Gießstatus aus der Bodenfeuchte.
+ */
+constexpr WateringStatus statusForMoisture(int moisture)
+{
+    return moisture <= DryThreshold ? WateringStatus::WaterNow
+         : moisture <= LowThreshold ? WateringStatus::WaterSoon
+         : WateringStatus::Ok;
+}
+
+constexpr const StatusStyle &styleFor(WateringStatus status)
+{
+    return StatusStyles[static_cast<std::uint8_t>(status)];
+}
+
+/**
+ * @brief Stimmung der Sonnenblume aus der Bodenfeuchte.
+ */
+constexpr Mood moodForMoisture(int moisture)
+{
+    return styleFor(statusForMoisture(moisture)).mood;
+}
+
+/** @brief Index der Stimmung, z.B. für vorgerenderte Sprites. */
+constexpr std::uint8_t index(Mood mood)
+{
+    return static_cast<std::uint8_t>(mood);
+}
+
+} // namespace plant
+
+#endif //PLANT_STATE_HPP__
@@ -0,0 +1,111 @@
+/**
+ * @file power_manager.hpp
+ * @brief Schlafen zwischen den Aufgaben des Schedulers mit Aufenthaltszählern je Energiezustand.
+*/
+
+#ifndef POWER_MANAGER_HPP__
+#define POWER_MANAGER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Verteilt die Zeit zwischen zwei Deadlines auf die Zustände Active, Idle und Sleep.
+ *
+ * Nach jedem Scheduler-Durchlauf wird rest() mit der Zeit bis zur nächsten Deadline aufgerufen.
+ * Die übergebene Wartefunktion legt die CPU schlafen, bis die Zeit erreicht ist (jeder Interrupt
+ * weckt sie kurz auf). Im Energiesparmodus (setLowPower) zählt die Wartezeit als Sleep, sonst als
+ * Idle; die Abschaltung von Peripherie übernimmt die Anwendung beim Umschalten.
+ *
+ * Aus den Aufenthaltszeiten und den Stromaufnahmen je Zustand lässt sich der mittlere Strom
+ * abschätzen.
+ */
+class PowerManager
+{
+public:
+    enum class State : std::uint8_t { Active, Idle, Sleep };
+    static constexpr std::size_t StateCount = 3;
+
+    typedef unsigned long (*ClockFunction)();
+    /** @brief Schläft, bis die Zeitquelle den übergebenen Wert erreicht hat. */
+    typedef void (*WaitFunction)(unsigned long wakeTime);
+
+private:
+    ClockFunction clock;
+    WaitFunction wait;
+    unsigned long minRest;
+
+    bool lowPower = false;
+    unsigned long lastMark;
+    std::uint64_t residency[StateCount] = {};
+    std::uint32_t restCount = 0;
+    std::uint32_t lowPowerEntries = 0;
+
+public:
+    /**
+     * @param [in] minRest kürzeste Wartezeit, für die geschlafen wird (kürzere Zeiten laufen weiter).
+     */
+    PowerManager(ClockFunction clock, WaitFunction wait, unsigned long minRest = 2)
+        : clock(clock), wait(wait), minRest(minRest), lastMark(clock())
+    {
+    }
+
+    /**
+     * @brief Schläft bis zur nächsten Deadline; aus loop() nach dem Scheduler aufrufen.
+     * @param [in] waitTime Zeit bis zur nächsten Deadline (Scheduler::timeUntilNext).
+     */
+    void rest(unsigned long waitTime)
+    {
+        unsigned long now = this->clock();
+        this->residency[static_cast<std::size_t>(State::Active)] += now - this->lastMark;
+        this->lastMark = now;
+        if (waitTime < this->minRest) {
+            return;
+        }
+
+        this->wait(now + waitTime);
+        unsigned long woken = this->clock();
+        State state = this->lowPower ? State::Sleep : State::Idle;
+        this->residency[static_cast<std::size_t>(state)] += woken - now;
+        this->lastMark = woken;
+        this->restCount++;
+    }
+
+    /**
+     * @brief Schaltet zwischen Idle (Anzeige an) und Sleep (Anzeige und Peripherie aus) um.
+     */
+    void setLowPower(bool enabled)
+    {
+        if (enabled && !this->lowPower) {
+            this->lowPowerEntries++;
+        }
+        this->lowPower = enabled;
+    }
+
+    bool isLowPower() const { return this->lowPower; }
+    /** @brief Aufenthaltszeit im Zustand in Einheiten der Zeitquelle. */
+    std::uint64_t residencyIn(State state) const { return this->residency[static_cast<std::size_t>(state)]; }
+    std::uint64_t totalTime() const { return this->residency[0] + this->residency[1] + this->residency[2]; }
+    std::uint32_t rests() const { return this->restCount; }
+    std::uint32_t lowPowerCount() const { return this->lowPowerEntries; }
+
+    /**
+     * @brief Mittlerer Strom aus den Aufenthaltszeiten.
+     * @param [in] microAmps Stromaufnahme je Zustand in µA, Reihenfolge wie State.
+     * @return gewichteter Mittelwert in µA, 0 ohne Messzeit.
+     */
+    std::uint32_t averageCurrent(const std::uint32_t (&microAmps)[StateCount]) const
+    {
+        std::uint64_t total = this->totalTime();
+        if (total == 0) {
+            return 0;
+        }
+        std::uint64_t weighted = 0;
+        for (std::size_t i = 0; i < StateCount; i++) {
+            weighted += this->residency[i] * microAmps[i];
+        }
+        return static_cast<std::uint32_t>(weighted / total);
+    }
+};
+
+#endif //POWER_MANAGER_HPP__
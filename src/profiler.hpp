@@ -0,0 +1,188 @@
+/**
+ * @file profiler.hpp
+ * @brief Laufzeitprofil benannter Code-Abschnitte: Anzahl, Summe, Maximum und log2-Histogramm je Abschnitt.
+ *
+ * Nur mit -DAQUA_PROFILE aktiv; ohne das Flag werden PROFILE_REGION und PROFILE_SCOPE zu nichts
+ * und es bleibt kein Code und kein RAM übrig.
+*/
+
+#ifndef PROFILER_HPP__
+#define PROFILER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Sammelt Laufzeiten je Abschnitt aus einem freilaufenden Zykluszähler (z.B. DWT->CYCCNT).
+ *
+ * Ein Abschnitt kostet zwei Zählerabfragen und einige Additionen. begin() bestimmt die Kosten einer
+ * leeren Messung, die von jeder Messung abgezogen werden, und die Kosten einer vollständigen Messung,
+ * aus denen overheadMicros() den Anteil des Profilers an der Laufzeit schätzt. Der 32-Bit-Zähler
+ * läuft bei 120 MHz nach 35 s über; längere Abschnitte gibt es nicht.
+ *
+ * Histogramm: Fach 0 zählt Laufzeiten unter 1 µs, Fach b (b >= 1) Laufzeiten von 2^(b-1) bis unter
+ * 2^b µs, das letzte Fach alles darüber.
+ */
+class Profiler
+{
+public:
+    typedef std::uint32_t (*CounterFunction)();
+    static constexpr std::size_t MaxRegions = 8;
+    static constexpr std::size_t Buckets = 20;     // letztes Fach ab 2^18 µs (262 ms)
+    static constexpr int InvalidRegion = -1;
+
+    struct Region
+    {
+        const char *name = nullptr;
+        std::uint32_t count = 0;
+        std::uint64_t totalCycles = 0;
+        std::uint32_t maxCycles = 0;
+        std::uint32_t windowMaxCycles = 0;  // Maximum seit dem letzten takeWindowMax()
+        std::uint32_t histogram[Buckets] = {};
+    };
+
+    /** @brief Misst einen Abschnitt vom Konstruktor bis zum Destruktor. */
+    class Scope
+    {
+    private:
+        Profiler &profiler;
+        int region;
+        std::uint32_t start;
+
+    public:
+        Scope(Profiler &profiler, int region) : profiler(profiler), region(region), start(profiler.counter()) {}
+        ~Scope() { this->profiler.record(this->region, this->profiler.counter() - this->start); }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+private:
+    CounterFunction counter;
+    std::uint32_t cyclesPerMicrosecond;
+    std::uint32_t overhead = 0;         // leere Messung, wird abgezogen
+    std::uint32_t measurementCost = 0;  // vollständige Messung inklusive record()
+    Region regions[MaxRegions];
+    std::size_t regionCount = 0;
+    Region calibration;
+
+    void recordInto(Region &entry, std::uint32_t cycles)
+    {
+        cycles = cycles > this->overhead ? cycles - this->overhead : 0;
+        entry.count++;
+        entry.totalCycles += cycles;
+        entry.maxCycles = cycles > entry.maxCycles ? cycles : entry.maxCycles;
+        entry.windowMaxCycles = cycles > entry.windowMaxCycles ? cycles : entry.windowMaxCycles;
+        std::uint32_t micros = cycles / this->cyclesPerMicrosecond;
+        std::size_t bucket = micros ? 32 - static_cast<std::size_t>(__builtin_clz(micros)) : 0;
+        entry.histogram[bucket < Buckets ? bucket : Buckets - 1]++;
+    }
+
+public:
+    /**
+     * @param [in] counter Zykluszähler, z.B. hal::cycleCount.
+     * @param [in] cyclesPerMicrosecond Takt des Zählers in MHz (1 für einen µs-Zähler wie micros()).
+     */
+    Profiler(CounterFunction counter, std::uint32_t cyclesPerMicrosecond)
+        : counter(counter), cyclesPerMicrosecond(cyclesPerMicrosecond ? cyclesPerMicrosecond : 1)
+    {
+    }
+
+    /**
+     * @brief Registriert einen Abschnitt; auch vor begin() (bei der Initialisierung globaler Variablen) möglich.
+     * @return Id des Abschnitts oder InvalidRegion, wenn MaxRegions erreicht ist.
+     */
+    int add(const char *name)
+    {
+        if (this->regionCount >= MaxRegions) {
+            return InvalidRegion;
+        }
+        this->regions[this->regionCount].name = name;
+        return static_cast<int>(this->regionCount++);
+    }
+
+    /**
+     * @brief Bestimmt die Kosten einer Messung; einmal aufrufen, nachdem der Zähler läuft.
+     */
+    void begin()
+    {
+        constexpr int Rounds = 16;
+        std::uint32_t cheapest = UINT32_MAX;
+        for (int i = 0; i < Rounds; i++) {
+            std::uint32_t start = this->counter();
+            std::uint32_t cycles = this->counter() - start;
+            cheapest = cycles < cheapest ? cycles : cheapest;
+        }
+        this->overhead = cheapest;
+
+        std::uint32_t start = this->counter();
+        for (int i = 0; i < Rounds; i++) {
+            std::uint32_t scopeStart = this->counter();
+            this->recordInto(this->calibration, this->counter() - scopeStart);
+        }
+        this->measurementCost = (this->counter() - start) / Rounds;
+    }
+
+    void record(int region, std::uint32_t cycles)
+    {
+        if (region >= 0 && static_cast<std::size_t>(region) < this->regionCount) {
+            this->recordInto(this->regions[region], cycles);
+        }
+    }
+
+    std::size_t size() const { return this->regionCount; }
+    const Region &region(int id) const { return this->regions[id]; }
+
+    std::uint32_t toMicros(std::uint64_t cycles) const
+    {
+        return static_cast<std::uint32_t>(cycles / this->cyclesPerMicrosecond);
+    }
+
+    /** @brief Mittlere Laufzeit eines Abschnitts in µs. */
+    std::uint32_t averageMicros(int id) const
+    {
+        const Region &entry = this->regions[id];
+        return entry.count ? this->toMicros(entry.totalCycles / entry.count) : 0;
+    }
+
+    /** @brief Maximum seit dem letzten Aufruf in µs (z.B. für periodische Telemetrie). */
+    std::uint32_t takeWindowMax(int id)
+    {
+        std::uint32_t cycles = this->regions[id].windowMaxCycles;
+        this->regions[id].windowMaxCycles = 0;
+        return this->toMicros(cycles);
+    }
+
+    /** @brief Kosten einer vollständigen Messung in Zyklen. */
+    std::uint32_t costCycles() const { return this->measurementCost; }
+
+    /** @brief Geschätzte Zeit, die alle bisherigen Messungen selbst gekostet haben, in µs. */
+    std::uint32_t overheadMicros() const
+    {
+        std::uint64_t measurements = 0;
+        for (std::size_t i = 0; i < this->regionCount; i++) {
+            measurements += this->regions[i].count;
+        }
+        return this->toMicros(measurements * this->measurementCost);
+    }
+
+    void reset()
+    {
+        for (std::size_t i = 0; i < this->regionCount; i++) {
+            const char *name = this->regions[i].name;
+            this->regions[i] = Region();
+            this->regions[i].name = name;
+        }
+    }
+};
+
+#ifdef AQUA_PROFILE
+/** @brief Legt eine globale Id für einen Abschnitt an. */
+#define PROFILE_REGION(profiler, id, name) const int id = (profiler).add(name)
+/** @brief Misst den Rest des umgebenden Blocks als Abschnitt id. */
+#define PROFILE_SCOPE(profiler, id) Profiler::Scope profileScope(profiler, id)
+#else
+#define PROFILE_REGION(profiler, id, name)
+#define PROFILE_SCOPE(profiler, id)
+#endif
+
+#endif //PROFILER_HPP__
@@ -0,0 +1,89 @@
+/**
+ * @file proximity_detector.hpp
+ * @brief Wandelt Abstandsmessungen in Ereignisse "Annäherung" und "Entfernt" mit Hysterese um.
+*/
+
+#ifndef PROXIMITY_DETECTOR_HPP__
+#define PROXIMITY_DETECTOR_HPP__
+
+#include <cstdint>
+
+/**
+ * @brief Erkennt Annäherung und Entfernen aus einer Folge von Abstandswerten.
+ *
+ * Eine Annäherung wird sofort gemeldet (die Anzeige soll ohne Verzögerung aufwachen). Entfernt
+ * gilt erst, wenn der Abstand leaveCount Messungen hintereinander über farDistance liegt; der
+ * Abstand zwischen nearDistance und farDistance verhindert ein Flattern an der Schwelle.
+ */
+class ProximityDetector
+{
+public:
+    enum class Event : std::uint8_t { None, Approached, Left };
+
+    /** @brief Werte ab hier meldet der VL53L0X, wenn kein Ziel in Reichweite ist. */
+    static constexpr std::uint16_t OutOfRange = 8190;
+
+private:
+    std::uint16_t nearDistance;
+    std::uint16_t farDistance;
+    std::uint8_t leaveCount;
+
+    bool near = false;
+    std::uint8_t farInRow = 0;
+    std::uint16_t lastDistance = OutOfRange;
+    std::uint32_t measurementCount = 0;
+    std::uint32_t eventCount = 0;
+
+public:
+    /**
+     * @param [in] nearDistance Abstand in mm, ab dem (oder näher) eine Annäherung erkannt wird.
+     * @param [in] farDistance Abstand in mm, über dem das Ziel als entfernt gilt.
+     * @param [in] leaveCount Anzahl aufeinanderfolgender Messungen über farDistance.
+     */
+    ProximityDetector(std::uint16_t nearDistance, std::uint16_t farDistance, std::uint8_t leaveCount = 3)
+        : nearDistance(nearDistance), farDistance(farDistance), leaveCount(leaveCount)
+    {
+    }
+
+    /**
+     * @brief Wertet eine Messung aus.
+     * @param [in] distance Abstand in mm; Werte >= OutOfRange bedeuten kein Ziel.
+     * @param [in] valid false bei Messfehler (z.B. Range-Status ungleich 0); zählt als kein Ziel.
+     */
+    Event update(std::uint16_t distance, bool valid = true)
+    {
+        this->measurementCount++;
+        if (!valid) {
+            distance = OutOfRange;
+        }
+        this->lastDistance = distance;
+
+        if (!this->near) {
+            if (distance <= this->nearDistance) {
+                this->near = true;
+                this->farInRow = 0;
+                this->eventCount++;
+                return Event::Approached;
+            }
+            return Event::None;
+        }
+
+        if (distance > this->farDistance) {
+            if (++this->farInRow >= this->leaveCount) {
+                this->near = false;
+                this->eventCount++;
+                return Event::Left;
+            }
+        } else {
+            this->farInRow = 0;
+        }
+        return Event::None;
+    }
+
+    bool isNear() const { return this->near; }
+    std::uint16_t distance() const { return this->lastDistance; }
+    std::uint32_t measurements() const { return this->measurementCount; }
+    std::uint32_t events() const { return this->eventCount; }
+};
+
+#endif //PROXIMITY_DETECTOR_HPP__
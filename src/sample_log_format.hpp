@@ -0,0 +1,194 @@
+/**
+ * @file sample_log_format.hpp
+ * @brief Binäres Logformat für Sensordaten (sensors.bin), gemeinsam genutzt von Firmware und export_csv.
+ *
+ * Aufbau der Datei (alle Werte Little Endian):
+ *  - Sektor 0: Dateikopf (FileHeader), 512 Byte, CRC32 in den letzten 4 Byte.
+ *  - ab Byte 512: Datenblöcke zu je 512 Byte:
+ *      Byte 0..3    Blocknummer (0, 1, 2, ...)
+ *      Byte 4..5    Anzahl gültiger Datensätze (0..RecordsPerBlock)
+ *      Byte 6..7    reserviert (0)
+ *      Byte 8..507  RecordsPerBlock Datensätze zu je RecordSize Byte
+ *      Byte 508..511 CRC32 über Byte 0..507
+ *  - Datensatz: uint32 Unixzeit (RTC, Ortszeit), uint16 Bodenfeuchte (ADC-Rohwert),
+ *    int16 Temperatur in 0,1 °C, int16 Luftfeuchtigkeit in 0,1 %.
+*/
+
+#ifndef SAMPLE_LOG_FORMAT_HPP__
+#define SAMPLE_LOG_FORMAT_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace samplelog {
+
+constexpr std::uint32_t Magic = 0x4C425141;     // "AQBL"
+constexpr std::uint16_t Version = 1;
+constexpr std::size_t BlockSize = 512;
+constexpr std::size_t RecordSize = 10;
+constexpr std::size_t BlockHeaderSize = 8;
+constexpr std::size_t CrcOffset = BlockSize - 4;
+constexpr std::size_t RecordsPerBlock = (CrcOffset - BlockHeaderSize) / RecordSize;
+
+/**
+ * @brief Ein Messwert in Festkommadarstellung.
+ */
+struct Record
+{
+    std::uint32_t unixTime;
+    std::uint16_t moisture;
+    std::int16_t temperature;   // 0,1 °C
+    std::int16_t humidity;      // 0,1 %
+};
+
+/**
+ * @brief Inhalt des Dateikopfs.
+ */
+struct FileHeader
+{
+    std::uint16_t version;
+    std::uint16_t recordSize;
+    std::uint16_t blockSize;
+    std::uint16_t recordsPerBlock;
+    std::uint32_t createdUnixTime;
+};
+
+inline void put16(std::uint8_t *p, std::uint16_t v)
+{
+    p[0] = static_cast<std::uint8_t>(v);
+    p[1] = static_cast<std::uint8_t>(v >> 8);
+}
+
+inline void put32(std::uint8_t *p, std::uint32_t v)
+{
+    put16(p, static_cast<std::uint16_t>(v));
+    put16(p + 2, static_cast<std::uint16_t>(v >> 16));
+}
+
+inline std::uint16_t get16(const std::uint8_t *p)
+{
+    return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline std::uint32_t get32(const std::uint8_t *p)
+{
+    return get16(p) | (static_cast<std::uint32_t>(get16(p + 2)) << 16);
+}
+
+/**
+ * @brief CRC-32 (IEEE 802.3) mit 16-Einträge-Tabelle, klein genug für den Flash.
+ */
+inline std::uint32_t crc32(const std::uint8_t *data, std::size_t length)
+{
+    static const std::uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    std::uint32_t crc = 0xFFFFFFFF;
+    for (std::size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+inline void sealBlock(std::uint8_t *block)
+{
+    put32(block + CrcOffset, crc32(block, CrcOffset));
+}
+
+inline bool blockCrcValid(const std::uint8_t *block)
+{
+    return get32(block + CrcOffset) == crc32(block, CrcOffset);
+}
+
+/**
+ * @brief Schreibt einen vollständigen Dateikopf-Sektor.
+ */
+inline void encodeFileHeader(std::uint8_t *sector, std::uint32_t createdUnixTime)
+{
+    std::memset(sector, 0, BlockSize);
+    put32(sector, Magic);
+    put16(sector + 4, Version);
+    put16(sector + 6, RecordSize);
+    put16(sector + 8, BlockSize);
+    put16(sector + 10, RecordsPerBlock);
+    put32(sector + 12, createdUnixTime);
+    sealBlock(sector);
+}
+
+/**
+ * @brief Prüft und dekodiert den Dateikopf.
+ * @return false bei falscher Kennung, CRC oder unbekanntem Layout.
+ */
+inline bool decodeFileHeader(const std::uint8_t *sector, FileHeader &header)
+{
+    if (get32(sector) != Magic || !blockCrcValid(sector)) {
+        return false;
+    }
+    header.version = get16(sector + 4);
+    header.recordSize = get16(sector + 6);
+    header.blockSize = get16(sector + 8);
+    header.recordsPerBlock = get16(sector + 10);
+    header.createdUnixTime = get32(sector + 12);
+    return header.version == Version && header.recordSize == RecordSize && header.blockSize == BlockSize
+        && header.recordsPerBlock == RecordsPerBlock;
+}
+
+/**
+ * @brief Setzt einen leeren Datenblock mit Blocknummer auf.
+ */
+inline void initBlock(std::uint8_t *block, std::uint32_t index)
+{
+    std::memset(block, 0, BlockSize);
+    put32(block, index);
+}
+
+inline std::uint32_t blockIndex(const std::uint8_t *block) { return get32(block); }
+inline std::uint16_t blockCount(const std::uint8_t *block) { return get16(block + 4); }
+
+/**
+ * @brief Hängt einen Datensatz an den Block an; der Block muss noch Platz haben.
+ */
+inline void appendRecord(std::uint8_t *block, const Record &record)
+{
+    std::uint16_t count = blockCount(block);
+    std::uint8_t *p = block + BlockHeaderSize + count * RecordSize;
+    put32(p, record.unixTime);
+    put16(p + 4, record.moisture);
+    put16(p + 6, static_cast<std::uint16_t>(record.temperature));
+    put16(p + 8, static_cast<std::uint16_t>(record.humidity));
+    put16(block + 4, static_cast<std::uint16_t>(count + 1));
+}
+
+inline Record readRecord(const std::uint8_t *block, std::size_t i)
+{
+    const std::uint8_t *p = block + BlockHeaderSize + i * RecordSize;
+    Record record;
+    record.unixTime = get32(p);
+    record.moisture = get16(p + 4);
+    record.temperature = static_cast<std::int16_t>(get16(p + 6));
+    record.humidity = static_cast<std::int16_t>(get16(p + 8));
+    return record;
+}
+
+/**
+ * @brief Wandelt einen Messwert in Zehntel um (gerundet, auf int16 begrenzt).
+ */
+inline std::int16_t toTenths(float value)
+{
+    float scaled = value * 10.0f;
+    scaled += scaled < 0 ? -0.5f : 0.5f;
+    if (scaled > 32767.0f) {
+        return 32767;
+    }
+    if (scaled < -32768.0f) {
+        return -32768;
+    }
+    return static_cast<std::int16_t>(scaled);
+}
+
+} // namespace samplelog
+
+#endif //SAMPLE_LOG_FORMAT_HPP__
@@ -0,0 +1,236 @@
+/**
+ * @file scheduler.hpp
+ * @brief Kooperativer Scheduler mit fester Kapazität für periodische und einmalige Aufgaben.
+*/
+
+#ifndef SCHEDULER_HPP__
+#define SCHEDULER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Führt fällige Aufgaben nach Deadline geordnet aus (früheste Deadline zuerst).
+ *
+ * Jede Aufgabe hat ihre eigene Deadline, es gibt keinen gemeinsamen Zeitstempel mehr. Eine
+ * periodische Aufgabe, die eine oder mehrere Perioden verpasst hat, wird nur einmal nachgeholt
+ * (kein Burst) und die verpassten Deadlines werden gezählt. Läuft eine Aufgabe länger als ihr
+ * Budget (standardmäßig die Periode), wird ein Overrun gezählt.
+ *
+ * Die Zeitquelle wird als Funktion übergeben (z.B. millis), damit der Scheduler auch mit einer
+ * simulierten Uhr betrieben werden kann.
+ */
+class Scheduler
+{
+public:
+    typedef void (*TaskFunction)();
+    typedef unsigned long (*ClockFunction)();
+    static constexpr std::size_t MaxTasks = 16;
+    static constexpr int InvalidTask = -1;
+
+    /**
+     * @brief Laufzeitstatistik einer Aufgabe, alle Zeiten in Einheiten der Zeitquelle.
+     */
+    struct TaskStats
+    {
+        std::uint32_t runs = 0;
+        std::uint32_t missedDeadlines = 0;  // Start erst nach der nächsten Deadline
+        std::uint32_t overruns = 0;         // Laufzeit über dem Budget
+        unsigned long maxLateness = 0;      // Jitter: Start - Deadline
+        unsigned long totalLateness = 0;
+        unsigned long maxDuration = 0;
+    };
+
+private:
+    struct Task
+    {
+        const char *name = nullptr;
+        TaskFunction function = nullptr;
+        unsigned long deadline = 0;
+        unsigned long period = 0;       // 0 = einmalig
+        unsigned long budget = 0;
+        bool active = false;
+        std::uint32_t generation = 0;   // ändert sich bei jedem cancel() und jeder Neubelegung des Slots
+        TaskStats stats;
+    };
+
+    ClockFunction clock;
+    Task tasks[MaxTasks];
+
+    int add(const char *name, TaskFunction function, unsigned long delay, unsigned long period, unsigned long budget)
+    {
+        for (std::size_t i = 0; i < MaxTasks; i++) {
+            Task &task = this->tasks[i];
+            if (!task.active) {
+                std::uint32_t generation = task.generation + 1;
+                task = Task();
+                task.generation = generation;
+                task.name = name;
+                task.function = function;
+                task.deadline = this->clock() + delay;
+                task.period = period;
+                task.budget = budget;
+                task.active = true;
+                return static_cast<int>(i);
+            }
+        }
+        return InvalidTask;
+    }
+
+    /**
+     * @brief Sucht die fällige Aufgabe mit der frühesten Deadline.
+     */
+    int nextDue(unsigned long now) const
+    {
+        int best = InvalidTask;
+        long bestLateness = -1;
+        for (std::size_t i = 0; i < MaxTasks; i++) {
+            const Task &task = this->tasks[i];
+            if (!task.active) {
+                continue;
+            }
+            // Vorzeichenbehaftete Differenz, damit der millis()-Überlauf korrekt behandelt wird
+            long lateness = static_cast<long>(now - task.deadline);
+            if (lateness >= 0 && lateness > bestLateness) {
+                best = static_cast<int>(i);
+                bestLateness = lateness;
+            }
+        }
+        return best;
+    }
+
+public:
+    explicit Scheduler(ClockFunction clock) : clock(clock) {}
+
+    /**
+     * @brief Legt eine periodische Aufgabe an.
+     * @param [in] name Name für Statistikausgaben (muss dauerhaft gültig sein).
+     * @param [in] period Periode; die erste Ausführung erfolgt nach firstDelay.
+     * @param [in] budget maximal erwartete Laufzeit, 0 = Periode.
+     * @return Aufgaben-ID oder InvalidTask, wenn kein Platz frei ist.
+     */
+    int addPeriodic(const char *name, TaskFunction function, unsigned long period, unsigned long firstDelay = 0,
+                    unsigned long budget = 0)
+    {
+        return this->add(name, function, firstDelay, period, budget ? budget : period);
+    }
+
+    /**
+     * @brief Legt eine einmalige Aufgabe an, die nach delay ausgeführt und danach entfernt wird.
+     */
+    int addOneShot(const char *name, TaskFunction function, unsigned long delay, unsigned long budget = 0)
+    {
+        return this->add(name, function, delay, 0, budget);
+    }
+
+    /**
+     * @brief Entfernt eine Aufgabe; darf auch aus der Aufgabe selbst aufgerufen werden.
+     *
+     * Der Slot kann danach sofort neu belegt werden, die ID ist dann ungültig (auf InvalidTask setzen).
+     */
+    void cancel(int id)
+    {
+        if (id >= 0 && static_cast<std::size_t>(id) < MaxTasks && this->tasks[id].active) {
+            this->tasks[id].active = false;
+            this->tasks[id].generation++;
+        }
+    }
+
+    /**
+     * @brief Verschiebt die nächste Ausführung einer Aufgabe auf jetzt + delay.
+     */
+    void reschedule(int id, unsigned long delay)
+    {
+        if (id >= 0 && static_cast<std::size_t>(id) < MaxTasks && this->tasks[id].active) {
+            this->tasks[id].deadline = this->clock() + delay;
+        }
+    }
+
+    /**
+     * @brief Führt alle fälligen Aufgaben aus; aus loop() aufrufen.
+     * @return Anzahl ausgeführter Aufgaben.
+     */
+    unsigned int runPending()
+    {
+        unsigned int executed = 0;
+        // Jede Aufgabe höchstens einmal pro Durchlauf, damit eine zu langsame Aufgabe nicht alle anderen blockiert
+        std::uint32_t ranMask = 0;
+        for (;;) {
+            unsigned long start = this->clock();
+            int id = this->nextDue(start);
+            if (id == InvalidTask || (ranMask & (1UL << id))) {
+                break;
+            }
+            ranMask |= 1UL << id;
+            Task &task = this->tasks[id];
+            TaskStats &stats = task.stats;
+
+            unsigned long lateness = start - task.deadline;
+            stats.totalLateness += lateness;
+            if (lateness > stats.maxLateness) {
+                stats.maxLateness = lateness;
+            }
+
+            // Die Aufgabe kann sich selbst entfernen und dabei neue anlegen, die denselben Slot
+            // belegen; nach dem Aufruf gelten daher nur noch die hier kopierten Werte
+            std::uint32_t generation = task.generation;
+            unsigned long period = task.period;
+            unsigned long budget = task.budget;
+            if (period != 0) {
+                unsigned long missed = lateness / period;
+                stats.missedDeadlines += missed;
+                task.deadline += (missed + 1) * period;
+            } else {
+                task.active = false;    // vor dem Aufruf, damit der Slot darin neu vergeben werden kann
+            }
+
+            task.function();
+            executed++;
+
+            unsigned long duration = this->clock() - start;
+            if (task.generation != generation) {
+                continue;   // entfernt oder neu belegt, die Statistik gehört nicht mehr zu dieser Aufgabe
+            }
+            stats.runs++;
+            if (duration > stats.maxDuration) {
+                stats.maxDuration = duration;
+            }
+            if (budget && duration > budget) {
+                stats.overruns++;
+            }
+        }
+        return executed;
+    }
+
+    /**
+     * @brief Zeit bis zur nächsten Deadline (0, wenn bereits eine Aufgabe fällig ist).
+     * @return Zeit bis zur nächsten Deadline oder maxWait, falls keine Aufgabe aktiv ist.
+     */
+    unsigned long timeUntilNext(unsigned long maxWait) const
+    {
+        unsigned long now = this->clock();
+        unsigned long wait = maxWait;
+        for (std::size_t i = 0; i < MaxTasks; i++) {
+            const Task &task = this->tasks[i];
+            if (!task.active) {
+                continue;
+            }
+            long remaining = static_cast<long>(task.deadline - now);
+            if (remaining <= 0) {
+                return 0;
+            }
+            if (static_cast<unsigned long>(remaining) < wait) {
+                wait = remaining;
+            }
+        }
+        return wait;
+    }
+
+    std::size_t capacity() const { return MaxTasks; }
+    bool isActive(int id) const { return id >= 0 && static_cast<std::size_t>(id) < MaxTasks && this->tasks[id].active; }
+    /** @brief Name der Aufgabe im Slot id oder nullptr, wenn der Slot nie belegt war. */
+    const char *name(int id) const { return this->tasks[id].name; }
+    const TaskStats &stats(int id) const { return this->tasks[id].stats; }
+};
+
+#endif //SCHEDULER_HPP__
@@ -0,0 +1,196 @@
+/**
+ * @file sd_logger.hpp
+ * @brief Gepufferter SD-Logger mit dauerhaft geöffnetem Datei-Handle.
+*/
+
+#ifndef SD_LOGGER_HPP__
+#define SD_LOGGER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include "sample_log_format.hpp"
+
+/**
+ * @brief Schreibt Messwerte im Binärformat (sample_log_format.hpp) in ganzen 512-Byte-Sektoren.
+ *
+ * Die Datei bleibt geöffnet, sodass FAT-Verzeichniseintrag und FAT-Tabelle nicht bei jedem Messwert
+ * aktualisiert werden. Der aktuelle Block liegt im RAM und wird geschrieben, sobald er voll ist
+ * (Größenschwelle) oder wenn seit dem letzten flush() mehr als flushInterval vergangen ist
+ * (Zeitschwelle). Ein teilweise gefüllter Block wird dabei an seiner Position überschrieben, bis er
+ * voll ist; jeder Schreibzugriff ist damit genau ein ausgerichteter Sektor.
+ *
+ * Schlägt ein Schreibzugriff fehl (Karte entfernt oder defekt), wird die Datei geschlossen und
+ * isOpen() liefert false, bis begin() mit einer neu geöffneten Datei aufgerufen wird.
+ *
+ * @tparam FileT Dateityp mit read(void*, n), write(const uint8_t*, n), seek(pos), size(), flush() und
+ *               close(), z.B. File aus SD.h. Die Datei darf nicht mit O_APPEND geöffnet sein.
+ */
+template <typename FileT>
+class SdLogger
+{
+public:
+    static constexpr std::size_t SectorSize = samplelog::BlockSize;
+
+private:
+    FileT file;
+    std::uint8_t block[SectorSize];
+    std::uint32_t blockOffset = 0;  // Dateiposition des aktuellen Blocks
+    bool open = false;
+    bool dirty = false;             // Block enthält ungeschriebene Datensätze
+    unsigned long flushInterval;
+    unsigned long lastFlush = 0;
+
+    std::uint32_t records = 0;
+    std::uint32_t writes = 0;
+    std::uint32_t errors = 0;
+
+    /**
+     * @brief Schreibt einen Sektor; bei einem Fehler wird die Datei geschlossen.
+     */
+    bool writeSector(std::uint32_t offset)
+    {
+        this->writes++;
+        if (!this->file.seek(offset) || this->file.write(this->block, SectorSize) != SectorSize) {
+            this->errors++;
+            this->file.close();
+            this->open = false;
+            return false;
+        }
+        return true;
+    }
+
+    bool writeBlock()
+    {
+        samplelog::sealBlock(this->block);
+        this->dirty = false;
+        return this->writeSector(this->blockOffset);
+    }
+
+    /**
+     * @brief Sucht den letzten Block und setzt das Schreiben dort fort.
+     *
+     * Ein unvollständig geschriebener Rest am Dateiende oder ein Block mit falscher CRC (z.B. nach
+     * Stromausfall während des Schreibens) wird beim nächsten Schreiben überschrieben.
+     */
+    void resume(std::uint32_t fileSize)
+    {
+        std::uint32_t blocks = (fileSize - SectorSize) / SectorSize;
+        if (blocks > 0) {
+            std::uint32_t lastOffset = SectorSize * blocks;
+            this->file.seek(lastOffset);
+            if (this->file.read(this->block, SectorSize) == static_cast<int>(SectorSize)) {
+                if (!samplelog::blockCrcValid(this->block)) {
+                    samplelog::initBlock(this->block, blocks - 1);
+                    this->blockOffset = lastOffset;
+                    return;
+                }
+                if (samplelog::blockCount(this->block) < samplelog::RecordsPerBlock) {
+                    this->blockOffset = lastOffset;
+                    return;
+                }
+            }
+        }
+        samplelog::initBlock(this->block, blocks);
+        this->blockOffset = SectorSize * (blocks + 1);
+    }
+
+public:
+    /**
+     * @param [in] flushInterval maximale Zeit in ms, die Daten nur im RAM liegen.
+     */
+    explicit SdLogger(unsigned long flushInterval = 60000) : flushInterval(flushInterval) {}
+
+    /**
+     * @brief Übernimmt eine zum Lesen und Schreiben geöffnete Datei.
+     * @param [in] file geöffnete Datei (leer oder im Binärformat).
+     * @param [in] now aktuelle Zeit in ms.
+     * @param [in] unixTime aktuelle RTC-Zeit, wird bei einer neuen Datei im Kopf vermerkt.
+     * @return false, wenn die Datei einen ungültigen Kopf hat oder der Kopf nicht geschrieben werden kann.
+     */
+    bool begin(FileT file, unsigned long now, std::uint32_t unixTime)
+    {
+        this->file = file;
+        this->lastFlush = now;
+        this->dirty = false;
+        this->open = false;
+
+        std::uint32_t fileSize = this->file.size();
+        if (fileSize < SectorSize) {
+            samplelog::encodeFileHeader(this->block, unixTime);
+            if (!this->writeSector(0)) {
+                return false;
+            }
+            this->file.flush();
+            samplelog::initBlock(this->block, 0);
+            this->blockOffset = SectorSize;
+        } else {
+            samplelog::FileHeader header;
+            this->file.seek(0);
+            if (this->file.read(this->block, SectorSize) != static_cast<int>(SectorSize)
+                || !samplelog::decodeFileHeader(this->block, header)) {
+                return false;
+            }
+            this->resume(fileSize);
+        }
+        this->open = true;
+        return true;
+    }
+
+    /**
+     * @brief Hängt einen Messwert an; ein voller Block wird sofort geschrieben.
+     * @return false, wenn keine Datei geöffnet ist oder der volle Block nicht geschrieben werden konnte.
+     */
+    bool append(const samplelog::Record &record)
+    {
+        if (!this->open) {
+            return false;
+        }
+        samplelog::appendRecord(this->block, record);
+        this->dirty = true;
+        this->records++;
+
+        if (samplelog::blockCount(this->block) == samplelog::RecordsPerBlock) {
+            if (!this->writeBlock()) {
+                return false;
+            }
+            samplelog::initBlock(this->block, samplelog::blockIndex(this->block) + 1);
+            this->blockOffset += SectorSize;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Prüft die Zeitschwelle; muss regelmäßig aus loop() aufgerufen werden.
+     */
+    void poll(unsigned long now)
+    {
+        if (this->open && now - this->lastFlush >= this->flushInterval) {
+            this->flush();
+            this->lastFlush = now;
+        }
+    }
+
+    /**
+     * @brief Schreibt den teilweise gefüllten Block und aktualisiert den Verzeichniseintrag.
+     * @remark Vor einem geplanten Abschalten aufrufen, sonst gehen bis zu flushInterval Daten verloren.
+     */
+    void flush()
+    {
+        if (!this->open || !this->dirty) {
+            return;
+        }
+        if (this->writeBlock()) {
+            this->file.flush();
+        }
+    }
+
+    bool isOpen() const { return this->open; }
+    /** @brief Anzahl angehängter Messwerte seit Start. */
+    std::uint32_t recordsLogged() const { return this->records; }
+    /** @brief Anzahl Sektor-Schreibzugriffe seit Start. */
+    std::uint32_t writeCalls() const { return this->writes; }
+    /** @brief Anzahl fehlgeschlagener Schreibzugriffe seit Start. */
+    std::uint32_t writeErrors() const { return this->errors; }
+};
+
+#endif //SD_LOGGER_HPP__
@@ -0,0 +1,484 @@
+/**
+ * @file sd_queue.hpp
+ * @brief Dauerhafte Telemetrie-Warteschlange auf der SD-Karte (nur anhängen, Segmentdateien, Commit-Datei).
+ *
+ * Aufbau im Verzeichnis (alle Werte Little Endian):
+ *  - 00000001.seg, 00000002.seg, ...: Segmente mit aufeinanderfolgenden Datensätzen:
+ *      Byte 0       RecordMagic
+ *      Byte 1       Länge n des Inhalts (telemetry::encode)
+ *      Byte 2..5    laufende Nummer (seq), lückenlos über alle Segmente
+ *      Byte 6..     Inhalt, n Byte
+ *      danach       CRC32 über Byte 0..5+n
+ *  - commit.dat: zwei Slots zu je CommitSlotSize Byte, abwechselnd beschrieben:
+ *      Generation, Segment, Offset und seq des ersten noch nicht gesendeten Datensatzes, CRC32.
+ *    Gültig ist der Slot mit korrekter CRC und der höheren Generation; ein beim Schreiben
+ *    abgebrochener Slot lässt damit immer den vorherigen Stand übrig.
+*/
+
+#ifndef SD_QUEUE_HPP__
+#define SD_QUEUE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "sample_log_format.hpp"
+#include "telemetry_queue.hpp"
+
+/**
+ * @brief Warteschlange mit der Schnittstelle aus telemetry_queue.hpp, gespeichert auf der SD-Karte.
+ *
+ * Segmente werden nur angehängt und nie überschrieben. Beim Start (begin()) wird das letzte Segment
+ * gelesen, bis der erste unvollständige oder beschädigte Datensatz folgt (Stromausfall während des
+ * Schreibens); dieser Rest wird nicht mehr gelesen, geschrieben wird ab dann in ein neues Segment.
+ * Die Arduino-SD-Bibliothek kann Dateien nicht kürzen, das Segment wird deshalb an dieser Stelle
+ * logisch abgeschnitten. Vollständig gesendete Segmente werden gelöscht; sind mehr als maxSegments
+ * vorhanden, wird das älteste verworfen.
+ *
+ * @tparam FsT Dateisystem mit open(path, mode), exists(path), remove(path), mkdir(path), z.B. SDClass.
+ * @tparam FileT Dateityp mit read(void*, n), write(const uint8_t*, n), seek(pos), size(), flush(),
+ *               close() und operator bool, z.B. File aus SD.h.
+ */
+template <typename FsT, typename FileT>
+class SdQueue
+{
+public:
+    static constexpr std::uint8_t RecordMagic = 0xA5;
+    static constexpr std::size_t HeaderSize = 6;
+    static constexpr std::size_t MaxRecordSize = HeaderSize + telemetry::MaxEncodedSize + 4;
+    static constexpr std::size_t CommitSlotSize = 20;
+    static constexpr std::size_t MaxPeek = 64;
+
+    /**
+     * @brief Stelle in der Warteschlange: Datensatz seq beginnt in segment bei offset.
+     */
+    struct Position
+    {
+        std::uint32_t segment = 1;
+        std::uint32_t offset = 0;
+        std::uint32_t seq = 1;
+    };
+
+    struct Stats
+    {
+        std::uint32_t appended = 0;
+        std::uint32_t consumed = 0;
+        std::uint32_t dropped = 0;          // mit vollen Segmenten verworfen oder beschädigt
+        std::uint32_t recoveredBytes = 0;   // beim Start abgeschnittener Rest
+        std::uint32_t commitWrites = 0;
+        std::uint32_t writeErrors = 0;
+    };
+
+private:
+    enum class ReadResult : std::uint8_t { Ok, End, Corrupt };
+
+    FsT &fs;
+    const char *directory;
+    std::uint8_t writeMode;
+    std::uint8_t readMode;
+    std::uint32_t segmentSize;
+    std::uint32_t maxSegments;
+    unsigned long flushInterval;
+
+    FileT writer;               // aktuelles Segment head.segment
+    FileT reader;               // älteres Segment beim Abbauen des Rückstands
+    std::uint32_t readerSegment = 0;
+    FileT commitFile;
+    bool open = false;
+    bool dirty = false;
+    unsigned long lastFlush = 0;
+
+    Position head;              // nächster zu schreibender Datensatz
+    Position committed;         // erster nicht gesendeter Datensatz
+    std::uint32_t oldestSegment = 1;
+    std::uint32_t generation = 0;
+    Position peekEnd[MaxPeek];  // Position nach dem i-ten gelesenen Datensatz
+    std::size_t peeked = 0;
+    Stats statistics;
+
+    void segmentPath(std::uint32_t segment, char *path, std::size_t size) const
+    {
+        snprintf(path, size, "%s/%08lu.seg", this->directory, static_cast<unsigned long>(segment));
+    }
+
+    bool segmentExists(std::uint32_t segment)
+    {
+        char path[48];
+        this->segmentPath(segment, path, sizeof(path));
+        return this->fs.exists(path);
+    }
+
+    void removeSegment(std::uint32_t segment)
+    {
+        char path[48];
+        this->segmentPath(segment, path, sizeof(path));
+        if (this->readerSegment == segment) {
+            this->reader.close();
+            this->readerSegment = 0;
+        }
+        this->fs.remove(path);
+    }
+
+    /**
+     * @brief Datei zum Lesen von segment; das aktuelle Segment wird über den Schreib-Handle gelesen,
+     *        damit noch nicht geflushte Daten sichtbar sind.
+     */
+    FileT *fileFor(std::uint32_t segment)
+    {
+        if (segment == this->head.segment) {
+            return this->writer ? &this->writer : nullptr;
+        }
+        if (this->readerSegment != segment) {
+            if (this->readerSegment != 0) {
+                this->reader.close();
+            }
+            char path[48];
+            this->segmentPath(segment, path, sizeof(path));
+            this->reader = this->fs.open(path, this->readMode);
+            this->readerSegment = this->reader ? segment : 0;
+        }
+        return this->readerSegment == segment ? &this->reader : nullptr;
+    }
+
+    /**
+     * @brief Liest den Datensatz an offset und prüft Magic, Länge und CRC.
+     * @param [out] length Gesamtlänge des Datensatzes in Byte.
+     */
+    ReadResult readRecord(FileT &file, std::uint32_t offset, telemetry::Entry &entry, std::uint32_t &seq,
+                          std::size_t &length)
+    {
+        std::uint8_t record[MaxRecordSize];
+        if (!file.seek(offset) || file.read(record, HeaderSize) != static_cast<int>(HeaderSize)) {
+            return ReadResult::End;
+        }
+        std::size_t size = record[1];
+        if (record[0] != RecordMagic || size == 0 || size > telemetry::MaxEncodedSize) {
+            return ReadResult::Corrupt;
+        }
+        length = HeaderSize + size + 4;
+        int rest = static_cast<int>(size + 4);
+        if (file.read(record + HeaderSize, rest) != rest) {
+            return ReadResult::End;
+        }
+        if (samplelog::crc32(record, HeaderSize + size) != samplelog::get32(record + HeaderSize + size)
+            || !telemetry::decode(record + HeaderSize, size, entry)) {
+            return ReadResult::Corrupt;
+        }
+        seq = samplelog::get32(record + 2);
+        return ReadResult::Ok;
+    }
+
+    /**
+     * @brief Liest ein Segment ab offset bis zum ersten ungültigen Datensatz.
+     * @param [in,out] seq erwartete seq des ersten Datensatzes (0: beliebig), danach die des nächsten.
+     * @return Ende des gültigen Teils.
+     */
+    std::uint32_t scan(FileT &file, std::uint32_t offset, std::uint32_t &seq)
+    {
+        telemetry::Entry entry;
+        std::uint32_t recordSeq = 0;
+        std::size_t length = 0;
+        while (this->readRecord(file, offset, entry, recordSeq, length) == ReadResult::Ok
+               && (recordSeq == seq || (offset == 0 && recordSeq > seq))) {
+            offset += length;
+            seq = recordSeq + 1;
+        }
+        return offset;
+    }
+
+    bool loadCommit()
+    {
+        // Fehlende Slots einer neuen oder kurzen Datei bleiben 0 und sind damit ungültig
+        std::uint8_t slots[2 * CommitSlotSize] = {};
+        this->commitFile.seek(0);
+        this->commitFile.read(slots, sizeof(slots));
+        bool found = false;
+        for (std::size_t i = 0; i < 2; i++) {
+            const std::uint8_t *slot = slots + i * CommitSlotSize;
+            if (samplelog::crc32(slot, 16) != samplelog::get32(slot + 16)) {
+                continue;
+            }
+            std::uint32_t slotGeneration = samplelog::get32(slot);
+            if (found && slotGeneration <= this->generation) {
+                continue;
+            }
+            found = true;
+            this->generation = slotGeneration;
+            this->committed.segment = samplelog::get32(slot + 4);
+            this->committed.offset = samplelog::get32(slot + 8);
+            this->committed.seq = samplelog::get32(slot + 12);
+        }
+        return found;
+    }
+
+    void writeCommit()
+    {
+        std::uint8_t slot[CommitSlotSize];
+        this->generation++;
+        samplelog::put32(slot, this->generation);
+        samplelog::put32(slot + 4, this->committed.segment);
+        samplelog::put32(slot + 8, this->committed.offset);
+        samplelog::put32(slot + 12, this->committed.seq);
+        samplelog::put32(slot + 16, samplelog::crc32(slot, 16));
+        this->commitFile.seek((this->generation & 1) * CommitSlotSize);
+        if (this->commitFile.write(slot, sizeof(slot)) != sizeof(slot)) {
+            this->statistics.writeErrors++;
+        }
+        this->commitFile.flush();
+        this->statistics.commitWrites++;
+    }
+
+    /**
+     * @brief Verwirft das älteste Segment, wenn mehr als maxSegments belegt sind.
+     */
+    void dropOldest()
+    {
+        std::uint32_t next = this->committed.segment + 1;
+        std::uint32_t seq = this->head.seq;
+        FileT *file = this->fileFor(next);
+        telemetry::Entry entry;
+        std::size_t length = 0;
+        if (file == nullptr || this->readRecord(*file, 0, entry, seq, length) != ReadResult::Ok) {
+            seq = this->head.seq;
+        }
+        this->statistics.dropped += seq - this->committed.seq;
+        this->removeSegment(this->committed.segment);
+        this->committed.segment = next;
+        this->committed.offset = 0;
+        this->committed.seq = seq;
+        this->oldestSegment = next;
+        this->peeked = 0;
+        this->writeCommit();
+    }
+
+    bool startSegment(std::uint32_t segment)
+    {
+        if (this->writer) {
+            this->writer.flush();
+            this->writer.close();
+        }
+        this->head.segment = segment;
+        this->head.offset = 0;
+        this->dirty = false;
+        if (this->head.segment - this->committed.segment + 1 > this->maxSegments) {
+            this->dropOldest();
+        }
+        char path[48];
+        this->segmentPath(segment, path, sizeof(path));
+        this->writer = this->fs.open(path, this->writeMode);
+        return static_cast<bool>(this->writer);
+    }
+
+public:
+    /**
+     * @param [in] directory Verzeichnis der Warteschlange, muss dauerhaft gültig sein.
+     * @param [in] writeMode Modus zum Schreiben, lesend und schreibend ohne O_APPEND (O_READ | O_WRITE | O_CREAT).
+     * @param [in] readMode Modus zum Lesen älterer Segmente (O_READ).
+     * @param [in] segmentSize Größe, ab der ein neues Segment begonnen wird, in Byte.
+     * @param [in] maxSegments höchstens so viele Segmente werden behalten.
+     * @param [in] flushInterval spätestens nach dieser Zeit in ms werden angehängte Datensätze geschrieben.
+     */
+    SdQueue(FsT &fs, const char *directory, std::uint8_t writeMode, std::uint8_t readMode,
+            std::uint32_t segmentSize = 32768, std::uint32_t maxSegments = 128, unsigned long flushInterval = 10000)
+        : fs(fs), directory(directory), writeMode(writeMode), readMode(readMode), segmentSize(segmentSize),
+          maxSegments(maxSegments < 2 ? 2 : maxSegments), flushInterval(flushInterval)
+    {
+    }
+
+    /**
+     * @brief Öffnet die Warteschlange und stellt den Zustand nach einem Neustart wieder her.
+     *
+     * Auch nach erneuter Initialisierung der SD-Karte aufrufen.
+     */
+    bool begin(unsigned long now)
+    {
+        this->close();
+        this->statistics.recoveredBytes = 0;
+        this->lastFlush = now;
+        this->committed = Position();
+        this->generation = 0;
+
+        if (!this->fs.exists(this->directory)) {
+            this->fs.mkdir(this->directory);
+        }
+        char path[48];
+        snprintf(path, sizeof(path), "%s/commit.dat", this->directory);
+        this->commitFile = this->fs.open(path, this->writeMode);
+        if (!this->commitFile) {
+            return false;
+        }
+        this->loadCommit();
+        this->oldestSegment = this->committed.segment;
+
+        // Nach einem Stromausfall zwischen Commit und Löschen übrig gebliebene Segmente entfernen
+        for (std::uint32_t segment = this->committed.segment - 1; segment > 0 && this->segmentExists(segment); segment--) {
+            this->removeSegment(segment);
+        }
+
+        // Letztes Segment suchen; die nächste seq ergibt sich aus dem letzten gültigen Datensatz,
+        // leere oder ganz abgeschnittene Segmente am Ende werden dabei übersprungen
+        std::uint32_t last = this->committed.segment;
+        while (this->segmentExists(last + 1)) {
+            last++;
+        }
+        this->head.segment = last + 1;  // fileFor() liest damit auch das letzte Segment über reader
+        std::uint32_t seq = 0;
+        for (std::uint32_t segment = last; seq == 0; segment--) {
+            FileT *file = this->fileFor(segment);
+            if (file != nullptr) {
+                std::uint32_t end = this->scan(*file, 0, seq);
+                if (segment == last) {
+                    this->statistics.recoveredBytes = file->size() - end;
+                }
+            }
+            if (segment == this->committed.segment) {
+                break;
+            }
+        }
+        this->head.seq = seq > this->committed.seq ? seq : this->committed.seq;
+
+        // Immer in ein neues Segment schreiben, ein abgeschnittener Rest wird so nie überschrieben
+        this->open = this->startSegment(last + 1);
+        this->peeked = 0;
+        return this->open;
+    }
+
+    /** @brief Schließt alle Dateien; bis zum nächsten begin() ist die Warteschlange nicht verfügbar. */
+    void close()
+    {
+        if (this->writer) {
+            this->writer.flush();
+            this->writer.close();
+        }
+        if (this->readerSegment != 0) {
+            this->reader.close();
+            this->readerSegment = 0;
+        }
+        if (this->commitFile) {
+            this->commitFile.close();
+        }
+        this->open = false;
+    }
+
+    bool isOpen() const { return this->open; }
+
+    /**
+     * @brief Hängt einen Eintrag an; geschrieben wird sofort, geflusht spätestens nach flushInterval.
+     * @return false bei einem Schreibfehler; die Warteschlange ist dann bis zum nächsten begin() geschlossen.
+     */
+    bool push(const telemetry::Entry &entry)
+    {
+        if (!this->open) {
+            return false;
+        }
+        std::uint8_t record[MaxRecordSize];
+        std::size_t size = telemetry::encode(entry, record + HeaderSize);
+        std::size_t length = HeaderSize + size + 4;
+        record[0] = RecordMagic;
+        record[1] = static_cast<std::uint8_t>(size);
+        samplelog::put32(record + 2, this->head.seq);
+        samplelog::put32(record + HeaderSize + size, samplelog::crc32(record, HeaderSize + size));
+
+        if (this->head.offset + length > this->segmentSize && !this->startSegment(this->head.segment + 1)) {
+            this->statistics.writeErrors++;
+            this->close();
+            return false;
+        }
+        if (!this->writer.seek(this->head.offset) || this->writer.write(record, length) != length) {
+            this->statistics.writeErrors++;
+            this->close();
+            return false;
+        }
+        this->head.offset += length;
+        this->head.seq++;
+        this->dirty = true;
+        this->statistics.appended++;
+        return true;
+    }
+
+    /**
+     * @brief Liest bis zu max der ältesten Einträge (höchstens MaxPeek), ohne sie zu entfernen.
+     *
+     * Beschädigte Datensätze und der Rest ihres Segments werden übersprungen.
+     */
+    std::size_t peek(telemetry::Entry *out, std::size_t max)
+    {
+        this->peeked = 0;
+        if (!this->open) {
+            return 0;
+        }
+        max = max < MaxPeek ? max : MaxPeek;
+        Position position = this->committed;
+        while (this->peeked < max
+               && (position.segment < this->head.segment || position.offset < this->head.offset)) {
+            FileT *file = this->fileFor(position.segment);
+            std::uint32_t seq = 0;
+            std::size_t length = 0;
+            ReadResult result = file != nullptr
+                              ? this->readRecord(*file, position.offset, out[this->peeked], seq, length)
+                              : ReadResult::End;
+            bool valid = result == ReadResult::Ok
+                      && (seq == position.seq || (position.offset == 0 && seq > position.seq));
+            if (!valid) {
+                if (position.segment == this->head.segment) {
+                    break;
+                }
+                position.segment++;     // Rest des Segments ist abgeschnitten oder beschädigt
+                position.offset = 0;
+                continue;
+            }
+            position.offset += length;
+            position.seq = seq + 1;
+            this->peekEnd[this->peeked++] = position;
+        }
+        return this->peeked;
+    }
+
+    /**
+     * @brief Entfernt die ersten n mit peek() gelesenen Einträge und schreibt die Commit-Datei.
+     *
+     * Dabei übersprungene seq (beschädigte Datensätze) werden hier als verworfen gezählt, nicht
+     * schon in peek(), das denselben Bereich mehrfach lesen kann.
+     */
+    void consume(std::size_t n)
+    {
+        n = n < this->peeked ? n : this->peeked;
+        if (!this->open || n == 0) {
+            return;
+        }
+        this->statistics.dropped += this->peekEnd[n - 1].seq - this->committed.seq - n;
+        this->committed = this->peekEnd[n - 1];
+        this->statistics.consumed += n;
+        this->peeked = 0;
+        this->writeCommit();
+        while (this->oldestSegment < this->committed.segment) {
+            this->removeSegment(this->oldestSegment++);
+        }
+    }
+
+    /**
+     * @brief Schreibt angehängte Datensätze, sobald das Flush-Intervall abgelaufen ist; zyklisch aufrufen.
+     */
+    void poll(unsigned long now)
+    {
+        if (this->open && this->dirty && now - this->lastFlush >= this->flushInterval) {
+            this->flush(now);
+        }
+    }
+
+    void flush(unsigned long now)
+    {
+        if (this->open && this->dirty) {
+            this->writer.flush();
+            this->dirty = false;
+        }
+        this->lastFlush = now;
+    }
+
+    std::uint32_t pending() const { return this->head.seq - this->committed.seq; }
+    std::uint32_t segments() const { return this->open ? this->head.segment - this->oldestSegment + 1 : 0; }
+    const Position &writePosition() const { return this->head; }
+    const Position &commitPosition() const { return this->committed; }
+    const Stats &stats() const { return this->statistics; }
+};
+
+#endif //SD_QUEUE_HPP__
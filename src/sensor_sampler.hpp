@@ -0,0 +1,108 @@
+/**
+ * @file sensor_sampler.hpp
+ * @brief Liest alle Sensoren einmal pro Periode und verteilt den Messwert an Abonnenten.
+*/
+
+#ifndef SENSOR_SAMPLER_HPP__
+#define SENSOR_SAMPLER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Ein zusammengehöriger Satz Messwerte mit Zeitstempel.
+ */
+struct Sample
+{
+    unsigned long timestamp = 0;    // millis() zum Zeitpunkt der Messung
+    std::uint32_t unixTime = 0;     // RTC-Zeit zum Zeitpunkt der Messung
+    int moisture = 0;               // Bodenfeuchte (ADC-Wert, gefiltert)
+    int moistureRaw = 0;            // Bodenfeuchte (einzelne ADC-Wandlung, ungefiltert)
+    float temperature = 0;          // °C
+    float humidity = 0;             // %
+    bool climateValid = false;      // false, wenn der DHT-Sensor keinen Wert geliefert hat
+};
+
+/**
+ * @brief Erfasst pro Periode genau einen Sample und veröffentlicht ihn an alle Abonnenten.
+ *
+ * Relais, Anzeige, Logger usw. arbeiten dadurch mit denselben Werten und die langsame
+ * DHT-Abfrage findet nur einmal pro Periode statt. Die Zeit wird von außen übergeben, damit die
+ * Klasse nicht von millis() abhängt.
+ */
+class SensorSampler
+{
+public:
+    typedef void (*ReadFunction)(Sample &sample);
+    typedef void (*SampleHandler)(const Sample &sample);
+    static constexpr std::size_t MaxSubscribers = 8;
+
+private:
+    ReadFunction read;
+    unsigned long period;
+    unsigned long lastSample = 0;
+    bool sampled = false;
+    Sample current;
+    SampleHandler subscribers[MaxSubscribers] = {};
+    std::size_t subscriberCount = 0;
+    std::uint32_t sampleCount = 0;
+
+public:
+    /**
+     * @param [in] read Funktion, die alle Sensoren einmal ausliest (ohne Zeitstempel).
+     * @param [in] period Abtastperiode in ms.
+     */
+    SensorSampler(ReadFunction read, unsigned long period) : read(read), period(period) {}
+
+    /**
+     * @brief Registriert einen Abonnenten; Aufrufreihenfolge entspricht der Registrierung.
+     * @return false, wenn bereits MaxSubscribers registriert sind.
+     */
+    bool subscribe(SampleHandler handler)
+    {
+        if (this->subscriberCount >= MaxSubscribers) {
+            return false;
+        }
+        this->subscribers[this->subscriberCount++] = handler;
+        return true;
+    }
+
+    /**
+     * @brief Misst, falls die Periode abgelaufen ist (oder noch nie gemessen wurde).
+     * @return true, wenn ein neuer Sample veröffentlicht wurde.
+     */
+    bool poll(unsigned long now)
+    {
+        if (this->sampled && now - this->lastSample < this->period) {
+            return false;
+        }
+        this->sampleNow(now);
+        return true;
+    }
+
+    /**
+     * @brief Misst sofort und veröffentlicht den Sample, unabhängig von der Periode.
+     */
+    void sampleNow(unsigned long now)
+    {
+        Sample sample;
+        this->read(sample);
+        sample.timestamp = now;
+        this->current = sample;
+        this->lastSample = now;
+        this->sampled = true;
+        this->sampleCount++;
+
+        for (std::size_t i = 0; i < this->subscriberCount; i++) {
+            this->subscribers[i](this->current);
+        }
+    }
+
+    bool hasSample() const { return this->sampled; }
+    /** @brief Zuletzt veröffentlichter Sample; nur gültig, wenn hasSample() true ist. */
+    const Sample &latest() const { return this->current; }
+    /** @brief Anzahl der Messungen seit Start. */
+    std::uint32_t samplesTaken() const { return this->sampleCount; }
+};
+
+#endif //SENSOR_SAMPLER_HPP__
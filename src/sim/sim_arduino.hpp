@@ -0,0 +1,196 @@
+/**
+ * @file sim_arduino.hpp
+ * @brief Simulierter Arduino-Kern für env:native: virtuelle Uhr, Pins und Serial.
+ *
+ * Die Zeit läuft nur, wenn sie vorgestellt wird (delay(), hal::sleepUntil() oder die Hauptschleife
+ * in sim_main.cpp); damit ist jeder Lauf mit denselben Eingaben reproduzierbar.
+*/
+
+#ifndef SIM_ARDUINO_HPP__
+#define SIM_ARDUINO_HPP__
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <math.h>
+#include <stdint.h>
+
+namespace sim {
+
+/**
+ * @brief Virtuelle Uhr in µs.
+ */
+class Clock
+{
+private:
+    std::uint64_t now = 0;
+    std::uint64_t slept = 0;
+
+public:
+    std::uint64_t micros() const { return this->now; }
+    unsigned long millis() const { return static_cast<unsigned long>(this->now / 1000); }
+
+    void advance(std::uint64_t us) { this->now += us; }
+
+    /** @brief Schläft bis zur angegebenen Zeit in ms (wie millis() gezählt). */
+    void sleepUntil(unsigned long wakeTime)
+    {
+        long remaining = static_cast<long>(wakeTime - this->millis());
+        if (remaining > 0) {
+            std::uint64_t target = (this->now / 1000 + static_cast<std::uint64_t>(remaining)) * 1000;
+            this->slept += target - this->now;
+            this->now = target;
+        }
+    }
+
+    /** @brief Verschlafene Zeit in µs. */
+    std::uint64_t sleptTime() const { return this->slept; }
+};
+
+constexpr std::size_t PinCount = 64;
+
+/**
+ * @brief Pegel der digitalen Ausgänge und Werte der analogen Eingänge.
+ */
+struct Pins
+{
+    std::uint8_t mode[PinCount] = {};
+    std::uint8_t level[PinCount] = {};
+    std::uint16_t analog[PinCount] = {};
+    std::uint32_t writes[PinCount] = {};
+    std::uint16_t noise = 0;            // Rauschen der ADC-Werte, +-noise
+    std::uint32_t random = 2463534242u;
+
+    int sampleAnalog(std::uint8_t pin)
+    {
+        int value = this->analog[pin % PinCount];
+        if (this->noise > 0) {
+            this->random ^= this->random << 13;
+            this->random ^= this->random >> 17;
+            this->random ^= this->random << 5;
+            value += static_cast<int>(this->random % (2u * this->noise + 1)) - this->noise;
+        }
+        return value < 0 ? 0 : value > 1023 ? 1023 : value;
+    }
+};
+
+/**
+ * @brief Serial: Ausgabe auf stdout, Eingabe aus einem Puffer (feed()).
+ */
+class SerialPort
+{
+private:
+    char input[256] = {};
+    std::size_t head = 0;
+    std::size_t count = 0;
+    bool quiet = false;
+
+public:
+    void begin(unsigned long) {}
+    void setQuiet(bool quiet) { this->quiet = quiet; }
+
+    std::size_t print(const char *text)
+    {
+        if (!this->quiet) {
+            std::fputs(text, stdout);
+        }
+        return std::strlen(text);
+    }
+    std::size_t print(char c)
+    {
+        const char text[2] = {c, '\0'};
+        return this->print(text);
+    }
+    std::size_t print(long value)
+    {
+        char text[24];
+        std::snprintf(text, sizeof(text), "%ld", value);
+        return this->print(text);
+    }
+    std::size_t print(int value) { return this->print(static_cast<long>(value)); }
+    std::size_t print(unsigned long value)
+    {
+        char text[24];
+        std::snprintf(text, sizeof(text), "%lu", value);
+        return this->print(text);
+    }
+    std::size_t print(unsigned value) { return this->print(static_cast<unsigned long>(value)); }
+    std::size_t print(double value, int digits = 2)
+    {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.*f", digits, value);
+        return this->print(text);
+    }
+
+    template <typename T>
+    std::size_t println(T value)
+    {
+        std::size_t n = this->print(value);
+        return n + this->print("\n");
+    }
+    std::size_t println() { return this->print("\n"); }
+
+    /** @brief Stellt Zeichen bereit, als kämen sie über USB. */
+    void feed(const char *text)
+    {
+        for (; *text != '\0' && this->count < sizeof(this->input); text++) {
+            this->input[(this->head + this->count++) % sizeof(this->input)] = *text;
+        }
+    }
+
+    int available() const { return static_cast<int>(this->count); }
+
+    int read()
+    {
+        if (this->count == 0) {
+            return -1;
+        }
+        char c = this->input[this->head];
+        this->head = (this->head + 1) % sizeof(this->input);
+        this->count--;
+        return static_cast<unsigned char>(c);
+    }
+};
+
+extern Clock clock;
+extern Pins pins;
+
+} // namespace sim
+
+extern sim::SerialPort Serial;
+
+// Pins des Wio Terminals, soweit main.cpp sie nutzt
+constexpr std::uint8_t A2 = 2;
+constexpr std::uint8_t D6 = 6;
+constexpr std::uint8_t INPUT = 0;
+constexpr std::uint8_t OUTPUT = 1;
+constexpr std::uint8_t LOW = 0;
+constexpr std::uint8_t HIGH = 1;
+
+#define F(text) (text)
+
+inline unsigned long millis() { return sim::clock.millis(); }
+inline unsigned long micros() { return static_cast<unsigned long>(sim::clock.micros()); }
+inline void delay(unsigned long ms) { sim::clock.advance(static_cast<std::uint64_t>(ms) * 1000); }
+inline void delayMicroseconds(unsigned int us) { sim::clock.advance(us); }
+
+inline void pinMode(std::uint8_t pin, std::uint8_t mode) { sim::pins.mode[pin % sim::PinCount] = mode; }
+
+inline void digitalWrite(std::uint8_t pin, std::uint8_t level)
+{
+    sim::pins.level[pin % sim::PinCount] = level;
+    sim::pins.writes[pin % sim::PinCount]++;
+}
+
+inline int digitalRead(std::uint8_t pin) { return sim::pins.level[pin % sim::PinCount]; }
+
+inline int analogRead(std::uint8_t pin)
+{
+    sim::clock.advance(10);     // Wandlungszeit des ADC
+    return sim::pins.sampleAnalog(pin);
+}
+
+#endif //SIM_ARDUINO_HPP__
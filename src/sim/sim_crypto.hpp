@@ -0,0 +1,198 @@
+/**
+ * @file sim_crypto.hpp
+ * @brief SHA-256, HMAC-SHA256 und Base64 für den Simulator (auf dem Gerät übernimmt das mbedtls).
+*/
+
+#ifndef SIM_CRYPTO_HPP__
+#define SIM_CRYPTO_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace sim {
+
+class Sha256
+{
+private:
+    std::uint32_t h[8];
+    std::uint8_t block[64];
+    std::size_t used = 0;
+    std::uint64_t total = 0;
+
+    static std::uint32_t rotr(std::uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+    void compress()
+    {
+        static const std::uint32_t k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+        std::uint32_t w[64];
+        for (int i = 0; i < 16; i++) {
+            w[i] = (std::uint32_t(this->block[4 * i]) << 24) | (std::uint32_t(this->block[4 * i + 1]) << 16)
+                 | (std::uint32_t(this->block[4 * i + 2]) << 8) | this->block[4 * i + 3];
+        }
+        for (int i = 16; i < 64; i++) {
+            std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        std::uint32_t a = this->h[0], b = this->h[1], c = this->h[2], d = this->h[3];
+        std::uint32_t e = this->h[4], f = this->h[5], g = this->h[6], hh = this->h[7];
+        for (int i = 0; i < 64; i++) {
+            std::uint32_t t1 = hh + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+            std::uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            hh = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        this->h[0] += a;
+        this->h[1] += b;
+        this->h[2] += c;
+        this->h[3] += d;
+        this->h[4] += e;
+        this->h[5] += f;
+        this->h[6] += g;
+        this->h[7] += hh;
+    }
+
+public:
+    Sha256()
+    {
+        static const std::uint32_t initial[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                                 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        std::memcpy(this->h, initial, sizeof(this->h));
+    }
+
+    void update(const std::uint8_t *data, std::size_t length)
+    {
+        this->total += length;
+        while (length > 0) {
+            std::size_t n = 64 - this->used < length ? 64 - this->used : length;
+            std::memcpy(this->block + this->used, data, n);
+            this->used += n;
+            data += n;
+            length -= n;
+            if (this->used == 64) {
+                this->compress();
+                this->used = 0;
+            }
+        }
+    }
+
+    void finish(std::uint8_t digest[32])
+    {
+        std::uint64_t bits = this->total * 8;
+        std::uint8_t pad = 0x80;
+        this->update(&pad, 1);
+        pad = 0;
+        while (this->used != 56) {
+            this->update(&pad, 1);
+        }
+        std::uint8_t length[8];
+        for (int i = 0; i < 8; i++) {
+            length[i] = static_cast<std::uint8_t>(bits >> (56 - 8 * i));
+        }
+        this->update(length, 8);
+        for (int i = 0; i < 32; i++) {
+            digest[i] = static_cast<std::uint8_t>(this->h[i / 4] >> (24 - 8 * (i % 4)));
+        }
+    }
+};
+
+inline void hmacSha256(const std::uint8_t *key, std::size_t keyLength, const std::uint8_t *data, std::size_t length,
+                       std::uint8_t digest[32])
+{
+    std::uint8_t block[64] = {};
+    if (keyLength > sizeof(block)) {
+        Sha256 hash;
+        hash.update(key, keyLength);
+        hash.finish(block);
+    } else {
+        std::memcpy(block, key, keyLength);
+    }
+    std::uint8_t pad[64];
+    for (int i = 0; i < 64; i++) {
+        pad[i] = block[i] ^ 0x36;
+    }
+    Sha256 inner;
+    inner.update(pad, sizeof(pad));
+    inner.update(data, length);
+    inner.finish(digest);
+    for (int i = 0; i < 64; i++) {
+        pad[i] = block[i] ^ 0x5c;
+    }
+    Sha256 outer;
+    outer.update(pad, sizeof(pad));
+    outer.update(digest, 32);
+    outer.finish(digest);
+}
+
+/** @return false, wenn out zu klein ist. */
+inline bool base64Encode(std::uint8_t *out, std::size_t size, std::size_t *written, const std::uint8_t *in,
+                         std::size_t length)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::size_t needed = (length + 2) / 3 * 4;
+    if (size < needed + 1) {
+        return false;
+    }
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < length; i += 3) {
+        std::uint32_t v = std::uint32_t(in[i]) << 16;
+        v |= i + 1 < length ? std::uint32_t(in[i + 1]) << 8 : 0;
+        v |= i + 2 < length ? in[i + 2] : 0;
+        out[n++] = alphabet[v >> 18];
+        out[n++] = alphabet[(v >> 12) & 0x3F];
+        out[n++] = i + 1 < length ? alphabet[(v >> 6) & 0x3F] : '=';
+        out[n++] = i + 2 < length ? alphabet[v & 0x3F] : '=';
+    }
+    out[n] = '\0';
+    *written = n;
+    return true;
+}
+
+/** @return false bei ungültigen Zeichen oder zu kleinem out. */
+inline bool base64Decode(std::uint8_t *out, std::size_t size, std::size_t *written, const std::uint8_t *in,
+                         std::size_t length)
+{
+    std::size_t n = 0;
+    std::uint32_t v = 0;
+    int bits = 0;
+    for (std::size_t i = 0; i < length && in[i] != '='; i++) {
+        char c = static_cast<char>(in[i]);
+        int value = c >= 'A' && c <= 'Z' ? c - 'A'
+                  : c >= 'a' && c <= 'z' ? c - 'a' + 26
+                  : c >= '0' && c <= '9' ? c - '0' + 52
+                  : c == '+' ? 62 : c == '/' ? 63 : -1;
+        if (value < 0) {
+            return false;
+        }
+        v = (v << 6) | static_cast<std::uint32_t>(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (n >= size) {
+                return false;
+            }
+            out[n++] = static_cast<std::uint8_t>(v >> bits);
+        }
+    }
+    *written = n;
+    return true;
+}
+
+} // namespace sim
+
+#endif //SIM_CRYPTO_HPP__
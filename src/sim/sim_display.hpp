@@ -0,0 +1,222 @@
+/**
+ * @file sim_display.hpp
+ * @brief Simuliertes TFT (320x240, RGB565) und Sprites mit der von main.cpp und den Widgets genutzten Schnittstelle.
+ *
+ * Text wird nicht mit einer echten Schrift gezeichnet: jedes Zeichen ist ein Block in der Größe
+ * der Standardschrift (6x8 Pixel je Textgröße). Für Layout, Überdeckung und Pixelzähler reicht das.
+*/
+
+#ifndef SIM_DISPLAY_HPP__
+#define SIM_DISPLAY_HPP__
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#define TFT_BLACK  0x0000
+#define TFT_WHITE  0xFFFF
+#define TFT_RED    0xF800
+#define TFT_GREEN  0x07E0
+#define TFT_YELLOW 0xFFE0
+
+namespace sim {
+
+class Display
+{
+protected:
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint16_t> pixels;
+    int cursorX = 0;
+    int cursorY = 0;
+    std::uint16_t textColor = TFT_WHITE;
+    std::uint16_t textBackground = TFT_BLACK;
+    bool textFilled = false;
+    std::uint8_t textSize = 1;
+
+    void resize(int width, int height)
+    {
+        this->width = width;
+        this->height = height;
+        this->pixels.assign(static_cast<std::size_t>(width) * height, 0);
+    }
+
+    void drawChar(char c)
+    {
+        int size = this->textSize;
+        if (this->textFilled) {
+            this->fillRect(this->cursorX, this->cursorY, 6 * size, 8 * size, this->textBackground);
+        }
+        if (c != ' ') {
+            this->fillRect(this->cursorX, this->cursorY + size, 5 * size, 7 * size, this->textColor);
+        }
+        this->cursorX += 6 * size;
+    }
+
+public:
+    std::uint32_t drawCalls = 0;
+    std::uint64_t pixelsWritten = 0;
+
+    Display() { this->resize(240, 320); }
+
+    void begin() {}
+
+    /** @brief 1 und 3 = Querformat. */
+    void setRotation(std::uint8_t rotation)
+    {
+        if (rotation & 1) {
+            this->resize(320, 240);
+        } else {
+            this->resize(240, 320);
+        }
+    }
+
+    void drawPixel(int x, int y, std::uint16_t color)
+    {
+        if (x >= 0 && y >= 0 && x < this->width && y < this->height) {
+            this->pixels[static_cast<std::size_t>(y) * this->width + x] = color;
+            this->pixelsWritten++;
+        }
+    }
+
+    void fillRect(int x, int y, int w, int h, std::uint16_t color)
+    {
+        this->drawCalls++;
+        int x0 = x < 0 ? 0 : x;
+        int y0 = y < 0 ? 0 : y;
+        int x1 = x + w > this->width ? this->width : x + w;
+        int y1 = y + h > this->height ? this->height : y + h;
+        for (int row = y0; row < y1; row++) {
+            for (int column = x0; column < x1; column++) {
+                this->pixels[static_cast<std::size_t>(row) * this->width + column] = color;
+            }
+        }
+        if (x1 > x0 && y1 > y0) {
+            this->pixelsWritten += static_cast<std::uint64_t>(x1 - x0) * (y1 - y0);
+        }
+    }
+
+    void fillScreen(std::uint16_t color) { this->fillRect(0, 0, this->width, this->height, color); }
+
+    void drawFastHLine(int x, int y, int w, std::uint16_t color) { this->fillRect(x, y, w, 1, color); }
+
+    void fillEllipse(int x, int y, int rx, int ry, std::uint16_t color)
+    {
+        for (int dy = -ry; dy <= ry; dy++) {
+            // x^2/rx^2 + y^2/ry^2 <= 1
+            int span = 0;
+            while (static_cast<long>(span + 1) * (span + 1) * ry * ry + static_cast<long>(dy) * dy * rx * rx
+                   <= static_cast<long>(rx) * rx * ry * ry) {
+                span++;
+            }
+            this->fillRect(x - span, y + dy, 2 * span + 1, 1, color);
+        }
+    }
+
+    void fillCircle(int x, int y, int r, std::uint16_t color) { this->fillEllipse(x, y, r, r, color); }
+
+    void setCursor(int x, int y)
+    {
+        this->cursorX = x;
+        this->cursorY = y;
+    }
+
+    /** @brief Ohne Hintergrundfarbe wird transparent gezeichnet. */
+    void setTextColor(std::uint16_t color)
+    {
+        this->textColor = color;
+        this->textFilled = false;
+    }
+
+    void setTextColor(std::uint16_t color, std::uint16_t background)
+    {
+        this->textColor = color;
+        this->textBackground = background;
+        this->textFilled = true;
+    }
+
+    void setTextSize(std::uint8_t size) { this->textSize = size ? size : 1; }
+
+    std::size_t print(const char *text)
+    {
+        std::size_t n = 0;
+        for (; *text != '\0'; text++, n++) {
+            if (*text == '\n') {
+                this->cursorX = 0;
+                this->cursorY += 8 * this->textSize;
+            } else {
+                this->drawChar(*text);
+            }
+        }
+        return n;
+    }
+
+    std::size_t println(const char *text)
+    {
+        std::size_t n = this->print(text);
+        return n + this->print("\n");
+    }
+
+    std::uint16_t pixel(int x, int y) const { return this->pixels[static_cast<std::size_t>(y) * this->width + x]; }
+    int screenWidth() const { return this->width; }
+    int screenHeight() const { return this->height; }
+
+    /** @brief Speichert den Bildschirminhalt als PPM (RGB888). */
+    bool writePpm(const char *path) const
+    {
+        FILE *file = std::fopen(path, "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        std::fprintf(file, "P6\n%d %d\n255\n", this->width, this->height);
+        for (std::uint16_t color : this->pixels) {
+            std::uint8_t rgb[3] = {static_cast<std::uint8_t>((color >> 11) * 255 / 31),
+                                   static_cast<std::uint8_t>(((color >> 5) & 0x3F) * 255 / 63),
+                                   static_cast<std::uint8_t>((color & 0x1F) * 255 / 31)};
+            std::fwrite(rgb, 1, sizeof(rgb), file);
+        }
+        return std::fclose(file) == 0;
+    }
+};
+
+/**
+ * @brief Sprite im RAM; bei 4 Bit Farbtiefe enthalten die Pixel Palettenindizes.
+ */
+class Sprite : public Display
+{
+private:
+    Display *target;
+    std::uint8_t depth = 16;
+    std::uint16_t palette[16] = {};
+
+public:
+    explicit Sprite(Display *target) : target(target) { this->resize(0, 0); }
+
+    void setColorDepth(std::uint8_t depth) { this->depth = depth; }
+
+    void *createSprite(int width, int height)
+    {
+        this->resize(width, height);
+        return this->pixels.data();
+    }
+
+    void setPaletteColor(std::uint8_t index, std::uint16_t color) { this->palette[index & 0x0F] = color; }
+
+    void fillSprite(std::uint16_t color) { this->fillScreen(color); }
+
+    void pushSprite(int x, int y)
+    {
+        for (int row = 0; row < this->height; row++) {
+            for (int column = 0; column < this->width; column++) {
+                std::uint16_t color = this->pixel(column, row);
+                this->target->drawPixel(x + column, y + row, this->depth == 4 ? this->palette[color & 0x0F] : color);
+            }
+        }
+        this->target->drawCalls++;
+    }
+};
+
+} // namespace sim
+
+#endif //SIM_DISPLAY_HPP__
@@ -0,0 +1,135 @@
+/**
+ * @file sim_environment.hpp
+ * @brief Umgebung des Simulators: Sensorwerte aus einer Messreihe (Trace) oder einem einfachen Pflanzenmodell.
+ *
+ * Format der Messreihe (CSV, eine Zeile pro Stützpunkt, Zeilen mit # werden übersprungen):
+ *   ms,moisture,temperature,humidity,distance[,wifi]
+ * Ein Wert gilt bis zum nächsten Stützpunkt. Leere Felder übernehmen den vorherigen Wert,
+ * temperature "nan" simuliert einen DHT-Lesefehler, distance 8190 "kein Ziel", wifi 0 einen
+ * ausgefallenen Access Point.
+*/
+
+#ifndef SIM_ENVIRONMENT_HPP__
+#define SIM_ENVIRONMENT_HPP__
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace sim {
+
+struct SensorState
+{
+    float moisture = 420.0f;    // ADC-Rohwert
+    float temperature = 21.5f;
+    float humidity = 48.0f;
+    std::uint16_t distance = 8190;
+    bool wifiAvailable = true;
+};
+
+/**
+ * @brief Liefert die Sensorwerte zum aktuellen Zeitpunkt.
+ *
+ * Ohne Messreihe trocknet die Erde langsam aus und wird feucht, solange das Pumpenrelais an ist;
+ * alle 10 Minuten steht 20 s lang jemand vor dem Gerät.
+ */
+class Environment
+{
+private:
+    struct Point
+    {
+        unsigned long time;
+        SensorState state;
+    };
+
+    std::vector<Point> trace;
+    std::size_t next = 0;
+    unsigned long lastUpdate = 0;
+
+public:
+    SensorState state;
+    bool tofPresent = true;
+    bool rtcPresent = true;
+    bool sdPresent = true;
+    std::uint32_t utcStart = 1717243200;    // UTC beim Start (1.6.2024 12:00), Quelle der NTP-Antworten
+    std::int32_t rtcOffset = 7200 - 30;     // RTC beim Start: Ortszeit (MESZ), 30 s nachgehend
+    float dryingPerMinute = 5.0f;   // Pflanzenmodell: Abnahme der Feuchte ohne Pumpe
+    float wateringPerSecond = 6.0f; // Zunahme bei laufender Pumpe
+
+    /**
+     * @brief Liest eine Messreihe; danach kommen alle Werte aus ihr.
+     */
+    bool loadTrace(const char *path)
+    {
+        FILE *file = std::fopen(path, "r");
+        if (file == nullptr) {
+            return false;
+        }
+        char line[160];
+        SensorState current = this->state;
+        while (std::fgets(line, sizeof(line), file) != nullptr) {
+            if (line[0] == '#' || line[0] == '\n' || std::strncmp(line, "ms", 2) == 0) {
+                continue;
+            }
+            char *fields[6] = {};
+            std::size_t count = 0;
+            for (char *field = line; count < 6; ) {
+                fields[count++] = field;
+                char *comma = std::strchr(field, ',');
+                if (comma == nullptr) {
+                    break;
+                }
+                *comma = '\0';
+                field = comma + 1;
+            }
+            auto present = [&](std::size_t i) { return i < count && fields[i][0] != '\0' && fields[i][0] != '\n'; };
+            Point point;
+            point.time = std::strtoul(fields[0], nullptr, 10);
+            if (present(1)) current.moisture = std::strtof(fields[1], nullptr);
+            if (present(2)) current.temperature = std::strtof(fields[2], nullptr);
+            if (present(3)) current.humidity = std::strtof(fields[3], nullptr);
+            if (present(4)) current.distance = static_cast<std::uint16_t>(std::strtoul(fields[4], nullptr, 10));
+            if (present(5)) current.wifiAvailable = std::strtoul(fields[5], nullptr, 10) != 0;
+            point.state = current;
+            this->trace.push_back(point);
+        }
+        std::fclose(file);
+        this->next = 0;
+        return !this->trace.empty();
+    }
+
+    /** @brief Virtuelle UTC-Zeit in ms. */
+    std::int64_t utcMs(unsigned long now) const { return static_cast<std::int64_t>(this->utcStart) * 1000 + now; }
+
+    bool hasTrace() const { return !this->trace.empty(); }
+
+    /**
+     * @brief Schreibt die Werte für den Zeitpunkt now fest.
+     * @param [in] pumpOn Zustand des Pumpenrelais (nur für das Pflanzenmodell).
+     */
+    void update(unsigned long now, bool pumpOn)
+    {
+        if (this->hasTrace()) {
+            while (this->next < this->trace.size() && this->trace[this->next].time <= now) {
+                this->state = this->trace[this->next++].state;
+            }
+        } else {
+            float minutes = (now - this->lastUpdate) / 60000.0f;
+            this->state.moisture -= this->dryingPerMinute * minutes;
+            if (pumpOn) {
+                this->state.moisture += this->wateringPerSecond * minutes * 60.0f;
+            }
+            this->state.moisture = this->state.moisture < 0.0f ? 0.0f : this->state.moisture > 900.0f ? 900.0f : this->state.moisture;
+            this->state.distance = now % 600000 >= 300000 && now % 600000 < 320000 ? 60 : 8190;
+        }
+        this->lastUpdate = now;
+    }
+};
+
+extern Environment environment;
+
+} // namespace sim
+
+#endif //SIM_ENVIRONMENT_HPP__
@@ -0,0 +1,158 @@
+/**
+ * @file sim_main.cpp
+ * @brief Einstiegspunkt des Simulators (pio run -e native): führt setup() und loop() aus main.cpp mit
+ *        virtueller Zeit und simulierter Peripherie aus.
+ *
+ * Aufruf: program [Optionen]
+ *   --duration s     simulierte Dauer in Sekunden (Standard 3600)
+ *   --trace datei    Sensorwerte aus einer Messreihe (Format siehe sim_environment.hpp)
+ *   --start unix     UTC-Zeit beim Start
+ *   --serial text    Befehle für den Serial Monitor, am Ende der Simulation eingegeben (z.B. "sbpe")
+ *   --frame datei    Bildschirminhalt am Ende als PPM speichern
+ *   --sd verz        SD-Karte aus verz laden und am Ende dorthin schreiben
+ *   --noise n        Rauschen des Feuchtesensors in ADC-Schritten
+ *   --no-wifi, --no-tof, --no-rtc, --no-sd   Peripherie fehlt
+ *   --quiet          Serial-Ausgabe bis zu den Befehlen unterdrücken
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "../hal.hpp"
+
+namespace sim {
+Clock clock;
+Pins pins;
+Environment environment;
+} // namespace sim
+
+sim::SerialPort Serial;
+sim::Storage SD;
+sim::Network WiFi;
+
+void setup();
+void loop();
+extern hal::Display tft;
+extern hal::Watchdog watchdog;
+
+namespace {
+
+void usage(const char *program)
+{
+    std::fprintf(stderr, "Aufruf: %s [--duration s] [--trace datei] [--start unix] [--serial text] [--frame datei]\n"
+                         "          [--sd verz] [--noise n] [--no-wifi] [--no-tof] [--no-rtc] [--no-sd] [--quiet]\n",
+                 program);
+}
+
+/** @brief Führt loop() bis zur virtuellen Zeit end (ms) aus. */
+std::uint32_t run(unsigned long end)
+{
+    std::uint32_t watchdogResets = 0;
+    bool expired = false;
+    while (sim::clock.millis() < end) {
+        sim::environment.update(sim::clock.millis(), sim::pins.level[D6] == HIGH);
+        sim::pins.analog[A2] = static_cast<std::uint16_t>(sim::environment.state.moisture);
+        std::uint64_t before = sim::clock.micros();
+        loop();
+        if (sim::clock.micros() == before) {
+            sim::clock.advance(1000);   // loop() ohne Schlafphase, Rechenzeit ist nicht modelliert
+        }
+        // Auf dem Gerät würde der Watchdog hier neu starten; gemeldet wird jeder Ablauf einmal
+        if (watchdog.expired() != expired) {
+            expired = !expired;
+            if (expired) {
+                watchdogResets++;
+                std::fprintf(stderr, "[sim] %lu ms: Watchdog abgelaufen\n", sim::clock.millis());
+            }
+        }
+    }
+    return watchdogResets;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned long duration = 3600;
+    const char *serialCommands = nullptr;
+    const char *framePath = nullptr;
+    const char *sdDirectory = nullptr;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *option = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (std::strcmp(option, "--no-wifi") == 0) {
+            sim::environment.state.wifiAvailable = false;
+        } else if (std::strcmp(option, "--no-tof") == 0) {
+            sim::environment.tofPresent = false;
+        } else if (std::strcmp(option, "--no-rtc") == 0) {
+            sim::environment.rtcPresent = false;
+        } else if (std::strcmp(option, "--no-sd") == 0) {
+            sim::environment.sdPresent = false;
+        } else if (std::strcmp(option, "--quiet") == 0) {
+            quiet = true;
+        } else if (value == nullptr) {
+            usage(argv[0]);
+            return 2;
+        } else if (std::strcmp(option, "--duration") == 0) {
+            duration = std::strtoul(value, nullptr, 10);
+            i++;
+        } else if (std::strcmp(option, "--trace") == 0) {
+            if (!sim::environment.loadTrace(value)) {
+                std::fprintf(stderr, "Messreihe %s nicht lesbar\n", value);
+                return 1;
+            }
+            i++;
+        } else if (std::strcmp(option, "--start") == 0) {
+            sim::environment.utcStart = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            i++;
+        } else if (std::strcmp(option, "--serial") == 0) {
+            serialCommands = value;
+            i++;
+        } else if (std::strcmp(option, "--frame") == 0) {
+            framePath = value;
+            i++;
+        } else if (std::strcmp(option, "--sd") == 0) {
+            sdDirectory = value;
+            i++;
+        } else if (std::strcmp(option, "--noise") == 0) {
+            sim::pins.noise = static_cast<std::uint16_t>(std::strtoul(value, nullptr, 10));
+            i++;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (sdDirectory != nullptr) {
+        SD.load(sdDirectory);
+    }
+    Serial.setQuiet(quiet);
+
+    auto wallStart = std::chrono::steady_clock::now();
+    setup();
+    std::uint32_t watchdogResets = run(duration * 1000);
+    if (serialCommands != nullptr) {
+        Serial.setQuiet(false);
+        Serial.feed(serialCommands);
+        run(sim::clock.millis() + 1000);   // der Serial-Task läuft alle 200 ms
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    if (framePath != nullptr && !tft.writePpm(framePath)) {
+        std::fprintf(stderr, "Bild %s nicht geschrieben\n", framePath);
+    }
+    if (sdDirectory != nullptr && !SD.save(sdDirectory)) {
+        std::fprintf(stderr, "SD-Karte nach %s nicht vollstaendig geschrieben\n", sdDirectory);
+    }
+
+    std::fflush(stdout);
+    std::fprintf(stderr, "[sim] %lu s simuliert in %.2f s, davon %llu s geschlafen; Pumpe %lu Schaltungen, "
+                         "Feuchte %.0f, SD %llu B in %lu Dateien, %lu Watchdog-Abläufe\n",
+                 sim::clock.millis() / 1000, wallSeconds, (unsigned long long)(sim::clock.sleptTime() / 1000000),
+                 (unsigned long)sim::pins.writes[D6], sim::environment.state.moisture,
+                 (unsigned long long)SD.usedBytes(), (unsigned long)SD.fileCount(), (unsigned long)watchdogResets);
+    return watchdogResets > 0 ? 1 : 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file sim_network.hpp
+ * @brief Simuliertes WLAN, NTP-Server (über WiFiUDP) und MQTT-Client mit der Schnittstelle von rpcWiFi und PubSubClient.
+ *
+ * Der Access Point ist verfügbar, solange environment.state.wifiAvailable gesetzt ist. NTP-Anfragen
+ * beantwortet ein simulierter Server mit environment.utcMs() nach 30 ms; der TLS-Client verschlüsselt nicht.
+*/
+
+#ifndef SIM_NETWORK_HPP__
+#define SIM_NETWORK_HPP__
+
+#include <cstdint>
+#include <cstring>
+#include "sim_arduino.hpp"
+#include "sim_environment.hpp"
+
+#define WL_IDLE_STATUS 0
+#define WL_CONNECTED 3
+#define WL_CONNECT_FAILED 4
+#define WL_DISCONNECTED 6
+
+namespace sim {
+
+/**
+ * @brief WLAN: verbindet 1,5 s nach begin(), bleibt nach einem Ausfall des Access Points getrennt.
+ */
+class Network
+{
+private:
+    bool active = false;
+    bool lost = false;
+    unsigned long startedAt = 0;
+
+public:
+    static constexpr unsigned long ConnectTime = 1500;
+    std::uint32_t begins = 0;
+
+    int begin(const char *, const char *)
+    {
+        this->active = true;
+        this->lost = false;
+        this->startedAt = clock.millis();
+        this->begins++;
+        return this->status();
+    }
+
+    int status()
+    {
+        if (!this->active || this->lost) {
+            return WL_DISCONNECTED;
+        }
+        if (!environment.state.wifiAvailable) {
+            // Verbindung abgebrochen, erst ein neues begin() verbindet wieder
+            this->lost = clock.millis() - this->startedAt >= ConnectTime;
+            return WL_DISCONNECTED;
+        }
+        return clock.millis() - this->startedAt >= ConnectTime ? WL_CONNECTED : WL_DISCONNECTED;
+    }
+
+    bool disconnect(bool = false)
+    {
+        this->active = false;
+        return true;
+    }
+
+    std::int32_t RSSI() const { return -55 - static_cast<std::int32_t>(clock.millis() / 1000 % 7); }
+};
+
+/**
+ * @brief UDP für NTP: jede gesendete Anfrage wird nach 30 ms von einem Server der Schicht 2 beantwortet.
+ */
+class Udp
+{
+private:
+    std::uint8_t request[48] = {};
+    bool pending = false;
+    unsigned long replyAt = 0;
+
+public:
+    static constexpr unsigned long ReplyDelay = 30;
+    std::uint32_t requests = 0;
+
+    std::uint8_t begin(std::uint16_t) { return 1; }
+    void stop() { this->pending = false; }
+    int beginPacket(const char *, std::uint16_t) { return 1; }
+
+    std::size_t write(const std::uint8_t *buffer, std::size_t size)
+    {
+        std::memcpy(this->request, buffer, size < sizeof(this->request) ? size : sizeof(this->request));
+        return size;
+    }
+
+    int endPacket()
+    {
+        this->requests++;
+        if (!environment.state.wifiAvailable) {
+            return 0;   // Paket geht verloren
+        }
+        this->pending = true;
+        this->replyAt = clock.millis() + ReplyDelay;
+        return 1;
+    }
+
+    int parsePacket() { return this->pending && static_cast<long>(clock.millis() - this->replyAt) >= 0 ? 48 : 0; }
+
+    int read(std::uint8_t *buffer, std::size_t length)
+    {
+        if (length < 48 || !this->pending) {
+            return 0;
+        }
+        std::memset(buffer, 0, 48);
+        buffer[0] = 0x24;   // LI = 0, Version 4, Mode 4 (Server)
+        buffer[1] = 2;      // Stratum
+        std::memcpy(buffer + 24, this->request + 40, 8);    // Originate = Transmit der Anfrage
+        // Receive und Transmit: Serverzeit in der Mitte des Weges
+        std::int64_t unixMs = environment.utcMs(clock.millis() - ReplyDelay / 2);
+        std::uint32_t seconds = static_cast<std::uint32_t>(unixMs / 1000) + 2208988800UL;
+        std::uint32_t fraction = static_cast<std::uint32_t>(((unixMs % 1000) << 32) / 1000);
+        for (int i = 0; i < 4; i++) {
+            buffer[32 + i] = buffer[40 + i] = static_cast<std::uint8_t>(seconds >> (24 - 8 * i));
+            buffer[36 + i] = buffer[44 + i] = static_cast<std::uint8_t>(fraction >> (24 - 8 * i));
+        }
+        this->pending = false;
+        return 48;
+    }
+
+    void flush() { this->pending = false; }
+};
+
+class SecureClient
+{
+public:
+    void setCACert(const char *) {}
+};
+
+/**
+ * @brief MQTT-Client ohne Broker: Publishes werden gezählt, solange der Access Point verfügbar ist.
+ */
+class MqttClient
+{
+private:
+    bool session = false;
+
+public:
+    std::uint32_t publishes = 0;
+    std::uint64_t publishedBytes = 0;
+
+    explicit MqttClient(SecureClient &) {}
+    void setServer(const char *, std::uint16_t) {}
+    bool setBufferSize(std::uint16_t) { return true; }
+
+    bool connect(const char *, const char *, const char *)
+    {
+        clock.advance(250000);  // TLS-Handshake
+        this->session = environment.state.wifiAvailable;
+        return this->session;
+    }
+
+    bool connected()
+    {
+        this->session = this->session && environment.state.wifiAvailable;
+        return this->session;
+    }
+
+    bool publish(const char *topic, const std::uint8_t *, unsigned int length)
+    {
+        if (!this->connected()) {
+            return false;
+        }
+        this->publishes++;
+        this->publishedBytes += std::strlen(topic) + length;
+        return true;
+    }
+
+    bool loop() { return this->connected(); }
+    void disconnect() { this->session = false; }
+};
+
+} // namespace sim
+
+#endif //SIM_NETWORK_HPP__
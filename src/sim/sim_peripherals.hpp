@@ -0,0 +1,237 @@
+/**
+ * @file sim_peripherals.hpp
+ * @brief Simulierte Sensoren und MCU-Peripherie: DHT, DS3231 (mit DateTime/TimeSpan), VL53L0X,
+ *        Hintergrundbeleuchtung und Watchdog, jeweils mit der von main.cpp genutzten Schnittstelle.
+*/
+
+#ifndef SIM_PERIPHERALS_HPP__
+#define SIM_PERIPHERALS_HPP__
+
+#include <cmath>
+#include <cstdint>
+#include "sim_arduino.hpp"
+#include "sim_environment.hpp"
+
+#define DHT11 11
+#define DHT22 22
+
+/**
+ * @brief Datum und Uhrzeit wie in RTClib (Sekunden seit 1970, ohne Zeitzone).
+ */
+class TimeSpan
+{
+private:
+    std::int32_t seconds;
+
+public:
+    TimeSpan(std::int32_t seconds = 0) : seconds(seconds) {}
+    TimeSpan(std::int16_t days, std::int8_t hours, std::int8_t minutes, std::int8_t seconds)
+        : seconds(days * 86400L + hours * 3600L + minutes * 60L + seconds)
+    {
+    }
+    std::int32_t totalseconds() const { return this->seconds; }
+};
+
+class DateTime
+{
+private:
+    std::uint32_t secs;
+    std::int32_t y;
+    std::uint8_t m;
+    std::uint8_t d;
+
+    static std::int32_t daysFromCivil(std::int32_t year, unsigned month, unsigned day)
+    {
+        year -= month <= 2;
+        std::int32_t era = (year >= 0 ? year : year - 399) / 400;
+        unsigned yoe = static_cast<unsigned>(year - era * 400);
+        unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<std::int32_t>(doe) - 719468;
+    }
+
+    void split()
+    {
+        std::int32_t z = static_cast<std::int32_t>(this->secs / 86400) + 719468;
+        std::int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+        unsigned doe = static_cast<unsigned>(z - era * 146097);
+        unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        unsigned mp = (5 * doy + 2) / 153;
+        this->d = static_cast<std::uint8_t>(doy - (153 * mp + 2) / 5 + 1);
+        this->m = static_cast<std::uint8_t>(mp < 10 ? mp + 3 : mp - 9);
+        this->y = static_cast<std::int32_t>(yoe) + era * 400 + (this->m <= 2);
+    }
+
+public:
+    DateTime(std::uint32_t unixTime = 946684800) : secs(unixTime) { this->split(); }
+    DateTime(std::uint16_t year, std::uint8_t month, std::uint8_t day, std::uint8_t hour = 0, std::uint8_t min = 0,
+             std::uint8_t sec = 0)
+        : secs(static_cast<std::uint32_t>(daysFromCivil(year, month, day)) * 86400u + hour * 3600u + min * 60u + sec)
+    {
+        this->split();
+    }
+
+    std::uint16_t year() const { return static_cast<std::uint16_t>(this->y); }
+    std::uint8_t month() const { return this->m; }
+    std::uint8_t day() const { return this->d; }
+    std::uint8_t hour() const { return static_cast<std::uint8_t>(this->secs / 3600 % 24); }
+    std::uint8_t minute() const { return static_cast<std::uint8_t>(this->secs / 60 % 60); }
+    std::uint8_t second() const { return static_cast<std::uint8_t>(this->secs % 60); }
+    /** @brief 0 = Sonntag. */
+    std::uint8_t dayOfTheWeek() const { return static_cast<std::uint8_t>((this->secs / 86400 + 4) % 7); }
+    std::uint32_t unixtime() const { return this->secs; }
+
+    DateTime operator+(const TimeSpan &span) const { return DateTime(this->secs + span.totalseconds()); }
+    DateTime operator-(const TimeSpan &span) const { return DateTime(this->secs - span.totalseconds()); }
+    bool operator<(const DateTime &other) const { return this->secs < other.secs; }
+    bool operator>(const DateTime &other) const { return this->secs > other.secs; }
+    bool operator<=(const DateTime &other) const { return this->secs <= other.secs; }
+    bool operator>=(const DateTime &other) const { return this->secs >= other.secs; }
+    bool operator==(const DateTime &other) const { return this->secs == other.secs; }
+    bool operator!=(const DateTime &other) const { return this->secs != other.secs; }
+};
+
+namespace sim {
+
+/**
+ * @brief DHT11/DHT22; eine Messung dauert wie auf dem Gerät einige ms.
+ */
+class ClimateSensor
+{
+public:
+    ClimateSensor(std::uint8_t, std::uint8_t) {}
+    void begin() {}
+
+    float readTemperature()
+    {
+        clock.advance(5000);
+        return environment.state.temperature;
+    }
+
+    float readHumidity()
+    {
+        clock.advance(5000);
+        return environment.state.humidity;
+    }
+};
+
+/**
+ * @brief DS3231; läuft mit der virtuellen Uhr, startet mit environment.utcStart + rtcOffset (Ortszeit).
+ */
+class Rtc
+{
+private:
+    std::int64_t offset = 0;    // Ortszeit - millis()/1000
+    bool started = false;       // die Uhr läuft weiter, auch wenn begin() erneut aufgerufen wird
+
+public:
+    bool begin()
+    {
+        if (!this->started) {
+            this->offset = static_cast<std::int64_t>(environment.utcStart) + environment.rtcOffset;
+            this->started = true;
+        }
+        return environment.rtcPresent;
+    }
+
+    DateTime now() const
+    {
+        return DateTime(static_cast<std::uint32_t>(this->offset + clock.millis() / 1000));
+    }
+
+    void adjust(const DateTime &time)
+    {
+        this->offset = static_cast<std::int64_t>(time.unixtime()) - clock.millis() / 1000;
+    }
+};
+
+/**
+ * @brief VL53L0X im Continuous-Mode: alle period ms liegt eine neue Messung vor.
+ */
+class RangeSensor
+{
+private:
+    bool running = false;
+    std::uint16_t period = 50;
+    unsigned long lastRange = 0;
+
+public:
+    std::uint32_t measurements = 0;
+
+    bool begin() { return environment.tofPresent; }
+
+    bool startRangeContinuous(std::uint16_t period = 50)
+    {
+        this->running = true;
+        this->period = period;
+        this->lastRange = clock.millis();
+        return true;
+    }
+
+    void stopRangeContinuous() { this->running = false; }
+
+    bool isRangeComplete() const { return this->running && clock.millis() - this->lastRange >= this->period; }
+
+    std::uint16_t readRangeResult()
+    {
+        this->lastRange = clock.millis();
+        this->measurements++;
+        return environment.state.distance;
+    }
+};
+
+/**
+ * @brief Hintergrundbeleuchtung; Überblendungen springen sofort auf den Zielwert.
+ */
+class BackLight
+{
+private:
+    std::uint8_t brightness = 100;
+    bool enabled = true;
+
+public:
+    void initialize() {}
+    void setBrightness(std::uint8_t brightness) { this->brightness = brightness; }
+    void fadeTo(std::uint8_t brightness, std::uint32_t) { this->brightness = brightness; }
+    bool isFading() const { return false; }
+    void setGammaCorrection(bool) {}
+    void setAutoDim(std::uint32_t, std::uint8_t, std::uint16_t = 1000) {}
+    void touch() {}
+    void handleTimerInterrupt() {}
+    void disable() { this->enabled = false; }
+    void enable() { this->enabled = true; }
+    bool isEnabled() const { return this->enabled; }
+    std::uint8_t getBrightness() const { return this->enabled ? this->brightness : 0; }
+};
+
+/**
+ * @brief Watchdog; sim_main.cpp meldet, wenn er auf dem Gerät ausgelöst hätte.
+ */
+class Watchdog
+{
+private:
+    bool running = false;
+    std::uint32_t timeout = 0;
+    unsigned long lastFeed = 0;
+
+public:
+    bool begin(std::uint32_t timeoutMs)
+    {
+        this->timeout = timeoutMs;
+        this->running = true;
+        this->lastFeed = clock.millis();
+        return true;
+    }
+
+    void feed() { this->lastFeed = clock.millis(); }
+    bool isRunning() const { return this->running; }
+    static bool causedLastReset() { return false; }
+
+    /** @brief true, wenn der Watchdog auf dem Gerät inzwischen einen Reset ausgelöst hätte. */
+    bool expired() const { return this->running && clock.millis() - this->lastFeed > this->timeout; }
+};
+
+} // namespace sim
+
+#endif //SIM_PERIPHERALS_HPP__
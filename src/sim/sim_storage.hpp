@@ -0,0 +1,203 @@
+/**
+ * @file sim_storage.hpp
+ * @brief Simulierte SD-Karte: Dateisystem im RAM mit der Schnittstelle von File und SDClass aus SD.h.
+ *
+ * Der Inhalt kann aus einem Verzeichnis geladen und am Ende dorthin geschrieben werden, damit mehrere
+ * Läufe hintereinander wie Neustarts mit derselben Karte wirken.
+*/
+
+#ifndef SIM_STORAGE_HPP__
+#define SIM_STORAGE_HPP__
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "sim_environment.hpp"
+
+#ifndef O_READ
+#define O_READ 0x01
+#endif
+#ifndef O_WRITE
+#define O_WRITE 0x02
+#endif
+
+namespace sim {
+
+struct FileData
+{
+    std::vector<std::uint8_t> bytes;
+};
+
+class File
+{
+private:
+    std::shared_ptr<FileData> data;
+    std::uint32_t offset = 0;
+    bool writable = false;
+
+public:
+    File() = default;
+    File(std::shared_ptr<FileData> data, bool writable) : data(std::move(data)), writable(writable) {}
+
+    int read(void *buffer, std::uint16_t length)
+    {
+        if (!this->data) {
+            return -1;
+        }
+        std::uint32_t size = static_cast<std::uint32_t>(this->data->bytes.size());
+        std::uint32_t n = this->offset < size ? size - this->offset : 0;
+        n = n < length ? n : length;
+        std::memcpy(buffer, this->data->bytes.data() + this->offset, n);
+        this->offset += n;
+        return static_cast<int>(n);
+    }
+
+    std::size_t write(const std::uint8_t *buffer, std::size_t length)
+    {
+        if (!this->data || !this->writable) {
+            return 0;
+        }
+        if (this->offset + length > this->data->bytes.size()) {
+            this->data->bytes.resize(this->offset + length);
+        }
+        std::memcpy(this->data->bytes.data() + this->offset, buffer, length);
+        this->offset += static_cast<std::uint32_t>(length);
+        return length;
+    }
+
+    bool seek(std::uint32_t position)
+    {
+        if (!this->data || position > this->data->bytes.size()) {
+            return false;
+        }
+        this->offset = position;
+        return true;
+    }
+
+    std::uint32_t position() const { return this->offset; }
+    std::uint32_t size() const { return this->data ? static_cast<std::uint32_t>(this->data->bytes.size()) : 0; }
+    void flush() {}
+    void close() { this->data.reset(); }
+    explicit operator bool() const { return static_cast<bool>(this->data); }
+};
+
+class Storage
+{
+private:
+    std::map<std::string, std::shared_ptr<FileData>> files;
+    std::set<std::string> directories;
+
+    static std::string normalize(const char *path)
+    {
+        while (*path == '/') {
+            path++;
+        }
+        return path;
+    }
+
+public:
+    bool begin(std::uint8_t = 0) { return environment.sdPresent; }
+
+    File open(const char *path, std::uint8_t mode = O_READ)
+    {
+        std::string name = normalize(path);
+        auto found = this->files.find(name);
+        if (found == this->files.end()) {
+            if (!(mode & O_CREAT) || this->directories.count(name)) {
+                return File();
+            }
+            found = this->files.emplace(name, std::make_shared<FileData>()).first;
+        }
+        return File(found->second, (mode & O_WRITE) != 0);
+    }
+
+    bool exists(const char *path) const
+    {
+        std::string name = normalize(path);
+        return this->files.count(name) > 0 || this->directories.count(name) > 0;
+    }
+
+    bool remove(const char *path) { return this->files.erase(normalize(path)) > 0; }
+
+    bool mkdir(const char *path) { return this->directories.insert(normalize(path)).second; }
+
+    std::uint64_t usedBytes() const
+    {
+        std::uint64_t total = 0;
+        for (const auto &file : this->files) {
+            total += file.second->bytes.size();
+        }
+        return total;
+    }
+
+    std::size_t fileCount() const { return this->files.size(); }
+
+    /** @brief Lädt alle Dateien unterhalb von directory (eine Verzeichnisebene wie auf der Karte). */
+    bool load(const char *directory, const std::string &prefix = "")
+    {
+        DIR *dir = opendir(directory);
+        if (dir == nullptr) {
+            return false;
+        }
+        while (dirent *entry = readdir(dir)) {
+            if (entry->d_name[0] == '.') {
+                continue;
+            }
+            std::string path = std::string(directory) + "/" + entry->d_name;
+            std::string name = prefix + entry->d_name;
+            struct stat info;
+            if (stat(path.c_str(), &info) != 0) {
+                continue;
+            }
+            if (S_ISDIR(info.st_mode)) {
+                this->directories.insert(name);
+                this->load(path.c_str(), name + "/");
+                continue;
+            }
+            FILE *file = std::fopen(path.c_str(), "rb");
+            if (file == nullptr) {
+                continue;
+            }
+            auto data = std::make_shared<FileData>();
+            data->bytes.resize(static_cast<std::size_t>(info.st_size));
+            std::size_t n = std::fread(data->bytes.data(), 1, data->bytes.size(), file);
+            data->bytes.resize(n);
+            std::fclose(file);
+            this->files[name] = data;
+        }
+        closedir(dir);
+        return true;
+    }
+
+    /** @brief Schreibt den Inhalt der Karte nach directory. */
+    bool save(const char *directory) const
+    {
+        ::mkdir(directory, 0755);
+        for (const std::string &name : this->directories) {
+            ::mkdir((std::string(directory) + "/" + name).c_str(), 0755);
+        }
+        bool ok = true;
+        for (const auto &file : this->files) {
+            FILE *out = std::fopen((std::string(directory) + "/" + file.first).c_str(), "wb");
+            if (out == nullptr) {
+                ok = false;
+                continue;
+            }
+            ok = std::fwrite(file.second->bytes.data(), 1, file.second->bytes.size(), out) == file.second->bytes.size() && ok;
+            ok = std::fclose(out) == 0 && ok;
+        }
+        return ok;
+    }
+};
+
+} // namespace sim
+
+#endif //SIM_STORAGE_HPP__
@@ -0,0 +1,103 @@
+/**
+ * @file sunflower.hpp
+ * @brief Zeichnet die Sonnenblume (Kopf mit Stimmung, Stiel und Blätter) in ein Display oder Sprite.
+ *
+ * Nur die Mundpartie (MoodX, MoodY, MoodWidth x MoodHeight) unterscheidet sich zwischen den
+ * Stimmungen; main.cpp rendert sie beim Start in je ein 4-Bit-Sprite und überträgt bei einem
+ * Stimmungswechsel nur diesen Ausschnitt.
+*/
+
+#ifndef SUNFLOWER_HPP__
+#define SUNFLOWER_HPP__
+
+#include <cstdint>
+#include "gfx_math.hpp"
+#include "plant_state.hpp"
+
+namespace sunflower {
+
+constexpr int CenterX = 160;    // horizontal zentriert
+constexpr int CenterY = 90;
+constexpr int FaceRadius = 50;  // Radius des Gesichts
+
+constexpr int MoodX = 132;
+constexpr int MoodY = 94;
+constexpr int MoodWidth = 56;
+constexpr int MoodHeight = 44;
+
+/**
+ * @brief Farben der Sonnenblume; RGB565 für das Display, Palettenindizes für 4-Bit-Sprites.
+ */
+struct Colors
+{
+    std::uint16_t petals;
+    std::uint16_t face;
+    std::uint16_t features;     // Augen und Mund
+};
+
+/**
+ * @brief Kopf (Blütenblätter, Gesicht, Augen, Mund); (originX, originY) ist die Lage des Ziels auf dem Bildschirm.
+ *
+ * @tparam Gfx Ziel mit fillCircle, fillRect und drawFastHLine, z.B. TFT_eSPI oder TFT_eSprite.
+ */
+template <typename Gfx>
+void drawHead(Gfx &target, int originX, int originY, plant::Mood mood, const Colors &colors)
+{
+    int centerX = CenterX - originX;
+    int centerY = CenterY - originY;
+
+    for (int angle = 0; angle < 360; angle += 30) {
+        int xOffset = gfx::mulQ15(gfx::cosQ15(angle), 60);
+        int yOffset = gfx::mulQ15(gfx::sinQ15(angle), 60);
+        target.fillCircle(centerX + xOffset, centerY + yOffset, 20, colors.petals);
+    }
+
+    //Gesicht
+    target.fillCircle(centerX, centerY, FaceRadius, colors.face);
+
+    //Augen
+    target.fillCircle(centerX - 25, centerY - 12, 6, colors.features); // Linkes Auge
+    target.fillCircle(centerX + 25, centerY - 12, 6, colors.features); // Rechtes Auge
+
+    //Mund
+    int mouthY = centerY + 20;
+    int mouthRadius = 25;
+    if (mood == plant::Mood::Happy) {
+        // Lachender Mund (oben gewölbt)
+        gfx::drawArcSpans(target, centerX, mouthY, mouthRadius, 180, 360, colors.features, 4);
+    } else if (mood == plant::Mood::Sad) {
+        // Trauriger Mund (unten gewölbt)
+        gfx::drawArcSpans(target, centerX, mouthY + 10, mouthRadius, 0, 180, colors.features, 4);
+    } else {
+        // Neutraler Mund (gerade Linie)
+        target.fillRect(centerX - 25, mouthY - 2, 50, 4, colors.features);
+    }
+}
+
+/**
+ * @brief Stiel und Blätter unter dem Kopf.
+ *
+ * @tparam Gfx Ziel mit fillRect und fillEllipse.
+ */
+template <typename Gfx>
+void drawStem(Gfx &target, std::uint16_t color)
+{
+    //Stiel
+    int stemWidth = 12;
+    int stemX = CenterX - stemWidth / 2;
+    int stemY = CenterY + FaceRadius;
+    int stemHeight = 100;
+    target.fillRect(stemX, stemY, stemWidth, stemHeight, color);
+
+    //Blätter
+    int leafCenterY = stemY + stemHeight / 2 + 10;
+    int leafOffsetX = 40;
+    int leafRadiusX = 30;
+    int leafRadiusY = 15;
+    target.fillEllipse(CenterX - leafOffsetX, leafCenterY, leafRadiusX, leafRadiusY, color); // Linkes Blatt
+    target.fillEllipse(CenterX + leafOffsetX, leafCenterY, leafRadiusX, leafRadiusY, color); // Rechtes Blatt
+}
+
+} // namespace sunflower
+
+#endif //SUNFLOWER_HPP__
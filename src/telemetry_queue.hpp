@@ -0,0 +1,217 @@
+/**
+ * @file telemetry_queue.hpp
+ * @brief Einträge der Telemetrie-Warteschlange (Messwerte und Ereignisse), RAM-Warteschlange und Rückfallebene.
+ *
+ * Alle Warteschlangen haben dieselbe Schnittstelle, die TelemetryUplink nutzt:
+ *  - push(entry): hinten anhängen
+ *  - peek(entries, max): die ältesten Einträge lesen, ohne sie zu entfernen
+ *  - consume(n): die ersten n gelesenen Einträge entfernen (nach erfolgreichem Publish)
+ *  - pending(): Anzahl wartender Einträge
+*/
+
+#ifndef TELEMETRY_QUEUE_HPP__
+#define TELEMETRY_QUEUE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "sample_log_format.hpp"
+
+namespace telemetry {
+
+enum class EntryType : std::uint8_t { Sample = 1, Event = 2 };
+
+constexpr std::size_t EventNameSize = 16;   // inklusive Nullterminator
+
+/**
+ * @brief Ein Eintrag der Warteschlange: Messwert oder Ereignis (z.B. Pumpe an/aus).
+ */
+struct Entry
+{
+    EntryType type = EntryType::Sample;
+    samplelog::Record sample = {};      // bei Ereignissen ist nur unixTime belegt
+    char event[EventNameSize] = {};     // Name des Ereignisses, nullterminiert
+    std::int32_t value = 0;             // Wert zum Ereignis
+};
+
+inline Entry sampleEntry(const samplelog::Record &record)
+{
+    Entry entry;
+    entry.type = EntryType::Sample;
+    entry.sample = record;
+    return entry;
+}
+
+inline Entry eventEntry(std::uint32_t unixTime, const char *name, std::int32_t value)
+{
+    Entry entry;
+    entry.type = EntryType::Event;
+    entry.sample.unixTime = unixTime;
+    std::strncpy(entry.event, name, EventNameSize - 1);
+    entry.value = value;
+    return entry;
+}
+
+/** @brief Größte Länge eines kodierten Eintrags in Byte. */
+constexpr std::size_t MaxEncodedSize = 1 + 4 + 4 + EventNameSize - 1;
+
+/**
+ * @brief Kodiert einen Eintrag kompakt (Little Endian): Typ, danach
+ *  - Messwert: Datensatz wie im Log (samplelog::RecordSize Byte)
+ *  - Ereignis: uint32 Unixzeit, int32 Wert, Name ohne Nullterminator
+ * @return Länge in Byte (höchstens MaxEncodedSize).
+ */
+inline std::size_t encode(const Entry &entry, std::uint8_t *out)
+{
+    out[0] = static_cast<std::uint8_t>(entry.type);
+    samplelog::put32(out + 1, entry.sample.unixTime);
+    if (entry.type == EntryType::Sample) {
+        samplelog::put16(out + 5, entry.sample.moisture);
+        samplelog::put16(out + 7, static_cast<std::uint16_t>(entry.sample.temperature));
+        samplelog::put16(out + 9, static_cast<std::uint16_t>(entry.sample.humidity));
+        return 1 + samplelog::RecordSize;
+    }
+    samplelog::put32(out + 5, static_cast<std::uint32_t>(entry.value));
+    std::size_t length = strnlen(entry.event, EventNameSize - 1);
+    std::memcpy(out + 9, entry.event, length);
+    return 9 + length;
+}
+
+/**
+ * @brief Gegenstück zu encode().
+ * @return false bei unbekanntem Typ oder unpassender Länge.
+ */
+inline bool decode(const std::uint8_t *data, std::size_t length, Entry &entry)
+{
+    entry = Entry();
+    if (length < 5) {
+        return false;
+    }
+    entry.sample.unixTime = samplelog::get32(data + 1);
+    switch (static_cast<EntryType>(data[0])) {
+    case EntryType::Sample:
+        if (length != 1 + samplelog::RecordSize) {
+            return false;
+        }
+        entry.type = EntryType::Sample;
+        entry.sample.moisture = samplelog::get16(data + 5);
+        entry.sample.temperature = static_cast<std::int16_t>(samplelog::get16(data + 7));
+        entry.sample.humidity = static_cast<std::int16_t>(samplelog::get16(data + 9));
+        return true;
+    case EntryType::Event:
+        if (length < 9 || length > MaxEncodedSize) {
+            return false;
+        }
+        entry.type = EntryType::Event;
+        entry.value = static_cast<std::int32_t>(samplelog::get32(data + 5));
+        std::memcpy(entry.event, data + 9, length - 9);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Ringpuffer im RAM; ist er voll, wird der älteste Eintrag verworfen.
+ */
+template <std::size_t Capacity>
+class RamQueue
+{
+private:
+    Entry entries[Capacity];
+    std::size_t head = 0;       // ältester Eintrag
+    std::size_t count = 0;
+    std::uint32_t droppedCount = 0;
+
+public:
+    /** @return false, wenn dafür ein älterer Eintrag verworfen wurde. */
+    bool push(const Entry &entry)
+    {
+        bool dropped = false;
+        if (this->count == Capacity) {
+            this->head = (this->head + 1) % Capacity;
+            this->count--;
+            this->droppedCount++;
+            dropped = true;
+        }
+        this->entries[(this->head + this->count) % Capacity] = entry;
+        this->count++;
+        return !dropped;
+    }
+
+    std::size_t peek(Entry *out, std::size_t max)
+    {
+        std::size_t n = this->count < max ? this->count : max;
+        for (std::size_t i = 0; i < n; i++) {
+            out[i] = this->entries[(this->head + i) % Capacity];
+        }
+        return n;
+    }
+
+    void consume(std::size_t n)
+    {
+        n = n < this->count ? n : this->count;
+        this->head = (this->head + n) % Capacity;
+        this->count -= n;
+    }
+
+    std::uint32_t pending() const { return static_cast<std::uint32_t>(this->count); }
+    std::uint32_t dropped() const { return this->droppedCount; }
+    std::size_t capacity() const { return Capacity; }
+};
+
+/**
+ * @brief Dauerhafte Warteschlange (z.B. SdQueue) mit RAM-Puffer, solange sie nicht verfügbar ist.
+ *
+ * Einträge aus Zeiten ohne SD-Karte werden zuerst gesendet; ein danach wieder lesbarer Rückstand
+ * auf der Karte folgt. Die Reihenfolge über beide Teile ist damit nur pro Teil zeitlich geordnet,
+ * jeder Eintrag trägt aber seinen eigenen Zeitstempel.
+ *
+ * @tparam PersistentT Warteschlange mit push/peek/consume/pending und isOpen().
+ */
+template <typename PersistentT, std::size_t RamCapacity>
+class FallbackQueue
+{
+private:
+    PersistentT &persistent;
+    RamQueue<RamCapacity> ram;
+    bool peekedRam = false;
+
+public:
+    explicit FallbackQueue(PersistentT &persistent) : persistent(persistent) {}
+
+    bool push(const Entry &entry)
+    {
+        if (this->persistent.isOpen() && this->persistent.push(entry)) {
+            return true;
+        }
+        return this->ram.push(entry);
+    }
+
+    std::size_t peek(Entry *out, std::size_t max)
+    {
+        this->peekedRam = this->ram.pending() > 0 || !this->persistent.isOpen();
+        return this->peekedRam ? this->ram.peek(out, max) : this->persistent.peek(out, max);
+    }
+
+    void consume(std::size_t n)
+    {
+        if (this->peekedRam) {
+            this->ram.consume(n);
+        } else {
+            this->persistent.consume(n);
+        }
+    }
+
+    std::uint32_t pending() const
+    {
+        return this->ram.pending() + (this->persistent.isOpen() ? this->persistent.pending() : 0);
+    }
+
+    /** @brief Im RAM wartende Einträge (SD-Karte nicht verfügbar). */
+    std::uint32_t pendingInRam() const { return this->ram.pending(); }
+    std::uint32_t droppedInRam() const { return this->ram.dropped(); }
+};
+
+} // namespace telemetry
+
+#endif //TELEMETRY_QUEUE_HPP__
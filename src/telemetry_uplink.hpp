@@ -0,0 +1,373 @@
+/**
+ * @file telemetry_uplink.hpp
+ * @brief Sendet Messwerte und Ereignisse gebündelt per MQTT an einen Azure IoT Hub.
+*/
+
+#ifndef TELEMETRY_UPLINK_HPP__
+#define TELEMETRY_UPLINK_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <azure/az_core.h>
+#include <azure/az_iot.h>
+#include "sample_log_format.hpp"
+#include "telemetry_queue.hpp"
+
+/**
+ * @brief Nicht blockierender Telemetrie-Uplink (bis auf den Verbindungsaufbau selbst).
+ *
+ * Die Einträge kommen aus einer Warteschlange (telemetry_queue.hpp, z.B. SdQueue) und werden als
+ * ein JSON-Dokument pro Publish gesendet:
+ *   {"fields":["ts","moisture","temp_dC","hum_dpct"],"rows":[[1700000000,312,215,401],...],
+ *    "events":[["pump_on",1700000000,12],...]}
+ * Dadurch verteilen sich Topic, MQTT-Header und TLS-Record auf mehrere Einträge. Erst nach einem
+ * erfolgreichen Publish werden die Einträge aus der Warteschlange entfernt. Ohne Netz wird nur
+ * gesammelt; kommt das Netz zurück, wird der Rückstand in großen Batches (bis MaxBatch) abgebaut,
+ * höchstens ein Publish pro replayInterval, damit Broker-Drosselung und Hauptschleife verschont bleiben.
+ *
+ * Das SAS-Token läuft relativ zur übergebenen UTC-Zeit ab. Solange die Uhr noch nicht gestellt ist
+ * (vor MinPlausibleTime, z.B. 0 ohne RTC und NTP), wird deshalb nicht verbunden; ein Token mit
+ * Ablauf 1970 würde vom Hub abgelehnt und beim nächsten poll() wieder getrennt.
+ *
+ * @tparam MqttT MQTT-Client mit der Schnittstelle von PubSubClient (connect, connected, publish, loop).
+ * @tparam QueueT Warteschlange mit peek(entries, max), consume(n) und pending().
+ */
+template <typename MqttT, typename QueueT>
+class TelemetryUplink
+{
+public:
+    enum class State : std::uint8_t { Offline, Online, Backoff };
+
+    /**
+     * @brief Erzeugt das MQTT-Passwort (SAS-Token) für den Client, gültig bis expiry (Unixzeit).
+     */
+    typedef bool (*PasswordFunction)(const az_iot_hub_client *client, std::uint64_t expiry, char *password,
+                                     std::size_t size);
+
+    static constexpr std::size_t MaxBatch = 48;
+    /** @brief Frühere Zeiten stammen von einer nicht gestellten Uhr (1.1.2024 00:00 UTC). */
+    static constexpr std::uint64_t MinPlausibleTime = 1704067200ULL;
+    static constexpr std::size_t PayloadCapacity = 96 + MaxBatch * 48;   // auch für lauter Ereignisse mit langem Namen
+
+    struct Stats
+    {
+        std::uint32_t connects = 0;
+        std::uint32_t failedConnects = 0;
+        std::uint32_t publishes = 0;
+        std::uint32_t failedPublishes = 0;
+        std::uint32_t samplesSent = 0;
+        std::uint32_t eventsSent = 0;
+        std::uint32_t replayPublishes = 0;  // Publishes beim Abbau eines Rückstands
+        std::uint32_t replayTime = 0;       // Dauer der Rückstandsabbauten in ms
+        std::uint32_t replayEntries = 0;    // dabei gesendete Einträge
+        std::uint64_t bytesSent = 0;        // Topic + Payload
+    };
+
+private:
+    MqttT &mqtt;
+    QueueT &queue;
+    PasswordFunction password;
+    std::size_t batchSize;
+    unsigned long maxBatchAge;
+    unsigned long replayInterval;
+    unsigned long tokenLifetime;
+
+    az_iot_hub_client client;
+    char clientId[128] = {};
+    char userName[192] = {};
+    char topic[128] = {};
+    char payload[PayloadCapacity];
+    bool initialized = false;
+
+    telemetry::Entry batch[MaxBatch];
+    unsigned long batchStarted = 0;     // seit dann wartet mindestens ein Eintrag
+    unsigned long lastPublish = 0;
+    bool replaying = false;
+    unsigned long replayStarted = 0;
+
+    State current = State::Offline;
+    unsigned long stateSince = 0;
+    unsigned long backoff = 0;
+    unsigned long initialBackoff;
+    unsigned long maxBackoff;
+    std::uint64_t tokenExpiry = 0;
+    unsigned long startedAt = 0;
+    Stats statistics;
+
+    void enter(State state, unsigned long now)
+    {
+        this->current = state;
+        this->stateSince = now;
+    }
+
+    void fail(unsigned long now)
+    {
+        this->backoff = this->backoff * 2 < this->maxBackoff ? this->backoff * 2 : this->maxBackoff;
+        this->enter(State::Backoff, now);
+    }
+
+    bool connect(unsigned long now, std::uint64_t unixTime)
+    {
+        char token[256];
+        std::uint64_t expiry = unixTime + this->tokenLifetime;
+        if (!this->password(&this->client, expiry, token, sizeof(token))) {
+            return false;
+        }
+        if (!this->mqtt.connect(this->clientId, this->userName, token)) {
+            return false;
+        }
+        this->tokenExpiry = expiry;
+        this->backoff = this->initialBackoff;
+        this->statistics.connects++;
+        this->enter(State::Online, now);
+        return true;
+    }
+
+    /**
+     * @brief Schreibt die ersten n Einträge aus batch als JSON in payload.
+     * @return Länge in Bytes oder 0, wenn der Puffer nicht reicht.
+     */
+    std::size_t buildPayload(std::size_t n)
+    {
+        az_json_writer writer;
+        if (az_result_failed(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(this->payload), nullptr))
+            || az_result_failed(az_json_writer_append_begin_object(&writer))
+            || az_result_failed(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("fields")))
+            || az_result_failed(az_json_writer_append_begin_array(&writer))
+            || az_result_failed(az_json_writer_append_string(&writer, AZ_SPAN_FROM_STR("ts")))
+            || az_result_failed(az_json_writer_append_string(&writer, AZ_SPAN_FROM_STR("moisture")))
+            || az_result_failed(az_json_writer_append_string(&writer, AZ_SPAN_FROM_STR("temp_dC")))
+            || az_result_failed(az_json_writer_append_string(&writer, AZ_SPAN_FROM_STR("hum_dpct")))
+            || az_result_failed(az_json_writer_append_end_array(&writer))
+            || az_result_failed(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("rows")))
+            || az_result_failed(az_json_writer_append_begin_array(&writer))) {
+            return 0;
+        }
+        std::size_t events = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            const telemetry::Entry &entry = this->batch[i];
+            if (entry.type != telemetry::EntryType::Sample) {
+                events++;
+                continue;
+            }
+            // Zeitstempel als int32 reicht bis 2038, wie die RTC-Zeit im Log
+            const samplelog::Record &record = entry.sample;
+            if (az_result_failed(az_json_writer_append_begin_array(&writer))
+                || az_result_failed(az_json_writer_append_int32(&writer, static_cast<std::int32_t>(record.unixTime)))
+                || az_result_failed(az_json_writer_append_int32(&writer, record.moisture))
+                || az_result_failed(az_json_writer_append_int32(&writer, record.temperature))
+                || az_result_failed(az_json_writer_append_int32(&writer, record.humidity))
+                || az_result_failed(az_json_writer_append_end_array(&writer))) {
+                return 0;
+            }
+        }
+        if (az_result_failed(az_json_writer_append_end_array(&writer))) {
+            return 0;
+        }
+        if (events > 0) {
+            if (az_result_failed(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("events")))
+                || az_result_failed(az_json_writer_append_begin_array(&writer))) {
+                return 0;
+            }
+            for (std::size_t i = 0; i < n; i++) {
+                const telemetry::Entry &entry = this->batch[i];
+                if (entry.type != telemetry::EntryType::Event) {
+                    continue;
+                }
+                if (az_result_failed(az_json_writer_append_begin_array(&writer))
+                    || az_result_failed(az_json_writer_append_string(&writer, az_span_create_from_str(const_cast<char *>(entry.event))))
+                    || az_result_failed(az_json_writer_append_int32(&writer, static_cast<std::int32_t>(entry.sample.unixTime)))
+                    || az_result_failed(az_json_writer_append_int32(&writer, entry.value))
+                    || az_result_failed(az_json_writer_append_end_array(&writer))) {
+                    return 0;
+                }
+            }
+            if (az_result_failed(az_json_writer_append_end_array(&writer))) {
+                return 0;
+            }
+        }
+        if (az_result_failed(az_json_writer_append_end_object(&writer))) {
+            return 0;
+        }
+        return static_cast<std::size_t>(az_span_size(az_json_writer_get_bytes_used_in_destination(&writer)));
+    }
+
+    bool batchReady(unsigned long now, std::uint32_t pending) const
+    {
+        return pending >= this->batchSize || (pending > 0 && now - this->batchStarted >= this->maxBatchAge);
+    }
+
+    void publishBatch(unsigned long now, std::uint32_t pending)
+    {
+        // Rückstand: große Batches, aber höchstens einer pro replayInterval
+        bool backlog = pending > this->batchSize;
+        if (backlog && this->statistics.publishes > 0 && now - this->lastPublish < this->replayInterval) {
+            return;
+        }
+        if (backlog && !this->replaying) {
+            this->replaying = true;
+            this->replayStarted = now;
+        }
+        std::size_t n = this->queue.peek(this->batch, backlog ? MaxBatch : this->batchSize);
+        if (n == 0) {
+            return;
+        }
+        std::size_t length = this->buildPayload(n);
+        size_t topicLength = 0;
+        if (length == 0
+            || az_result_failed(az_iot_hub_client_telemetry_get_publish_topic(&this->client, nullptr, this->topic,
+                                                                              sizeof(this->topic), &topicLength))) {
+            this->statistics.failedPublishes++;
+            return;
+        }
+        if (!this->mqtt.publish(this->topic, reinterpret_cast<const std::uint8_t *>(this->payload),
+                                static_cast<unsigned int>(length))) {
+            this->statistics.failedPublishes++;
+            this->fail(now);
+            return;
+        }
+        this->queue.consume(n);
+        this->lastPublish = now;
+        this->batchStarted = now;
+        this->statistics.publishes++;
+        for (std::size_t i = 0; i < n; i++) {
+            if (this->batch[i].type == telemetry::EntryType::Sample) {
+                this->statistics.samplesSent++;
+            } else {
+                this->statistics.eventsSent++;
+            }
+        }
+        this->statistics.bytesSent += topicLength + length;
+        if (this->replaying) {
+            this->statistics.replayPublishes++;
+            this->statistics.replayEntries += n;
+            if (this->queue.pending() <= this->batchSize) {
+                // Dauer inklusive des Intervalls, das dem letzten Batch zusteht
+                this->statistics.replayTime += now - this->replayStarted + this->replayInterval;
+                this->replaying = false;
+            }
+        }
+    }
+
+public:
+    /**
+     * @param [in] queue Warteschlange, aus der gesendet wird.
+     * @param [in] password Funktion, die das SAS-Token erzeugt.
+     * @param [in] batchSize Einträge pro Publish im Normalbetrieb (höchstens MaxBatch).
+     * @param [in] maxBatchAge spätestens nach dieser Zeit in ms wird auch ein unvollständiger Batch gesendet.
+     * @param [in] replayInterval Mindestabstand der Publishes beim Abbau eines Rückstands in ms.
+     * @param [in] tokenLifetime Gültigkeit des SAS-Tokens in s; danach wird neu verbunden.
+     */
+    TelemetryUplink(MqttT &mqtt, QueueT &queue, PasswordFunction password, std::size_t batchSize = 10,
+                    unsigned long maxBatchAge = 60000, unsigned long replayInterval = 2000,
+                    unsigned long tokenLifetime = 3600, unsigned long initialBackoff = 5000,
+                    unsigned long maxBackoff = 300000)
+        : mqtt(mqtt), queue(queue), password(password), batchSize(batchSize < MaxBatch ? batchSize : MaxBatch),
+          maxBatchAge(maxBatchAge), replayInterval(replayInterval), tokenLifetime(tokenLifetime),
+          initialBackoff(initialBackoff), maxBackoff(maxBackoff)
+    {
+        this->backoff = initialBackoff;
+    }
+
+    /**
+     * @brief Initialisiert den IoT-Hub-Client und erzeugt Client-ID und Benutzername.
+     * @param [in] host Hostname des IoT Hubs (xxx.azure-devices.net), muss dauerhaft gültig sein.
+     * @param [in] deviceId Geräte-ID, muss dauerhaft gültig sein.
+     */
+    bool begin(const char *host, const char *deviceId, unsigned long now)
+    {
+        this->startedAt = now;
+        this->initialized =
+            az_result_succeeded(az_iot_hub_client_init(&this->client, az_span_create_from_str(const_cast<char *>(host)),
+                                                       az_span_create_from_str(const_cast<char *>(deviceId)), nullptr))
+            && az_result_succeeded(az_iot_hub_client_get_client_id(&this->client, this->clientId,
+                                                                   sizeof(this->clientId), nullptr))
+            && az_result_succeeded(az_iot_hub_client_get_user_name(&this->client, this->userName,
+                                                                   sizeof(this->userName), nullptr));
+        return this->initialized;
+    }
+
+    /**
+     * @brief Schaltet den Uplink weiter; zyklisch aufrufen (z.B. jede Sekunde).
+     * @param [in] unixTime aktuelle UTC-Zeit in s, für die Gültigkeit des SAS-Tokens; 0, solange unbekannt.
+     * @param [in] networkUp true, wenn WLAN verbunden ist.
+     */
+    State poll(unsigned long now, std::uint64_t unixTime, bool networkUp)
+    {
+        if (!this->initialized) {
+            return this->current;
+        }
+        std::uint32_t pending = this->queue.pending();
+        if (pending == 0) {
+            this->batchStarted = now;
+        }
+        if (!networkUp) {
+            if (this->current == State::Online) {
+                this->mqtt.disconnect();
+            }
+            this->enter(State::Offline, now);
+            return this->current;
+        }
+
+        if (this->current != State::Online && unixTime < MinPlausibleTime) {
+            return this->current;   // auf NTP warten, zählt nicht als Fehlversuch
+        }
+
+        switch (this->current) {
+        case State::Offline:
+            if (!this->connect(now, unixTime)) {
+                this->statistics.failedConnects++;
+                this->fail(now);
+            }
+            break;
+        case State::Backoff:
+            if (now - this->stateSince >= this->backoff && !this->connect(now, unixTime)) {
+                this->statistics.failedConnects++;
+                this->fail(now);
+            }
+            break;
+        case State::Online:
+            this->mqtt.loop();
+            if (!this->mqtt.connected()) {
+                this->fail(now);
+                break;
+            }
+            if (unixTime + 60 >= this->tokenExpiry) {
+                // Token läuft ab: kurz vorher selbst neu verbinden statt auf die Trennung zu warten
+                this->mqtt.disconnect();
+                this->enter(State::Offline, now);
+                break;
+            }
+            if (this->batchReady(now, pending)) {
+                this->publishBatch(now, pending);
+            }
+            break;
+        }
+        return this->current;
+    }
+
+    State state() const { return this->current; }
+    std::uint32_t queued() const { return this->queue.pending(); }
+    const Stats &stats() const { return this->statistics; }
+
+    /** @brief Publishes pro Stunde seit begin(). */
+    std::uint32_t publishesPerHour(unsigned long now) const
+    {
+        unsigned long elapsed = now - this->startedAt;
+        return elapsed ? static_cast<std::uint32_t>(static_cast<std::uint64_t>(this->statistics.publishes) * 3600000UL / elapsed) : 0;
+    }
+
+    /** @brief Gesendete Bytes (Topic + Payload) pro Messwert. */
+    std::uint32_t bytesPerSample() const
+    {
+        return this->statistics.samplesSent ? static_cast<std::uint32_t>(this->statistics.bytesSent / this->statistics.samplesSent) : 0;
+    }
+
+    /** @brief Beim Abbau von Rückständen gesendete Einträge pro Minute. */
+    std::uint32_t replayPerMinute() const
+    {
+        return this->statistics.replayTime ? static_cast<std::uint32_t>(static_cast<std::uint64_t>(this->statistics.replayEntries) * 60000UL / this->statistics.replayTime) : 0;
+    }
+};
+
+#endif //TELEMETRY_UPLINK_HPP__
@@ -0,0 +1,67 @@
+/**
+ * @file watchdog.hpp
+ * @brief Hardware-Watchdog (WDT) des SAMD51.
+*/
+
+#ifndef WATCHDOG_HPP__
+#define WATCHDOG_HPP__
+
+#include <cstdint>
+
+/**
+ * @brief Setzt den Controller zurück, wenn feed() nicht rechtzeitig aufgerufen wird.
+ *
+ * Der WDT läuft mit dem 1,024-kHz-Takt des OSCULP32K; die Periode wird als Zweierpotenz der
+ * Taktzyklen eingestellt (8 bis 16384 Zyklen, ca. 8 ms bis 16 s).
+ */
+class Watchdog
+{
+private:
+    bool running = false;
+
+public:
+    /**
+     * @brief Startet den Watchdog.
+     * @param [in] timeoutMs gewünschte Zeit bis zum Reset, wird auf die nächste mögliche Periode aufgerundet.
+     * @return tatsächliche Periode in ms.
+     */
+    std::uint32_t begin(std::uint32_t timeoutMs)
+    {
+        std::uint8_t period = 0;    // PER = 0 entspricht 8 Zyklen
+        std::uint32_t cycles = 8;
+        while (cycles * 1000u / 1024u < timeoutMs && period < 11) {
+            cycles <<= 1;
+            period++;
+        }
+
+        WDT->CTRLA.reg = 0;         // für die Konfiguration abschalten
+        while (WDT->SYNCBUSY.reg);
+        WDT->CONFIG.reg = period;   // PER, kein Fenster
+        WDT->EWCTRL.reg = 0;        // keine Frühwarnung
+        WDT->CTRLA.reg = 1u << 1;   // ENABLE
+        while (WDT->SYNCBUSY.reg);
+        this->running = true;
+        return cycles * 1000u / 1024u;
+    }
+
+    /**
+     * @brief Setzt den Zähler zurück.
+     */
+    void feed()
+    {
+        if (!this->running) {
+            return;
+        }
+        WDT->CLEAR.reg = 0xA5;      // CLEAR-Key
+        while (WDT->SYNCBUSY.reg);
+    }
+
+    bool isRunning() const { return this->running; }
+
+    /**
+     * @brief true, wenn der letzte Reset vom Watchdog ausgelöst wurde.
+     */
+    static bool causedLastReset() { return (RSTC->RCAUSE.reg & (1u << 5)) != 0; }  // RCAUSE.WDT
+};
+
+#endif //WATCHDOG_HPP__
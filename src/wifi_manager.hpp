@@ -0,0 +1,263 @@
+/**
+ * @file wifi_manager.hpp
+ * @brief Verwaltet die WLAN-Verbindung im Hintergrund: Verbindungsaufbau ohne Warten, Backoff mit Jitter, Statistik.
+*/
+
+#ifndef WIFI_MANAGER_HPP__
+#define WIFI_MANAGER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Einziger Besitzer der WLAN-Verbindung.
+ *
+ * Nutzer melden ihren Bedarf mit acquire() an und mit release() wieder ab; solange niemand die
+ * Verbindung braucht, ist das WLAN ausgeschaltet. poll() wird zyklisch vom Scheduler aufgerufen
+ * und wartet nie: WiFi.begin() startet den Verbindungsaufbau, danach wird nur der Status abgefragt.
+ * Gelingt die Verbindung nicht innerhalb von connectTimeout oder bricht sie ab, wird nach einer
+ * exponentiell wachsenden Pause erneut verbunden. Die Pause liegt zufällig zwischen der Hälfte und
+ * dem vollen Wert, damit mehrere Geräte nach einem Ausfall des Access Points nicht gleichzeitig
+ * verbinden. Verbindungsereignisse werden an die Abonnenten verteilt (z.B. NTP und Uplink).
+ *
+ * @tparam WiFiT WLAN-Schnittstelle mit begin(ssid, password), status(), disconnect(wifiOff) und RSSI(),
+ *               z.B. WiFiClass aus rpcWiFi.h.
+ * @tparam ConnectedStatus Rückgabewert von status() bei bestehender Verbindung (WL_CONNECTED).
+ */
+template <typename WiFiT, int ConnectedStatus>
+class WiFiManager
+{
+public:
+    enum class State : std::uint8_t { Off, Connecting, Connected, Backoff };
+    enum class Event : std::uint8_t { Connected, Disconnected, ConnectFailed };
+    typedef void (*EventHandler)(Event event, unsigned long now);
+    static constexpr std::size_t MaxSubscribers = 4;
+
+    struct Stats
+    {
+        std::uint32_t attempts = 0;
+        std::uint32_t connects = 0;
+        std::uint32_t failures = 0;         // Zeitüberschreitung beim Verbinden
+        std::uint32_t drops = 0;            // Verbindung abgebrochen
+        unsigned long lastConnectTime = 0;  // Dauer des letzten erfolgreichen Verbindungsaufbaus in ms
+        std::uint64_t connectedTime = 0;    // Summe der Verbindungsdauer in ms (ohne laufende Verbindung)
+        std::int8_t rssi = 0;               // letzter Wert in dBm
+        std::int8_t rssiMin = 0;
+        std::int8_t rssiMax = -128;
+        std::int32_t rssiSum = 0;
+        std::uint32_t rssiSamples = 0;
+    };
+
+private:
+    WiFiT &wifi;
+    const char *ssid;
+    const char *password;
+    unsigned long connectTimeout;
+    unsigned long initialBackoff;
+    unsigned long maxBackoff;
+    unsigned long rssiInterval;
+
+    State current = State::Off;
+    unsigned long stateSince = 0;
+    unsigned long backoff;
+    unsigned long backoffDelay = 0;
+    unsigned long lastRssi = 0;
+    unsigned long startedAt = 0;
+    std::uint32_t random;
+    std::uint8_t users = 0;
+    EventHandler subscribers[MaxSubscribers] = {};
+    std::size_t subscriberCount = 0;
+    Stats statistics;
+
+    void enter(State state, unsigned long now)
+    {
+        this->current = state;
+        this->stateSince = now;
+    }
+
+    void publish(Event event, unsigned long now)
+    {
+        for (std::size_t i = 0; i < this->subscriberCount; i++) {
+            this->subscribers[i](event, now);
+        }
+    }
+
+    /** @brief xorshift32, reicht für den Jitter. */
+    std::uint32_t nextRandom()
+    {
+        this->random ^= this->random << 13;
+        this->random ^= this->random >> 17;
+        this->random ^= this->random << 5;
+        return this->random;
+    }
+
+    void connect(unsigned long now)
+    {
+        this->statistics.attempts++;
+        this->wifi.begin(this->ssid, this->password);
+        this->enter(State::Connecting, now);
+    }
+
+    /**
+     * @brief Wartet vor dem nächsten Versuch backoff/2 bis backoff und verdoppelt backoff.
+     */
+    void retryLater(unsigned long now)
+    {
+        this->backoffDelay = this->backoff / 2 + this->nextRandom() % (this->backoff / 2 + 1);
+        this->backoff = this->backoff * 2 < this->maxBackoff ? this->backoff * 2 : this->maxBackoff;
+        this->enter(State::Backoff, now);
+    }
+
+    void sampleRssi(unsigned long now)
+    {
+        std::int8_t rssi = static_cast<std::int8_t>(this->wifi.RSSI());
+        this->lastRssi = now;
+        this->statistics.rssi = rssi;
+        this->statistics.rssiMin = rssi < this->statistics.rssiMin ? rssi : this->statistics.rssiMin;
+        this->statistics.rssiMax = rssi > this->statistics.rssiMax ? rssi : this->statistics.rssiMax;
+        this->statistics.rssiSum += rssi;
+        this->statistics.rssiSamples++;
+    }
+
+    void disconnected(unsigned long now)
+    {
+        this->statistics.connectedTime += now - this->stateSince;
+        this->publish(Event::Disconnected, now);
+    }
+
+public:
+    /**
+     * @param [in] ssid, password Zugangsdaten, müssen dauerhaft gültig sein.
+     * @param [in] connectTimeout längste Dauer eines Verbindungsversuchs in ms.
+     * @param [in] initialBackoff Pause nach dem ersten Fehlschlag in ms; verdoppelt sich bis maxBackoff.
+     * @param [in] rssiInterval Abstand der RSSI-Messungen bei bestehender Verbindung in ms.
+     */
+    WiFiManager(WiFiT &wifi, const char *ssid, const char *password, unsigned long connectTimeout = 15000,
+                unsigned long initialBackoff = 5000, unsigned long maxBackoff = 300000,
+                unsigned long rssiInterval = 10000)
+        : wifi(wifi), ssid(ssid), password(password), connectTimeout(connectTimeout),
+          initialBackoff(initialBackoff), maxBackoff(maxBackoff), rssiInterval(rssiInterval),
+          backoff(initialBackoff), random(1)
+    {
+    }
+
+    /**
+     * @brief Registriert einen Abonnenten für Verbindungsereignisse.
+     * @return false, wenn bereits MaxSubscribers registriert sind.
+     */
+    bool subscribe(EventHandler handler)
+    {
+        if (this->subscriberCount >= MaxSubscribers) {
+            return false;
+        }
+        this->subscribers[this->subscriberCount++] = handler;
+        return true;
+    }
+
+    /**
+     * @param [in] seed Startwert für den Jitter, z.B. micros() beim Start.
+     */
+    void begin(unsigned long now, std::uint32_t seed)
+    {
+        this->startedAt = now;
+        this->random = seed ? seed : 1;
+    }
+
+    /** @brief Meldet Bedarf an der Verbindung an; der Aufbau beginnt beim nächsten poll(). */
+    void acquire() { this->users++; }
+
+    /** @brief Meldet Bedarf ab; ohne weitere Nutzer wird das WLAN beim nächsten poll() ausgeschaltet. */
+    void release()
+    {
+        if (this->users > 0) {
+            this->users--;
+        }
+    }
+
+    /**
+     * @brief Schaltet den Zustand weiter; zyklisch aufrufen (z.B. alle 500 ms), blockiert nicht.
+     */
+    State poll(unsigned long now)
+    {
+        bool linkUp = this->current != State::Off && this->wifi.status() == ConnectedStatus;
+
+        if (this->users == 0) {
+            if (this->current != State::Off) {
+                if (this->current == State::Connected) {
+                    this->disconnected(now);
+                }
+                this->wifi.disconnect(true);
+                this->backoff = this->initialBackoff;
+                this->enter(State::Off, now);
+            }
+            return this->current;
+        }
+
+        switch (this->current) {
+        case State::Off:
+            this->connect(now);
+            break;
+        case State::Connecting:
+            if (linkUp) {
+                this->statistics.connects++;
+                this->statistics.lastConnectTime = now - this->stateSince;
+                this->backoff = this->initialBackoff;
+                this->enter(State::Connected, now);
+                this->sampleRssi(now);
+                this->publish(Event::Connected, now);
+            } else if (now - this->stateSince >= this->connectTimeout) {
+                this->statistics.failures++;
+                this->wifi.disconnect(false);
+                this->retryLater(now);
+                this->publish(Event::ConnectFailed, now);
+            }
+            break;
+        case State::Connected:
+            if (!linkUp) {
+                this->statistics.drops++;
+                this->disconnected(now);
+                // Erster Versuch nach einem Abbruch sofort, danach mit Backoff
+                this->connect(now);
+                break;
+            }
+            if (now - this->lastRssi >= this->rssiInterval) {
+                this->sampleRssi(now);
+            }
+            break;
+        case State::Backoff:
+            if (now - this->stateSince >= this->backoffDelay) {
+                this->connect(now);
+            }
+            break;
+        }
+        return this->current;
+    }
+
+    State state() const { return this->current; }
+    bool isConnected() const { return this->current == State::Connected; }
+    const Stats &stats() const { return this->statistics; }
+
+    /** @brief Dauer der bestehenden Verbindung in ms (0 ohne Verbindung). */
+    unsigned long connectedFor(unsigned long now) const
+    {
+        return this->current == State::Connected ? now - this->stateSince : 0;
+    }
+
+    /** @brief Anteil der Zeit seit begin() mit Verbindung in Promille. */
+    std::uint32_t availability(unsigned long now) const
+    {
+        unsigned long elapsed = now - this->startedAt;
+        std::uint64_t connected = this->statistics.connectedTime + this->connectedFor(now);
+        return elapsed ? static_cast<std::uint32_t>(connected * 1000 / elapsed) : 0;
+    }
+
+    /** @brief Mittlerer RSSI in dBm. */
+    std::int8_t averageRssi() const
+    {
+        return this->statistics.rssiSamples
+             ? static_cast<std::int8_t>(this->statistics.rssiSum / static_cast<std::int32_t>(this->statistics.rssiSamples))
+             : 0;
+    }
+};
+
+#endif //WIFI_MANAGER_HPP__
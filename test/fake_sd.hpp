@@ -0,0 +1,235 @@
+/**
+ * @file fake_sd.hpp
+ * @brief Testdoppel für SD.h: Dateisystem im RAM mit Zählern für Schreibzugriffe und Stromausfall auf Abruf.
+ *
+ * Schnittstelle wie SDClass und File, soweit SdLogger und SdQueue sie nutzen. Ein Stromausfall wird mit
+ * einem Byte-Budget nachgebildet: ist es aufgebraucht, bricht der laufende write() nach den restlichen
+ * Bytes ab (torn write) und alle weiteren Schreibzugriffe schlagen fehl, bis restorePower() aufgerufen wird.
+*/
+
+#ifndef FAKE_SD_HPP__
+#define FAKE_SD_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#ifndef O_READ
+#define O_READ 0x01
+#endif
+#ifndef O_WRITE
+#define O_WRITE 0x02
+#endif
+#ifndef O_CREAT
+#define O_CREAT 0x40
+#endif
+
+namespace fake {
+
+/**
+ * @brief Zähler über alle Dateien einer Karte.
+ */
+struct SdCounters
+{
+    std::uint32_t opens = 0;
+    std::uint32_t closes = 0;
+    std::uint32_t writeCalls = 0;
+    std::uint64_t bytesWritten = 0;
+    std::uint32_t flushes = 0;
+    std::uint32_t unalignedWrites = 0;  // Schreibzugriffe, die nicht genau einen 512-Byte-Sektor treffen
+    std::uint32_t failedWrites = 0;
+};
+
+struct SdState
+{
+    std::map<std::string, std::vector<std::uint8_t>> files;
+    std::set<std::string> directories;
+    SdCounters counters;
+    std::int64_t powerBudget = -1;      // verbleibende Bytes bis zum Stromausfall, -1 = unbegrenzt
+    bool writesFail = false;            // Karte defekt: jeder write() schlägt fehl
+};
+
+class File
+{
+private:
+    std::shared_ptr<SdState> state;
+    std::string name;
+    std::uint32_t offset = 0;
+    bool writable = false;
+    bool isOpen = false;
+
+    std::vector<std::uint8_t> *bytes() const
+    {
+        auto found = this->state->files.find(this->name);
+        return found != this->state->files.end() ? &found->second : nullptr;
+    }
+
+public:
+    File() = default;
+    File(std::shared_ptr<SdState> state, std::string name, bool writable)
+        : state(std::move(state)), name(std::move(name)), writable(writable), isOpen(true)
+    {
+    }
+
+    int read(void *buffer, std::size_t length)
+    {
+        std::vector<std::uint8_t> *data = this->isOpen ? this->bytes() : nullptr;
+        if (data == nullptr) {
+            return -1;
+        }
+        std::size_t available = this->offset < data->size() ? data->size() - this->offset : 0;
+        std::size_t n = available < length ? available : length;
+        std::memcpy(buffer, data->data() + this->offset, n);
+        this->offset += static_cast<std::uint32_t>(n);
+        return static_cast<int>(n);
+    }
+
+    std::size_t write(const std::uint8_t *buffer, std::size_t length)
+    {
+        std::vector<std::uint8_t> *data = this->isOpen && this->writable ? this->bytes() : nullptr;
+        if (data == nullptr) {
+            return 0;
+        }
+        SdState &card = *this->state;
+        card.counters.writeCalls++;
+        if (length != 512 || this->offset % 512 != 0) {
+            card.counters.unalignedWrites++;
+        }
+        std::size_t n = length;
+        if (card.writesFail || card.powerBudget == 0) {
+            n = 0;
+        } else if (card.powerBudget > 0 && static_cast<std::int64_t>(n) > card.powerBudget) {
+            n = static_cast<std::size_t>(card.powerBudget);
+        }
+        if (card.powerBudget > 0) {
+            card.powerBudget -= static_cast<std::int64_t>(n);
+        }
+        if (this->offset + n > data->size()) {
+            data->resize(this->offset + n);
+        }
+        std::memcpy(data->data() + this->offset, buffer, n);
+        this->offset += static_cast<std::uint32_t>(n);
+        card.counters.bytesWritten += n;
+        if (n != length) {
+            card.counters.failedWrites++;
+        }
+        return n;
+    }
+
+    bool seek(std::uint32_t position)
+    {
+        std::vector<std::uint8_t> *data = this->isOpen ? this->bytes() : nullptr;
+        if (data == nullptr || position > data->size()) {
+            return false;
+        }
+        this->offset = position;
+        return true;
+    }
+
+    std::uint32_t position() const { return this->offset; }
+
+    std::uint32_t size() const
+    {
+        std::vector<std::uint8_t> *data = this->isOpen ? this->bytes() : nullptr;
+        return data != nullptr ? static_cast<std::uint32_t>(data->size()) : 0;
+    }
+
+    void flush()
+    {
+        if (this->isOpen) {
+            this->state->counters.flushes++;
+        }
+    }
+
+    void close()
+    {
+        if (this->isOpen) {
+            this->state->counters.closes++;
+        }
+        this->isOpen = false;
+    }
+
+    explicit operator bool() const { return this->isOpen && this->bytes() != nullptr; }
+};
+
+/**
+ * @brief Karte; Kopien teilen sich den Inhalt, ein "Neustart" legt einfach neue Objekte auf derselben Karte an.
+ */
+class Sd
+{
+private:
+    std::shared_ptr<SdState> state = std::make_shared<SdState>();
+
+    static std::string normalize(const char *path)
+    {
+        while (*path == '/') {
+            path++;
+        }
+        return path;
+    }
+
+public:
+    File open(const char *path, std::uint8_t mode = O_READ)
+    {
+        std::string name = normalize(path);
+        if (this->state->files.count(name) == 0) {
+            if (!(mode & O_CREAT) || this->state->directories.count(name) || this->state->powerBudget == 0) {
+                return File();
+            }
+            this->state->files[name];
+        }
+        this->state->counters.opens++;
+        return File(this->state, name, (mode & O_WRITE) != 0);
+    }
+
+    bool exists(const char *path) const
+    {
+        std::string name = normalize(path);
+        return this->state->files.count(name) > 0 || this->state->directories.count(name) > 0;
+    }
+
+    bool remove(const char *path)
+    {
+        if (this->state->powerBudget == 0) {
+            return false;
+        }
+        return this->state->files.erase(normalize(path)) > 0;
+    }
+
+    bool mkdir(const char *path) { return this->state->directories.insert(normalize(path)).second; }
+
+    /** @brief Stromausfall nach bytes weiteren geschriebenen Bytes. */
+    void cutPowerAfter(std::int64_t bytes) { this->state->powerBudget = bytes; }
+    void restorePower() { this->state->powerBudget = -1; }
+    void setWritesFail(bool fail) { this->state->writesFail = fail; }
+
+    SdCounters &counters() { return this->state->counters; }
+    void resetCounters() { this->state->counters = SdCounters(); }
+
+    /** @brief Inhalt einer Datei (leer, wenn sie nicht existiert). */
+    std::vector<std::uint8_t> contents(const char *path) const
+    {
+        auto found = this->state->files.find(normalize(path));
+        return found != this->state->files.end() ? found->second : std::vector<std::uint8_t>();
+    }
+
+    /** @brief Überschreibt Bytes einer Datei direkt, z.B. um einen beschädigten Sektor nachzubilden. */
+    void corrupt(const char *path, std::size_t offset, std::uint8_t value)
+    {
+        auto found = this->state->files.find(normalize(path));
+        if (found != this->state->files.end() && offset < found->second.size()) {
+            found->second[offset] = value;
+        }
+    }
+
+    std::size_t fileCount() const { return this->state->files.size(); }
+};
+
+} // namespace fake
+
+#endif //FAKE_SD_HPP__
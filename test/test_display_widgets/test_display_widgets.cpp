@@ -0,0 +1,148 @@
+// Tests für die Widgets mit Teil-Neuzeichnen an einem Display-Stub (pio test -e native -f test_display_widgets)
+
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+#include "display_widgets.hpp"
+
+namespace {
+
+/**
+ * @brief Display-Stub mit der Schnittstelle von TFT_eSPI; zählt die tatsächlich übertragenen Pixel.
+ */
+class StubDisplay
+{
+public:
+    std::uint32_t pixels = 0;
+    std::uint32_t calls = 0;
+    std::uint8_t size = 1;
+    std::int16_t cursorX = 0;
+    char printed[64] = {};
+
+    void setTextColor(std::uint16_t, std::uint16_t) {}
+    void setTextSize(std::uint8_t textSize) { this->size = textSize; }
+    void setCursor(std::int16_t x, std::int16_t) { this->cursorX = x; }
+    void print(const char *text)
+    {
+        std::strncpy(this->printed, text, sizeof(this->printed) - 1);
+        this->pixels += static_cast<std::uint32_t>(std::strlen(text)) * 6 * this->size * 8 * this->size;
+        this->calls++;
+    }
+    void fillRect(std::int16_t, std::int16_t, std::int16_t w, std::int16_t h, std::uint16_t)
+    {
+        this->pixels += static_cast<std::uint32_t>(w) * h;
+        this->calls++;
+    }
+};
+
+typedef TextWidget<StubDisplay> Text;
+
+StubDisplay display;
+
+} // namespace
+
+void setUp()
+{
+    display = StubDisplay();
+}
+
+void tearDown() {}
+
+void test_only_changed_characters_are_drawn()
+{
+    ClockWidget<StubDisplay> clock(200, 10, 0xFFFF, 0);
+    clock.setTime(12, 34, 56);
+    TEST_ASSERT_EQUAL_UINT32(8 * 12 * 16, clock.render(display));
+    clock.setTime(12, 34, 57);
+    TEST_ASSERT_EQUAL_UINT32(12 * 16, clock.render(display));
+    TEST_ASSERT_EQUAL_STRING("7", display.printed);
+    TEST_ASSERT_EQUAL_INT(200 + 7 * 12, display.cursorX);
+    TEST_ASSERT_EQUAL_UINT32(0, clock.render(display));    // unverändert: nichts zeichnen
+}
+
+void test_shorter_text_clears_only_the_rest()
+{
+    NumberField<StubDisplay> field(0, 0, 0, "", 0xFFFF, 0);
+    field.setValue(1023);
+    field.render(display);
+    display = StubDisplay();
+    field.setValue(998);
+    field.render(display);
+    TEST_ASSERT_EQUAL_STRING("998", display.printed);
+    TEST_ASSERT_EQUAL_UINT32(2, display.calls);
+    TEST_ASSERT_EQUAL_UINT32(3 * 12 * 16 + 12 * 16, display.pixels);
+}
+
+void test_number_field_formats_and_clamps_decimals()
+{
+    NumberField<StubDisplay> temperature(0, 0, 2, " C", 0xFFFF, 0);
+    temperature.setValue(21.456f);
+    TEST_ASSERT_EQUAL_STRING("21.46 C", temperature.currentText());
+    temperature.setValue(-0.004f);
+    TEST_ASSERT_EQUAL_STRING("0.00 C", temperature.currentText());
+    temperature.setValue(-3.5f);
+    TEST_ASSERT_EQUAL_STRING("-3.50 C", temperature.currentText());
+
+    NumberField<StubDisplay> precise(0, 0, 200, "", 0xFFFF, 0);
+    precise.setValue(1.23456789f);
+    TEST_ASSERT_EQUAL_STRING("1.2346", precise.currentText());   // höchstens MaxDecimals Stellen
+
+    NumberField<StubDisplay> wide(0, 0, 0, " Einheit mit langem Namen", 0xFFFF, 0);
+    wide.setValue(12345);
+    TEST_ASSERT_EQUAL_size_t(Text::MaxText - 1, std::strlen(wide.currentText()));
+}
+
+/**
+ * @brief Eine Stunde Hauptbildschirm wie in main.cpp: Uhr jede Sekunde, Messwerte alle 4 s.
+ */
+void test_pixels_per_frame_report()
+{
+    WidgetScreen<StubDisplay> screen(display);
+    Label<StubDisplay> timeLabel(10, 10, "Uhrzeit:", 0xFFFF, 0);
+    Label<StubDisplay> moistureLabel(10, 50, "Pflanze F.:", 0xFFFF, 0);
+    Label<StubDisplay> temperatureLabel(10, 90, "Temperatur:", 0xFFFF, 0);
+    Label<StubDisplay> humidityLabel(10, 130, "Luft F.:", 0xFFFF, 0);
+    ClockWidget<StubDisplay> clock(200, 10, 0xFFFF, 0);
+    NumberField<StubDisplay> moisture(200, 50, 0, "", 0xFFFF, 0);
+    NumberField<StubDisplay> temperature(200, 90, 2, " C", 0xFFFF, 0);
+    NumberField<StubDisplay> humidity(200, 130, 2, " %", 0xFFFF, 0);
+    Text *widgets[] = {&timeLabel, &moistureLabel, &temperatureLabel, &humidityLabel,
+                       &clock, &moisture, &temperature, &humidity};
+    for (Text *widget : widgets) {
+        screen.add(*widget);
+    }
+
+    std::uint64_t fullRedraw = 0;   // bisher: jedes Feld bei jeder Aktualisierung komplett
+    for (int second = 0; second < 3600; second++) {
+        clock.setTime(12 + second / 3600, second / 60 % 60, second % 60);
+        if (second % 4 == 0) {
+            moisture.setValue(static_cast<float>(480 - second / 300));
+            temperature.setValue(21.5f + 0.01f * static_cast<float>(second % 7));
+            humidity.setValue(40.0f + 0.1f * static_cast<float>(second % 3));
+        }
+        screen.render();
+        for (Text *widget : widgets) {
+            fullRedraw += static_cast<std::uint32_t>(std::strlen(widget->currentText())) * 12 * 16;
+        }
+    }
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "%lu Frames: %lu Pixel/Frame (max %lu), vollständig %lu Pixel/Frame",
+                  static_cast<unsigned long>(screen.frameCount()),
+                  static_cast<unsigned long>(screen.pixelsPushed() / screen.frameCount()),
+                  static_cast<unsigned long>(screen.maxFramePixels()),
+                  static_cast<unsigned long>(fullRedraw / screen.frameCount()));
+    TEST_MESSAGE(line);
+    TEST_ASSERT_EQUAL_UINT64(display.pixels, screen.pixelsPushed());
+    TEST_ASSERT_LESS_THAN(fullRedraw / 10, screen.pixelsPushed());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_only_changed_characters_are_drawn);
+    RUN_TEST(test_shorter_text_clears_only_the_rest);
+    RUN_TEST(test_number_field_formats_and_clamps_decimals);
+    RUN_TEST(test_pixels_per_frame_report);
+    return UNITY_END();
+}
@@ -0,0 +1,170 @@
+// Tests für Q15-Trigonometrie und den Kreisbogen-Rasterizer mit horizontalen Linien (pio test -e native -f test_gfx_math)
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+#include "gfx_math.hpp"
+
+namespace {
+
+constexpr int CanvasSize = 200;
+constexpr int Center = CanvasSize / 2;
+
+/**
+ * @brief Zeichenziel mit der Schnittstelle von TFT_eSPI; merkt sich gesetzte Pixel und Aufrufe.
+ */
+class Canvas
+{
+public:
+    std::uint8_t pixels[CanvasSize][CanvasSize];
+    std::uint32_t calls = 0;
+    std::uint32_t pixelWrites = 0;
+
+    Canvas() { std::memset(this->pixels, 0, sizeof(this->pixels)); }
+
+    void drawPixel(int x, int y, std::uint16_t)
+    {
+        this->calls++;
+        this->pixelWrites++;
+        this->pixels[y][x] = 1;
+    }
+
+    void drawFastHLine(int x, int y, int w, std::uint16_t)
+    {
+        this->calls++;
+        this->pixelWrites += static_cast<std::uint32_t>(w);
+        for (int i = 0; i < w; i++) {
+            this->pixels[y][x + i] = 1;
+        }
+    }
+};
+
+/** @brief Zeichenziel ohne Speicher für den Mikrobenchmark; zählt und bildet eine Prüfsumme der Koordinaten. */
+struct CountingTarget
+{
+    std::uint32_t calls = 0;
+    std::uint32_t pixelWrites = 0;
+    std::uint32_t checksum = 0;
+
+    void drawPixel(int x, int y, std::uint16_t)
+    {
+        this->calls++;
+        this->pixelWrites++;
+        this->checksum += static_cast<std::uint32_t>(x * 31 + y);
+    }
+
+    void drawFastHLine(int x, int y, int w, std::uint16_t)
+    {
+        this->calls++;
+        this->pixelWrites += static_cast<std::uint32_t>(w);
+        this->checksum += static_cast<std::uint32_t>(x * 31 + y + w);
+    }
+};
+
+volatile int benchmarkRadius = 25;  // verhindert, dass der Compiler die Bögen vorausberechnet
+
+/** @brief Pixelweise Referenz mit derselben Q15-Rechnung wie drawArcSpans(). */
+template <typename Gfx>
+void drawArcPixels(Gfx &gfx, int x, int y, int r, int startAngle, int endAngle, std::uint16_t color, int thickness)
+{
+    for (int angle = startAngle; angle <= endAngle; angle++) {
+        int x0 = x + gfx::mulQ15(gfx::cosQ15(angle), r);
+        int y0 = y - gfx::mulQ15(gfx::sinQ15(angle), r);
+        gfx.drawPixel(x0, y0, color);
+        for (int j = -thickness / 2; j < thickness / 2; j++) {
+            gfx.drawPixel(x0 + j, y0, color);
+        }
+    }
+}
+
+/** @brief Bisheriges drawArc() aus main.cpp: double-Trigonometrie, ein drawPixel() je Punkt. */
+template <typename Gfx>
+void drawArcLegacy(Gfx &gfx, int x, int y, int r, int startAngle, int endAngle, std::uint16_t color, int thickness)
+{
+    for (int i = startAngle; i <= endAngle; i++) {
+        float angle = i * 3.14159 / 180.0;
+        int x0 = x + (int)(cos(angle) * r);
+        int y0 = y - (int)(sin(angle) * r);
+        gfx.drawPixel(x0, y0, color);
+        for (int j = -thickness / 2; j < thickness / 2; j++) {
+            gfx.drawPixel(x0 + j, y0, color);
+        }
+    }
+}
+
+/** @brief Laufzeit je Bogen in ns, gemessen über runs Wiederholungen des lachenden Munds. */
+template <typename Draw>
+double nanosPerArc(Draw draw, int runs, CountingTarget &target)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+        draw(target, Center, Center, benchmarkRadius, 180, 360, 0, 4);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / runs;
+}
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_sine_table_matches_libm()
+{
+    for (int degrees = -720; degrees <= 720; degrees++) {
+        double radians = degrees * 3.14159265358979323846 / 180.0;
+        TEST_ASSERT_INT_WITHIN(1, static_cast<int>(std::lround(std::sin(radians) * 32767)), gfx::sinQ15(degrees));
+        TEST_ASSERT_INT_WITHIN(1, static_cast<int>(std::lround(std::cos(radians) * 32767)), gfx::cosQ15(degrees));
+    }
+    TEST_ASSERT_EQUAL_INT(60, gfx::mulQ15(gfx::cosQ15(0), 60));
+    TEST_ASSERT_EQUAL_INT(-60, gfx::mulQ15(gfx::cosQ15(180), 60));
+    TEST_ASSERT_EQUAL_INT(30, gfx::mulQ15(gfx::sinQ15(30), 60));
+}
+
+void test_spans_cover_exactly_the_reference_pixels()
+{
+    const int arcs[][2] = {{180, 360}, {0, 180}, {0, 359}, {45, 135}, {-30, 30}, {90, 90}};
+    for (const auto &arc : arcs) {
+        for (int r = 1; r <= 80; r++) {
+            for (int thickness = 0; thickness <= 6; thickness++) {
+                Canvas spans;
+                Canvas reference;
+                int lines = gfx::drawArcSpans(spans, Center, Center, r, arc[0], arc[1], 1, thickness);
+                drawArcPixels(reference, Center, Center, r, arc[0], arc[1], 1, thickness);
+                TEST_ASSERT_EQUAL_MEMORY(reference.pixels, spans.pixels, sizeof(spans.pixels));
+                TEST_ASSERT_EQUAL_UINT32(static_cast<std::uint32_t>(lines), spans.calls);
+                TEST_ASSERT_LESS_OR_EQUAL_UINT32(reference.calls, spans.calls);
+            }
+        }
+    }
+}
+
+void test_arc_microbenchmark_report()
+{
+    const int runs = 20000;
+    CountingTarget legacy;
+    CountingTarget spans;
+    double legacyNanos = nanosPerArc(drawArcLegacy<CountingTarget>, runs, legacy);
+    double spanNanos = nanosPerArc(gfx::drawArcSpans<CountingTarget>, runs, spans);
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "Mund r=25, 4 px: bisher %.0f ns und %lu Aufrufe, Linien %.0f ns und %lu Aufrufe je Bogen",
+                  legacyNanos, static_cast<unsigned long>(legacy.calls / runs),
+                  spanNanos, static_cast<unsigned long>(spans.calls / runs));
+    TEST_MESSAGE(line);
+    TEST_ASSERT_NOT_EQUAL(0, legacy.checksum);
+    TEST_ASSERT_EQUAL_UINT32(181 * 5, legacy.calls / runs);
+    TEST_ASSERT_LESS_THAN(legacy.calls / runs / 10, spans.calls / runs);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sine_table_matches_libm);
+    RUN_TEST(test_spans_cover_exactly_the_reference_pixels);
+    RUN_TEST(test_arc_microbenchmark_report);
+    return UNITY_END();
+}
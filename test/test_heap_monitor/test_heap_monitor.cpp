@@ -0,0 +1,133 @@
+// Tests für die Heap-Statistik und ein Dauerlauf der Messschleife (pio test -e native -f test_heap_monitor)
+
+#include <cstdio>
+#include <cstdlib>
+#include <unity.h>
+#include "display_widgets.hpp"
+#include "heap_monitor.hpp"
+#include "plant_state.hpp"
+#include "sensor_sampler.hpp"
+#include "telemetry_queue.hpp"
+
+namespace {
+
+/** @brief Display-Stub mit der Schnittstelle von TFT_eSPI, zeichnet nichts. */
+struct NullDisplay
+{
+    void setTextColor(std::uint16_t, std::uint16_t) {}
+    void setTextSize(std::uint8_t) {}
+    void setCursor(std::int16_t, std::int16_t) {}
+    void print(const char *) {}
+    void fillRect(std::int16_t, std::int16_t, std::int16_t, std::int16_t, std::uint16_t) {}
+};
+
+unsigned long fakeNow = 0;
+
+void readSensors(Sample &sample)
+{
+    unsigned long minute = fakeNow / 60000;
+    sample.moisture = static_cast<int>(500 - minute % 600);    // trocknet aus, wird gegossen
+    sample.temperature = 20.0f + static_cast<float>(minute % 240) / 40.0f;
+    sample.humidity = 40.0f + static_cast<float>(minute % 100) / 10.0f;
+    sample.climateValid = true;
+}
+
+NullDisplay display;
+NumberField<NullDisplay> moisture(200, 50, 0, "", 0xFFFF, 0);
+NumberField<NullDisplay> temperature(200, 90, 2, " C", 0xFFFF, 0);
+NumberField<NullDisplay> humidity(200, 130, 2, " %", 0xFFFF, 0);
+telemetry::RamQueue<64> queue;
+plant::Mood shownMood = plant::Mood::Neutral;
+
+void showSample(const Sample &sample)
+{
+    moisture.setValue(static_cast<float>(sample.moisture));
+    temperature.setValue(sample.temperature);
+    humidity.setValue(sample.humidity);
+    shownMood = plant::moodForMoisture(sample.moisture);
+}
+
+void queueSample(const Sample &sample)
+{
+    samplelog::Record record = {};
+    record.unixTime = 1717243200U + static_cast<std::uint32_t>(sample.timestamp / 1000);
+    record.moisture = static_cast<std::uint16_t>(sample.moisture);
+    queue.push(telemetry::sampleEntry(record));
+    if (queue.pending() == 10) {
+        queue.consume(10);  // Batch gesendet
+    }
+}
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_sample_tracks_allocations_and_extremes()
+{
+    HeapMonitor monitor;
+    TEST_ASSERT_EQUAL_size_t(0, monitor.minFree());
+    std::size_t before = monitor.sample().inUse;
+    void *block = std::malloc(64 * 1024);
+    TEST_ASSERT_NOT_NULL(block);
+    std::size_t during = monitor.sample().inUse;
+    std::free(block);
+    std::size_t after = monitor.sample().inUse;
+
+    TEST_ASSERT_GREATER_OR_EQUAL(before + 64 * 1024, during);
+    TEST_ASSERT_LESS_THAN(during, after);
+    TEST_ASSERT_EQUAL_size_t(during, monitor.maxInUse());
+    TEST_ASSERT_EQUAL_UINT32(3, monitor.sampleCount());
+    TEST_ASSERT_EQUAL_size_t(0, monitor.latest().freeAbove);   // auf dem Host ohne Bedeutung
+}
+
+/**
+ * @brief Eine Woche Messschleife wie in main.cpp (alle 4 s messen, anzeigen, in die Warteschlange).
+ *
+ * Im Dauerbetrieb darf weder die Belegung wachsen noch der Heap in Lücken zerfallen.
+ */
+void test_week_soak_keeps_heap_flat()
+{
+    SensorSampler sampler(readSensors, 4000);
+    sampler.subscribe(showSample);
+    sampler.subscribe(queueSample);
+    WidgetScreen<NullDisplay> screen(display);
+    screen.add(moisture);
+    screen.add(temperature);
+    screen.add(humidity);
+
+    HeapMonitor monitor;
+    const unsigned long week = 7UL * 24 * 3600000;
+    const unsigned long hour = 3600000UL;
+    std::size_t baseline = 0;
+    for (fakeNow = 0; fakeNow < week; fakeNow += 1000) {
+        if (sampler.poll(fakeNow)) {
+            screen.render();
+        }
+        if (fakeNow % hour == 0) {
+            const HeapMonitor::Snapshot &heap = monitor.sample();
+            if (fakeNow == hour) {
+                baseline = heap.inUse;  // nach der ersten Stunde eingeschwungen
+            }
+        }
+    }
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "%lu Messungen: belegt %u Byte (max %u), Luecken max %u Byte",
+                  static_cast<unsigned long>(sampler.samplesTaken()), static_cast<unsigned>(monitor.latest().inUse),
+                  static_cast<unsigned>(monitor.maxInUse()), static_cast<unsigned>(monitor.maxFreeInHeap()));
+    TEST_MESSAGE(line);
+    TEST_ASSERT_EQUAL_UINT32(week / 4000, sampler.samplesTaken());
+    TEST_ASSERT_EQUAL_size_t(baseline, monitor.latest().inUse);
+    TEST_ASSERT_EQUAL_size_t(baseline, monitor.maxInUse());
+    TEST_ASSERT_TRUE(shownMood == plant::moodForMoisture(sampler.latest().moisture));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sample_tracks_allocations_and_extremes);
+    RUN_TEST(test_week_soak_keeps_heap_flat);
+    return UNITY_END();
+}
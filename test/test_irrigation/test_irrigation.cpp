@@ -0,0 +1,242 @@
+// Tests für die Bewässerungssteuerung (pio test -e native -f test_irrigation)
+
+#include <cstdio>
+#include <unity.h>
+#include "irrigation_controller.hpp"
+
+namespace {
+
+typedef IrrigationController::State State;
+
+bool relayOn = false;
+unsigned int relayCalls = 0;
+
+void relay(bool on)
+{
+    relayOn = on;
+    relayCalls++;
+}
+
+IrrigationController::Config testConfig()
+{
+    IrrigationController::Config config;
+    config.startThreshold = 10;
+    config.stopThreshold = 100;
+    config.minRunTime = 5000;
+    config.maxRunTime = 30000;
+    config.soakTime = 60000;
+    config.minOffTime = 600000;
+    config.maxCycles = 3;
+    config.dailyBudget = 180000;
+    return config;
+}
+
+/**
+ * @brief Einfaches Bodenmodell: Verdunstung tagsüber stärker als nachts, das Wasser der Pumpe
+ *        erreicht den Sensor verzögert (Zeitkonstante 60 s).
+ */
+class SoilModel
+{
+private:
+    double sensor = 60;
+    double surface = 0;     // gegossen, aber noch nicht am Sensor
+
+public:
+    void step(unsigned long second, bool pumpOn)
+    {
+        unsigned long hour = second / 3600 % 24;
+        double drying = (hour >= 7 && hour < 20 ? 40.0 : 10.0) / 3600;
+        if (pumpOn) {
+            this->surface += 4.0;   // Sensoreinheiten pro Sekunde Pumpenlaufzeit
+        }
+        double soaked = this->surface / 60;
+        this->surface -= soaked;
+        this->sensor += soaked - drying;
+        if (this->sensor < 0) {
+            this->sensor = 0;
+        }
+    }
+
+    int reading() const { return static_cast<int>(this->sensor); }
+};
+
+struct DayResult
+{
+    std::uint32_t pumpCycles = 0;
+    std::uint32_t relayWrites = 0;
+    unsigned long pumpSeconds = 0;
+    int minMoisture = 1023;
+    int maxMoisture = 0;
+};
+
+/**
+ * @brief Simuliert days Tage im Sekundentakt; gemessen wird wie in main.cpp alle 4 s.
+ *
+ * Mit controller == nullptr wird das frühere controlRelayBasedOnMoisture() nachgebildet:
+ * Relais bei jeder Messung schreiben, an bei Feuchte <= 10.
+ */
+DayResult simulate(IrrigationController *controller, unsigned long days)
+{
+    DayResult result;
+    SoilModel soil;
+    bool wasOn = false;
+    if (controller != nullptr) {
+        controller->begin(0);
+    }
+    for (unsigned long second = 0; second < days * 86400; second++) {
+        unsigned long now = second * 1000;
+        int moisture = soil.reading();
+        if (controller != nullptr) {
+            if (second % 4 == 0) {
+                controller->update(now, moisture);
+            } else {
+                controller->poll(now);
+            }
+        } else if (second % 4 == 0) {
+            relay(moisture <= 10);
+        }
+        bool on = controller != nullptr ? controller->pumpOn() : relayOn;
+        if (on && !wasOn) {
+            result.pumpCycles++;
+        }
+        wasOn = on;
+        result.pumpSeconds += on ? 1 : 0;
+        soil.step(second, on);
+        if (second >= 3600) {   // erste Stunde eingeschwungen
+            result.minMoisture = moisture < result.minMoisture ? moisture : result.minMoisture;
+            result.maxMoisture = moisture > result.maxMoisture ? moisture : result.maxMoisture;
+        }
+    }
+    result.relayWrites = controller != nullptr ? controller->relayWrites() : relayCalls;
+    result.pumpCycles /= days;
+    result.relayWrites /= days;
+    result.pumpSeconds /= days;
+    return result;
+}
+
+} // namespace
+
+void setUp()
+{
+    relayOn = false;
+    relayCalls = 0;
+}
+
+void tearDown() {}
+
+void test_hysteresis_between_thresholds()
+{
+    IrrigationController controller(testConfig(), relay);
+    controller.begin(0);
+    TEST_ASSERT_TRUE(controller.update(1000, 50) == State::Idle);   // zwischen den Schwellen: nichts tun
+    TEST_ASSERT_TRUE(controller.update(2000, 10) == State::Watering);
+    TEST_ASSERT_TRUE(relayOn);
+    TEST_ASSERT_TRUE(controller.update(4000, 150) == State::Watering);  // minRunTime noch nicht erreicht
+    TEST_ASSERT_TRUE(controller.update(7000, 60) == State::Watering);   // unter stopThreshold
+    TEST_ASSERT_TRUE(controller.update(8000, 100) == State::Soaking);
+    TEST_ASSERT_FALSE(relayOn);
+    TEST_ASSERT_TRUE(controller.update(68000, 100) == State::Idle);
+    TEST_ASSERT_EQUAL_UINT32(1, controller.pumpCycles());
+}
+
+void test_relay_written_only_on_transitions()
+{
+    IrrigationController controller(testConfig(), relay);
+    controller.begin(0);
+    for (unsigned long t = 0; t < 20000; t += 500) {
+        controller.update(t, t < 5000 ? 5 : 50);
+    }
+    // begin() aus, einmal an; ausgeschaltet wird erst nach maxRunTime
+    TEST_ASSERT_EQUAL_UINT(2, relayCalls);
+    TEST_ASSERT_EQUAL_UINT32(relayCalls, controller.relayWrites());
+}
+
+void test_max_run_time_then_soak_then_retry()
+{
+    IrrigationController controller(testConfig(), relay);
+    controller.begin(0);
+    controller.update(0, 5);
+    TEST_ASSERT_TRUE(controller.poll(29999) == State::Watering);
+    TEST_ASSERT_TRUE(controller.poll(30000) == State::Soaking);
+    TEST_ASSERT_TRUE(controller.poll(89999) == State::Soaking);
+    TEST_ASSERT_TRUE(controller.poll(90000) == State::Watering);    // Sensor noch trocken: nächster Zyklus
+    TEST_ASSERT_EQUAL_UINT32(2, controller.pumpCycles());
+}
+
+void test_lockout_after_max_cycles_until_next_window()
+{
+    IrrigationController controller(testConfig(), relay);
+    controller.begin(0);
+    controller.update(0, 0);    // Sensor steigt nie, z.B. Tank leer
+    unsigned long t = 0;
+    for (; t < 400000 && controller.state() != State::Lockout; t += 500) {
+        controller.poll(t);
+    }
+    TEST_ASSERT_TRUE(controller.state() == State::Lockout);
+    TEST_ASSERT_EQUAL_UINT32(3, controller.pumpCycles());
+    TEST_ASSERT_EQUAL_UINT32(1, controller.lockouts());
+    TEST_ASSERT_FALSE(relayOn);
+
+    TEST_ASSERT_TRUE(controller.poll(86400000UL - 1) == State::Lockout);
+    controller.poll(86400000UL);    // neues Budgetfenster: Idle, danach wieder gießen
+    TEST_ASSERT_TRUE(controller.poll(86400500UL) == State::Watering);
+}
+
+void test_daily_budget_limits_run_time()
+{
+    IrrigationController::Config config = testConfig();
+    config.dailyBudget = 45000;
+    IrrigationController controller(config, relay);
+    controller.begin(0);
+    controller.update(0, 0);
+    for (unsigned long t = 0; t < 3600000UL; t += 100) {
+        controller.poll(t);
+    }
+    TEST_ASSERT_EQUAL_UINT32(45000, controller.usedBudget(3600000UL));
+    TEST_ASSERT_EQUAL_UINT32(45000, controller.totalRunTime());
+    TEST_ASSERT_TRUE(controller.state() == State::Lockout);
+}
+
+/**
+ * @brief Eine Woche Bodenmodell mit der Konfiguration aus main.cpp gegen die frühere Zweipunktregelung.
+ */
+void test_soil_model_cycles_per_day_report()
+{
+    IrrigationController::Config config;    // wie irrigationConfig() in main.cpp
+    config.startThreshold = 10;
+    config.stopThreshold = 100;
+    IrrigationController controller(config, relay);
+    DayResult current = simulate(&controller, 7);
+    relayCalls = 0;
+    relayOn = false;
+    DayResult legacy = simulate(nullptr, 7);
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "Pro Tag bisher: %lu Zyklen, %lu Relais-Schaltungen, Pumpe %lu s, Feuchte %d..%d",
+                  static_cast<unsigned long>(legacy.pumpCycles), static_cast<unsigned long>(legacy.relayWrites),
+                  legacy.pumpSeconds, legacy.minMoisture, legacy.maxMoisture);
+    TEST_MESSAGE(line);
+    std::snprintf(line, sizeof(line), "Pro Tag Steuerung: %lu Zyklen, %lu Relais-Schaltungen, Pumpe %lu s, Feuchte %d..%d",
+                  static_cast<unsigned long>(current.pumpCycles), static_cast<unsigned long>(current.relayWrites),
+                  current.pumpSeconds, current.minMoisture, current.maxMoisture);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_EQUAL_UINT32(86400 / 4, legacy.relayWrites);        // jede Messung ein digitalWrite()
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(2 * current.pumpCycles + 1, current.relayWrites);
+    TEST_ASSERT_LESS_THAN_UINT32(legacy.pumpCycles / 4, current.pumpCycles);
+    TEST_ASSERT_LESS_OR_EQUAL(config.dailyBudget / 1000, current.pumpSeconds);
+    TEST_ASSERT_GREATER_OR_EQUAL(config.stopThreshold, current.maxMoisture);
+    TEST_ASSERT_EQUAL_UINT32(0, controller.lockouts());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_hysteresis_between_thresholds);
+    RUN_TEST(test_relay_written_only_on_transitions);
+    RUN_TEST(test_max_run_time_then_soak_then_retry);
+    RUN_TEST(test_lockout_after_max_cycles_until_next_window);
+    RUN_TEST(test_daily_budget_limits_run_time);
+    RUN_TEST(test_soil_model_cycles_per_day_report);
+    return UNITY_END();
+}
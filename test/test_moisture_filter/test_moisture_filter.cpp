@@ -0,0 +1,146 @@
+// Tests für den Bodenfeuchtefilter mit einer verrauschten ADC-Aufzeichnung (pio test -e native -f test_moisture_filter)
+
+#include <cstdio>
+#include <cstdint>
+#include <unity.h>
+#include "moisture_filter.hpp"
+
+namespace {
+
+constexpr int Dry = 400;
+constexpr int Wet = 600;
+constexpr int StepAt = 200;     // Messung, bei der gegossen wird
+constexpr int Samples = 400;    // 4 s pro Messung: knapp 27 min
+
+/**
+ * @brief Nachgebildeter ADC des Grove-Sensors: Rauschen ±24 LSB, etwa jede 40. Wandlung ein Ausreißer
+ *        (Störung durch Pumpe und WLAN) an den Rand des Messbereichs.
+ */
+class NoisyAdc
+{
+private:
+    std::uint32_t seed = 12345;
+
+    std::uint32_t next()
+    {
+        this->seed = this->seed * 1664525u + 1013904223u;
+        return this->seed >> 8;
+    }
+
+public:
+    int level = Dry;
+    unsigned int conversions = 0;
+
+    int read()
+    {
+        this->conversions++;
+        std::uint32_t r = this->next();
+        if (r % 40 == 0) {
+            return (r >> 6) % 2 ? 1023 : 0;
+        }
+        // Summe aus drei Gleichverteilungen, annähernd normalverteilt
+        int noise = static_cast<int>(this->next() % 17) + static_cast<int>(this->next() % 17)
+                  + static_cast<int>(this->next() % 17) - 24;
+        return this->level + noise;
+    }
+};
+
+struct Trace
+{
+    int raw[Samples];
+    int filtered[Samples];
+};
+
+Trace replay(std::uint8_t smoothingShift)
+{
+    Trace trace;
+    NoisyAdc adc;
+    MoistureFilter<9> filter(smoothingShift);  // wie in main.cpp
+    for (int i = 0; i < Samples; i++) {
+        adc.level = i < StepAt ? Dry : Wet;
+        trace.filtered[i] = filter.sample([&adc]() { return adc.read(); });
+        trace.raw[i] = filter.lastRaw();
+    }
+    return trace;
+}
+
+/** @brief Varianz um den wahren Wert im eingeschwungenen Bereich [from, to). */
+double variance(const int *values, int from, int to, int truth)
+{
+    double sum = 0;
+    for (int i = from; i < to; i++) {
+        double error = values[i] - truth;
+        sum += error * error;
+    }
+    return sum / (to - from);
+}
+
+/** @brief Messungen nach dem Sprung, bis der Wert 90 % der Sprunghöhe erreicht. */
+int settling(const int *values)
+{
+    for (int i = StepAt; i < Samples; i++) {
+        if (values[i] >= Dry + (Wet - Dry) * 9 / 10) {
+            return i - StepAt;
+        }
+    }
+    return Samples;
+}
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_outliers_do_not_reach_output()
+{
+    MoistureFilter<9> filter(0);
+    std::uint16_t burst[9] = {500, 0, 502, 1023, 498, 501, 1023, 499, 500};
+    TEST_ASSERT_EQUAL_INT(500, filter.update(burst));
+    TEST_ASSERT_EQUAL_INT(500, filter.lastRaw());
+    TEST_ASSERT_EQUAL_INT(500, filter.lastMedian());
+}
+
+void test_first_sample_is_taken_without_settling()
+{
+    MoistureFilter<9> filter(2);
+    std::uint16_t burst[9] = {600, 600, 600, 600, 600, 600, 600, 600, 600};
+    TEST_ASSERT_EQUAL_INT(600, filter.update(burst));
+    filter.reset();
+    std::uint16_t low[9] = {100, 100, 100, 100, 100, 100, 100, 100, 100};
+    TEST_ASSERT_EQUAL_INT(100, filter.update(low));
+}
+
+void test_noisy_trace_variance_and_latency_report()
+{
+    Trace raw = replay(0);      // nur Median
+    Trace smoothed = replay(2); // Median und Tiefpass wie in main.cpp
+
+    double rawVariance = variance(raw.raw, 50, StepAt, Dry);
+    double medianVariance = variance(raw.filtered, 50, StepAt, Dry);
+    double filteredVariance = variance(smoothed.filtered, 50, StepAt, Dry);
+    int medianLatency = settling(raw.filtered);
+    int filteredLatency = settling(smoothed.filtered);
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "Varianz: einzeln %.1f, Median %.1f, Median+Tiefpass %.1f LSB^2",
+                  rawVariance, medianVariance, filteredVariance);
+    TEST_MESSAGE(line);
+    std::snprintf(line, sizeof(line), "90 %% nach Sprung %d->%d: Median %d, Median+Tiefpass %d Messungen (+%d s)",
+                  Dry, Wet, medianLatency, filteredLatency, (filteredLatency - medianLatency) * 4);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_TRUE(medianVariance < rawVariance / 100);      // Ausreißer entfernt
+    TEST_ASSERT_TRUE(filteredVariance < medianVariance / 2);
+    TEST_ASSERT_EQUAL_INT(0, medianLatency);                       // Median verzögert nicht
+    TEST_ASSERT_LESS_OR_EQUAL(8, filteredLatency);                 // höchstens 32 s bei alpha 1/4
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_outliers_do_not_reach_output);
+    RUN_TEST(test_first_sample_is_taken_without_settling);
+    RUN_TEST(test_noisy_trace_variance_and_latency_report);
+    return UNITY_END();
+}
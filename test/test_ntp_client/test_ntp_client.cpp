@@ -0,0 +1,264 @@
+// Tests für den NTP-Client mit einem UDP-Endpunkt im Speicher (pio test -e native -f test_ntp_client)
+
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+#include "ntp_client.hpp"
+
+namespace {
+
+constexpr std::int64_t ServerUnixMs = 1717243200000LL;     // 1.6.2024 12:00 UTC
+
+/**
+ * @brief UDP-Endpunkt: merkt sich die Anfragen, Antworten werden vom Test mit reply() eingestellt.
+ */
+class FakeUdp
+{
+public:
+    unsigned long now = 0;
+    std::uint8_t request[48] = {};
+    const char *host = nullptr;
+    std::uint32_t requests = 0;
+    bool running = false;
+
+    std::uint8_t answer[48] = {};
+    bool answerPending = false;
+    unsigned long answerAt = 0;
+
+    std::uint8_t begin(std::uint16_t)
+    {
+        this->running = true;
+        return 1;
+    }
+    void stop() { this->running = false; }
+    int beginPacket(const char *host, std::uint16_t)
+    {
+        this->host = host;
+        return 1;
+    }
+    std::size_t write(const std::uint8_t *buffer, std::size_t size)
+    {
+        std::memcpy(this->request, buffer, size < 48 ? size : 48);
+        return size;
+    }
+    int endPacket()
+    {
+        this->requests++;
+        return 1;
+    }
+    int parsePacket() { return this->answerPending && this->now >= this->answerAt ? 48 : 0; }
+    int read(std::uint8_t *buffer, std::size_t length)
+    {
+        if (!this->answerPending || length < 48) {
+            return 0;
+        }
+        std::memcpy(buffer, this->answer, 48);
+        this->answerPending = false;
+        return 48;
+    }
+    void flush() { this->answerPending = false; }
+
+    /** @brief Stellt eine Antwort ein, die ab at gelesen werden kann. */
+    void reply(const std::uint8_t *packet, unsigned long at)
+    {
+        std::memcpy(this->answer, packet, 48);
+        this->answerPending = true;
+        this->answerAt = at;
+    }
+};
+
+void putNtp(std::uint8_t *p, std::int64_t unixMs)
+{
+    std::uint32_t seconds = static_cast<std::uint32_t>(unixMs / 1000) + 2208988800UL;
+    std::uint32_t fraction = static_cast<std::uint32_t>(((unixMs % 1000) << 32) / 1000);
+    for (int i = 0; i < 4; i++) {
+        p[i] = static_cast<std::uint8_t>(seconds >> (24 - 8 * i));
+        p[4 + i] = static_cast<std::uint8_t>(fraction >> (24 - 8 * i));
+    }
+}
+
+/**
+ * @brief Antwort eines Servers der Schicht 2 auf die letzte Anfrage; Receive und Transmit = serverMs.
+ */
+void serverReply(const FakeUdp &udp, std::int64_t serverMs, std::uint8_t *packet)
+{
+    std::memset(packet, 0, 48);
+    packet[0] = 0x24;   // LI = 0, Version 4, Mode 4
+    packet[1] = 2;
+    std::memcpy(packet + 24, udp.request + 40, 8);
+    putNtp(packet + 32, serverMs);
+    putNtp(packet + 40, serverMs);
+}
+
+const char *const servers[] = {"a.example", "b.example"};
+
+typedef NtpClient<FakeUdp> Client;
+FakeUdp udp;
+
+/** @brief Schaltet den Client bis until in 10-ms-Schritten weiter. */
+Client::State runUntil(Client &client, unsigned long until)
+{
+    while (udp.now < until && client.busy()) {
+        udp.now += 10;
+        client.poll(udp.now);
+    }
+    return client.state();
+}
+
+} // namespace
+
+void setUp()
+{
+    udp = FakeUdp();
+}
+
+void tearDown() {}
+
+void test_offset_and_delay_from_four_timestamps()
+{
+    Client client(udp, servers, 2, 1000, 2, 2000, 60000);
+    // Lokale Uhr geht 5 s nach; die Antwort kommt nach 40 ms, der Server misst in der Mitte des Weges
+    client.start(0, ServerUnixMs - 5000);
+    TEST_ASSERT_EQUAL_STRING("a.example", udp.host);
+    std::uint8_t packet[48];
+    serverReply(udp, ServerUnixMs + 20, packet);
+    udp.reply(packet, 40);
+
+    TEST_ASSERT_TRUE(runUntil(client, 1000) == Client::State::Synced);
+    // NTP-Bruchteile werden abgeschnitten, daher 1 ms Toleranz
+    TEST_ASSERT_INT64_WITHIN(1, 5000, client.offsetMs());
+    TEST_ASSERT_INT64_WITHIN(1, 40, client.delayMs());
+    TEST_ASSERT_INT64_WITHIN(1, ServerUnixMs + 40, client.unixMs(40));
+    TEST_ASSERT_FALSE(udp.running);
+}
+
+void test_silent_server_falls_over_to_next()
+{
+    Client client(udp, servers, 2, 1000, 2, 2000, 60000);
+    client.start(0, ServerUnixMs);
+    runUntil(client, 1000);
+    TEST_ASSERT_EQUAL_UINT32(2, udp.requests);
+    TEST_ASSERT_EQUAL_STRING("b.example", udp.host);
+
+    std::uint8_t packet[48];
+    serverReply(udp, ServerUnixMs + 1000, packet);
+    udp.reply(packet, 1030);
+    TEST_ASSERT_TRUE(runUntil(client, 2000) == Client::State::Synced);
+    TEST_ASSERT_EQUAL_STRING("b.example", client.server());
+}
+
+void test_fails_after_max_rounds_with_backoff()
+{
+    Client client(udp, servers, 2, 1000, 2, 2000, 60000);
+    client.start(0, ServerUnixMs);
+    // Runde 1: 2 Server je 1 s, Backoff 2 s, Runde 2: 2 Server je 1 s
+    TEST_ASSERT_TRUE(runUntil(client, 3990) == Client::State::Backoff);
+    TEST_ASSERT_TRUE(runUntil(client, 10000) == Client::State::Failed);
+    TEST_ASSERT_EQUAL_UINT32(4, client.requestsSent());
+    TEST_ASSERT_EQUAL_UINT(6000, udp.now);
+    TEST_ASSERT_FALSE(udp.running);
+}
+
+void test_invalid_replies_are_ignored()
+{
+    struct Canned
+    {
+        const char *what;
+        std::uint8_t header;
+        std::uint8_t stratum;
+        bool wrongOriginate;
+    };
+    const Canned canned[] = {
+        {"Kiss-o'-Death", 0x24, 0, false},
+        {"nicht synchronisiert (LI = 3)", 0xE4, 2, false},
+        {"Client-Paket (Mode 3)", 0x23, 2, false},
+        {"Schicht 16", 0x24, 16, false},
+        {"Antwort auf eine andere Anfrage", 0x24, 2, true},
+    };
+    for (const Canned &c : canned) {
+        setUp();
+        Client client(udp, servers, 2, 1000, 2, 2000, 60000);
+        client.start(0, ServerUnixMs);
+        std::uint8_t packet[48];
+        serverReply(udp, ServerUnixMs, packet);
+        packet[0] = c.header;
+        packet[1] = c.stratum;
+        if (c.wrongOriginate) {
+            packet[31] ^= 0x01;
+        }
+        udp.reply(packet, 20);
+        TEST_ASSERT_TRUE_MESSAGE(runUntil(client, 990) == Client::State::WaitingReply, c.what);
+        TEST_ASSERT_FALSE_MESSAGE(udp.answerPending, c.what);   // gelesen und verworfen
+        runUntil(client, 1000);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE("b.example", udp.host, c.what);
+    }
+}
+
+void test_stale_reply_before_request_is_discarded()
+{
+    std::uint8_t packet[48];
+    udp.request[40] = 0x55;     // Antwort auf eine frühere Synchronisation liegt noch im Puffer
+    serverReply(udp, ServerUnixMs - 60000, packet);
+    udp.reply(packet, 0);
+    Client client(udp, servers, 2, 1000, 2, 2000, 60000);
+    client.start(0, ServerUnixMs);
+    TEST_ASSERT_FALSE(udp.answerPending);
+    serverReply(udp, ServerUnixMs + 15, packet);
+    udp.reply(packet, 30);
+    TEST_ASSERT_TRUE(runUntil(client, 1000) == Client::State::Synced);
+    TEST_ASSERT_INT64_WITHIN(1, 0, client.offsetMs());
+}
+
+/**
+ * @brief Zeit bis zur Synchronisation für verschiedene Netzbedingungen.
+ */
+void test_time_to_sync_report()
+{
+    struct Scenario
+    {
+        const char *name;
+        unsigned long latency;          // Umlaufzeit der Antwort
+        unsigned int silentRequests;    // so viele Anfragen bleiben unbeantwortet
+        unsigned long expected;
+    };
+    const Scenario scenarios[] = {
+        {"schnell", 30, 0, 30},
+        {"langsam", 400, 0, 400},
+        {"erster Server stumm", 30, 1, 1030},
+        {"eine Runde verloren", 30, 2, 4030},     // 2 x 1 s Timeout, 2 s Backoff
+        {"zwei Runden verloren", 30, 4, 10030},   // zweite Runde 2 s, Backoff verdoppelt auf 4 s
+    };
+    char line[96];
+    for (const Scenario &scenario : scenarios) {
+        setUp();
+        Client client(udp, servers, 2, 1000, 3, 2000, 60000);
+        client.start(0, ServerUnixMs);
+        while (client.busy() && udp.now < 60000) {
+            if (udp.requests > scenario.silentRequests && !udp.answerPending) {
+                std::uint8_t packet[48];
+                serverReply(udp, ServerUnixMs + static_cast<std::int64_t>(udp.now), packet);
+                udp.reply(packet, udp.now + scenario.latency);
+            }
+            udp.now += 10;
+            client.poll(udp.now);
+        }
+        std::snprintf(line, sizeof(line), "%-22s Anfragen %lu, synchronisiert nach %lu ms", scenario.name,
+                      static_cast<unsigned long>(client.requestsSent()), client.timeToSync());
+        TEST_MESSAGE(line);
+        TEST_ASSERT_TRUE(client.state() == Client::State::Synced);
+        TEST_ASSERT_EQUAL_UINT32(scenario.silentRequests + 1, client.requestsSent());
+        TEST_ASSERT_UINT32_WITHIN(10, scenario.expected, client.timeToSync());
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_offset_and_delay_from_four_timestamps);
+    RUN_TEST(test_silent_server_falls_over_to_next);
+    RUN_TEST(test_fails_after_max_rounds_with_backoff);
+    RUN_TEST(test_invalid_replies_are_ignored);
+    RUN_TEST(test_stale_reply_before_request_is_discarded);
+    RUN_TEST(test_time_to_sync_report);
+    return UNITY_END();
+}
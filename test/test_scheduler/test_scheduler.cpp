@@ -0,0 +1,276 @@
+// Tests für den kooperativen Scheduler mit simulierter Uhr (pio test -e native -f test_scheduler)
+
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+#include "scheduler.hpp"
+
+namespace {
+
+unsigned long fakeNow = 0;
+unsigned long fakeClock() { return fakeNow; }
+
+Scheduler scheduler(fakeClock);
+unsigned int runsA = 0;
+unsigned int runsB = 0;
+char order[8] = {};
+std::size_t orderLength = 0;
+unsigned long taskDuration = 0;
+
+void taskA()
+{
+    runsA++;
+    order[orderLength++ % sizeof(order)] = 'A';
+    fakeNow += taskDuration;
+}
+
+void taskB()
+{
+    runsB++;
+    order[orderLength++ % sizeof(order)] = 'B';
+}
+
+int selfId = Scheduler::InvalidTask;
+int successorId = Scheduler::InvalidTask;
+
+/** @brief Entfernt sich selbst und legt eine Nachfolgeaufgabe an, wie pollNtpTime in main.cpp. */
+void selfReplacingTask()
+{
+    runsA++;
+    scheduler.cancel(selfId);
+    selfId = Scheduler::InvalidTask;
+    successorId = scheduler.addOneShot("b", taskB, 1000);
+    fakeNow += taskDuration;
+}
+
+} // namespace
+
+void setUp()
+{
+    fakeNow = 0;
+    runsA = 0;
+    runsB = 0;
+    orderLength = 0;
+    taskDuration = 0;
+    selfId = Scheduler::InvalidTask;
+    successorId = Scheduler::InvalidTask;
+    std::memset(order, 0, sizeof(order));
+    scheduler = Scheduler(fakeClock);
+}
+
+void tearDown() {}
+
+void test_periodic_task_runs_once_per_period()
+{
+    scheduler.addPeriodic("a", taskA, 100);
+    for (fakeNow = 0; fakeNow < 1000; fakeNow += 10) {
+        scheduler.runPending();
+    }
+    TEST_ASSERT_EQUAL_UINT(10, runsA);
+}
+
+void test_one_shot_runs_once_and_frees_slot()
+{
+    int id = scheduler.addOneShot("b", taskB, 50);
+    fakeNow = 49;
+    TEST_ASSERT_EQUAL_UINT(0, scheduler.runPending());
+    fakeNow = 50;
+    TEST_ASSERT_EQUAL_UINT(1, scheduler.runPending());
+    fakeNow = 500;
+    scheduler.runPending();
+    TEST_ASSERT_EQUAL_UINT(1, runsB);
+    TEST_ASSERT_FALSE(scheduler.isActive(id));
+    TEST_ASSERT_EQUAL_INT(id, scheduler.addOneShot("b", taskB, 0));
+}
+
+void test_earliest_deadline_runs_first()
+{
+    scheduler.addOneShot("b", taskB, 20);
+    scheduler.addOneShot("a", taskA, 10);
+    fakeNow = 30;
+    scheduler.runPending();
+    TEST_ASSERT_EQUAL_STRING("AB", order);
+}
+
+void test_missed_periods_are_counted_without_burst()
+{
+    int id = scheduler.addPeriodic("a", taskA, 100);
+    scheduler.runPending();
+    fakeNow = 450;  // Deadlines 100, 200, 300, 400 verpasst
+    scheduler.runPending();
+    scheduler.runPending();
+    TEST_ASSERT_EQUAL_UINT(2, runsA);
+    TEST_ASSERT_EQUAL_UINT32(3, scheduler.stats(id).missedDeadlines);
+    TEST_ASSERT_EQUAL_UINT32(350, scheduler.stats(id).maxLateness);
+    TEST_ASSERT_EQUAL_UINT32(50, scheduler.timeUntilNext(1000));
+}
+
+void test_overrun_is_counted_against_budget()
+{
+    int id = scheduler.addPeriodic("a", taskA, 100, 0, 20);
+    taskDuration = 30;
+    scheduler.runPending();
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.stats(id).overruns);
+    TEST_ASSERT_EQUAL_UINT32(30, scheduler.stats(id).maxDuration);
+}
+
+void test_cancel_and_reschedule()
+{
+    int a = scheduler.addPeriodic("a", taskA, 100);
+    int b = scheduler.addOneShot("b", taskB, 100);
+    scheduler.cancel(a);
+    scheduler.reschedule(b, 300);
+    fakeNow = 200;
+    scheduler.runPending();
+    TEST_ASSERT_EQUAL_UINT(0, runsA);
+    TEST_ASSERT_EQUAL_UINT(0, runsB);
+    TEST_ASSERT_EQUAL_UINT32(100, scheduler.timeUntilNext(1000));
+    fakeNow = 300;
+    scheduler.runPending();
+    TEST_ASSERT_EQUAL_UINT(1, runsB);
+}
+
+void test_capacity_is_bounded()
+{
+    for (std::size_t i = 0; i < Scheduler::MaxTasks; i++) {
+        TEST_ASSERT_NOT_EQUAL(Scheduler::InvalidTask, scheduler.addPeriodic("a", taskA, 100));
+    }
+    TEST_ASSERT_EQUAL_INT(Scheduler::InvalidTask, scheduler.addPeriodic("a", taskA, 100));
+}
+
+void test_deadline_survives_millis_overflow()
+{
+    fakeNow = static_cast<unsigned long>(-50);
+    scheduler.addPeriodic("a", taskA, 100);
+    scheduler.runPending();
+    fakeNow += 100;     // läuft über
+    scheduler.runPending();
+    TEST_ASSERT_EQUAL_UINT(2, runsA);
+}
+
+void test_periodic_task_replaced_from_inside_keeps_successor()
+{
+    selfId = scheduler.addPeriodic("a", taskA, 100);
+    scheduler.cancel(selfId);
+    selfId = scheduler.addPeriodic("a", selfReplacingTask, 100, 0, 10);
+    taskDuration = 50;  // Budget überschritten, darf aber nicht beim Nachfolger landen
+    scheduler.runPending();
+    TEST_ASSERT_EQUAL_UINT(1, runsA);
+    TEST_ASSERT_EQUAL_INT(0, successorId);  // derselbe Slot
+    TEST_ASSERT_TRUE(scheduler.isActive(successorId));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.stats(successorId).runs);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.stats(successorId).overruns);
+    TEST_ASSERT_EQUAL_UINT32(950, scheduler.timeUntilNext(5000));   // Deadline des Nachfolgers, nicht die Periode
+
+    fakeNow = 999;      // Deadline ab dem Zeitpunkt des Anlegens, nicht nach der Laufzeit
+    scheduler.runPending();
+    TEST_ASSERT_EQUAL_UINT(1, runsA);
+    TEST_ASSERT_EQUAL_UINT(0, runsB);
+    fakeNow = 1000;
+    scheduler.runPending();
+    TEST_ASSERT_EQUAL_UINT(1, runsB);
+    TEST_ASSERT_FALSE(scheduler.isActive(successorId));
+}
+
+void test_one_shot_replaced_from_inside_keeps_successor()
+{
+    selfId = scheduler.addOneShot("a", selfReplacingTask, 0);
+    scheduler.runPending();
+    TEST_ASSERT_EQUAL_INT(0, successorId);
+    TEST_ASSERT_TRUE(scheduler.isActive(successorId));     // nicht durch das Ende der Einmal-Aufgabe deaktiviert
+    fakeNow = 1000;
+    scheduler.runPending();
+    TEST_ASSERT_EQUAL_UINT(1, runsB);
+}
+
+void test_stale_id_refers_to_reused_slot()
+{
+    int old = scheduler.addOneShot("a", taskA, 0);
+    scheduler.runPending();
+    int fresh = scheduler.addPeriodic("b", taskB, 100);
+    TEST_ASSERT_EQUAL_INT(old, fresh);
+    // Gleiche ID: ein cancel() mit der alten ID träfe die neue Aufgabe, daher IDs nach cancel()
+    // und nach dem Lauf einer Einmal-Aufgabe auf InvalidTask setzen; das ist ein No-op
+    scheduler.cancel(Scheduler::InvalidTask);
+    TEST_ASSERT_TRUE(scheduler.isActive(fresh));
+}
+
+/**
+ * @brief Simuliert eine Stunde mit den Aufgaben aus main.cpp und berichtet Jitter und verpasste Deadlines.
+ */
+void test_jitter_and_missed_deadlines_report()
+{
+    struct Load
+    {
+        const char *name;
+        unsigned long period;
+        unsigned long duration;
+        unsigned long everyNth;     // jede n-te Ausführung dauert 10-mal so lange (z.B. SD-Flush)
+        unsigned long count;
+    };
+    static Load loads[] = {
+        {"sensors", 1000, 3, 0, 0},
+        {"display", 100, 8, 0, 0},
+        {"wifi", 500, 1, 20, 0},
+        {"logflush", 60000, 40, 0, 0},
+        {"uplink", 5000, 12, 4, 0},
+    };
+    struct Runner
+    {
+        static void run(Load &load)
+        {
+            load.count++;
+            fakeNow += load.everyNth && load.count % load.everyNth == 0 ? 10 * load.duration : load.duration;
+        }
+        static void sensors() { run(loads[0]); }
+        static void display() { run(loads[1]); }
+        static void wifi() { run(loads[2]); }
+        static void logflush() { run(loads[3]); }
+        static void uplink() { run(loads[4]); }
+    };
+    Scheduler::TaskFunction functions[] = {Runner::sensors, Runner::display, Runner::wifi, Runner::logflush,
+                                           Runner::uplink};
+    int ids[5];
+    for (int i = 0; i < 5; i++) {
+        ids[i] = scheduler.addPeriodic(loads[i].name, functions[i], loads[i].period, 0, 2 * loads[i].duration);
+    }
+
+    const unsigned long duration = 3600000UL;
+    while (fakeNow < duration) {
+        scheduler.runPending();
+        fakeNow += scheduler.timeUntilNext(10);   // wie loop(): bis zur nächsten Deadline warten
+    }
+
+    char line[96];
+    for (int i = 0; i < 5; i++) {
+        const Scheduler::TaskStats &stats = scheduler.stats(ids[i]);
+        std::snprintf(line, sizeof(line), "%-8s runs %6lu  jitter avg %4lu max %4lu ms  missed %lu  overruns %lu",
+                      loads[i].name, static_cast<unsigned long>(stats.runs),
+                      stats.runs ? stats.totalLateness / stats.runs : 0UL, stats.maxLateness,
+                      static_cast<unsigned long>(stats.missedDeadlines), static_cast<unsigned long>(stats.overruns));
+        TEST_MESSAGE(line);
+        // Keine Aufgabe blockiert die anderen länger als die längste Einzellaufzeit (uplink 120 ms)
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(200, stats.maxLateness);
+        TEST_ASSERT_EQUAL_UINT32(duration / loads[i].period, stats.runs + stats.missedDeadlines);
+        // Die langen Ausführungen verschieben Starts, aber keine Aufgabe verliert eine ganze Periode
+        TEST_ASSERT_EQUAL_UINT32(0, stats.missedDeadlines);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_periodic_task_runs_once_per_period);
+    RUN_TEST(test_one_shot_runs_once_and_frees_slot);
+    RUN_TEST(test_earliest_deadline_runs_first);
+    RUN_TEST(test_missed_periods_are_counted_without_burst);
+    RUN_TEST(test_overrun_is_counted_against_budget);
+    RUN_TEST(test_cancel_and_reschedule);
+    RUN_TEST(test_capacity_is_bounded);
+    RUN_TEST(test_deadline_survives_millis_overflow);
+    RUN_TEST(test_periodic_task_replaced_from_inside_keeps_successor);
+    RUN_TEST(test_one_shot_replaced_from_inside_keeps_successor);
+    RUN_TEST(test_stale_id_refers_to_reused_slot);
+    RUN_TEST(test_jitter_and_missed_deadlines_report);
+    return UNITY_END();
+}
@@ -0,0 +1,327 @@
+// Tests für das Binärformat und den gepufferten SD-Logger (pio test -e native -f test_sd_logger)
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+#include "fake_sd.hpp"
+#include "sd_logger.hpp"
+
+namespace {
+
+samplelog::Record makeRecord(std::uint32_t i)
+{
+    samplelog::Record record;
+    record.unixTime = 1717243200 + 4 * i;
+    record.moisture = static_cast<std::uint16_t>(300 + i % 100);
+    record.temperature = static_cast<std::int16_t>(215 - static_cast<int>(i % 50));
+    record.humidity = 401;
+    return record;
+}
+
+/** @brief Liest alle Datensätze aus gültigen Blöcken der Datei. */
+std::vector<samplelog::Record> readAll(const std::vector<std::uint8_t> &bytes)
+{
+    std::vector<samplelog::Record> records;
+    for (std::size_t offset = samplelog::BlockSize; offset + samplelog::BlockSize <= bytes.size();
+         offset += samplelog::BlockSize) {
+        const std::uint8_t *block = bytes.data() + offset;
+        if (!samplelog::blockCrcValid(block)) {
+            continue;
+        }
+        for (std::size_t i = 0; i < samplelog::blockCount(block); i++) {
+            records.push_back(samplelog::readRecord(block, i));
+        }
+    }
+    return records;
+}
+
+fake::Sd sd;
+
+/**
+ * @brief Nachbildung des früheren logDataToCSV(): pro Messwert öffnen, mit File::print schreiben, schließen.
+ *
+ * Die Schreibzugriffe entsprechen Arduinos Print: Zahlen und Texte je ein write(), Gleitkommazahlen
+ * ganzzahliger Teil, Punkt und jede Nachkommastelle einzeln, println() ein weiteres write() für "\r\n".
+ */
+class LegacyCsv
+{
+private:
+    fake::File file;
+
+    void print(const char *text) { this->file.write(reinterpret_cast<const std::uint8_t *>(text), std::strlen(text)); }
+
+    void print(unsigned long value)
+    {
+        char digits[12];
+        std::snprintf(digits, sizeof(digits), "%lu", value);
+        this->print(digits);
+    }
+
+    void print(float value)
+    {
+        if (value < 0) {
+            this->print("-");
+            value = -value;
+        }
+        value += 0.005f;    // Rundung auf 2 Stellen wie Print::printFloat
+        unsigned long integer = static_cast<unsigned long>(value);
+        this->print(integer);
+        this->print(".");
+        float remainder = value - static_cast<float>(integer);
+        for (int i = 0; i < 2; i++) {
+            remainder *= 10.0f;
+            unsigned long digit = static_cast<unsigned long>(remainder);
+            this->print(digit);
+            remainder -= static_cast<float>(digit);
+        }
+    }
+
+public:
+    void log(fake::Sd &card, const samplelog::Record &record)
+    {
+        this->file = card.open("sensors.csv", O_READ | O_WRITE | O_CREAT);   // FILE_WRITE: anhängen
+        this->file.seek(this->file.size());
+        char time[16];
+        std::uint32_t seconds = record.unixTime % 86400;
+        std::snprintf(time, sizeof(time), "%02lu:%02lu:%02lu", static_cast<unsigned long>(seconds / 3600),
+                      static_cast<unsigned long>(seconds / 60 % 60), static_cast<unsigned long>(seconds % 60));
+        this->print(time);
+        this->print(",");
+        this->print(static_cast<unsigned long>(record.moisture));
+        this->print(",");
+        this->print(record.temperature / 10.0f);
+        this->print(",");
+        this->print(record.humidity / 10.0f);
+        this->print("\r\n");
+        this->file.close();
+    }
+};
+
+} // namespace
+
+void setUp()
+{
+    sd = fake::Sd();
+}
+
+void tearDown() {}
+
+void test_file_header_round_trip()
+{
+    std::uint8_t sector[samplelog::BlockSize];
+    samplelog::encodeFileHeader(sector, 1717243200);
+    samplelog::FileHeader header;
+    TEST_ASSERT_TRUE(samplelog::decodeFileHeader(sector, header));
+    TEST_ASSERT_EQUAL_UINT32(1717243200, header.createdUnixTime);
+    TEST_ASSERT_EQUAL_UINT16(samplelog::RecordsPerBlock, header.recordsPerBlock);
+    sector[20] ^= 1;
+    TEST_ASSERT_FALSE(samplelog::decodeFileHeader(sector, header));
+}
+
+void test_record_round_trip_and_block_crc()
+{
+    std::uint8_t block[samplelog::BlockSize];
+    samplelog::initBlock(block, 7);
+    samplelog::Record record = makeRecord(3);
+    record.temperature = -125;
+    samplelog::appendRecord(block, record);
+    samplelog::sealBlock(block);
+
+    TEST_ASSERT_EQUAL_UINT32(7, samplelog::blockIndex(block));
+    TEST_ASSERT_EQUAL_UINT16(1, samplelog::blockCount(block));
+    TEST_ASSERT_TRUE(samplelog::blockCrcValid(block));
+    samplelog::Record decoded = samplelog::readRecord(block, 0);
+    TEST_ASSERT_EQUAL_UINT32(record.unixTime, decoded.unixTime);
+    TEST_ASSERT_EQUAL_UINT16(record.moisture, decoded.moisture);
+    TEST_ASSERT_EQUAL_INT16(-125, decoded.temperature);
+    block[9] ^= 0x80;
+    TEST_ASSERT_FALSE(samplelog::blockCrcValid(block));
+}
+
+void test_to_tenths_rounds_and_saturates()
+{
+    TEST_ASSERT_EQUAL_INT16(215, samplelog::toTenths(21.54f));
+    TEST_ASSERT_EQUAL_INT16(-13, samplelog::toTenths(-1.26f));
+    TEST_ASSERT_EQUAL_INT16(32767, samplelog::toTenths(1e6f));
+    TEST_ASSERT_EQUAL_INT16(-32768, samplelog::toTenths(-1e6f));
+}
+
+void test_logger_writes_whole_sectors_only()
+{
+    SdLogger<fake::File> logger(60000);
+    TEST_ASSERT_TRUE(logger.begin(sd.open("sensors.bin", O_READ | O_WRITE | O_CREAT), 0, 1717243200));
+    for (std::uint32_t i = 0; i < 3 * samplelog::RecordsPerBlock + 7; i++) {
+        logger.append(makeRecord(i));
+    }
+    logger.flush();
+
+    TEST_ASSERT_EQUAL_UINT32(0, sd.counters().unalignedWrites);
+    TEST_ASSERT_EQUAL_UINT32(5, logger.writeCalls());     // Kopf, 3 volle Blöcke, 1 Teilblock
+    std::vector<samplelog::Record> records = readAll(sd.contents("sensors.bin"));
+    TEST_ASSERT_EQUAL_size_t(3 * samplelog::RecordsPerBlock + 7, records.size());
+    TEST_ASSERT_EQUAL_UINT32(makeRecord(100).unixTime, records[100].unixTime);
+}
+
+void test_time_threshold_flushes_partial_block()
+{
+    SdLogger<fake::File> logger(60000);
+    logger.begin(sd.open("sensors.bin", O_READ | O_WRITE | O_CREAT), 0, 0);
+    logger.append(makeRecord(0));
+    logger.poll(59999);
+    TEST_ASSERT_EQUAL_UINT32(1, logger.writeCalls());
+    logger.poll(60000);
+    TEST_ASSERT_EQUAL_UINT32(2, logger.writeCalls());
+    logger.poll(120000);    // nichts Neues, kein Schreibzugriff
+    TEST_ASSERT_EQUAL_UINT32(2, logger.writeCalls());
+}
+
+void test_resume_continues_partial_block_after_restart()
+{
+    {
+        SdLogger<fake::File> logger;
+        logger.begin(sd.open("sensors.bin", O_READ | O_WRITE | O_CREAT), 0, 0);
+        for (std::uint32_t i = 0; i < 10; i++) {
+            logger.append(makeRecord(i));
+        }
+        logger.flush();
+    }
+    SdLogger<fake::File> logger;
+    TEST_ASSERT_TRUE(logger.begin(sd.open("sensors.bin", O_READ | O_WRITE | O_CREAT), 0, 0));
+    for (std::uint32_t i = 10; i < 20; i++) {
+        logger.append(makeRecord(i));
+    }
+    logger.flush();
+
+    std::vector<std::uint8_t> bytes = sd.contents("sensors.bin");
+    TEST_ASSERT_EQUAL_size_t(2 * samplelog::BlockSize, bytes.size());
+    std::vector<samplelog::Record> records = readAll(bytes);
+    TEST_ASSERT_EQUAL_size_t(20, records.size());
+    TEST_ASSERT_EQUAL_UINT32(makeRecord(19).unixTime, records[19].unixTime);
+}
+
+void test_begin_rejects_foreign_file()
+{
+    fake::File file = sd.open("sensors.bin", O_READ | O_WRITE | O_CREAT);
+    std::uint8_t garbage[samplelog::BlockSize] = {'Z', 'e', 'i', 't'};
+    file.write(garbage, sizeof(garbage));
+    SdLogger<fake::File> logger;
+    TEST_ASSERT_FALSE(logger.begin(file, 0, 0));
+    TEST_ASSERT_FALSE(logger.append(makeRecord(0)));
+}
+
+void test_write_error_closes_logger_until_begin()
+{
+    SdLogger<fake::File> logger;
+    logger.begin(sd.open("sensors.bin", O_READ | O_WRITE | O_CREAT), 0, 0);
+    for (std::uint32_t i = 0; i + 1 < samplelog::RecordsPerBlock; i++) {
+        TEST_ASSERT_TRUE(logger.append(makeRecord(i)));
+    }
+    sd.setWritesFail(true);     // Karte entfernt
+    TEST_ASSERT_FALSE(logger.append(makeRecord(samplelog::RecordsPerBlock - 1)));
+    TEST_ASSERT_FALSE(logger.isOpen());
+    TEST_ASSERT_EQUAL_UINT32(1, logger.writeErrors());
+    TEST_ASSERT_FALSE(logger.append(makeRecord(0)));
+
+    sd.setWritesFail(false);
+    TEST_ASSERT_TRUE(logger.begin(sd.open("sensors.bin", O_READ | O_WRITE | O_CREAT), 0, 0));
+    TEST_ASSERT_TRUE(logger.append(makeRecord(100)));
+    logger.flush();
+    std::vector<samplelog::Record> records = readAll(sd.contents("sensors.bin"));
+    TEST_ASSERT_EQUAL_size_t(1, records.size());
+    TEST_ASSERT_EQUAL_UINT32(makeRecord(100).unixTime, records[0].unixTime);
+}
+
+void test_failed_header_write_fails_begin()
+{
+    sd.cutPowerAfter(100);
+    SdLogger<fake::File> logger;
+    TEST_ASSERT_FALSE(logger.begin(sd.open("sensors.bin", O_READ | O_WRITE | O_CREAT), 0, 0));
+    TEST_ASSERT_FALSE(logger.isOpen());
+    TEST_ASSERT_EQUAL_UINT32(1, logger.writeErrors());
+}
+
+void test_rows_per_second_and_writes_per_row_report()
+{
+    const std::uint32_t rows = 100000;     // rund 4,6 Tage bei einem Messwert alle 4 s
+    SdLogger<fake::File> logger(60000);
+    logger.begin(sd.open("sensors.bin", O_READ | O_WRITE | O_CREAT), 0, 1717243200);
+    sd.resetCounters();
+
+    auto started = std::chrono::steady_clock::now();
+    for (std::uint32_t i = 0; i < rows; i++) {
+        logger.append(makeRecord(i));
+        logger.poll(4000UL * i);    // Zeitschwelle wie im Betrieb
+    }
+    logger.flush();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    std::uint32_t writes = sd.counters().writeCalls;
+    double writesPerRow = static_cast<double>(writes) / rows;
+    char line[128];
+    std::snprintf(line, sizeof(line), "%lu Zeilen: %.0f Zeilen/s, %lu Schreibzugriffe, %.4f pro Zeile, %lu geöffnet",
+                  static_cast<unsigned long>(rows), seconds > 0 ? rows / seconds : 0.0,
+                  static_cast<unsigned long>(writes), writesPerRow, static_cast<unsigned long>(sd.counters().opens));
+    TEST_MESSAGE(line);
+    // Volle Blöcke plus ein Teilblock je Minute, nie mehr als ein Zugriff pro Zeile
+    TEST_ASSERT_EQUAL_UINT32(0, sd.counters().unalignedWrites);
+    TEST_ASSERT_EQUAL_UINT32(0, sd.counters().opens);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(rows / samplelog::RecordsPerBlock + rows * 4 / 60 + 1, writes);
+    TEST_ASSERT_EQUAL_size_t(rows, readAll(sd.contents("sensors.bin")).size());
+}
+
+void test_binary_log_against_legacy_csv_report()
+{
+    const std::uint32_t rows = 10000;
+    LegacyCsv legacy;
+    for (std::uint32_t i = 0; i < rows; i++) {
+        legacy.log(sd, makeRecord(i));
+    }
+    fake::SdCounters csv = sd.counters();
+    std::size_t csvBytes = sd.contents("sensors.csv").size();
+    TEST_ASSERT_EQUAL_STRING_LEN("12:00:00,300,21.50,40.10\r\n",
+                                 reinterpret_cast<const char *>(sd.contents("sensors.csv").data()), 26);
+
+    sd.resetCounters();
+    SdLogger<fake::File> logger(60000);
+    logger.begin(sd.open("sensors.bin", O_READ | O_WRITE | O_CREAT), 0, 1717243200);
+    for (std::uint32_t i = 0; i < rows; i++) {
+        logger.append(makeRecord(i));
+        logger.poll(4000UL * i);
+    }
+    logger.flush();
+    fake::SdCounters binary = sd.counters();
+    std::size_t binaryBytes = sd.contents("sensors.bin").size();
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "CSV alt:  %.1f B/Zeile, %.2f write()/Zeile, %.2f open()/Zeile",
+                  static_cast<double>(csvBytes) / rows, static_cast<double>(csv.writeCalls) / rows,
+                  static_cast<double>(csv.opens) / rows);
+    TEST_MESSAGE(line);
+    std::snprintf(line, sizeof(line), "Binär:    %.1f B/Zeile, %.3f write()/Zeile, %.4f open()/Zeile",
+                  static_cast<double>(binaryBytes) / rows, static_cast<double>(binary.writeCalls) / rows,
+                  static_cast<double>(binary.opens) / rows);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_EQUAL_UINT32(14 * rows, csv.writeCalls);    // 6 Texte, 2 x 4 für die Gleitkommazahlen
+    TEST_ASSERT_EQUAL_UINT32(rows, csv.opens);
+    TEST_ASSERT_LESS_THAN_UINT32(csv.writeCalls / 100, binary.writeCalls);
+    TEST_ASSERT_LESS_THAN(csvBytes, binaryBytes);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_file_header_round_trip);
+    RUN_TEST(test_record_round_trip_and_block_crc);
+    RUN_TEST(test_to_tenths_rounds_and_saturates);
+    RUN_TEST(test_logger_writes_whole_sectors_only);
+    RUN_TEST(test_time_threshold_flushes_partial_block);
+    RUN_TEST(test_resume_continues_partial_block_after_restart);
+    RUN_TEST(test_begin_rejects_foreign_file);
+    RUN_TEST(test_write_error_closes_logger_until_begin);
+    RUN_TEST(test_failed_header_write_fails_begin);
+    RUN_TEST(test_rows_per_second_and_writes_per_row_report);
+    RUN_TEST(test_binary_log_against_legacy_csv_report);
+    return UNITY_END();
+}
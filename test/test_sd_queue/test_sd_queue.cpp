@@ -0,0 +1,285 @@
+// Tests für die Telemetrie-Warteschlange auf der SD-Karte (pio test -e native -f test_sd_queue)
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <unity.h>
+#include "fake_sd.hpp"
+#include "sd_queue.hpp"
+
+namespace {
+
+typedef SdQueue<fake::Sd, fake::File> Queue;
+
+constexpr std::uint8_t WriteMode = O_READ | O_WRITE | O_CREAT;
+
+telemetry::Entry sample(std::uint32_t i)
+{
+    samplelog::Record record = {};
+    record.unixTime = 1717243200 + i;
+    record.moisture = static_cast<std::uint16_t>(i);
+    return telemetry::sampleEntry(record);
+}
+
+/** @brief Liest und entfernt bis zu max Einträge; liefert die Anzahl. */
+std::size_t drain(Queue &queue, std::uint32_t *firstTime, std::size_t max = Queue::MaxPeek)
+{
+    telemetry::Entry entries[Queue::MaxPeek];
+    std::size_t n = queue.peek(entries, max);
+    if (n > 0 && firstTime != nullptr) {
+        *firstTime = entries[0].sample.unixTime;
+    }
+    queue.consume(n);
+    return n;
+}
+
+fake::Sd sd;
+
+} // namespace
+
+void setUp()
+{
+    sd = fake::Sd();
+}
+
+void tearDown() {}
+
+void test_entries_come_back_in_order()
+{
+    Queue queue(sd, "/queue", WriteMode, O_READ);
+    TEST_ASSERT_TRUE(queue.begin(0));
+    for (std::uint32_t i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(queue.push(sample(i)));
+    }
+    queue.push(telemetry::eventEntry(1717243300, "pump_on", 12));
+    TEST_ASSERT_EQUAL_UINT32(11, queue.pending());
+
+    telemetry::Entry entries[16];
+    TEST_ASSERT_EQUAL_size_t(11, queue.peek(entries, 16));
+    for (std::uint32_t i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL_UINT16(i, entries[i].sample.moisture);
+    }
+    TEST_ASSERT_TRUE(entries[10].type == telemetry::EntryType::Event);
+    TEST_ASSERT_EQUAL_STRING("pump_on", entries[10].event);
+    TEST_ASSERT_EQUAL_INT32(12, entries[10].value);
+
+    queue.consume(4);
+    TEST_ASSERT_EQUAL_UINT32(7, queue.pending());
+    TEST_ASSERT_EQUAL_size_t(7, queue.peek(entries, 16));
+    TEST_ASSERT_EQUAL_UINT16(4, entries[0].sample.moisture);
+}
+
+void test_backlog_survives_restart()
+{
+    {
+        Queue queue(sd, "/queue", WriteMode, O_READ);
+        queue.begin(0);
+        for (std::uint32_t i = 0; i < 20; i++) {
+            queue.push(sample(i));
+        }
+        std::uint32_t first = 0;
+        drain(queue, &first, 5);
+        queue.close();
+    }
+    Queue queue(sd, "/queue", WriteMode, O_READ);
+    TEST_ASSERT_TRUE(queue.begin(0));
+    TEST_ASSERT_EQUAL_UINT32(15, queue.pending());
+    std::uint32_t first = 0;
+    TEST_ASSERT_EQUAL_size_t(15, drain(queue, &first));
+    TEST_ASSERT_EQUAL_UINT32(sample(5).sample.unixTime, first);
+    queue.push(sample(20));
+    TEST_ASSERT_EQUAL_size_t(1, drain(queue, &first));
+    TEST_ASSERT_EQUAL_UINT32(sample(20).sample.unixTime, first);
+}
+
+void test_consumed_segments_are_removed()
+{
+    Queue queue(sd, "/queue", WriteMode, O_READ, 256, 16);
+    queue.begin(0);
+    for (std::uint32_t i = 0; i < 100; i++) {
+        queue.push(sample(i));
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(4, queue.segments());
+    while (drain(queue, nullptr) > 0) {
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, queue.pending());
+    TEST_ASSERT_EQUAL_UINT32(1, queue.segments());
+    TEST_ASSERT_EQUAL_size_t(2, sd.fileCount());      // commit.dat und das aktuelle Segment
+}
+
+void test_oldest_segment_is_dropped_when_full()
+{
+    Queue queue(sd, "/queue", WriteMode, O_READ, 256, 4);
+    queue.begin(0);
+    for (std::uint32_t i = 0; i < 200; i++) {
+        queue.push(sample(i));
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(4, queue.segments());
+    TEST_ASSERT_GREATER_THAN_UINT32(0, queue.stats().dropped);
+    TEST_ASSERT_EQUAL_UINT32(200, queue.pending() + queue.stats().dropped);
+
+    std::uint32_t first = 0;
+    drain(queue, &first);
+    TEST_ASSERT_EQUAL_UINT32(sample(queue.stats().dropped).sample.unixTime, first);
+}
+
+void test_write_error_closes_queue()
+{
+    Queue queue(sd, "/queue", WriteMode, O_READ);
+    queue.begin(0);
+    sd.setWritesFail(true);
+    TEST_ASSERT_FALSE(queue.push(sample(0)));
+    TEST_ASSERT_FALSE(queue.isOpen());
+    TEST_ASSERT_EQUAL_UINT32(1, queue.stats().writeErrors);
+    sd.setWritesFail(false);
+    TEST_ASSERT_TRUE(queue.begin(0));
+}
+
+void test_corrupt_record_is_counted_once_on_consume()
+{
+    Queue queue(sd, "/queue", WriteMode, O_READ, 256, 16);
+    queue.begin(0);
+    queue.push(sample(0));
+    std::uint32_t recordSize = queue.writePosition().offset;
+    for (std::uint32_t i = 1; i < 40; i++) {
+        queue.push(sample(i));
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(2, queue.segments());
+    std::uint32_t perSegment = 256 / recordSize;
+    sd.corrupt("/queue/00000002.seg", 2 * recordSize + Queue::HeaderSize, 0xFF);   // dritter Datensatz
+
+    telemetry::Entry entries[Queue::MaxPeek];
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_size_t(2 + 40 - perSegment, queue.peek(entries, Queue::MaxPeek));
+        TEST_ASSERT_EQUAL_UINT32(0, queue.stats().dropped);     // peek() allein zählt nichts
+    }
+    TEST_ASSERT_EQUAL_UINT16(perSegment, entries[2].sample.moisture);
+    queue.consume(3);
+    TEST_ASSERT_EQUAL_UINT32(perSegment - 2, queue.stats().dropped);
+    queue.peek(entries, Queue::MaxPeek);
+    queue.consume(0);
+    TEST_ASSERT_EQUAL_UINT32(perSegment - 2, queue.stats().dropped);
+    TEST_ASSERT_EQUAL_UINT32(40 - perSegment - 1, queue.pending());
+}
+
+/**
+ * @brief Zufällige Stromausfälle beim Anhängen und Committen; nach jedem Neustart wird weitergemacht.
+ *
+ * Jeder mit true angenommene Eintrag muss am Ende in Reihenfolge angekommen sein. Commits, die nach
+ * dem Ausfall nicht mehr geschrieben wurden, liefern die Einträge nach dem Neustart erneut
+ * (mindestens einmal), danach geht es ohne Lücke weiter.
+ */
+void test_random_power_cuts_lose_no_accepted_entry()
+{
+    std::mt19937 random(20240601);
+    std::set<std::uint32_t> accepted;
+    std::set<std::uint32_t> delivered;
+    std::uint32_t next = 0;
+    std::uint32_t lastDelivered = 0;
+    unsigned int reboots = 0;
+    unsigned int duplicates = 0;
+    unsigned int rejected = 0;
+
+    for (int run = 0; run < 300; run++) {
+        Queue queue(sd, "/queue", WriteMode, O_READ, 512, 1024);
+        TEST_ASSERT_TRUE(queue.begin(0));
+        bool rebooted = run > 0;
+        sd.cutPowerAfter(std::uniform_int_distribution<int>(0, 600)(random));
+        for (int step = 0; step < 50; step++) {
+            if (random() % 3 != 0) {
+                if (queue.push(sample(next))) {
+                    accepted.insert(next);
+                } else {
+                    rejected++;
+                }
+                next++;
+                if (!queue.isOpen()) {
+                    break;
+                }
+            } else {
+                telemetry::Entry entries[Queue::MaxPeek];
+                std::size_t n = queue.peek(entries, random() % 8 + 1);
+                for (std::size_t i = 0; i < n; i++) {
+                    std::uint32_t id = entries[i].sample.unixTime - sample(0).sample.unixTime;
+                    if (delivered.count(id) > 0) {
+                        TEST_ASSERT_TRUE(rebooted);     // Wiederholung nur nach einem Neustart
+                        duplicates++;
+                    } else {
+                        TEST_ASSERT_TRUE(delivered.empty() || id > lastDelivered);
+                        lastDelivered = id;
+                        delivered.insert(id);
+                        rebooted = false;
+                    }
+                }
+                queue.consume(n);
+            }
+        }
+        // Stromausfall: Objekte verwerfen, die Karte bleibt
+        sd.restorePower();
+        reboots++;
+    }
+
+    Queue queue(sd, "/queue", WriteMode, O_READ, 512, 1024);
+    TEST_ASSERT_TRUE(queue.begin(0));
+    telemetry::Entry entries[Queue::MaxPeek];
+    for (std::size_t n; (n = queue.peek(entries, Queue::MaxPeek)) > 0; queue.consume(n)) {
+        for (std::size_t i = 0; i < n; i++) {
+            delivered.insert(entries[i].sample.unixTime - sample(0).sample.unixTime);
+        }
+    }
+    for (std::uint32_t id : accepted) {
+        TEST_ASSERT_TRUE(delivered.count(id) > 0);
+    }
+    TEST_ASSERT_TRUE(delivered.size() <= accepted.size() + rejected);
+
+    char line[96];
+    std::snprintf(line, sizeof(line), "%u Neustarts: %u angenommen, %u abgelehnt, %u doppelt geliefert",
+                  reboots, static_cast<unsigned int>(accepted.size()), rejected, duplicates);
+    TEST_MESSAGE(line);
+}
+
+void test_replay_throughput_report()
+{
+    Queue queue(sd, "/queue", WriteMode, O_READ);
+    queue.begin(0);
+    const std::uint32_t count = 20000;     // etwa 22 h Messwerte alle 4 s
+    for (std::uint32_t i = 0; i < count; i++) {
+        queue.push(sample(i));
+    }
+    queue.flush(0);
+    sd.resetCounters();
+
+    auto started = std::chrono::steady_clock::now();
+    std::uint32_t expected = 0;
+    std::uint32_t batches = 0;
+    telemetry::Entry entries[48];
+    for (std::size_t n; (n = queue.peek(entries, 48)) > 0; queue.consume(n)) {
+        TEST_ASSERT_EQUAL_UINT16(static_cast<std::uint16_t>(expected), entries[0].sample.moisture);
+        expected += static_cast<std::uint32_t>(n);
+        batches++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    TEST_ASSERT_EQUAL_UINT32(count, expected);
+    TEST_ASSERT_EQUAL_UINT32(batches, sd.counters().writeCalls);   // ein Commit-Slot pro Batch
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "%lu Einträge in %lu Batches: %.0f Einträge/s, %.2f Schreibzugriffe/Batch",
+                  static_cast<unsigned long>(count), static_cast<unsigned long>(batches),
+                  seconds > 0 ? count / seconds : 0.0, static_cast<double>(sd.counters().writeCalls) / batches);
+    TEST_MESSAGE(line);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_entries_come_back_in_order);
+    RUN_TEST(test_backlog_survives_restart);
+    RUN_TEST(test_consumed_segments_are_removed);
+    RUN_TEST(test_oldest_segment_is_dropped_when_full);
+    RUN_TEST(test_write_error_closes_queue);
+    RUN_TEST(test_corrupt_record_is_counted_once_on_consume);
+    RUN_TEST(test_random_power_cuts_lose_no_accepted_entry);
+    RUN_TEST(test_replay_throughput_report);
+    return UNITY_END();
+}
@@ -0,0 +1,130 @@
+// Tests für die zentrale Sensorabfrage mit simulierter Uhr (pio test -e native -f test_sensor_sampler)
+
+#include <unity.h>
+#include "sensor_sampler.hpp"
+
+namespace {
+
+unsigned long fakeNow = 0;
+unsigned int moistureReads = 0;
+unsigned int climateReads = 0;
+unsigned long lastRead = 0;
+unsigned long minInterval = 0;
+
+void readSensors(Sample &sample)
+{
+    if (moistureReads > 0 && fakeNow - lastRead < minInterval) {
+        minInterval = fakeNow - lastRead;
+    }
+    lastRead = fakeNow;
+    moistureReads++;
+    sample.moisture = 300 + static_cast<int>(moistureReads);
+    climateReads++;     // DHT: langsam, darf nur einmal pro Periode laufen
+    sample.temperature = 21.5f;
+    sample.humidity = 40.0f;
+    sample.climateValid = true;
+}
+
+int handlerCalls[3] = {};
+int seenMoisture[3] = {};
+
+void relay(const Sample &sample)
+{
+    handlerCalls[0]++;
+    seenMoisture[0] = sample.moisture;
+}
+
+void display(const Sample &sample)
+{
+    handlerCalls[1]++;
+    seenMoisture[1] = sample.moisture;
+}
+
+void logger(const Sample &sample)
+{
+    handlerCalls[2]++;
+    seenMoisture[2] = sample.moisture;
+}
+
+} // namespace
+
+void setUp()
+{
+    fakeNow = 0;
+    moistureReads = 0;
+    climateReads = 0;
+    lastRead = 0;
+    minInterval = static_cast<unsigned long>(-1);
+    for (int i = 0; i < 3; i++) {
+        handlerCalls[i] = 0;
+        seenMoisture[i] = 0;
+    }
+}
+
+void tearDown() {}
+
+void test_each_sensor_read_once_per_period()
+{
+    SensorSampler sampler(readSensors, 4000);
+    sampler.subscribe(relay);
+    sampler.subscribe(display);
+    sampler.subscribe(logger);
+    // Eine Stunde; Anzeige, Relais und Logger fragen jede Millisekunde nach
+    for (fakeNow = 0; fakeNow < 3600000UL; fakeNow++) {
+        sampler.poll(fakeNow);
+    }
+    TEST_ASSERT_EQUAL_UINT(900, moistureReads);
+    TEST_ASSERT_EQUAL_UINT(900, climateReads);
+    TEST_ASSERT_EQUAL_UINT32(900, sampler.samplesTaken());
+    TEST_ASSERT_EQUAL_UINT32(4000, minInterval);
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_INT(900, handlerCalls[i]);
+        TEST_ASSERT_EQUAL_INT(sampler.latest().moisture, seenMoisture[i]);   // alle sehen denselben Wert
+    }
+}
+
+void test_irregular_polling_never_reads_twice_per_period()
+{
+    SensorSampler sampler(readSensors, 4000);
+    unsigned long steps[] = {3, 250, 17, 1999, 1, 4001, 60};
+    unsigned int polls = 0;
+    for (fakeNow = 0; fakeNow < 3600000UL; fakeNow += steps[polls++ % 7]) {
+        sampler.poll(fakeNow);
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(4000, minInterval);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(900, moistureReads);
+    TEST_ASSERT_EQUAL_UINT(moistureReads, climateReads);
+    TEST_ASSERT_GREATER_THAN_UINT32(polls / 100, polls - moistureReads);   // fast alle Abfragen aus dem Cache
+}
+
+void test_sample_now_restarts_period()
+{
+    SensorSampler sampler(readSensors, 4000);
+    TEST_ASSERT_TRUE(sampler.poll(0));
+    fakeNow = 1000;
+    sampler.sampleNow(fakeNow);     // z.B. Tastendruck
+    TEST_ASSERT_FALSE(sampler.poll(4999));
+    TEST_ASSERT_TRUE(sampler.poll(5000));
+    TEST_ASSERT_EQUAL_UINT(3, moistureReads);
+    TEST_ASSERT_EQUAL_UINT32(5000, sampler.latest().timestamp);
+}
+
+void test_period_survives_millis_overflow()
+{
+    SensorSampler sampler(readSensors, 4000);
+    unsigned long start = static_cast<unsigned long>(-2000);
+    sampler.poll(start);
+    TEST_ASSERT_FALSE(sampler.poll(start + 3999));
+    TEST_ASSERT_TRUE(sampler.poll(start + 4000));   // läuft über
+    TEST_ASSERT_EQUAL_UINT(2, moistureReads);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_each_sensor_read_once_per_period);
+    RUN_TEST(test_irregular_polling_never_reads_twice_per_period);
+    RUN_TEST(test_sample_now_restarts_period);
+    RUN_TEST(test_period_survives_millis_overflow);
+    return UNITY_END();
+}
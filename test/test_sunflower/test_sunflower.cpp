@@ -0,0 +1,201 @@
+// Tests für die Sonnenblume: SPI-Last eines Stimmungswechsels mit und ohne Sprites (pio test -e native -f test_sunflower)
+
+#include <cstdio>
+#include <vector>
+#include <unity.h>
+#include "sunflower.hpp"
+
+namespace {
+
+constexpr std::uint16_t Black = 0x0000;
+constexpr std::uint16_t Green = 0x07E0;
+constexpr std::uint16_t Yellow = 0xFFE0;
+constexpr std::uint16_t DarkOrange = 0xFCC0;
+
+/**
+ * @brief Bildspeicher mit der Zeichenschnittstelle von TFT_eSPI (Querformat 320x240); zählt Zeichenaufrufe und Pixel.
+ */
+class StubDisplay
+{
+protected:
+    int width;
+    int height;
+    std::vector<std::uint16_t> pixels;
+
+public:
+    std::uint32_t drawCalls = 0;
+    std::uint64_t pixelsWritten = 0;
+
+    StubDisplay(int width = 320, int height = 240) : width(width), height(height), pixels(width * height, 0) {}
+
+    /** @brief Ein Pixel im offenen Adressfenster, ohne eigenen Zeichenaufruf. */
+    void pushPixel(int x, int y, std::uint16_t color)
+    {
+        if (x >= 0 && y >= 0 && x < this->width && y < this->height) {
+            this->pixels[y * this->width + x] = color;
+            this->pixelsWritten++;
+        }
+    }
+
+
+    void fillRect(int x, int y, int w, int h, std::uint16_t color)
+    {
+        this->drawCalls++;
+        int x0 = x < 0 ? 0 : x;
+        int y0 = y < 0 ? 0 : y;
+        int x1 = x + w > this->width ? this->width : x + w;
+        int y1 = y + h > this->height ? this->height : y + h;
+        for (int row = y0; row < y1; row++) {
+            for (int column = x0; column < x1; column++) {
+                this->pixels[row * this->width + column] = color;
+            }
+        }
+        if (x1 > x0 && y1 > y0) {
+            this->pixelsWritten += static_cast<std::uint64_t>(x1 - x0) * (y1 - y0);
+        }
+    }
+
+    void fillScreen(std::uint16_t color) { this->fillRect(0, 0, this->width, this->height, color); }
+
+    void drawFastHLine(int x, int y, int w, std::uint16_t color) { this->fillRect(x, y, w, 1, color); }
+
+    /** @brief Zeilenweise wie TFT_eSPI, eine horizontale Linie je Bildzeile. */
+    void fillEllipse(int x, int y, int rx, int ry, std::uint16_t color)
+    {
+        for (int dy = -ry; dy <= ry; dy++) {
+            int span = 0;
+            while (static_cast<long>(span + 1) * (span + 1) * ry * ry + static_cast<long>(dy) * dy * rx * rx
+                   <= static_cast<long>(rx) * rx * ry * ry) {
+                span++;
+            }
+            this->fillRect(x - span, y + dy, 2 * span + 1, 1, color);
+        }
+    }
+
+    void fillCircle(int x, int y, int r, std::uint16_t color) { this->fillEllipse(x, y, r, r, color); }
+
+    std::uint16_t pixel(int x, int y) const { return this->pixels[y * this->width + x]; }
+
+    bool sameScreen(const StubDisplay &other) const { return this->pixels == other.pixels; }
+};
+
+/**
+ * @brief 4-Bit-Sprite: Pixel sind Palettenindizes, pushSprite() überträgt das Rechteck in einem Aufruf.
+ */
+class StubSprite : public StubDisplay
+{
+private:
+    StubDisplay &target;
+    std::uint16_t palette[16] = {};
+
+public:
+    explicit StubSprite(StubDisplay &target)
+        : StubDisplay(sunflower::MoodWidth, sunflower::MoodHeight), target(target)
+    {
+    }
+
+    void setPaletteColor(std::uint8_t index, std::uint16_t color) { this->palette[index & 0x0F] = color; }
+
+    void pushSprite(int x, int y)
+    {
+        for (int row = 0; row < this->height; row++) {
+            for (int column = 0; column < this->width; column++) {
+                this->target.pushPixel(x + column, y + row, this->palette[this->pixel(column, row) & 0x0F]);
+            }
+        }
+        this->target.drawCalls++;
+    }
+};
+
+/**
+ * @brief Übertragene Bytes auf dem SPI-Bus des ILI9341: pro Zeichenaufruf ein Adressfenster
+ *        (CASET, RASET, RAMWR: 3 Befehle und 8 Datenbytes), dann 2 Byte je Pixel (RGB565).
+ */
+std::uint64_t spiBytes(const StubDisplay &display)
+{
+    return display.drawCalls * 11ULL + display.pixelsWritten * 2;
+}
+
+void resetCounters(StubDisplay &display)
+{
+    display.drawCalls = 0;
+    display.pixelsWritten = 0;
+}
+
+/** @brief Vollständiges Neuzeichnen wie drawSunflower() in main.cpp. */
+void drawFull(StubDisplay &display, plant::Mood mood)
+{
+    display.fillScreen(Black);
+    sunflower::Colors colors = {Yellow, DarkOrange, Black};
+    sunflower::drawHead(display, 0, 0, mood, colors);
+    sunflower::drawStem(display, Green);
+}
+
+/** @brief Mundpartie als 4-Bit-Sprite wie renderMoodSprites() in main.cpp. */
+void renderSprite(StubSprite &sprite, plant::Mood mood)
+{
+    sprite.setPaletteColor(0, Black);
+    sprite.setPaletteColor(1, Yellow);
+    sprite.setPaletteColor(2, DarkOrange);
+    sprite.setPaletteColor(3, Black);
+    sprite.fillScreen(0);
+    sunflower::Colors colors = {1, 2, 3};
+    sunflower::drawHead(sprite, sunflower::MoodX, sunflower::MoodY, mood, colors);
+}
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_sprite_switch_matches_full_redraw()
+{
+    const plant::Mood moods[] = {plant::Mood::Sad, plant::Mood::Neutral, plant::Mood::Happy};
+    for (plant::Mood from : moods) {
+        for (plant::Mood to : moods) {
+            StubDisplay expected;
+            drawFull(expected, to);
+
+            StubDisplay actual;
+            drawFull(actual, from);
+            StubSprite sprite(actual);
+            renderSprite(sprite, to);
+            sprite.pushSprite(sunflower::MoodX, sunflower::MoodY);
+            TEST_ASSERT_TRUE(expected.sameScreen(actual));      // alle Unterschiede liegen im Sprite
+        }
+    }
+}
+
+void test_spi_bytes_per_mood_change_report()
+{
+    StubDisplay display;
+    drawFull(display, plant::Mood::Neutral);
+
+    resetCounters(display);
+    drawFull(display, plant::Mood::Happy);
+    std::uint64_t before = spiBytes(display);
+    std::uint32_t beforeCalls = display.drawCalls;
+
+    StubSprite sprite(display);
+    renderSprite(sprite, plant::Mood::Sad);
+    resetCounters(display);
+    sprite.pushSprite(sunflower::MoodX, sunflower::MoodY);
+    std::uint64_t after = spiBytes(display);
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "Stimmungswechsel: vorher %lu B in %lu Aufrufen, Sprite %lu B in %lu Aufruf",
+                  static_cast<unsigned long>(before), static_cast<unsigned long>(beforeCalls),
+                  static_cast<unsigned long>(after), static_cast<unsigned long>(display.drawCalls));
+    TEST_MESSAGE(line);
+    TEST_ASSERT_EQUAL_UINT64(11 + 2 * sunflower::MoodWidth * sunflower::MoodHeight, after);
+    TEST_ASSERT_GREATER_THAN(30 * after, before);   // ganzer Bildschirm (150 KB) gegen 5 KB
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sprite_switch_matches_full_redraw);
+    RUN_TEST(test_spi_bytes_per_mood_change_report);
+    return UNITY_END();
+}
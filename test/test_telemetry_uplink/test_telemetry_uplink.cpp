@@ -0,0 +1,275 @@
+// Tests für den Telemetrie-Uplink gegen einen nachgebildeten IoT-Hub-Broker (pio test -e native -f test_telemetry_uplink)
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unity.h>
+#include "telemetry_uplink.hpp"
+
+namespace {
+
+const char *const Host = "aqua.azure-devices.net";
+const char *const DeviceId = "wio-1";
+constexpr std::uint64_t ServerTime = 1717243200ULL;     // 1.6.2024 12:00 UTC
+
+/**
+ * @brief Broker wie der MQTT-Endpunkt des IoT Hubs, direkt hinter der PubSubClient-Schnittstelle.
+ *
+ * Prüft Client-ID, Benutzername und den Ablauf des SAS-Tokens gegen die eigene Uhr, lehnt
+ * abgelaufene Tokens ab und trennt eine Sitzung, sobald ihr Token abläuft.
+ */
+class FakeBroker
+{
+public:
+    std::uint64_t unixTime = ServerTime;    // Uhr des Brokers
+    bool reachable = true;
+    unsigned int connects = 0;
+    unsigned int rejected = 0;
+    unsigned int expiredSessions = 0;
+    std::uint64_t sessionExpiry = 0;
+    std::vector<std::string> topics;
+    std::vector<std::string> payloads;
+
+    bool connect(const char *id, const char *user, const char *password)
+    {
+        this->connects++;
+        this->session = false;
+        std::string expectedUser = std::string(Host) + "/" + DeviceId + "/?api-version=";
+        const char *se = std::strstr(password, "&se=");
+        if (!this->reachable || std::strcmp(id, DeviceId) != 0
+            || std::strncmp(user, expectedUser.c_str(), expectedUser.size()) != 0
+            || std::strncmp(password, "SharedAccessSignature sr=", 25) != 0 || se == nullptr) {
+            this->rejected++;
+            return false;
+        }
+        std::uint64_t expiry = std::strtoull(se + 4, nullptr, 10);
+        if (expiry <= this->unixTime) {
+            this->rejected++;   // CONNACK "not authorized"
+            return false;
+        }
+        this->sessionExpiry = expiry;
+        this->session = true;
+        return true;
+    }
+
+    bool connected()
+    {
+        if (this->session && this->unixTime >= this->sessionExpiry) {
+            this->session = false;
+            this->expiredSessions++;
+        }
+        return this->session && this->reachable;
+    }
+
+    bool publish(const char *topic, const std::uint8_t *payload, unsigned int length)
+    {
+        if (!this->connected()) {
+            return false;
+        }
+        this->topics.push_back(topic);
+        this->payloads.push_back(std::string(reinterpret_cast<const char *>(payload), length));
+        return true;
+    }
+
+    bool loop() { return this->connected(); }
+    void disconnect() { this->session = false; }
+
+private:
+    bool session = false;
+};
+
+bool fakePassword(const az_iot_hub_client *client, std::uint64_t expiry, char *password, std::size_t size)
+{
+    // Signatur wird vom Broker nicht geprüft, nur Format und Ablauf
+    return az_result_succeeded(az_iot_hub_client_sas_get_password(client, expiry, AZ_SPAN_FROM_STR("c2lnbmF0dXJl"),
+                                                                  AZ_SPAN_EMPTY, password, size, nullptr));
+}
+
+typedef telemetry::RamQueue<1024> Queue;
+typedef TelemetryUplink<FakeBroker, Queue> Uplink;
+
+FakeBroker broker;
+Queue queue;
+
+telemetry::Entry sample(std::uint32_t i)
+{
+    samplelog::Record record = {};
+    record.unixTime = static_cast<std::uint32_t>(ServerTime) + i;
+    record.moisture = static_cast<std::uint16_t>(300 + i);
+    record.temperature = -15;
+    record.humidity = 401;
+    return telemetry::sampleEntry(record);
+}
+
+/** @brief Zeilen in "rows" eines Payloads; first erhält den ersten Zeitstempel. */
+int countRows(const std::string &payload, std::int32_t *first)
+{
+    az_json_reader reader;
+    if (az_result_failed(az_json_reader_init(&reader, az_span_create((std::uint8_t *)payload.data(),
+                                                                     static_cast<std::int32_t>(payload.size())),
+                                             nullptr))) {
+        return -1;
+    }
+    int rows = -1;
+    int depth = 0;
+    bool inRows = false;
+    while (az_result_succeeded(az_json_reader_next_token(&reader))) {
+        switch (reader.token.kind) {
+        case AZ_JSON_TOKEN_PROPERTY_NAME:
+            inRows = depth == 1 && az_json_token_is_text_equal(&reader.token, AZ_SPAN_FROM_STR("rows"));
+            break;
+        case AZ_JSON_TOKEN_BEGIN_OBJECT:
+        case AZ_JSON_TOKEN_BEGIN_ARRAY:
+            depth++;
+            if (inRows && depth == 2) {
+                rows = 0;
+            } else if (inRows && depth == 3) {
+                rows++;
+                if (rows == 1 && first != nullptr
+                    && (az_result_failed(az_json_reader_next_token(&reader))
+                        || az_result_failed(az_json_token_get_int32(&reader.token, first)))) {
+                    return -1;
+                }
+            }
+            break;
+        case AZ_JSON_TOKEN_END_OBJECT:
+        case AZ_JSON_TOKEN_END_ARRAY:
+            depth--;
+            if (depth == 1) {
+                inRows = false;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return depth == 0 ? rows : -1;
+}
+
+} // namespace
+
+void setUp()
+{
+    broker = FakeBroker();
+    queue = Queue();
+}
+
+void tearDown() {}
+
+void test_no_connect_before_clock_is_set()
+{
+    Uplink uplink(broker, queue, fakePassword);
+    TEST_ASSERT_TRUE(uplink.begin(Host, DeviceId, 0));
+    queue.push(sample(0));
+    // Ohne RTC und NTP liefert currentUtcTime() 0; eine Minute lang kein Verbindungsversuch
+    for (unsigned long now = 0; now < 60000; now += 1000) {
+        TEST_ASSERT_TRUE(uplink.poll(now, 0, true) == Uplink::State::Offline);
+    }
+    TEST_ASSERT_EQUAL_UINT(0, broker.connects);
+    TEST_ASSERT_EQUAL_UINT32(0, uplink.stats().failedConnects);
+    TEST_ASSERT_TRUE(uplink.poll(61000, 946684800ULL, true) == Uplink::State::Offline);  // RTC ab Werk (2000)
+    TEST_ASSERT_EQUAL_UINT(0, broker.connects);
+
+    TEST_ASSERT_TRUE(uplink.poll(62000, ServerTime, true) == Uplink::State::Online);
+    TEST_ASSERT_EQUAL_UINT(1, broker.connects);
+    TEST_ASSERT_EQUAL_UINT64(ServerTime + 3600, broker.sessionExpiry);
+}
+
+void test_token_is_renewed_before_broker_drops_session()
+{
+    Uplink uplink(broker, queue, fakePassword);
+    uplink.begin(Host, DeviceId, 0);
+    std::uint32_t next = 0;
+    // Drei Stunden, jede Sekunde ein poll(), alle 4 s ein Messwert
+    for (unsigned long now = 0; now < 3 * 3600000UL; now += 1000) {
+        broker.unixTime = ServerTime + now / 1000;
+        if (now % 4000 == 0) {
+            queue.push(sample(next++));
+        }
+        uplink.poll(now, broker.unixTime, true);
+    }
+    TEST_ASSERT_EQUAL_UINT(0, broker.expiredSessions);
+    TEST_ASSERT_EQUAL_UINT(0, broker.rejected);
+    TEST_ASSERT_EQUAL_UINT(4, broker.connects);     // 1 min vor Ablauf neu: bei 0, 59, 118 und 177 min
+    TEST_ASSERT_EQUAL_UINT32(0, uplink.stats().failedPublishes);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(10, queue.pending());
+}
+
+void test_payload_is_valid_json_with_all_rows()
+{
+    Uplink uplink(broker, queue, fakePassword, 10);
+    uplink.begin(Host, DeviceId, 0);
+    for (std::uint32_t i = 0; i < 10; i++) {
+        queue.push(sample(i));
+    }
+    queue.push(telemetry::eventEntry(static_cast<std::uint32_t>(ServerTime), "pump_on", 12));
+    uplink.poll(0, ServerTime, true);   // verbinden
+    uplink.poll(1000, ServerTime, true);
+    TEST_ASSERT_EQUAL_size_t(1, broker.payloads.size());
+    TEST_ASSERT_EQUAL_STRING("devices/wio-1/messages/events/", broker.topics[0].c_str());
+
+    std::int32_t first = 0;
+    TEST_ASSERT_EQUAL_INT(10, countRows(broker.payloads[0], &first));
+    TEST_ASSERT_EQUAL_INT32(static_cast<std::int32_t>(ServerTime), first);
+    TEST_ASSERT_TRUE(broker.payloads[0].find("[300,") == std::string::npos);   // Zeitstempel steht vorn
+    TEST_ASSERT_TRUE(broker.payloads[0].find(",300,-15,401]") != std::string::npos);
+    TEST_ASSERT_TRUE(broker.payloads[0].find("\"events\":[[\"pump_on\",1717243200,12]]") != std::string::npos);
+    TEST_ASSERT_EQUAL_UINT32(0, queue.pending());   // 11 Einträge gelten als Rückstand und gehen in einen Batch
+}
+
+void test_backlog_is_replayed_in_order_after_outage()
+{
+    Uplink uplink(broker, queue, fakePassword, 10, 60000, 2000);
+    uplink.begin(Host, DeviceId, 0);
+    for (std::uint32_t i = 0; i < 600; i++) {
+        queue.push(sample(i));  // 40 min ohne Netz
+    }
+    unsigned long now = 0;
+    for (; now < 600000 && queue.pending() > 0; now += 1000) {
+        broker.unixTime = ServerTime + now / 1000;
+        uplink.poll(now, broker.unixTime, true);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, queue.pending());
+    std::int32_t expected = static_cast<std::int32_t>(ServerTime);
+    for (const std::string &payload : broker.payloads) {
+        std::int32_t first = 0;
+        int rows = countRows(payload, &first);
+        TEST_ASSERT_GREATER_THAN(0, rows);
+        TEST_ASSERT_EQUAL_INT32(expected, first);
+        expected += rows;
+    }
+    TEST_ASSERT_EQUAL_INT32(static_cast<std::int32_t>(ServerTime) + 600, expected);
+
+    char line[96];
+    std::snprintf(line, sizeof(line), "Rückstand 600 Einträge: %u Publishes in %lu s, %lu Bytes/Messwert",
+                  static_cast<unsigned int>(broker.payloads.size()), now / 1000,
+                  static_cast<unsigned long>(uplink.bytesPerSample()));
+    TEST_MESSAGE(line);
+    TEST_ASSERT_EQUAL_size_t(13, broker.payloads.size());      // 12 x 48 + 24
+}
+
+void test_unreachable_broker_backs_off()
+{
+    broker.reachable = false;
+    Uplink uplink(broker, queue, fakePassword, 10, 60000, 2000, 3600, 5000, 300000);
+    uplink.begin(Host, DeviceId, 0);
+    for (unsigned long now = 0; now < 700000; now += 1000) {
+        uplink.poll(now, ServerTime + now / 1000, true);
+    }
+    // Versuche bei 0, 10, 30, 70, 150, 310 s (Pause verdoppelt sich ab 10 s), dann alle 300 s
+    TEST_ASSERT_EQUAL_UINT(7, broker.connects);
+    TEST_ASSERT_EQUAL_UINT32(7, uplink.stats().failedConnects);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_no_connect_before_clock_is_set);
+    RUN_TEST(test_token_is_renewed_before_broker_drops_session);
+    RUN_TEST(test_payload_is_valid_json_with_all_rows);
+    RUN_TEST(test_backlog_is_replayed_in_order_after_outage);
+    RUN_TEST(test_unreachable_broker_backs_off);
+    return UNITY_END();
+}
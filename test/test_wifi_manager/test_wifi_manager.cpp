@@ -0,0 +1,245 @@
+// Tests für die WLAN-Verwaltung mit einer nachgebildeten WLAN-Schnittstelle (pio test -e native -f test_wifi_manager)
+
+#include <cstdio>
+#include <unity.h>
+#include "wifi_manager.hpp"
+
+namespace {
+
+constexpr int Connected = 3;
+constexpr int Disconnected = 6;
+
+/**
+ * @brief WLAN-Schnittstelle wie rpcWiFi: verbindet connectTime nach begin(), solange der Access Point da ist.
+ */
+class FakeWiFi
+{
+public:
+    unsigned long now = 0;
+    unsigned long connectTime = 1500;
+    bool accessPoint = true;
+    bool active = false;
+    unsigned long startedAt = 0;
+    unsigned int begins = 0;
+    unsigned int disconnects = 0;
+    unsigned long beginTimes[32] = {};  // Zeitpunkte der ersten begin()-Aufrufe
+
+    int begin(const char *, const char *)
+    {
+        this->active = true;
+        this->startedAt = this->now;
+        if (this->begins < 32) {
+            this->beginTimes[this->begins] = this->now;
+        }
+        this->begins++;
+        return this->status();
+    }
+    int status() const
+    {
+        return this->active && this->accessPoint && this->now - this->startedAt >= this->connectTime ? Connected
+                                                                                                     : Disconnected;
+    }
+    bool disconnect(bool)
+    {
+        this->active = false;
+        this->disconnects++;
+        return true;
+    }
+    int RSSI() const { return -60; }
+};
+
+typedef WiFiManager<FakeWiFi, Connected> Manager;
+
+FakeWiFi wifi;
+unsigned int connectedEvents = 0;
+unsigned int disconnectedEvents = 0;
+unsigned int failedEvents = 0;
+
+void onEvent(Manager::Event event, unsigned long)
+{
+    switch (event) {
+    case Manager::Event::Connected:
+        connectedEvents++;
+        break;
+    case Manager::Event::Disconnected:
+        disconnectedEvents++;
+        break;
+    case Manager::Event::ConnectFailed:
+        failedEvents++;
+        break;
+    }
+}
+
+/** @brief Ruft poll() alle 500 ms bis until auf, wie wifiTask in main.cpp. */
+void runUntil(Manager &manager, unsigned long until)
+{
+    while (wifi.now < until) {
+        wifi.now += 500;
+        manager.poll(wifi.now);
+    }
+}
+
+} // namespace
+
+void setUp()
+{
+    wifi = FakeWiFi();
+    connectedEvents = 0;
+    disconnectedEvents = 0;
+    failedEvents = 0;
+}
+
+void tearDown() {}
+
+void test_stays_off_without_users()
+{
+    Manager manager(wifi, "ssid", "pw");
+    manager.begin(0, 1);
+    runUntil(manager, 10000);
+    TEST_ASSERT_EQUAL_UINT(0, wifi.begins);
+    TEST_ASSERT_TRUE(manager.state() == Manager::State::Off);
+}
+
+void test_connects_in_background_and_publishes_event()
+{
+    Manager manager(wifi, "ssid", "pw");
+    manager.subscribe(onEvent);
+    manager.begin(0, 1);
+    manager.acquire();
+    manager.poll(0);    // startet nur, wartet nicht
+    TEST_ASSERT_TRUE(manager.state() == Manager::State::Connecting);
+    runUntil(manager, 2000);
+    TEST_ASSERT_TRUE(manager.isConnected());
+    TEST_ASSERT_EQUAL_UINT(1, connectedEvents);
+    TEST_ASSERT_EQUAL_UINT32(1500, manager.stats().lastConnectTime);
+    TEST_ASSERT_EQUAL_INT(-60, manager.stats().rssi);
+}
+
+void test_release_switches_radio_off()
+{
+    Manager manager(wifi, "ssid", "pw");
+    manager.subscribe(onEvent);
+    manager.begin(0, 1);
+    manager.acquire();
+    runUntil(manager, 5000);
+    manager.release();
+    runUntil(manager, 5500);
+    TEST_ASSERT_TRUE(manager.state() == Manager::State::Off);
+    TEST_ASSERT_FALSE(wifi.active);
+    TEST_ASSERT_EQUAL_UINT(1, disconnectedEvents);
+    TEST_ASSERT_EQUAL_UINT32(3500 * 1000 / 5500, manager.availability(5500));   // verbunden von 1,5 s bis 5 s
+}
+
+void test_timeout_enters_backoff()
+{
+    wifi.accessPoint = false;
+    Manager manager(wifi, "ssid", "pw", 15000, 5000, 300000);
+    manager.subscribe(onEvent);
+    manager.begin(0, 12345);
+    manager.acquire();
+    runUntil(manager, 15000);   // Versuch ab 500 ms
+    TEST_ASSERT_TRUE(manager.state() == Manager::State::Connecting);
+    runUntil(manager, 15500);
+    TEST_ASSERT_TRUE(manager.state() == Manager::State::Backoff);
+    TEST_ASSERT_EQUAL_UINT(1, failedEvents);
+    TEST_ASSERT_EQUAL_UINT32(1, manager.stats().failures);
+}
+
+void test_drop_reconnects_immediately()
+{
+    Manager manager(wifi, "ssid", "pw");
+    manager.subscribe(onEvent);
+    manager.begin(0, 1);
+    manager.acquire();
+    runUntil(manager, 5000);
+    wifi.accessPoint = false;
+    runUntil(manager, 5500);
+    TEST_ASSERT_TRUE(manager.state() == Manager::State::Connecting);
+    TEST_ASSERT_EQUAL_UINT32(1, manager.stats().drops);
+    TEST_ASSERT_EQUAL_UINT(2, wifi.begins);
+    wifi.accessPoint = true;
+    runUntil(manager, 8000);
+    TEST_ASSERT_TRUE(manager.isConnected());
+    TEST_ASSERT_EQUAL_UINT(2, connectedEvents);
+}
+
+void test_backoff_doubles_with_jitter_up_to_max()
+{
+    wifi.accessPoint = false;
+    Manager manager(wifi, "ssid", "pw", 15000, 5000, 300000);
+    manager.begin(0, 12345);
+    manager.acquire();
+    runUntil(manager, 3600000UL);
+
+    TEST_ASSERT_GREATER_THAN(10, wifi.begins);
+    unsigned long backoff = 5000;
+    unsigned long delays[32] = {};
+    for (unsigned int i = 1; i < wifi.begins && i < 32; i++) {
+        // Pause zwischen Ablauf des Timeouts und dem nächsten begin(); poll() alle 500 ms
+        unsigned long delay = wifi.beginTimes[i] - wifi.beginTimes[i - 1] - 15000;
+        TEST_ASSERT_GREATER_OR_EQUAL(backoff / 2, delay);
+        TEST_ASSERT_LESS_OR_EQUAL(backoff + 500, delay);
+        delays[i] = delay;
+        backoff = backoff * 2 < 300000 ? backoff * 2 : 300000;
+    }
+    unsigned int running = manager.state() == Manager::State::Connecting ? 1 : 0;
+    TEST_ASSERT_EQUAL_UINT32(wifi.begins - running, manager.stats().failures);
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "Pausen ohne Access Point: %lu, %lu, %lu, %lu, %lu, %lu, %lu ms; %u Versuche in 1 h",
+                  delays[1], delays[2], delays[3], delays[4], delays[5], delays[6], delays[7], wifi.begins);
+    TEST_MESSAGE(line);
+}
+
+/**
+ * @brief Nach einem Ausfall des Access Points dürfen nicht alle Geräte gleichzeitig neu verbinden.
+ */
+void test_jitter_spreads_retries_of_many_devices()
+{
+    const int devices = 20;
+    unsigned long fifthAttempt[devices];
+    unsigned long earliest = static_cast<unsigned long>(-1);
+    unsigned long latest = 0;
+    for (int device = 0; device < devices; device++) {
+        wifi = FakeWiFi();
+        wifi.accessPoint = false;
+        Manager manager(wifi, "ssid", "pw", 15000, 5000, 300000);
+        manager.begin(0, static_cast<std::uint32_t>(1000003 * (device + 1)));  // micros() beim Start
+        manager.acquire();
+        while (wifi.begins < 5) {
+            wifi.now += 500;
+            manager.poll(wifi.now);
+        }
+        fifthAttempt[device] = wifi.beginTimes[4];
+        earliest = fifthAttempt[device] < earliest ? fifthAttempt[device] : earliest;
+        latest = fifthAttempt[device] > latest ? fifthAttempt[device] : latest;
+    }
+    int distinct = 0;
+    for (int i = 0; i < devices; i++) {
+        bool seen = false;
+        for (int j = 0; j < i; j++) {
+            seen = seen || fifthAttempt[j] == fifthAttempt[i];
+        }
+        distinct += seen ? 0 : 1;
+    }
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "5. Versuch von %d Geraeten: %lu..%lu ms, %d verschiedene Zeitpunkte",
+                  devices, earliest, latest, distinct);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_GREATER_OR_EQUAL(15, distinct);
+    TEST_ASSERT_GREATER_THAN(10000, latest - earliest);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_stays_off_without_users);
+    RUN_TEST(test_connects_in_background_and_publishes_event);
+    RUN_TEST(test_release_switches_radio_off);
+    RUN_TEST(test_timeout_enters_backoff);
+    RUN_TEST(test_drop_reconnects_immediately);
+    RUN_TEST(test_backoff_doubles_with_jitter_up_to_max);
+    RUN_TEST(test_jitter_spreads_retries_of_many_devices);
+    return UNITY_END();
+}
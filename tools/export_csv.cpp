@@ -0,0 +1,76 @@
+// Exportiert sensors.bin (Binärformat, siehe src/sample_log_format.hpp) als CSV.
+//
+// Bauen und Aufrufen auf dem PC:
+//   g++ -std=c++11 -O2 -I src tools/export_csv.cpp -o export_csv
+//   ./export_csv sensors.bin > sensors.csv
+//
+// Die Datei wird blockweise gestreamt, der Speicherbedarf ist unabhängig von der Dateigröße.
+// Blöcke mit falscher CRC werden übersprungen und auf stderr gemeldet.
+
+#include <cstdio>
+#include <ctime>
+#include "sample_log_format.hpp"
+
+static void printTenths(std::FILE *out, int tenths)
+{
+    // Zwei Nachkommastellen wie die bisherige CSV-Ausgabe (Print::print(float))
+    const char *sign = tenths < 0 ? "-" : "";
+    int absValue = tenths < 0 ? -tenths : tenths;
+    std::fprintf(out, "%s%d.%d0", sign, absValue / 10, absValue % 10);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 2) {
+        std::fprintf(stderr, "Aufruf: %s [sensors.bin] > sensors.csv\n", argv[0]);
+        return 2;
+    }
+    std::FILE *in = argc == 2 ? std::fopen(argv[1], "rb") : stdin;
+    if (!in) {
+        std::perror(argv[1]);
+        return 1;
+    }
+
+    std::uint8_t block[samplelog::BlockSize];
+    samplelog::FileHeader header;
+    if (std::fread(block, 1, sizeof(block), in) != sizeof(block) || !samplelog::decodeFileHeader(block, header)) {
+        std::fprintf(stderr, "Kein gültiger Dateikopf (Version %u erwartet)\n", samplelog::Version);
+        return 1;
+    }
+
+    std::printf("Zeit,Feuchtigkeit_Pflanze,Temperatur,Luftfeuchtigkeit\n");
+
+    unsigned long blocks = 0;
+    unsigned long badBlocks = 0;
+    unsigned long rows = 0;
+    while (std::fread(block, 1, sizeof(block), in) == sizeof(block)) {
+        if (!samplelog::blockCrcValid(block) || samplelog::blockCount(block) > samplelog::RecordsPerBlock) {
+            std::fprintf(stderr, "Block %lu: CRC-Fehler, übersprungen\n", blocks);
+            badBlocks++;
+            blocks++;
+            continue;
+        }
+        for (std::size_t i = 0; i < samplelog::blockCount(block); i++) {
+            samplelog::Record record = samplelog::readRecord(block, i);
+            // Die RTC läuft in Ortszeit, daher ohne weitere Zeitzonenumrechnung ausgeben
+            std::time_t t = record.unixTime;
+            char timeBuffer[24];
+            std::strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d %H:%M:%S", std::gmtime(&t));
+            std::printf("%s,%u,", timeBuffer, record.moisture);
+            printTenths(stdout, record.temperature);
+            std::putchar(',');
+            printTenths(stdout, record.humidity);
+            std::putchar('\n');
+            rows++;
+        }
+        blocks++;
+    }
+
+    long fileBytes = static_cast<long>(samplelog::BlockSize * (blocks + 1));
+    std::fprintf(stderr, "%lu Datensätze in %lu Blöcken (%lu fehlerhaft), %.1f Byte/Datensatz\n",
+                 rows, blocks, badBlocks, rows ? static_cast<double>(fileBytes) / rows : 0.0);
+    if (in != stdin) {
+        std::fclose(in);
+    }
+    return badBlocks ? 3 : 0;
+}